@@ -0,0 +1,675 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// This is a lock-free version of shared_ptr_mt, with the same interface.
+//
+// shared_ptr_mt embeds a Futex in every pointer and locks it on every copy,
+// assignment and reset. atomic_shared_ptr_mt is the size of a single 64 bit
+// word, and its copies and assignments are lock-free. It uses the split
+// reference count technique: the pointer word holds, next to the address of
+// the shared control block, a count of the threads which are in the middle
+// of copying from it. A copying thread increments that count, which keeps
+// the control block alive until it has incremented the shared reference
+// count, and then decrements it again. A thread which replaces the pointer
+// adds the count of such threads to the shared reference count, so that
+// those threads can finish their copy from the control block they saw.
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef EATHREAD_ATOMIC_SHARED_PTR_MT_H
+#define EATHREAD_ATOMIC_SHARED_PTR_MT_H
+
+#ifndef INCLUDED_eabase_H
+   #include <EABase/eabase.h>
+#endif
+#ifndef EATHREAD_EATHREAD_ATOMIC_H
+   #include <eathread/eathread_atomic.h>
+#endif
+#ifndef EATHREAD_EATHREAD_SYNC_H
+   #include <eathread/eathread_sync.h>
+#endif
+#ifndef EATHREAD_EATHREAD_H
+   #include <eathread/eathread.h>
+#endif
+#include <eathread/internal/config.h>
+#include <eathread/internal/eathread_memory.h>
+#include <new>
+#include <utility>
+
+#if defined(EA_PRAGMA_ONCE_SUPPORTED)
+	#pragma once // Some compilers (e.g. VC++) benefit significantly from using this. We've measured 3-4% build speed improvements in apps as a result.
+#endif
+
+
+
+
+namespace EA
+{
+   namespace Thread
+   {
+	  namespace detail
+	  {
+		 /// Used by atomic_shared_ptr_mt::lock and unlock, which exist for
+		 /// compatibility with shared_ptr_mt. Locks one of a fixed set of 
+		 /// spin locks, chosen by address.
+		 EATHREADLIB_API void LockSharedPtrStripe(const void* pAddress);
+		 EATHREADLIB_API void UnlockSharedPtrStripe(const void* pAddress);
+
+		 /// Control blocks are aligned to this, which leaves the low bits of their
+		 /// addresses clear for atomic_shared_ptr_mt's borrow count.
+		 static const size_t kSharedControlBlockAlignment = 64;
+
+
+		 /// shared_control_block
+		 /// The control block shared by the atomic_shared_ptr_mt and weak_ptr_mt
+		 /// objects which refer to the same owned pointer.
+		 template<class T>
+		 struct shared_control_block
+		 {
+			typedef void (*function_type)(shared_control_block*);
+
+			AtomicInt32   mRefCount;      /// Number of owning atomic_shared_ptr_mt objects, plus borrows transferred from replaced pointer words.
+			AtomicInt32   mWeakCount;     /// Number of weak_ptr_mt objects, plus one while mRefCount is non-zero.
+			T*            mpValue;        /// The owned pointer.
+			function_type mpDestroyValue; /// Destroys the owned object when mRefCount drops to zero.
+			function_type mpFreeBlock;    /// Frees this block when mWeakCount drops to zero.
+
+			shared_control_block(T* pValue, function_type pDestroyValue, function_type pFreeBlock)
+			   : mRefCount(1), mWeakCount(1), mpValue(pValue), mpDestroyValue(pDestroyValue), mpFreeBlock(pFreeBlock) {}
+
+			/// Adds nDelta to the reference count. If it drops to zero, destroys the 
+			/// owned object and releases the weak reference held by the strong ones.
+			void add_ref(int32_t nDelta)
+			{
+			   if(mRefCount.Add(nDelta) == 0) // Atomic operation
+			   {
+				  mpDestroyValue(this);
+				  release_weak();
+			   }
+			}
+
+			/// Increments the reference count unless it has already dropped to zero.
+			bool try_add_ref()
+			{
+			   for(int32_t n = mRefCount.GetValue(); n > 0; n = mRefCount.GetValue())
+			   {
+				  if(mRefCount.SetValueConditional(n + 1, n))
+					 return true;
+			   }
+			   return false;
+			}
+
+			void release_weak()
+			{
+			   if(mWeakCount.Decrement() == 0) // Atomic operation
+				  mpFreeBlock(this);
+			}
+
+			// Functions for owned pointers which were allocated separately with operator new.
+			static void delete_value(shared_control_block* pControl) { delete pControl->mpValue; }
+			static void delete_block(shared_control_block* pControl) { pControl->~shared_control_block(); FreeAlignedMemory(pControl); }
+		 };
+
+
+		 /// shared_inplace_block
+		 /// The control block and owned object created by make_shared_mt, which
+		 /// share a single allocation.
+		 template<class T>
+		 struct shared_inplace_block : public shared_control_block<T>
+		 {
+			typedef shared_control_block<T> base_type;
+
+			alignas(T) char mStorage[sizeof(T)];  /// The owned object.
+
+			shared_inplace_block()
+			   : base_type(0, &destroy_value, &free_block) {}
+
+			static void destroy_value(base_type* pControl)
+			{
+			   pControl->mpValue->~T();
+			}
+
+			static void free_block(base_type* pControl)
+			{
+			   shared_inplace_block* const pBlock = static_cast<shared_inplace_block*>(pControl);
+
+			   pBlock->~shared_inplace_block();
+			   FreeAlignedMemory(pBlock);
+			}
+		 };
+
+
+		 /// Selects the atomic_shared_ptr_mt constructor which adopts a reference on a control block.
+		 struct shared_adopt_tag {};
+	  }
+
+
+	  template<class T>
+	  class weak_ptr_mt;
+
+
+	  /// class atomic_shared_ptr_mt
+	  /// @brief Implements a lock-free, thread-safe version of shared_ptr.
+	  ///
+	  /// Any number of threads may concurrently copy from, assign to and reset
+	  /// the same atomic_shared_ptr_mt object. get, operator-> and operator*, 
+	  /// however, read the control block of the object in place, and so must 
+	  /// not be used on an object that another thread may be assigning at the
+	  /// same time. Copy such an object first, and use the copy.
+	  ///
+	  /// When constructed from a pointer, the owned pointer's control block is
+	  /// allocated separately, as with shared_ptr_mt, from the EA::Thread::Allocator
+	  /// given to SetAllocator if there is one, and from operator new otherwise. Use 
+	  /// make_shared_mt to allocate the object and control block together.
+	  /// A null pointer has no control block and no allocation.
+	  ///
+	  /// Example usage:
+	  ///   atomic_shared_ptr_mt<Config> gConfig(new Config);
+	  ///
+	  ///   // Reader threads:
+	  ///   atomic_shared_ptr_mt<Config> pConfig(gConfig); // Lock-free.
+	  ///   Use(pConfig->mValue);
+	  ///
+	  ///   // Writer thread:
+	  ///   gConfig.reset(new Config(newSettings));       // Readers keep the old Config alive until they are done with it.
+	  ///
+	  template<class T>
+	  class atomic_shared_ptr_mt
+	  {
+	  private:
+		 /// this_type
+		 /// This is an alias for atomic_shared_ptr_mt<T>, this class.
+		 typedef atomic_shared_ptr_mt<T> this_type;
+
+		 typedef detail::shared_control_block<T> control_block;
+
+		 template<class U>
+		 friend class weak_ptr_mt;
+
+		 // The pointer word holds the control block address, with the count of borrows
+		 // in the low bits which the control block's alignment leaves clear. The address
+		 // bits are stored as they are, so any high bits that the platform uses, such as 
+		 // AArch64 pointer tags or 57 bit virtual addresses, are preserved. A borrow is 
+		 // held for only a few instructions, and a thread which finds all 63 in use waits
+		 // for one to be returned.
+		 static const uint64_t kBorrowMask  = detail::kSharedControlBlockAlignment - 1;
+		 static const uint64_t kAddressMask = ~kBorrowMask;
+		 static const uint64_t kBorrowOne   = 1;
+
+		 mutable AtomicUint64 mWord;      /// control_block address | borrow count
+
+		 static control_block* to_control(uint64_t nWord)
+		 {
+			return reinterpret_cast<control_block*>((uintptr_t)(nWord & kAddressMask));
+		 }
+
+		 static uint64_t to_word(control_block* pControl)
+		 {
+			EAT_ASSERT(((uint64_t)(uintptr_t)pControl & kBorrowMask) == 0); // All control blocks are allocated with kSharedControlBlockAlignment.
+			return (uint64_t)(uintptr_t)pControl;
+		 }
+
+		 static control_block* create_control(T* pValue)
+		 {
+			if(!pValue)
+			   return 0;
+
+			void* const pMemory = detail::AllocateAlignedMemory(sizeof(control_block), detail::kSharedControlBlockAlignment, EATHREAD_ALLOC_PREFIX "atomic_shared_ptr_mt");
+
+			if(!pMemory)
+			{
+			   delete pValue;
+
+			   #if defined(EA_COMPILER_NO_EXCEPTIONS) || defined(EA_COMPILER_NO_UNWIND)
+				  return 0;
+			   #else
+				  throw std::bad_alloc();
+			   #endif
+			}
+
+			return new(pMemory) control_block(pValue, &control_block::delete_value, &control_block::delete_block);
+		 }
+
+		 /// Releases the reference of a replaced pointer word and transfers its
+		 /// borrows to the reference count.
+		 static void release(uint64_t nWord)
+		 {
+			control_block* const pControl = to_control(nWord);
+
+			if(pControl)
+			   pControl->add_ref((int32_t)(nWord & kBorrowMask) - 1);
+		 }
+
+		 /// Returns our control block with its reference count incremented on behalf of the caller.
+		 control_block* acquire() const
+		 {
+			uint64_t nWord = mWord.GetValue();
+
+			// Borrow: keeps the control block from being freed until we have our own reference.
+			for(;;)
+			{
+			   if((nWord & kAddressMask) == 0)
+				  return 0;
+
+			   if((nWord & kBorrowMask) == kBorrowMask) // Every borrow bit is in use; wait for one to be returned.
+				  EA_THREAD_DO_SPIN();
+			   else if(mWord.SetValueConditional(nWord + kBorrowOne, nWord))
+				  break;
+
+			   nWord = mWord.GetValue();
+			}
+
+			control_block* const pControl = to_control(nWord);
+			pControl->mRefCount.Increment(); // Atomic operation
+
+			// Return the borrow. If the word no longer has any borrows for our control block,
+			// the thread which replaced the word has moved ours into the reference count, and
+			// we return it there. Borrows are interchangeable, so it doesn't matter if the
+			// control block has been stored again and the borrow we return is another thread's.
+			for(;;)
+			{
+			   const uint64_t nCurrent = mWord.GetValue();
+
+			   if(((nCurrent & kAddressMask) != (nWord & kAddressMask)) || ((nCurrent & kBorrowMask) == 0))
+			   {
+				  pControl->mRefCount.Decrement(); // Can't reach zero, as we hold a reference.
+				  break;
+			   }
+
+			   if(mWord.SetValueConditional(nCurrent - kBorrowOne, nCurrent))
+				  break;
+			}
+
+			return pControl;
+		 }
+
+		 /// Stores a control block whose reference we already hold, and releases the old one.
+		 void replace(control_block* pControl)
+		 {
+			release(mWord.SetValue(to_word(pControl))); // SetValue returns the previous value.
+		 }
+
+	  public:
+		 typedef T element_type;
+		 typedef T value_type;
+
+		 /// atomic_shared_ptr_mt
+		 /// Takes ownership of the pointer and sets the reference count
+		 /// to the pointer to 1. It is OK if the input pointer is null.
+		 /// If an exception occurs during the allocation of the shared 
+		 /// reference count, the owned pointer is deleted and the exception
+		 /// is rethrown.
+		 explicit atomic_shared_ptr_mt(T* pValue = 0)
+			: mWord(to_word(create_control(pValue)))
+		 {
+		 }
+
+		 /// atomic_shared_ptr_mt
+		 /// Shares ownership of a pointer with another instance of atomic_shared_ptr_mt,
+		 /// which may be concurrently modified by other threads.
+		 atomic_shared_ptr_mt(atomic_shared_ptr_mt const& sharedPtr)
+			: mWord(to_word(sharedPtr.acquire()))
+		 {
+		 }
+
+		 /// atomic_shared_ptr_mt
+		 /// Takes over a reference which the caller holds on a control block.
+		 /// This is used by make_shared_mt and weak_ptr_mt.
+		 atomic_shared_ptr_mt(control_block* pControl, detail::shared_adopt_tag)
+			: mWord(to_word(pControl))
+		 {
+		 }
+
+		 /// ~atomic_shared_ptr_mt
+		 /// Decrements the reference count for the owned pointer. If the 
+		 /// reference count goes to zero, the owned pointer is deleted and
+		 /// the shared reference count is deleted.
+		 ~atomic_shared_ptr_mt()
+		 {
+			release(mWord.GetValue());
+		 }
+
+		 /// operator=
+		 /// Copies another atomic_shared_ptr_mt to this object, releasing the
+		 /// pointer this object previously owned.
+		 atomic_shared_ptr_mt& operator=(atomic_shared_ptr_mt const& sharedPtr)
+		 {
+			if(&sharedPtr != this)
+			   replace(sharedPtr.acquire());
+			return *this;
+		 }
+
+		 /// lock
+		 /// Provided for compatibility with shared_ptr_mt. None of the functions
+		 /// of this class need it, but users that relied on shared_ptr_mt::lock to
+		 /// serialize their own operations on a pointer object can keep doing so.
+		 void lock() const
+		 {
+			detail::LockSharedPtrStripe(this);
+		 }
+
+		 /// unlock
+		 /// Unlocks a previous call to lock.
+		 void unlock() const
+		 {
+			detail::UnlockSharedPtrStripe(this);
+		 }
+
+		 /// reset
+		 /// Releases the owned pointer and takes ownership of the 
+		 /// passed in pointer. If the passed in pointer is the same
+		 /// as the owned pointer, nothing is done.
+		 void reset(T* pValue = 0)
+		 {
+			// We compare with the owned pointer through a reference of our own, as another
+			// thread may replace the pointer and free its control block at any time.
+			control_block* const pControl = acquire();
+			const bool           bSame    = pControl ? (pControl->mpValue == pValue) : (pValue == 0);
+
+			if(pControl)
+			   pControl->add_ref(-1);
+
+			if(!bSame)
+			   replace(create_control(pValue));
+		 }
+
+		 /// swap
+		 /// Exchanges the owned pointer beween two atomic_shared_ptr_mt objects.
+		 /// Each object is updated atomically, but the pair isn't; another thread
+		 /// concurrently reading both may see them owning the same pointer.
+		 void swap(atomic_shared_ptr_mt<T>& sharedPtr)
+		 {
+			const uint64_t       nOther   = sharedPtr.mWord.SetValue(to_word(acquire()));
+			control_block* const pControl = to_control(nOther);
+
+			// The other word's reference moves to us, and its borrows to the reference count.
+			if(pControl && (nOther & kBorrowMask))
+			   pControl->mRefCount.Add((int32_t)(nOther & kBorrowMask));
+
+			replace(pControl);
+		 }
+
+		 /// operator*
+		 /// Returns the owner pointer dereferenced.
+		 T& operator*() const
+		 {
+			return *get();
+		 }
+
+		 /// operator->
+		 /// Allows access to the owned pointer via operator->()
+		 T* operator->() const
+		 {
+			return get();
+		 }
+
+		 /// get
+		 /// Returns the owned pointer. Note that this class does 
+		 /// not provide an operator T() function. This is because such
+		 /// a thing (automatic conversion) is deemed unsafe.
+		 T* get() const
+		 {
+			control_block* const pControl = to_control(mWord.GetValue());
+			return pControl ? pControl->mpValue : 0;
+		 }
+
+		 /// use_count
+		 /// Returns the reference count on the owned pointer.
+		 /// The return value is one if the owned pointer is null.
+		 int use_count() const
+		 {
+			control_block* const pControl = to_control(mWord.GetValue());
+			return pControl ? (int)pControl->mRefCount.GetValue() : 1;
+		 }
+
+		 /// unique
+		 /// Returns true if the reference count on the owned pointer is one.
+		 /// The return value is true if the owned pointer is null.
+		 bool unique() const
+		 {
+			return (use_count() == 1);
+		 }
+
+		 /// Implicit operator bool
+		 /// Allows for using an atomic_shared_ptr_mt as a boolean. 
+		 typedef T* (this_type::*bool_)() const;
+		 operator bool_() const
+		 {
+			if(mWord.GetValue() & kAddressMask)
+			   return &this_type::get;
+			return 0;
+		 }
+
+		 /// operator!
+		 /// This returns the opposite of operator bool; it returns true if 
+		 /// the owned pointer is null.
+		 bool operator!() const
+		 {
+			return (mWord.GetValue() & kAddressMask) == 0;
+		 }
+
+	  }; // class atomic_shared_ptr_mt
+
+
+	  /// class weak_ptr_mt
+	  /// @brief A non-owning reference to the object of an atomic_shared_ptr_mt.
+	  ///
+	  /// A weak_ptr_mt doesn't keep its object alive, but can safely tell whether
+	  /// it still exists and, if so, obtain an owning pointer to it. This suits 
+	  /// caches, which should not keep otherwise unused objects around. The
+	  /// control block lives on until the last weak_ptr_mt is gone, even when the
+	  /// object doesn't; with make_shared_mt, so does the object's memory.
+	  ///
+	  /// Any number of threads may concurrently call the const functions of a
+	  /// weak_ptr_mt, such as lock. As with std::weak_ptr, assigning to a weak_ptr_mt
+	  /// while another thread uses the same weak_ptr_mt object is not supported.
+	  ///
+	  /// Example usage:
+	  ///   weak_ptr_mt<Texture> weakTexture(pTexture); // pTexture is an atomic_shared_ptr_mt<Texture>.
+	  ///
+	  ///   atomic_shared_ptr_mt<Texture> pCached = weakTexture.lock();
+	  ///   if(pCached)
+	  ///      Draw(*pCached);
+	  ///
+	  template<class T>
+	  class weak_ptr_mt
+	  {
+	  private:
+		 typedef detail::shared_control_block<T> control_block;
+
+		 control_block* mpControl;  /// Null if this refers to nothing.
+
+	  public:
+		 typedef T element_type;
+		 typedef T value_type;
+
+		 weak_ptr_mt()
+			: mpControl(0)
+		 {
+		 }
+
+		 /// weak_ptr_mt
+		 /// Refers to the object owned by sharedPtr, which may be concurrently
+		 /// modified by other threads.
+		 weak_ptr_mt(const atomic_shared_ptr_mt<T>& sharedPtr)
+			: mpControl(sharedPtr.acquire())
+		 {
+			if(mpControl)
+			{
+			   mpControl->mWeakCount.Increment(); // Atomic operation
+			   mpControl->add_ref(-1);            // Releases the reference that acquire gave us.
+			}
+		 }
+
+		 weak_ptr_mt(const weak_ptr_mt& weakPtr)
+			: mpControl(weakPtr.mpControl)
+		 {
+			if(mpControl)
+			   mpControl->mWeakCount.Increment(); // Atomic operation
+		 }
+
+		 ~weak_ptr_mt()
+		 {
+			if(mpControl)
+			   mpControl->release_weak();
+		 }
+
+		 weak_ptr_mt& operator=(const weak_ptr_mt& weakPtr)
+		 {
+			weak_ptr_mt(weakPtr).swap(*this);
+			return *this;
+		 }
+
+		 weak_ptr_mt& operator=(const atomic_shared_ptr_mt<T>& sharedPtr)
+		 {
+			weak_ptr_mt(sharedPtr).swap(*this);
+			return *this;
+		 }
+
+		 /// reset
+		 /// Makes this refer to nothing.
+		 void reset()
+		 {
+			weak_ptr_mt().swap(*this);
+		 }
+
+		 /// swap
+		 /// Exchanges the referred objects of two weak_ptr_mt objects.
+		 void swap(weak_ptr_mt& weakPtr)
+		 {
+			control_block* const pControl = weakPtr.mpControl;
+			weakPtr.mpControl = mpControl;
+			mpControl         = pControl;
+		 }
+
+		 /// lock
+		 /// Returns an owning pointer to the object, or a null pointer if the
+		 /// object has been destroyed.
+		 atomic_shared_ptr_mt<T> lock() const
+		 {
+			if(mpControl && mpControl->try_add_ref())
+			   return atomic_shared_ptr_mt<T>(mpControl, detail::shared_adopt_tag());
+			return atomic_shared_ptr_mt<T>();
+		 }
+
+		 /// expired
+		 /// Returns true if the object has been destroyed, or if this refers to nothing.
+		 /// A false return value may be out of date by the time it is seen; use lock
+		 /// to actually get at the object.
+		 bool expired() const
+		 {
+			return !mpControl || (mpControl->mRefCount.GetValue() == 0);
+		 }
+
+		 /// use_count
+		 /// Returns the number of atomic_shared_ptr_mt objects owning the object.
+		 int use_count() const
+		 {
+			return mpControl ? (int)mpControl->mRefCount.GetValue() : 0;
+		 }
+
+	  }; // class weak_ptr_mt
+
+
+	  /// make_shared_mt
+	  /// Constructs a T from the given arguments and returns an atomic_shared_ptr_mt
+	  /// that owns it. The object and its control block are allocated together,
+	  /// which saves an allocation and a likely cache miss per object compared 
+	  /// to atomic_shared_ptr_mt(new T). Memory comes from the EA::Thread::Allocator
+	  /// given to SetAllocator if there is one, and from operator new otherwise, and
+	  /// is aligned as T requires. If the memory can't be allocated, std::bad_alloc
+	  /// is thrown, or where exceptions are disabled, a null pointer is returned.
+	  ///
+	  /// Example usage:
+	  ///   atomic_shared_ptr_mt<Message> pMessage = make_shared_mt<Message>(nType, pPayload);
+	  ///
+	  template<class T, class... Args>
+	  inline atomic_shared_ptr_mt<T> make_shared_mt(Args&&... args)
+	  {
+		 typedef detail::shared_inplace_block<T> block_type;
+
+		 const size_t nAlignment = (EA_ALIGN_OF(block_type) > detail::kSharedControlBlockAlignment) ? EA_ALIGN_OF(block_type) : detail::kSharedControlBlockAlignment;
+		 void* const  pMemory    = detail::AllocateAlignedMemory(sizeof(block_type), nAlignment, EATHREAD_ALLOC_PREFIX "make_shared_mt");
+
+		 if(!pMemory)
+		 {
+			#if defined(EA_COMPILER_NO_EXCEPTIONS) || defined(EA_COMPILER_NO_UNWIND)
+			   return atomic_shared_ptr_mt<T>();
+			#else
+			   throw std::bad_alloc();
+			#endif
+		 }
+
+		 block_type* const pBlock = new(pMemory) block_type;
+
+		 #if defined(EA_COMPILER_NO_EXCEPTIONS) || defined(EA_COMPILER_NO_UNWIND)
+			pBlock->mpValue = new(pBlock->mStorage) T(std::forward<Args>(args)...);
+		 #else
+			EA_DISABLE_VC_WARNING(4571)
+			try
+			{
+			   pBlock->mpValue = new(pBlock->mStorage) T(std::forward<Args>(args)...);
+			}
+			catch(...)
+			{
+			   block_type::free_block(pBlock);
+			   throw;
+			}
+			EA_RESTORE_VC_WARNING()
+		 #endif
+
+		 return atomic_shared_ptr_mt<T>(pBlock, detail::shared_adopt_tag());
+	  }
+
+
+	  /// get_pointer
+	  /// returns atomic_shared_ptr_mt::get() via the input atomic_shared_ptr_mt. 
+	  template<class T>
+	  inline T* get_pointer(const atomic_shared_ptr_mt<T>& sharedPtr)
+	  {
+		 return sharedPtr.get();
+	  }
+
+	  /// swap
+	  /// Exchanges the owned pointer beween two atomic_shared_ptr_mt objects.
+	  template<class T>
+	  inline void swap(atomic_shared_ptr_mt<T>& sharedPtr1, atomic_shared_ptr_mt<T>& sharedPtr2)
+	  {
+		 sharedPtr1.swap(sharedPtr2);
+	  }
+
+	  /// operator==
+	  /// Compares two atomic_shared_ptr_mt objects for equality, which is defined
+	  /// as owning the same pointer.
+	  template<class T, class U>
+	  inline bool operator==(const atomic_shared_ptr_mt<T>& sharedPtr1, const atomic_shared_ptr_mt<U>& sharedPtr2)
+	  {
+		 return (sharedPtr1.get() == sharedPtr2.get());
+	  }
+
+	  /// operator!=
+	  template<class T, class U>
+	  inline bool operator!=(const atomic_shared_ptr_mt<T>& sharedPtr1, const atomic_shared_ptr_mt<U>& sharedPtr2)
+	  {
+		 return (sharedPtr1.get() != sharedPtr2.get());
+	  }
+
+	  /// operator<
+	  /// Returns which atomic_shared_ptr_mt is 'less' than the other. Useful when storing
+	  /// sorted containers of atomic_shared_ptr_mt objects.
+	  template<class T, class U>
+	  inline bool operator<(const atomic_shared_ptr_mt<T>& sharedPtr1, const atomic_shared_ptr_mt<U>& sharedPtr2)
+	  {
+		 return (sharedPtr1.get() < sharedPtr2.get());
+	  }
+
+   } // namespace Thread
+
+} // namespace EA
+
+
+
+
+#endif // EATHREAD_ATOMIC_SHARED_PTR_MT_H
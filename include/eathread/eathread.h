@@ -578,6 +578,94 @@ namespace EA
 		EATHREADLIB_API ThreadAffinityMask GetThreadAffinityMask(const EA::Thread::ThreadId& id);
 
 
+		/// ThreadSchedulingPolicy
+		///
+		/// Identifies the operating system scheduling class of a thread. These are
+		/// Linux's policies, and are available where EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+		/// is 1. Which policies a process may use depends on its privileges; see
+		/// ThreadSchedulingResult.
+		///
+		enum ThreadSchedulingPolicy
+		{
+			kThreadSchedulingPolicyDefault,    /// Normal time-sharing (SCHED_OTHER). The priority comes from ThreadParameters::mnPriority, as without scheduling.
+			kThreadSchedulingPolicyFifo,       /// Real-time (SCHED_FIFO). Runs ahead of all normal threads until it blocks or yields.
+			kThreadSchedulingPolicyRoundRobin, /// Real-time (SCHED_RR). As kThreadSchedulingPolicyFifo, but time-sliced with threads of equal priority.
+			kThreadSchedulingPolicyDeadline,   /// Earliest deadline first (SCHED_DEADLINE). Gets mnRuntimeNs of CPU time in each mnPeriodNs, by mnDeadlineNs into the period.
+			kThreadSchedulingPolicyBatch,      /// Time-sharing for CPU-bound, non-interactive work (SCHED_BATCH). Never preempts other threads on wakeup.
+			kThreadSchedulingPolicyIdle        /// Runs only when nothing else wants the processor (SCHED_IDLE). For background work which can wait.
+		};
+
+
+		/// ThreadScheduling
+		///
+		/// Describes the scheduling of a thread, for SetThreadScheduling and 
+		/// ThreadParameters::mScheduling.
+		///
+		/// Example usage:
+		///     ThreadScheduling scheduling;                            // An I/O thread which needs 200us of CPU every 1ms.
+		///     scheduling.mPolicy      = kThreadSchedulingPolicyDeadline;
+		///     scheduling.mnRuntimeNs  = 200000;
+		///     scheduling.mnPeriodNs   = 1000000;
+		///
+		///     if(SetThreadScheduling(scheduling) != kThreadSchedulingResultSuccess)
+		///         SetThreadScheduling(ThreadScheduling(kThreadSchedulingPolicyFifo, 10));
+		///
+		struct EATHREADLIB_API ThreadScheduling
+		{
+			ThreadSchedulingPolicy mPolicy;
+			int                    mnPriority;   /// The native real-time priority for kThreadSchedulingPolicyFifo and kThreadSchedulingPolicyRoundRobin, which on Linux is in [1, 99]. Else unused.
+			uint64_t               mnRuntimeNs;  /// For kThreadSchedulingPolicyDeadline, the CPU time the thread gets in each period. Must be at least 1024ns.
+			uint64_t               mnDeadlineNs; /// For kThreadSchedulingPolicyDeadline, how far into each period the runtime must have been given, in [mnRuntimeNs, mnPeriodNs]. 0 means mnPeriodNs.
+			uint64_t               mnPeriodNs;   /// For kThreadSchedulingPolicyDeadline, the length of each period. 0 means mnDeadlineNs.
+
+			ThreadScheduling(ThreadSchedulingPolicy policy = kThreadSchedulingPolicyDefault, int nPriority = 0)
+				: mPolicy(policy), mnPriority(nPriority), mnRuntimeNs(0), mnDeadlineNs(0), mnPeriodNs(0) {}
+		};
+
+
+		/// ThreadSchedulingResult
+		///
+		/// The result of changing the scheduling of a thread. If the change failed, the
+		/// thread's scheduling is as it was before, and the thread runs normally.
+		///
+		enum ThreadSchedulingResult
+		{
+			kThreadSchedulingResultSuccess,          /// The scheduling was applied as requested.
+			kThreadSchedulingResultPriorityReduced,  /// A real-time policy was applied, but with the highest priority the process is allowed (RLIMIT_RTPRIO), which is lower than requested.
+			kThreadSchedulingResultNotPermitted,     /// The process lacks the privilege (CAP_SYS_NICE or RLIMIT_RTPRIO). SCHED_DEADLINE also requires that the thread may run on every processor.
+			kThreadSchedulingResultNotSupported,     /// The policy isn't supported by the platform or kernel.
+			kThreadSchedulingResultInvalid,          /// The scheduling parameters or the thread aren't valid.
+			kThreadSchedulingResultBusy,             /// SCHED_DEADLINE admission control refused the request, as the processors don't have the bandwidth for it.
+			kThreadSchedulingResultPending           /// The thread hasn't yet started, and so hasn't applied its ThreadParameters::mScheduling.
+		};
+
+
+		#if EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+			/// SetThreadScheduling
+			///
+			/// Changes the scheduling policy (and its parameters) of the current thread,
+			/// or of the given thread. Returns kThreadSchedulingResultSuccess or the reason
+			/// why it couldn't; see ThreadSchedulingResult. Setting a real-time policy without
+			/// the privilege for the requested priority falls back to the highest allowed 
+			/// priority, if RLIMIT_RTPRIO allows any.
+			///
+			/// Without privileges, a thread can make itself kThreadSchedulingPolicyBatch or
+			/// kThreadSchedulingPolicyIdle, but may not then be able to return to the default.
+			/// A SCHED_DEADLINE thread can't create threads or processes.
+			///
+			EATHREADLIB_API ThreadSchedulingResult SetThreadScheduling(const ThreadScheduling& scheduling);
+			EATHREADLIB_API ThreadSchedulingResult SetThreadScheduling(const EA::Thread::ThreadId& id, const ThreadScheduling& scheduling);
+
+			/// GetThreadScheduling
+			///
+			/// Returns the scheduling of the current thread, or of the given thread. 
+			/// Returns false if the thread isn't valid.
+			///
+			EATHREADLIB_API bool GetThreadScheduling(ThreadScheduling& scheduling);
+			EATHREADLIB_API bool GetThreadScheduling(const EA::Thread::ThreadId& id, ThreadScheduling& scheduling);
+		#endif
+
+
 		/// GetName
 		/// Returns the name of the thread assigned by the SetName function.
 		/// If the thread was not named by the SetName function, then the name is empty ("").
@@ -0,0 +1,214 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Defines backoff policies for spin-wait loops.
+//
+// When many processors poll the same lock word, each release of the lock
+// causes every poller to re-fetch the cache line and many of them to attempt
+// an atomic update at once. Backing off (waiting progressively longer between
+// polls) spreads these attempts out and reduces the coherence traffic.
+//
+// A backoff policy is a small class that is constructed on the stack at the
+// start of a wait and whose Pause function is called once per failed poll.
+// The spinlocks in this package (SpinLockT, RWSpinLockT) take the policy as
+// a template parameter and default to BackoffNone, which is the historical
+// single-pause behavior.
+//
+// The time based policies are specified in nanoseconds rather than in pause
+// instruction counts, because the cost of a pause instruction varies by an
+// order of magnitude between processor generations (e.g. ~10 cycles on older
+// Intel cores versus ~140 cycles on Skylake and later). The pause cost is
+// measured once per process; see GetProcessorPausesPerMicrosecond.
+/////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef EATHREAD_EATHREAD_BACKOFF_H
+#define EATHREAD_EATHREAD_BACKOFF_H
+
+
+#include <EABase/eabase.h>
+#include <eathread/eathread.h>
+#include <eathread/eathread_sync.h>
+
+#if defined(EA_PRAGMA_ONCE_SUPPORTED)
+	#pragma once // Some compilers (e.g. VC++) benefit significantly from using this. We've measured 3-4% build speed improvements in apps as a result.
+#endif
+
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		/// GetProcessorPausesPerMicrosecond
+		///
+		/// Returns how many EAProcessorPause statements the current processor
+		/// executes per microsecond. The value is measured once, during the static
+		/// initialization of the EAThread library, and is cached thereafter. So the
+		/// backoff policies don't measure it while spinning. The measurement executes
+		/// 5000 pauses, so its cost is that of the processor's pause: around 100
+		/// microseconds on a recent Xeon, and a few hundred where a pause takes over
+		/// 100 cycles. If this is called before the measurement has been made (e.g. by
+		/// another static initializer, or after SetProcessorPausesPerMicrosecond(0)),
+		/// then it makes the measurement, and other threads which call it meanwhile
+		/// wait for the result. The return value is always at least 1.
+		///
+		EATHREADLIB_API uint32_t GetProcessorPausesPerMicrosecond();
+
+		/// SetProcessorPausesPerMicrosecond
+		///
+		/// Overrides the measured value, for example with a value that was measured
+		/// offline for a known target. Passing 0 causes the value to be re-measured
+		/// upon the next call to GetProcessorPausesPerMicrosecond.
+		///
+		EATHREADLIB_API void SetProcessorPausesPerMicrosecond(uint32_t nPausesPerMicrosecond);
+
+
+		/// ProcessorPause
+		///
+		/// Executes EAProcessorPause nCount times.
+		///
+		inline void ProcessorPause(uint32_t nCount)
+		{
+			for(uint32_t i = 0; i < nCount; i++)
+				EAProcessorPause();
+		}
+
+
+		/// BackoffNone
+		///
+		/// Polls again after a single EA_THREAD_DO_SPIN. This is the default policy
+		/// and is what the spinlocks in this package have always done.
+		///
+		struct BackoffNone
+		{
+			void Pause()
+				{ EA_THREAD_DO_SPIN(); }
+
+			void Pause(uint32_t /*nWaitersAhead*/)
+				{ EA_THREAD_DO_SPIN(); }
+		};
+
+
+		/// BackoffExponential
+		///
+		/// Doubles the wait between polls after each failed poll, starting with a
+		/// single pause and capping at nMaxBackoffNanoseconds. This is the usual
+		/// choice for test-and-set locks under heavy many-core contention.
+		///
+		template <uint32_t nMaxBackoffNanoseconds = 4000>
+		struct BackoffExponential
+		{
+			BackoffExponential() : mnPauseCount(1), mnMaxPauseCount(0) {}
+
+			void Pause()
+			{
+				#ifdef EA_THREAD_COOPERATIVE
+					ThreadSleep();
+				#else
+					if(mnMaxPauseCount == 0) // If this is the first pause of this wait...
+					{
+						mnMaxPauseCount = (uint32_t)(((uint64_t)nMaxBackoffNanoseconds * GetProcessorPausesPerMicrosecond()) / 1000);
+						if(mnMaxPauseCount == 0)
+							mnMaxPauseCount = 1;
+					}
+
+					ProcessorPause(mnPauseCount);
+
+					if(mnPauseCount < mnMaxPauseCount)
+					{
+						mnPauseCount *= 2;
+						if(mnPauseCount > mnMaxPauseCount)
+							mnPauseCount = mnMaxPauseCount;
+					}
+				#endif
+			}
+
+			void Pause(uint32_t /*nWaitersAhead*/)
+				{ Pause(); }
+
+			uint32_t mnPauseCount;
+			uint32_t mnMaxPauseCount;
+		};
+
+
+		/// BackoffProportional
+		///
+		/// For queue-ordered locks (e.g. ticket locks) where a waiter knows how many
+		/// other waiters are ahead of it. Each poll waits nNanosecondsPerWaiter times
+		/// the number of waiters ahead, which should be set to roughly the expected
+		/// critical section length. Locks which don't know the queue position call
+		/// Pause(), which waits as if one waiter were ahead.
+		///
+		template <uint32_t nNanosecondsPerWaiter = 250>
+		struct BackoffProportional
+		{
+			BackoffProportional() : mnPausesPerWaiter(0) {}
+
+			void Pause()
+				{ Pause(1); }
+
+			void Pause(uint32_t nWaitersAhead)
+			{
+				#ifdef EA_THREAD_COOPERATIVE
+					EA_UNUSED(nWaitersAhead);
+					ThreadSleep();
+				#else
+					if(mnPausesPerWaiter == 0)
+					{
+						mnPausesPerWaiter = (uint32_t)(((uint64_t)nNanosecondsPerWaiter * GetProcessorPausesPerMicrosecond()) / 1000);
+						if(mnPausesPerWaiter == 0)
+							mnPausesPerWaiter = 1;
+					}
+
+					ProcessorPause(mnPausesPerWaiter * (nWaitersAhead ? nWaitersAhead : 1));
+				#endif
+			}
+
+			uint32_t mnPausesPerWaiter;
+		};
+
+
+		/// BackoffSpinYieldSleep
+		///
+		/// Spins with a single pause per poll for the first nSpinCount polls, then
+		/// yields the processor for the next nYieldCount polls, and then sleeps for
+		/// nSleepMilliseconds per poll. This suits locks which are usually held
+		/// briefly but may occasionally be held across a long operation, and
+		/// systems which may have more runnable threads than processors.
+		///
+		template <uint32_t nSpinCount = 100, uint32_t nYieldCount = 10, uint32_t nSleepMilliseconds = 1>
+		struct BackoffSpinYieldSleep
+		{
+			BackoffSpinYieldSleep() : mnPollCount(0) {}
+
+			void Pause()
+			{
+				if(mnPollCount < nSpinCount)
+				{
+					mnPollCount++;
+					EA_THREAD_DO_SPIN();
+				}
+				else if(mnPollCount < (nSpinCount + nYieldCount))
+				{
+					mnPollCount++;
+					ThreadSleep(kTimeoutYield);
+				}
+				else
+					ThreadSleep(nSleepMilliseconds);
+			}
+
+			void Pause(uint32_t /*nWaitersAhead*/)
+				{ Pause(); }
+
+			uint32_t mnPollCount;
+		};
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+#endif // EATHREAD_EATHREAD_BACKOFF_H
@@ -0,0 +1,173 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Implements a table which stores each distinct callstack once and identifies
+// it with a 32 bit id.
+//
+// Tools which record a callstack per event (leak trackers, lock profilers,
+// allocation tracking) see the same few thousand callstacks millions of
+// times. Storing an id per event instead of a copy of the callstack saves
+// most of the memory, and comparing ids is cheaper than comparing arrays.
+//
+// The table is a fixed-size open-addressing hash table whose slots hold ids,
+// and the callstacks are stored one after another in a fixed-size frame
+// arena which is only ever appended to. An insert claims its id and its
+// space in the arena with compare-and-swap, fills them in, and then
+// publishes the id with a compare-and-swap on the hash slot. Lookups and
+// inserts thus take no locks and allocate no memory, which makes them usable
+// from signal handlers. The memory is allocated up front, and inserts fail
+// once it's used up rather than growing the table.
+/////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef EATHREAD_EATHREAD_CALLSTACK_TABLE_H
+#define EATHREAD_EATHREAD_CALLSTACK_TABLE_H
+
+
+#include <EABase/eabase.h>
+#include <eathread/internal/config.h>
+#include <eathread/eathread_atomic.h>
+
+#if defined(EA_DLL) && defined(EA_COMPILER_MSVC)
+	// Suppress warning about class 'AtomicInt32' needs to have a
+	// dll-interface to be used by clients of class which have a templated member.
+	EA_DISABLE_VC_WARNING(4251)
+#endif
+
+#if defined(EA_PRAGMA_ONCE_SUPPORTED)
+	#pragma once // Some compilers (e.g. VC++) benefit significantly from using this. We've measured 3-4% build speed improvements in apps as a result.
+#endif
+
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		/// CallstackId
+		///
+		/// Identifies a callstack in a CallstackTable. Ids are assigned from 0 up, in
+		/// the order the callstacks are first inserted, so they can index arrays of
+		/// per-callstack data.
+		///
+		typedef uint32_t CallstackId;
+
+		static const CallstackId kCallstackIdInvalid = 0xffffffff;
+
+
+		/// CallstackTable
+		///
+		/// Insert, Find and GetCallstack may be called concurrently from any number of
+		/// threads, and are async-signal-safe. A signal handler which needs only to
+		/// identify callstacks which were inserted before can use Find, which never
+		/// uses up any of the table's memory.
+		///
+		/// Two threads which insert the same new callstack at the same time get the
+		/// same id. The loser's id and arena space are lost, which costs a little of
+		/// the table's capacity, and is the price of not taking a lock.
+		///
+		/// Example usage:
+		///     CallstackTable gAllocationCallstacks(65536);
+		///
+		///     void* Allocate(size_t n)
+		///     {
+		///         Header* pHeader = (Header*)malloc(sizeof(Header) + n);
+		///         pHeader->mCallstackId = gAllocationCallstacks.Capture();
+		///         return pHeader + 1;
+		///     }
+		///
+		class EATHREADLIB_API CallstackTable
+		{
+		public:
+			static const size_t kMaxCallstackCount    = 0x40000000;
+			static const size_t kMaxFrameCapacity     = 0x7fffffff;
+			static const size_t kFrameCapacityDefault = 0; /// Selects 16 frames per callstack.
+
+			/// CallstackTable
+			/// Allocates room for nMaxCallstackCount distinct callstacks with a total of
+			/// nFrameCapacity entries. The hash table has twice as many slots as callstacks,
+			/// at 4 bytes each, so the memory used is about nMaxCallstackCount * 20 bytes
+			/// plus nFrameCapacity pointers. nFrameCapacity is limited to kMaxFrameCapacity.
+			/// If the memory can't be allocated then every Insert fails.
+			CallstackTable(size_t nMaxCallstackCount = 65536, size_t nFrameCapacity = kFrameCapacityDefault);
+		   ~CallstackTable();
+
+			/// Insert
+			/// Returns the id of the callstack, and adds it to the table if it isn't already.
+			/// Returns kCallstackIdInvalid if it wasn't in the table and the table is full.
+			CallstackId Insert(void* const* pCallstack, size_t nDepth);
+
+			/// Find
+			/// Returns the id of the callstack, or kCallstackIdInvalid if it isn't in the table.
+			CallstackId Find(void* const* pCallstack, size_t nDepth) const;
+
+			/// Capture
+			/// Reads the calling function's callstack, up to nMaxDepth (at most 64) entries,
+			/// with GetCallstack, and inserts it. The callstack starts in the calling function.
+			/// This is async-signal-safe only if GetCallstack is.
+			CallstackId Capture(size_t nMaxDepth = 32);
+
+			/// GetCallstack
+			/// Returns the callstack with the given id, which stays valid for the life of
+			/// the table. Returns NULL (with a depth of 0) if the id isn't one that Insert,
+			/// Find or Capture has returned. The ids in use needn't be contiguous, as an id
+			/// can be lost to a race between inserts or to a full frame arena.
+			void* const* GetCallstack(CallstackId id, size_t* pDepth) const;
+
+			/// GetCallstackCount
+			/// Returns the number of distinct callstacks in the table.
+			size_t GetCallstackCount() const
+				{ return (size_t)mnCallstackCount.GetValue(); }
+
+			/// GetFrameCount
+			/// Returns the number of entries used in the frame arena.
+			size_t GetFrameCount() const
+				{ return (size_t)mnFrameCount.GetValue(); }
+
+			/// GetMemorySize
+			/// Returns the number of bytes that the table allocated.
+			size_t GetMemorySize() const
+				{ return mnMemorySize; }
+
+		protected:
+			struct Entry
+			{
+				uint32_t mnHash;
+				uint32_t mnDepth;
+				uint32_t mnFrameIndex;
+			};
+
+			const Entry* FindEntry(void* const* pCallstack, size_t nDepth, uint32_t nHash, size_t& nSlot) const;
+
+			AtomicInt32*    mpSlotArray;        /// Each holds an id + 1, or 0 if unused.
+			Entry*          mpEntryArray;       /// Indexed by id.
+			void**          mpFrameArray;
+			void*           mpMemory;
+			size_t          mnMemorySize;
+			uint32_t        mnSlotMask;
+			uint32_t        mnMaxCallstackCount;
+			uint32_t        mnFrameCapacity;
+			AtomicInt32     mnAllocatedIdCount; /// Ids handed out, including those lost to races.
+			AtomicInt32     mnCallstackCount;   /// Ids published in the hash table.
+			AtomicInt32     mnFrameCount;
+
+		private:
+			// Objects of this class are not copyable.
+			CallstackTable(const CallstackTable&);
+			CallstackTable& operator=(const CallstackTable&);
+		};
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+#if defined(EA_DLL) && defined(EA_COMPILER_MSVC)
+	// re-enable warning 4251 (it's a level-1 warning and should not be suppressed globally)
+	EA_RESTORE_VC_WARNING()
+#endif
+
+
+#endif // EATHREAD_EATHREAD_CALLSTACK_TABLE_H
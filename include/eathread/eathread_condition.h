@@ -129,9 +129,10 @@ namespace EA
 		public:
 			enum Result
 			{
-				kResultOK      =  0,
-				kResultError   = -1,
-				kResultTimeout = -2
+				kResultOK        =  0,
+				kResultError     = -1,
+				kResultTimeout   = -2,
+				kResultOwnerDied = -3   /// The mutex was re-locked, but it is robust and its previous owner died holding it. See Mutex::kResultOwnerDied.
 			};
 
 			/// Condition
@@ -183,6 +184,10 @@ namespace EA
 			/// the actual amount of time passed before the timeout occurs may be significantly
 			/// more or less than the specified timeout time.
 			///
+			/// If pMutex is robust (see MutexParameters::mbRobust) and another thread or
+			/// process died while holding it, Wait re-locks it and returns kResultOwnerDied,
+			/// which is handled as with Mutex::Lock.
+			///
 			Result Wait(Mutex* pMutex, const ThreadTime& timeoutAbsolute = kTimeoutNone);
 
 			/// Signal
@@ -223,6 +228,7 @@ namespace EA
 
 			static size_t     GetConditionSize();                       // Internally implemented as: return sizeof(Condition);
 			static Condition* ConstructCondition(void* pMemory);        // Internally implemented as: return new(pMemory) Condition;
+			static Condition* ConstructCondition(void* pMemory, const ConditionParameters* pConditionParameters); // Internally implemented as: return new(pMemory) Condition(pConditionParameters);
 			static void       DestructCondition(Condition* pCondition); // Internally implemented as: pCondition->~Condition();
 		};
 
@@ -17,6 +17,7 @@
 #include <eathread/eathread.h>
 #include <stddef.h> // size_t, etc.
 #include <new>
+#include <utility>
 
 #if defined(EA_PRAGMA_ONCE_SUPPORTED)
 	#pragma once // Some compilers (e.g. VC++) benefit significantly from using this. We've measured 3-4% build speed improvements in apps as a result.
@@ -39,27 +40,91 @@ namespace EA
 				struct rebind { typedef ListDefaultAllocatorImpl<OT> other; };
 
 				T* construct()
+					{ return new(allocate()) T; }
+
+				void destroy(T* obj)
+				{
+					obj->~T();
+					deallocate(obj);
+				}
+
+				/// Allocates memory for a T without constructing it.
+				void* allocate()
 				{
 					Allocator* pAllocator = GetAllocator();
 
 					if(pAllocator)
-						return new(pAllocator->Alloc(sizeof(T))) T;
+						return pAllocator->Alloc(sizeof(T));
 					else
-						return new T;
+						return ::operator new(sizeof(T));
 				}
 
-				void destroy(T* obj)
+				/// Frees memory from allocate, or that of a T from construct which has been destructed.
+				void deallocate(void* p)
 				{
 					Allocator* pAllocator = GetAllocator();
 
 					if(pAllocator)
+						pAllocator->Free(p);
+					else
+						::operator delete(p);
+				}
+			};
+
+
+			/// Allocator for simple_list which keeps destroyed nodes for reuse instead
+			/// of freeing them, so that a list which stays within its past size doesn't
+			/// allocate memory. Cached nodes are freed when the list is destroyed.
+			/// Like simple_list itself, it isn't thread-safe.
+			template<typename T>
+			struct ListCachingAllocatorImpl
+			{
+				template<typename OT>
+				struct rebind { typedef ListCachingAllocatorImpl<OT> other; };
+
+				ListCachingAllocatorImpl()
+					: mpFreeList(NULL) {}
+
+			   ~ListCachingAllocatorImpl()
+				{
+					while(mpFreeList)
 					{
-						obj->~T();
-						pAllocator->Free(obj);
+						FreeNode* const pNode = mpFreeList;
+						mpFreeList = pNode->mpNext;
+						pNode->~FreeNode();
+						mDefaultAllocator.deallocate(pNode);
 					}
-					else
-						delete obj;
 				}
+
+				T* construct()
+				{
+					if(mpFreeList)
+					{
+						FreeNode* const pNode = mpFreeList;
+						mpFreeList = pNode->mpNext;
+						return new(pNode) T;
+					}
+
+					return mDefaultAllocator.construct();
+				}
+
+				void destroy(T* obj)
+				{
+					obj->~T();
+					FreeNode* const pNode = new(obj) FreeNode;
+					pNode->mpNext = mpFreeList;
+					mpFreeList    = pNode;
+				}
+
+			protected:
+				struct FreeNode { FreeNode* mpNext; };
+
+				FreeNode*                   mpFreeList;
+				ListDefaultAllocatorImpl<T> mDefaultAllocator;
+
+			private:
+				ListCachingAllocatorImpl(const ListCachingAllocatorImpl&);
+				ListCachingAllocatorImpl& operator=(const ListCachingAllocatorImpl&);
 			};
 		}
 
@@ -104,7 +169,7 @@ namespace EA
 
 			struct const_iterator
 			{
-				friend class simple_list<T>;
+				friend class simple_list<T, Allocator>;
 
 				const_iterator()
 					: mpNode(NULL)
@@ -157,7 +222,7 @@ namespace EA
 
 			struct iterator : public const_iterator
 			{
-				friend class simple_list<T>;
+				friend class simple_list<T, Allocator>;
 
 				iterator()
 					: const_iterator(){ }
@@ -230,6 +295,17 @@ namespace EA
 				++mnSize;
 			}
 
+			void push_back(T&& value)
+			{
+				node_t* const pNode   = mAllocator.construct();
+				pNode->mValue         = std::move(value);
+				pNode->mpPrev         = mpNodeTail->mpPrev;
+				pNode->mpNext         = mpNodeTail;
+				pNode->mpPrev->mpNext = pNode;
+				mpNodeTail->mpPrev    = pNode;
+				++mnSize;
+			}
+
 			void push_front(const T& value)
 			{
 				node_t* const pNode = mAllocator.construct();
@@ -0,0 +1,351 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Implements a fair, queue-based (MCS) spinlock for heavily contended, short
+// critical sections.
+//
+// A conventional test-and-set spinlock (see eathread_spinlock.h) has every
+// waiter polling the same shared variable. When the lock is released, every
+// waiting processor sees its cache line invalidated and races to grab it,
+// which becomes a coherence storm as the number of processors grows. It also
+// provides no fairness; a waiter can be starved indefinitely.
+//
+// The MCS lock (Mellor-Crummey and Scott, 1991) instead lines waiters up in
+// a linked queue. Each waiter spins only on a flag in its own queue node,
+// which lives in its own cache line, and the lock is handed off directly to
+// the next waiter in FIFO order. An unlock thus touches exactly one remote
+// cache line regardless of how many threads are waiting.
+//
+// The same caveats as with SpinLock apply: don't use this as a general
+// replacement for mutexes. In addition, because hand-off is strictly FIFO,
+// a waiter that is descheduled while queued delays every waiter behind it.
+// MCSSpinLock is thus best suited to systems where the contending threads
+// have processors of their own.
+/////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef EATHREAD_EATHREAD_MCSSPINLOCK_H
+#define EATHREAD_EATHREAD_MCSSPINLOCK_H
+
+
+#include <EABase/eabase.h>
+#include <eathread/eathread.h>
+#include <eathread/eathread_sync.h>
+#include <eathread/eathread_atomic.h>
+#include <new>
+
+#if defined(EA_PRAGMA_ONCE_SUPPORTED)
+	#pragma once // Some compilers (e.g. VC++) benefit significantly from using this. We've measured 3-4% build speed improvements in apps as a result.
+#endif
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_MCS_SPINLOCK_NODE_COUNT
+//
+// Defined as an integer in the range of [1, 32].
+// Specifies how many MCSSpinLocks a single thread can hold (or be waiting on)
+// at once via the node-less Lock/TryLock functions before queue nodes start
+// being allocated from the heap. Each node occupies a cache line of thread-local
+// memory. This has no effect on the node-taking versions of the functions.
+//
+#ifndef EATHREAD_MCS_SPINLOCK_NODE_COUNT
+	#define EATHREAD_MCS_SPINLOCK_NODE_COUNT 8
+#endif
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		/// MCSSpinLockNode
+		///
+		/// A waiter's entry in an MCSSpinLock queue. A node must stay alive and
+		/// unmoved from the call to Lock (or successful TryLock) until the matching
+		/// Unlock returns, and a node can be used with only one lock at a time.
+		/// Each node is given a cache line of its own so that waiters never share
+		/// the line they are polling.
+		///
+		EA_PREFIX_ALIGN(EATHREAD_CACHE_LINE_SIZE)
+		struct MCSSpinLockNode
+		{
+			AtomicPointer mpNext;    /// The waiter queued behind us, or NULL.
+			AtomicInt32   mnWaiting; /// Non-zero while the owner of this node is waiting for the lock.
+
+			MCSSpinLockNode() : mpNext(NULL), mnWaiting(0) {}
+
+		private:
+			// Nodes are linked by address and so must not be copied.
+			MCSSpinLockNode(const MCSSpinLockNode&);
+			MCSSpinLockNode& operator=(const MCSSpinLockNode&);
+		} EA_POSTFIX_ALIGN(EATHREAD_CACHE_LINE_SIZE);
+
+
+		/// class MCSSpinLock
+		///
+		/// A fair queue-based spinlock with the same interface as SpinLock.
+		/// Like SpinLock, it is not recursive and is intra-process only.
+		///
+		/// There are two ways to use it. The node-less Lock/TryLock/Unlock
+		/// functions take a queue node from a small thread-local pool and are
+		/// drop-in replacements for the SpinLock functions. The node-taking
+		/// versions let the caller supply the node (usually on the stack), which
+		/// avoids the thread-local lookup and is what AutoMCSSpinLock uses.
+		/// The two forms may be mixed on the same lock by different threads, but
+		/// each Unlock must match the form of the Lock it releases.
+		///
+		/// Example usage:
+		///     MCSSpinLock gLock;
+		///
+		///     void Function() {
+		///         MCSSpinLockNode node;
+		///         gLock.Lock(node);
+		///         // Do something
+		///         gLock.Unlock(node);
+		///     }
+		///
+		class EATHREADLIB_API MCSSpinLock
+		{
+		public:
+			MCSSpinLock();
+
+			void Lock();
+			bool TryLock();
+			bool IsLocked();
+			void Unlock();
+
+			void Lock(MCSSpinLockNode& node);
+			bool TryLock(MCSSpinLockNode& node);
+			void Unlock(MCSSpinLockNode& node);
+
+			/// GetPlatformData
+			/// Returns the address of the queue tail pointer. This value should be
+			/// read for diagnostic purposes only and should not be written.
+			void* GetPlatformData();
+
+		protected:
+			AtomicPointer    mpTail;      /// The last node in the queue, or NULL if unlocked. The head of the queue is the lock owner.
+			MCSSpinLockNode* mpOwnerNode; /// The node used by the node-less Lock/TryLock. Only read or written by the lock owner.
+
+		private:
+			// Objects of this class are not copyable.
+			MCSSpinLock(const MCSSpinLock&);
+			MCSSpinLock& operator=(const MCSSpinLock&);
+		};
+
+
+		/// MCSSpinLockFactory
+		///
+		/// Implements a factory-based creation and destruction mechanism for class MCSSpinLock.
+		/// A primary use of this would be to allow the MCSSpinLock implementation to reside in
+		/// a private library while users of the class interact only with the interface
+		/// header and the factory. The factory provides conventional create/destroy
+		/// semantics which use global operator new, but also provides manual construction/
+		/// destruction semantics so that the user can provide for memory allocation
+		/// and deallocation.
+		class EATHREADLIB_API MCSSpinLockFactory
+		{
+		public:
+			static MCSSpinLock* CreateMCSSpinLock();
+			static void         DestroyMCSSpinLock(MCSSpinLock* pMCSSpinLock);
+
+			static size_t       GetMCSSpinLockSize();
+			static MCSSpinLock* ConstructMCSSpinLock(void* pMemory);
+
+			static void DestructMCSSpinLock(MCSSpinLock* pMCSSpinLock);
+		};
+
+
+		/// class AutoMCSSpinLock
+		/// An AutoMCSSpinLock locks the MCSSpinLock in its constructor and
+		/// unlocks the MCSSpinLock in its destructor (when it goes out of scope).
+		/// The queue node is a member of the AutoMCSSpinLock itself, so no
+		/// thread-local node is used.
+		class AutoMCSSpinLock
+		{
+		public:
+			AutoMCSSpinLock(MCSSpinLock& spinLock);
+		   ~AutoMCSSpinLock();
+
+		protected:
+			MCSSpinLockNode mNode;
+			MCSSpinLock&    mSpinLock;
+
+		protected:
+			// Prevent copying by default, as copying is dangerous.
+			AutoMCSSpinLock(const AutoMCSSpinLock&);
+			const AutoMCSSpinLock& operator=(const AutoMCSSpinLock&);
+		};
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// inlines
+///////////////////////////////////////////////////////////////////////////////
+
+namespace EA
+{
+	namespace Thread
+	{
+		///////////////////////////////////////////////////////////////////////
+		// MCSSpinLock
+		///////////////////////////////////////////////////////////////////////
+
+		inline
+		MCSSpinLock::MCSSpinLock()
+		  : mpTail(NULL), mpOwnerNode(NULL)
+		{
+		}
+
+		inline
+		void MCSSpinLock::Lock(MCSSpinLockNode& node)
+		{
+			node.mpNext.SetValue(NULL);
+			node.mnWaiting.SetValue(1);
+
+			// Append ourselves to the queue. If there was no previous tail then the lock was free and is now ours.
+			MCSSpinLockNode* const pPrev = static_cast<MCSSpinLockNode*>(mpTail.SetValue(&node));
+
+			if(pPrev)
+			{
+				pPrev->mpNext.SetValue(&node);
+
+				// We poll only our own node, which the previous owner will clear when it hands the lock to us.
+				while(node.mnWaiting.GetValue() != 0)
+				{
+				#ifdef EA_THREAD_COOPERATIVE
+					ThreadSleep();
+				#else
+					EAProcessorPause();
+				#endif
+				}
+			}
+		}
+
+		inline
+		bool MCSSpinLock::TryLock(MCSSpinLockNode& node)
+		{
+			node.mpNext.SetValue(NULL);
+			node.mnWaiting.SetValue(0);
+
+			return mpTail.SetValueConditional(&node, NULL);
+		}
+
+		inline
+		bool MCSSpinLock::IsLocked()
+		{
+			return mpTail.GetValueRaw() != NULL;
+		}
+
+		inline
+		void MCSSpinLock::Unlock(MCSSpinLockNode& node)
+		{
+			EAT_ASSERT(IsLocked());
+
+			MCSSpinLockNode* pNext = static_cast<MCSSpinLockNode*>(node.mpNext.GetValue());
+
+			if(!pNext)
+			{
+				// If we are still the tail then nobody is waiting and we can mark the lock as free.
+				if(mpTail.SetValueConditional(NULL, &node))
+					return;
+
+				// Else a waiter has swapped itself in as the tail but hasn't linked itself to us yet.
+				// This window is only a few instructions long.
+				while((pNext = static_cast<MCSSpinLockNode*>(node.mpNext.GetValue())) == NULL)
+					EAProcessorPause();
+			}
+
+			pNext->mnWaiting.SetValue(0);
+		}
+
+		inline
+		void* MCSSpinLock::GetPlatformData()
+		{
+			return &mpTail;
+		}
+
+
+		///////////////////////////////////////////////////////////////////////
+		// MCSSpinLockFactory
+		///////////////////////////////////////////////////////////////////////
+
+		inline
+		MCSSpinLock* MCSSpinLockFactory::CreateMCSSpinLock()
+		{
+			Allocator* pAllocator = GetAllocator();
+
+			if(pAllocator)
+				return new(pAllocator->Alloc(sizeof(MCSSpinLock))) MCSSpinLock;
+			else
+				return new MCSSpinLock;
+		}
+
+		inline
+		void MCSSpinLockFactory::DestroyMCSSpinLock(MCSSpinLock* pMCSSpinLock)
+		{
+			Allocator* pAllocator = GetAllocator();
+
+			if(pAllocator)
+			{
+				pMCSSpinLock->~MCSSpinLock();
+				pAllocator->Free(pMCSSpinLock);
+			}
+			else
+				delete pMCSSpinLock;
+		}
+
+		inline
+		size_t MCSSpinLockFactory::GetMCSSpinLockSize()
+		{
+			return sizeof(MCSSpinLock);
+		}
+
+		inline
+		MCSSpinLock* MCSSpinLockFactory::ConstructMCSSpinLock(void* pMemory)
+		{
+			return new(pMemory) MCSSpinLock;
+		}
+
+		EA_DISABLE_VC_WARNING(4100) // Compiler mistakenly claims pMCSSpinLock is unreferenced
+		inline
+		void MCSSpinLockFactory::DestructMCSSpinLock(MCSSpinLock* pMCSSpinLock)
+		{
+			pMCSSpinLock->~MCSSpinLock();
+		}
+		EA_RESTORE_VC_WARNING()
+
+
+		///////////////////////////////////////////////////////////////////////
+		// AutoMCSSpinLock
+		///////////////////////////////////////////////////////////////////////
+
+		inline
+		AutoMCSSpinLock::AutoMCSSpinLock(MCSSpinLock& spinLock)
+		  : mNode(), mSpinLock(spinLock)
+		{
+			mSpinLock.Lock(mNode);
+		}
+
+		inline
+		AutoMCSSpinLock::~AutoMCSSpinLock()
+		{
+			mSpinLock.Unlock(mNode);
+		}
+
+	} // namespace Thread
+
+} // namespace EA
+
+#endif // EATHREAD_EATHREAD_MCSSPINLOCK_H
@@ -158,6 +158,8 @@ namespace EA
 		struct EATHREADLIB_API MutexParameters
 		{
 			bool mbIntraProcess; /// True if the mutex is intra-process, else inter-process.
+			bool mbRecursive;    /// True (the default) if a thread can lock the mutex more than once. See class Mutex.
+			bool mbRobust;       /// False by default. If true, Lock reports the death of a previous owner with kResultOwnerDied. See class Mutex.
 			char mName[128];      /// Mutex name, applicable only to platforms that recognize named synchronization objects.
 
 			MutexParameters(bool bIntraProcess = true, const char* pName = NULL);
@@ -166,16 +168,52 @@ namespace EA
 
 		/// class Mutex
 		///
-		/// Mutex are assumed to always be 'recursive', meaning that a given thread 
-		/// can lock the mutex more than once. If you want a specifically non-recursive 
-		/// mutex, you can use a semaphore with a lock count of 1.
+		/// Mutex are by default 'recursive', meaning that a given thread 
+		/// can lock the mutex more than once. Most locks are never re-entered,
+		/// though, and on some platforms a recursive mutex is measurably slower
+		/// due to the owner and count checks it must do. Setting 
+		/// MutexParameters::mbRecursive to false requests a non-recursive mutex,
+		/// which a thread must not lock again while holding it. In debug builds
+		/// (EAT_ASSERT_ENABLED) doing so asserts and Lock returns kResultError;
+		/// in other builds the thread deadlocks. Platforms which lack a faster
+		/// non-recursive mutex ignore mbRecursive. GetLockCount and HasLock work
+		/// for both kinds of mutex.
+		///
+		/// Example usage:
+		///     MutexParameters parameters;
+		///     parameters.mbRecursive = false;
+		///     Mutex mutex(&parameters);
+		///
+		/// A Mutex with MutexParameters::mbIntraProcess false can be placed in memory
+		/// shared between processes: one process builds it there with 
+		/// MutexFactory::ConstructMutex(pMemory, &parameters), and the others use 
+		/// the memory as a Mutex without constructing it again.
+		///
+		/// If a process dies while holding such a mutex, the others would block 
+		/// on it forever. Setting MutexParameters::mbRobust avoids this where 
+		/// EATHREAD_ROBUST_MUTEX_AVAILABLE is 1: the next Lock then acquires the 
+		/// mutex but returns kResultOwnerDied, as the data the mutex protects may 
+		/// be half-modified. The new owner repairs the data and calls MarkConsistent 
+		/// before Unlock. If it unlocks without doing so, the mutex is unusable 
+		/// from then on and every Lock returns kResultError. The same applies to 
+		/// a thread which exits while holding the mutex.
+		///
+		/// Example usage:
+		///     int result = pSharedMutex->Lock();
+		///
+		///     if(result == Mutex::kResultOwnerDied)
+		///     {
+		///         RepairSharedTable(pSharedTable);
+		///         pSharedMutex->MarkConsistent();
+		///     }
 		class EATHREADLIB_API Mutex
 		{
 		public:
 			enum Result
 			{
-				kResultError   = -1,
-				kResultTimeout = -2
+				kResultError     = -1,
+				kResultTimeout   = -2,
+				kResultOwnerDied = -3   /// The mutex was acquired, but its previous owner ended while holding it. See class Mutex.
 			};
 
 			/// Mutex
@@ -215,9 +253,10 @@ namespace EA
 			/// more or less than the specified timeout time.
 			///
 			/// Return value:
-			///     kResultError   Error
-			///     kResultTimeout Timeout
-			///     > 0            The new lock count.
+			///     kResultError     Error
+			///     kResultTimeout   Timeout
+			///     kResultOwnerDied The lock count is 1, but the previous owner died. See class Mutex.
+			///     > 0              The new lock count.
 			int Lock(const ThreadTime& timeoutAbsolute = EA::Thread::kTimeoutNone);
 
 			/// Unlock
@@ -226,6 +265,13 @@ namespace EA
 			/// Return value is the lock count value immediately upon unlock.
 			int Unlock();
 
+			/// MarkConsistent
+			/// Tells a robust mutex that the data it protects has been repaired after
+			/// Lock returned kResultOwnerDied. Must be called by the thread which holds
+			/// the lock. Returns true on success, and always on platforms without 
+			/// robust mutexes.
+			bool MarkConsistent();
+
 			/// GetLockCount
 			/// Returns the number of locks on the mutex. The return value from this 
 			/// function is only reliable if the calling thread already has one lock on 
@@ -282,6 +328,7 @@ namespace EA
 
 			static size_t  GetMutexSize();                   // Internally implemented as: return sizeof(Mutex);
 			static Mutex*  ConstructMutex(void* pMemory);    // Internally implemented as: return new(pMemory) Mutex;
+			static Mutex*  ConstructMutex(void* pMemory, const MutexParameters* pMutexParameters); // Internally implemented as: return new(pMemory) Mutex(pMutexParameters);
 			static void    DestructMutex(Mutex* pMutex);     // Internally implemented as: pMutex->~Mutex();
 		};
 
@@ -23,6 +23,13 @@
 #ifndef EATHREAD_EATHREAD_LIST_H
 	#include <eathread/eathread_list.h>
 #endif
+#ifndef EATHREAD_EATHREAD_SHARDEDCOUNTER_H
+	#include <eathread/eathread_shardedcounter.h>
+#endif
+#include <eathread/internal/eathread_callable.h>
+#if !EATHREAD_FUTEX_WORD_AVAILABLE
+	#include <eathread/eathread_mutex.h>
+#endif
 #include <stddef.h>
 
 
@@ -54,6 +61,19 @@
 #endif
 
 
+/////////////////////////////////////////////////////////////////////////////
+// EA_THREAD_POOL_JOB_CALLABLE_SIZE
+//
+// Defines the size of the buffer in each job which holds a callable passed
+// to ThreadPool::Begin. Callables which don't fit, such as lambdas with
+// large captures, are allocated separately. Every job carries the buffer,
+// so it should stay small.
+//
+#ifndef EA_THREAD_POOL_JOB_CALLABLE_SIZE
+	#define EA_THREAD_POOL_JOB_CALLABLE_SIZE (4 * sizeof(void*))
+#endif
+
+
 
 namespace EA
 {
@@ -68,6 +88,7 @@ namespace EA
 			unsigned         mnInitialCount;            /// Default is kDefaultInitialCount
 			ThreadTime       mnIdleTimeoutMilliseconds; /// Default is kDefaultIdleTimeout. This is a relative time, not an absolute time. Can be a millisecond value or Thread::kTimeoutNone or Thread::kTimeoutImmediate.
 			unsigned         mnProcessorMask;           /// Default is 0xffffffff. Controls which processors we are allowed to create threads on. Default is all processors.
+			int              mnIdleSpinMicroseconds;    /// Default is kDefaultIdleSpinMicroseconds, which is 0. How long a thread which runs out of jobs polls for a new one before it waits on the condition. 0 disables polling.
 			ThreadParameters mDefaultThreadParameters;  /// Currently only the mnStackSize, mnPriority, and mpName fields from ThreadParameters are used.
 
 			ThreadPoolParameters();
@@ -79,21 +100,94 @@ namespace EA
 		};
 
 
+		/// JobGroup
+		///
+		/// Counts a set of outstanding jobs and lets threads wait for all of them to complete,
+		/// in the manner of a wait group. Pass a JobGroup to ThreadPool::Begin and the pool
+		/// calls Add when the job is queued and Done when it completes (or is discarded by
+		/// Shutdown). Add and Done may also be called directly for work done elsewhere.
+		///
+		/// The count is a single atomic word, and Wait parks the calling thread until the
+		/// count reaches zero. Done makes a kernel call only if a thread is actually waiting.
+		/// A JobGroup must outlive the jobs it counts.
+		///
+		/// Example usage:
+		///     JobGroup jobGroup;
+		///
+		///     for(int i = 0; i < kPartCount; i++)
+		///         threadPool.Begin(ProcessPart, &partArray[i], NULL, false, &jobGroup);
+		///
+		///     jobGroup.Wait();
+		///
+		class EATHREADLIB_API JobGroup
+		{
+		public:
+			JobGroup();
+		   ~JobGroup();
+
+			/// Add
+			/// Increases the count of outstanding jobs by nCount.
+			void Add(int nCount = 1);
+
+			/// Done
+			/// Decreases the count of outstanding jobs by one and releases the waiting
+			/// threads if the count reaches zero.
+			void Done();
+
+			/// GetPendingCount
+			/// Returns the count of outstanding jobs.
+			int GetPendingCount() const
+				{ return mnWord.GetValue() >> 1; }
+
+			/// Wait
+			/// Waits until the count of outstanding jobs is zero. Returns true if so, or
+			/// false if the absolute timeout passed first. Jobs added during the wait are
+			/// waited for as well.
+			bool Wait(const ThreadTime& timeoutAbsolute = kTimeoutNone);
+
+		protected:
+			static const int32_t kWaitersFlag = 1; // Set while at least one thread is waiting.
+
+			AtomicInt32 mnWord;                    // (count << 1) | kWaitersFlag
+
+			#if !EATHREAD_FUTEX_WORD_AVAILABLE
+				Mutex     mMutex;
+				Condition mCondition;
+			#endif
+
+		private:
+			// Objects of this class are not copyable.
+			JobGroup(const JobGroup&);
+			JobGroup& operator=(const JobGroup&);
+		};
+
+
 		/// class ThreadPool
 		/// 
 		/// Implements a conventional thread pool. Thread pools are useful for situations where
 		/// thread creation and destruction is common and the application speed would improve
-		/// by using pre-made threads that are ready to execute. 
+		/// by using pre-made threads that are ready to execute.
+		///
+		/// If ThreadPoolParameters::mnIdleSpinMicroseconds is set, then a thread which finishes
+		/// a job and finds no other job waiting polls for a new one for up to that long before
+		/// it waits on the pool's condition variable. A job queued during that time is picked
+		/// up without a kernel wakeup, and the queueing thread skips signalling the condition
+		/// variable as well, which benefits jobs queued in quick succession. The cost is that
+		/// each thread which runs out of jobs keeps its processor busy while it polls, so
+		/// polling is off by default. The test suite reports the dispatch latency with and
+		/// without polling on machines with more than one processor. On single-processor
+		/// systems threads don't poll, as the queueing thread can't run while they do.
 		class EATHREADLIB_API ThreadPool
 		{
 		public:
 			enum Default
 			{
-				kDefaultMinCount      = 0,
-				kDefaultMaxCount      = 4,
-				kDefaultInitialCount  = 0,
-				kDefaultIdleTimeout   = 60000, // Milliseconds
-				kDefaultProcessorMask = 0xffffffff
+				kDefaultMinCount             = 0,
+				kDefaultMaxCount             = 4,
+				kDefaultInitialCount         = 0,
+				kDefaultIdleTimeout          = 60000, // Milliseconds
+				kDefaultProcessorMask        = 0xffffffff,
+				kDefaultIdleSpinMicroseconds = 0      // Microseconds
 			};
 
 			enum Result
@@ -152,8 +246,28 @@ namespace EA
 			/// will be the thread used for the job. Else the returned thread pointer will be NULL.
 			/// If input bEnabledDeferred is false but the max count of active theads has been 
 			/// reached, a new thread is nevertheless created.
-			int Begin(IRunnable*       pRunnable, void* pContext = NULL, Thread** ppThread = NULL, bool bEnableDeferred = false);
-			int Begin(RunnableFunction pFunction, void* pContext = NULL, Thread** ppThread = NULL, bool bEnableDeferred = false);
+			/// If pJobGroup is non-NULL, the job is counted by it until the job completes.
+			int Begin(IRunnable*       pRunnable, void* pContext = NULL, Thread** ppThread = NULL, bool bEnableDeferred = false, JobGroup* pJobGroup = NULL);
+			int Begin(RunnableFunction pFunction, void* pContext = NULL, Thread** ppThread = NULL, bool bEnableDeferred = false, JobGroup* pJobGroup = NULL);
+
+			/// Begin
+			/// Starts a job which calls a callable object, such as a lambda with captures.
+			/// The callable takes no arguments and its return value, if any, is ignored.
+			/// It is moved into the job, and destroyed after it has been called. A callable
+			/// of up to EA_THREAD_POOL_JOB_CALLABLE_SIZE bytes is stored within the job, so
+			/// that queueing the job doesn't allocate memory. Returns as the other versions,
+			/// and returns kResultError if a larger callable couldn't be allocated.
+			///
+			/// Example usage:
+			///     threadPool.Begin([&mesh, i]{ mesh.UpdatePart(i); }, &jobGroup);
+			template <typename Callable, typename = typename detail::EnableIfCallableObject<Callable, RunnableFunction>::type>
+			int Begin(Callable&& callable, JobGroup* pJobGroup = NULL)
+			{
+				Job job;
+				if(!job.mCallable.Set(std::forward<Callable>(callable)))
+					return kResultError;
+				return BeginJob(job, pJobGroup);
+			}
 
 			/// WaitForJobCompletion
 			/// Waits for an individual job or for all jobs (job id of -1) to complete. 
@@ -163,6 +277,11 @@ namespace EA
 			/// for those jobs to complete as well. jobWait is valid only if nJob is -1.
 			/// Note that the timeout is specified in absolute time and not relative time.
 			/// Returns one of enum Result.
+			///
+			/// Waiting for an individual job or for all jobs parks the calling thread until
+			/// the job completes. Each queued job has a completion record, which a waiter
+			/// finds by job id with the pool's lock briefly held and then waits on without
+			/// the lock. Use a JobGroup to wait for many jobs at once.
 			int WaitForJobCompletion(int nJob = -1, JobWait jobWait = kJobWaitAll, const ThreadTime& timeoutAbsolute = kTimeoutNone);
 
 			/// Pause
@@ -174,14 +293,25 @@ namespace EA
 			void Lock();
 			void Unlock();
 
+			typedef detail::CallableStorage<EA_THREAD_POOL_JOB_CALLABLE_SIZE> JobCallable;
+
+			struct JobRecord; // Completion state of a queued job. Internal to the pool.
+
 			struct Job
 			{
 				int              mnJobID;       /// Unique job id.
 				IRunnable*       mpRunnable;    /// User-supplied IRunnable. This is an alternative to mpFunction.
 				RunnableFunction mpFunction;    /// User-supplied function. This is an alternative to mpRunnable.
 				void*            mpContext;     /// User-supplied context.
+				JobGroup*        mpJobGroup;    /// User-supplied JobGroup which counts this job. May be NULL.
+				JobCallable      mCallable;     /// User-supplied callable. This is an alternative to mpRunnable and mpFunction.
+				JobRecord*       mpJobRecord;   /// Completion record which WaitForJobCompletion waits on. Set when the job is queued.
 
 				Job();
+
+				/// Returns false for the empty job which tells a thread to quit.
+				bool HasWork() const
+					{ return mpRunnable || mpFunction || mCallable.IsSet(); }
 			};
 
 			struct ThreadInfo
@@ -215,8 +345,14 @@ namespace EA
 			// value may be out of date by the time you read it. 
 			int GetThreadCount();
 
+			/// GetCompletedJobCount
+			/// Returns the number of jobs which have been completed since the pool was
+			/// constructed or since the last call with bReset = true. Jobs which complete
+			/// while this is being called may or may not be counted.
+			int64_t GetCompletedJobCount(bool bReset = false);
+
 		protected:
-			typedef EA::Thread::simple_list<Job>         JobList;
+			typedef EA::Thread::simple_list<Job, details::ListCachingAllocatorImpl<Job> > JobList;
 			typedef EA::Thread::simple_list<ThreadInfo*> ThreadInfoList;
 
 			// Member functions
@@ -224,10 +360,19 @@ namespace EA
 			ThreadInfo*     CreateThreadInfo();
 			void            SetupThreadParameters(ThreadParameters& tp);
 			void            AdjustThreadCount(unsigned nCount);
-			Result          QueueJob(const Job& job, Thread** ppThread, bool bEnableDeferred);
+			Result          QueueJob(Job& job, Thread** ppThread, bool bEnableDeferred); // Moves job into mJobList.
+			int             BeginJob(Job& job, JobGroup* pJobGroup);
 			void            AddThread(ThreadInfo* pThreadInfo);
 			void            RemoveThread(ThreadInfo* pThreadInfo);
 			void            FixThreads();
+			bool            TrackJob(Job& job);
+			void            CompleteJob(const Job& job);
+			void            RetireJob(const Job& job);
+			JobRecord*      AcquireJobRecord(int nJob);
+			void            ReleaseJobRecord(JobRecord* pJobRecord);
+			Result          WaitForJobRecord(JobRecord* pJobRecord, const ThreadTime& timeoutAbsolute);
+
+			static const int kJobRecordHashSize = 256; // Must be a power of two.
 
 			// Member data
 			bool                mbInitialized;              // 
@@ -241,11 +386,22 @@ namespace EA
 			uint32_t            mnNextProcessor;            // Used if we are manually round-robin assigning processors. 
 			AtomicInt32         mnPauseCount;               // A positive value means we pause working on jobs.
 			AtomicInt32         mnLastJobID;                // 
+			int                 mnIdleSpinCount;            // Number of polls a thread makes for a new job before waiting on mThreadCondition. 0 means don't poll.
+			AtomicInt32         mnSpinningCount;            // Number of polling threads not yet claimed by a queued job. QueueJob doesn't signal mThreadCondition while this is positive.
+			AtomicInt32         mnJobQueueSequence;         // Incremented each time a job is added to mJobList. Polling threads watch it so they don't need the mutex.
+			ShardedCounter      mnCompletedJobCount;        // Written by every worker thread after each job, so it is sharded.
 			ThreadParameters    mDefaultThreadParameters;   // 
 			Condition           mThreadCondition;           // Manages signalling mJobList.
 			Mutex               mThreadMutex;               // Guards manipulation of mThreadInfoList and mJobList.
 			ThreadInfoList      mThreadInfoList;            // List of threads in our pool.
 			JobList             mJobList;                   // List of waiting jobs.
+			JobGroup            mAllJobGroup;               // Counts all queued and running jobs.
+			JobRecord*          mJobRecordHash[kJobRecordHashSize]; // Records of queued and running jobs, chained by job id. Guarded by mThreadMutex.
+			JobRecord*          mpFreeJobRecordList;        // Records available for reuse. Guarded by mThreadMutex.
+			#if !EATHREAD_FUTEX_WORD_AVAILABLE
+				Mutex           mJobRecordMutex;            // Used by threads waiting on a job record.
+				Condition       mJobRecordCondition;        // Signalled when a job with waiters completes.
+			#endif
 
 		private:
 			// Prevent default generation of these functions by not defining them
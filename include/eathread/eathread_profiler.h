@@ -0,0 +1,212 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Implements an in-process sampling CPU profiler.
+//
+// Each sampled thread gets a timer on its own CPU time clock, so a thread is
+// sampled in proportion to the CPU time it uses, and a thread which is
+// blocked isn't sampled at all. The timer interrupts the thread with a
+// signal, and the thread's signal handler reads its callstack into a buffer
+// which only it writes to and only the profiler reads from, so that taking
+// a sample needs neither locks nor memory allocation. The profiler
+// periodically moves the samples from the buffers into a table of distinct
+// callstacks and their counts, which can be written out as folded stacks
+// (the input of flame graph tools) or enumerated to produce other formats.
+/////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef EATHREAD_EATHREAD_PROFILER_H
+#define EATHREAD_EATHREAD_PROFILER_H
+
+
+#include <EABase/eabase.h>
+#include <eathread/internal/config.h>
+#include <eathread/eathread.h>
+#include <eathread/eathread_mutex.h>
+
+#if defined(EA_DLL) && defined(EA_COMPILER_MSVC)
+	// Suppress warning about class 'Mutex' needs to have a
+	// dll-interface to be used by clients of class which have a templated member.
+	EA_DISABLE_VC_WARNING(4251)
+#endif
+
+#if defined(EA_PRAGMA_ONCE_SUPPORTED)
+	#pragma once // Some compilers (e.g. VC++) benefit significantly from using this. We've measured 3-4% build speed improvements in apps as a result.
+#endif
+
+
+
+#if EATHREAD_PROFILER_AVAILABLE
+
+namespace EA
+{
+	namespace Thread
+	{
+		struct ProfilerThread;
+
+
+		/// ProfilerParameters
+		///
+		/// The sampling overhead is roughly the time GetStats reports per sample
+		/// divided by mnSampleIntervalUs. It can be reduced by sampling less often,
+		/// by lowering mnMaxDepth, or by selecting the frame pointer unwinder with
+		/// SetCallstackUnwinder. In the profiler test on x86-64 Linux the frame pointer
+		/// unwinder took about 1.4 microseconds per sample and the unwind tables about 13.
+		///
+		struct EATHREADLIB_API ProfilerParameters
+		{
+			int    mnSampleIntervalUs;  /// The CPU time, in microseconds, that each thread uses between samples. Default is 10000 (100 samples per CPU second).
+			size_t mnMaxDepth;          /// The maximum number of callstack entries per sample, up to Profiler::kMaxDepth. Default is 32.
+			size_t mnSampleCapacity;    /// The number of samples each thread's buffer holds between calls to Collect. Rounded up to a power of two. Default is 256.
+			size_t mnMaxThreadCount;    /// The maximum number of threads which are sampled over the profiler's run. Default is 64.
+
+			ProfilerParameters();
+		};
+
+
+		/// ProfilerStats
+		///
+		struct ProfilerStats
+		{
+			uint64_t mnSampleCount;         /// The number of samples collected into the profile.
+			uint64_t mnDroppedSampleCount;  /// The number of samples lost because a thread's buffer was full. Call Collect more often, or raise mnSampleCapacity.
+			uint64_t mnSampleNanoseconds;   /// The time the sampled threads spent taking samples, which is the profiler's overhead.
+			size_t   mnThreadCount;         /// The number of threads which have been sampled.
+			size_t   mnStackCount;          /// The number of distinct callstacks in the profile.
+		};
+
+
+		/// Profiler
+		///
+		/// Samples the threads known to EnumerateThreads. Threads which start after
+		/// Start are sampled from the next call to Collect or UpdateThreads on.
+		/// Only one Profiler can be started at a time, as they share the signal.
+		///
+		/// The callstacks are read with the unwinder selected by SetCallstackUnwinder.
+		/// With the frame pointer unwinder, code compiled without frame pointers shows
+		/// up as truncated callstacks.
+		///
+		/// Example usage:
+		///     Profiler profiler;
+		///     profiler.Start();
+		///
+		///     while(!bDone)
+		///     {
+		///         RunFrame();
+		///         profiler.Collect(); // Every now and then, e.g. once per frame.
+		///     }
+		///
+		///     profiler.Stop();
+		///     profiler.WriteFoldedStacks(WriteToFile, pFile);
+		///
+		class EATHREADLIB_API Profiler
+		{
+		public:
+			static const size_t kMaxDepth = 64;
+
+			/// WriteFunction
+			/// Receives the output of WriteFoldedStacks, in pieces.
+			typedef void (*WriteFunction)(const char* pText, size_t nLength, void* pContext);
+
+			/// StackFunction
+			/// Receives each distinct callstack in the profile and the number of times it was
+			/// sampled. pCallstack[0] is the sampled instruction, and the rest are return addresses.
+			typedef void (*StackFunction)(void* const* pCallstack, size_t nDepth, uint64_t nCount, void* pContext);
+
+			Profiler();
+		   ~Profiler();
+
+			/// Start
+			/// Clears the profile and starts sampling. Returns false if this or another
+			/// Profiler is already started, or if the signal handler couldn't be installed.
+			bool Start(const ProfilerParameters* pParameters = NULL);
+
+			/// Stop
+			/// Stops sampling and collects the remaining samples. The profile is kept
+			/// until the next Start, and can be written out after Stop.
+			void Stop();
+
+			/// IsStarted
+			bool IsStarted() const;
+
+			/// UpdateThreads
+			/// Starts sampling threads which started since the last update, and stops
+			/// sampling threads which ended. Returns the number of threads being sampled.
+			size_t UpdateThreads();
+
+			/// Collect
+			/// Calls UpdateThreads, then moves the samples which the threads took since
+			/// the last call into the profile. Returns the number of samples moved.
+			size_t Collect();
+
+			/// GetStats
+			ProfilerStats GetStats() const;
+
+			/// EnumerateStacks
+			/// Calls pStackFunction for each distinct callstack in the profile.
+			void EnumerateStacks(StackFunction pStackFunction, void* pContext) const;
+
+			/// WriteFoldedStacks
+			/// Writes the profile as one line per distinct callstack, with the frames from
+			/// the outermost to the innermost separated by semicolons, and followed by a space
+			/// and the sample count. For example:
+			///     start_thread;RunnableFunctionInternal;WorkerThread;Compress 27
+			///
+			/// Frames are named with dladdr, which sees only exported symbols (link the
+			/// executable with -rdynamic to export its own). Others are written as the
+			/// module name and offset, e.g. "libz.so.1+0x3c10", or as a plain address.
+			void WriteFoldedStacks(WriteFunction pWriteFunction, void* pContext) const;
+
+		protected:
+			struct StackEntry
+			{
+				uint64_t mnHash;            /// 0 for an unused entry.
+				uint64_t mnCount;
+				size_t   mnFrameIndex;      /// The index of the callstack's first entry in mpFrameArray.
+				size_t   mnDepth;
+			};
+
+			void   StopThreads();
+			size_t CollectSamples();
+			bool   AddSample(void* const* pCallstack, size_t nDepth);
+			bool   GrowStackTable();
+			bool   GrowFrameArray(size_t nMinCapacity);
+			void   ClearProfile();
+
+			mutable Mutex      mMutex;
+			ProfilerParameters mParameters;
+			bool               mbStarted;
+			ProfilerThread*    mpThreadArray;
+			size_t             mnThreadCount;
+			StackEntry*        mpStackTable;
+			size_t             mnStackTableCapacity;
+			size_t             mnStackCount;
+			void**             mpFrameArray;
+			size_t             mnFrameCount;
+			size_t             mnFrameCapacity;
+			uint64_t           mnSampleCount;
+			uint64_t           mnDroppedSampleCount;
+			uint64_t           mnSampleNanoseconds;
+
+		private:
+			// Objects of this class are not copyable.
+			Profiler(const Profiler&);
+			Profiler& operator=(const Profiler&);
+		};
+
+	} // namespace Thread
+
+} // namespace EA
+
+#endif // EATHREAD_PROFILER_AVAILABLE
+
+
+#if defined(EA_DLL) && defined(EA_COMPILER_MSVC)
+	// re-enable warning 4251 (it's a level-1 warning and should not be suppressed globally)
+	EA_RESTORE_VC_WARNING()
+#endif
+
+
+#endif // EATHREAD_EATHREAD_PROFILER_H
@@ -0,0 +1,282 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Implements an interprocess ring buffer of variable length records, through
+// which one or more producer processes pass messages to a consumer process
+// in shared memory, without copying them through the kernel.
+//
+// The ring lives in a Shared<T> segment (see eathread_rwmutex_ip.h) and is
+// found by name. Producers reserve space for a record, build it in place and
+// commit it; the consumer peeks at the oldest committed record in place and
+// releases it when done. Neither side takes a lock: producers claim space
+// with a compare-and-swap on the reserve position, and the consumer only
+// ever writes the release position. A thread which finds the ring empty or
+// full polls for a short while and then parks on the position it is waiting
+// for, and the other side wakes it only if some thread actually parked.
+/////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef EATHREAD_EATHREAD_RINGBUFFER_IP_H
+#define EATHREAD_EATHREAD_RINGBUFFER_IP_H
+
+
+#include <EABase/eabase.h>
+#include <eathread/internal/config.h>
+#include <eathread/eathread.h>
+#include <eathread/eathread_atomic.h>
+#include <eathread/eathread_rwmutex_ip.h>
+
+#if defined(EA_DLL) && defined(EA_COMPILER_MSVC)
+	// Suppress warning about class 'AtomicInt32' needs to have a
+	// dll-interface to be used by clients of class which have a templated member.
+	EA_DISABLE_VC_WARNING(4251)
+#endif
+
+#if defined(EA_PRAGMA_ONCE_SUPPORTED)
+	#pragma once // Some compilers (e.g. VC++) benefit significantly from using this. We've measured 3-4% build speed improvements in apps as a result.
+#endif
+
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		/// RingBufferIPControl
+		///
+		/// The positions of a RingBufferIP, kept in the shared segment in front of its
+		/// buffer. Positions are byte counts since the ring was created, and wrap at 2^32.
+		/// Each group of fields is written by a different party, so each has its own cache line.
+		///
+		struct EATHREADLIB_API RingBufferIPControl
+		{
+			alignas(EATHREAD_CACHE_LINE_SIZE) AtomicInt32 mnReservePosition;  // End of the space claimed by producers.
+			alignas(EATHREAD_CACHE_LINE_SIZE) AtomicInt32 mnCommitPosition;   // End of the records the consumer may read.
+											  AtomicInt32 mnCommitWaiters;    // Count of threads parked on mnCommitPosition.
+			alignas(EATHREAD_CACHE_LINE_SIZE) AtomicInt32 mnReleasePosition;  // End of the records the consumer is done with.
+											  AtomicInt32 mnReleaseWaiters;   // Count of producers parked on mnReleasePosition.
+											  uint32_t    mnCapacity;         // Checked by processes which attach to the ring.
+
+			RingBufferIPControl(uint32_t nCapacity);
+		};
+
+
+		/// RingBufferIPSegment
+		///
+		/// The contents of the shared segment of a RingBufferIP.
+		///
+		template <uint32_t kCapacity>
+		struct RingBufferIPSegment
+		{
+			static_assert((kCapacity >= 64) && ((kCapacity & (kCapacity - 1)) == 0), "RingBufferIP capacity must be a power of two of at least 64 bytes.");
+
+			RingBufferIPControl mControl;
+			alignas(EATHREAD_CACHE_LINE_SIZE) char mBuffer[kCapacity];
+
+			RingBufferIPSegment() : mControl(kCapacity) { }
+		};
+
+
+		/// RingBufferIPBase
+		///
+		/// The operations of RingBufferIP, which don't depend on its capacity.
+		/// Use RingBufferIP rather than this class directly.
+		///
+		/// Any number of threads, in any number of processes, may produce records.
+		/// Only one thread at a time, in one process, may consume them.
+		///
+		class EATHREADLIB_API RingBufferIPBase
+		{
+		public:
+			static const int kDefaultSpinMicroseconds = 20;
+
+			/// Reservation
+			///
+			/// Space in the ring which a producer has claimed for a record.
+			///
+			struct Reservation
+			{
+				void*    mpData;    /// Where the producer builds the record.
+				uint32_t mnSize;    /// The reserved size of the record. May be reduced before Commit, but not increased.
+				uint32_t mnBegin;   /// Position of the reserved space, for internal use.
+				uint32_t mnEnd;     /// Position of the end of the reserved space, for internal use.
+			};
+
+			/// Reserve
+			///
+			/// Claims space for a record of nSize bytes, waiting for the consumer to make
+			/// room if the ring is full. The record is aligned to 8 bytes. Returns false if
+			/// the timeout passed first, if nSize is more than GetMaxRecordSize, or if the
+			/// ring isn't initialized.
+			///
+			/// Every successful Reserve must be followed by a Commit, soon: records reach
+			/// the consumer in the order in which they were reserved, so an uncommitted
+			/// reservation holds back the records reserved after it by other producers.
+			///
+			/// If a producer process exits between Reserve and Commit, its reservation is
+			/// skipped by the first thread which waits behind it for about 100 ms, either
+			/// a committing producer or the consumer in Peek, and the consumer never sees
+			/// the record. A reservation held by a process which is still running, such as
+			/// one whose producer thread has died or hung, holds back the ring for good.
+			///
+			bool Reserve(Reservation& reservation, uint32_t nSize, const ThreadTime& timeoutAbsolute = kTimeoutNone);
+
+			/// Commit
+			///
+			/// Makes a reserved record available to the consumer. Waits for producers whose
+			/// reservations precede this one to commit theirs, or to be found to have exited.
+			///
+			void Commit(const Reservation& reservation);
+
+			/// Write
+			///
+			/// Copies nSize bytes from pData into a new record. This is Reserve, memcpy and Commit.
+			///
+			bool Write(const void* pData, uint32_t nSize, const ThreadTime& timeoutAbsolute = kTimeoutNone);
+
+			/// Peek
+			///
+			/// Returns the oldest committed record, waiting for one if the ring is empty,
+			/// and sets nSize to its size. Returns NULL if the timeout passed first. The
+			/// record stays in the ring, and the returned pointer stays valid, until Release.
+			///
+			void* Peek(uint32_t& nSize, const ThreadTime& timeoutAbsolute = kTimeoutNone);
+
+			/// Release
+			///
+			/// Removes the record returned by the last Peek from the ring.
+			///
+			void Release();
+
+			/// GetCapacity
+			/// Returns the size of the ring's buffer in bytes.
+			uint32_t GetCapacity() const
+				{ return mnCapacity; }
+
+			/// GetMaxRecordSize
+			/// Returns the largest nSize which Reserve accepts. This is a little less than
+			/// half the capacity, so that a record always fits once the ring is empty.
+			uint32_t GetMaxRecordSize() const
+				{ return (mnCapacity / 2) - kRecordHeaderSize; }
+
+			/// GetUsedSize
+			/// Returns the number of bytes which are reserved and not yet released.
+			uint32_t GetUsedSize() const;
+
+		protected:
+			static const uint32_t kRecordHeaderSize = 16;
+
+			RingBufferIPBase();
+
+			void Attach(RingBufferIPControl* pControl, char* pBuffer, uint32_t nCapacity, int nSpinMicroseconds);
+			void Detach();
+			bool WaitWhileEqual(AtomicInt32& position, uint32_t nPosition, AtomicInt32& nWaiters, const ThreadTime& timeoutAbsolute);
+			void Wake(AtomicInt32& position, AtomicInt32& nWaiters);
+			void ReleaseTo(uint32_t nPosition);
+			bool SkipAbandoned(uint32_t nCommit);
+
+			RingBufferIPBase(const RingBufferIPBase&);
+			RingBufferIPBase& operator=(const RingBufferIPBase&);
+
+		protected:
+			RingBufferIPControl* mpControl;     // In the shared segment, or NULL if not initialized.
+			char*                mpBuffer;      // In the shared segment.
+			uint32_t             mnCapacity;
+			uint32_t             mnPeekEnd;     // End position of the record returned by Peek. Used only by the consumer.
+			int                  mnSpinCount;
+		};
+
+
+		/// RingBufferIP
+		///
+		/// An interprocess ring buffer with a buffer of kCapacity bytes, which must be a
+		/// power of two. Every process which opens the same name must use the same kCapacity.
+		///
+		/// Example usage:
+		///     // Producer process
+		///     RingBufferIP<65536> ring("Telemetry");
+		///     RingBufferIP<65536>::Reservation reservation;
+		///
+		///     if(ring.Reserve(reservation, sizeof(Message)))
+		///     {
+		///         new(reservation.mpData) Message(...);
+		///         ring.Commit(reservation);
+		///     }
+		///
+		///     // Consumer process
+		///     RingBufferIP<65536> ring("Telemetry");
+		///     uint32_t nSize;
+		///
+		///     while(void* pRecord = ring.Peek(nSize))
+		///     {
+		///         Process(static_cast<Message*>(pRecord));
+		///         ring.Release();
+		///     }
+		///
+		template <uint32_t kCapacity>
+		class RingBufferIP : public RingBufferIPBase
+		{
+		public:
+			RingBufferIP()
+				{ }
+
+			RingBufferIP(const char* pName, int nSpinMicroseconds = kDefaultSpinMicroseconds)
+				{ Init(pName, nSpinMicroseconds); }
+
+		   ~RingBufferIP()
+				{ Shutdown(); }
+
+			/// Init
+			///
+			/// Opens the ring of the given name, creating it if it doesn't exist. A thread
+			/// which must wait polls for up to nSpinMicroseconds before parking.
+			/// Returns false if the ring couldn't be opened, or if it exists with another capacity.
+			///
+			bool Init(const char* pName, int nSpinMicroseconds = kDefaultSpinMicroseconds)
+			{
+				Shutdown();
+
+				if(mSegment.Init(pName))
+				{
+					if(mSegment->mControl.mnCapacity == kCapacity)
+					{
+						Attach(&mSegment->mControl, mSegment->mBuffer, kCapacity, nSpinMicroseconds);
+						return true;
+					}
+
+					EAT_ASSERT(false); // Another process created this ring with a different capacity.
+					mSegment.Shutdown();
+				}
+
+				return false;
+			}
+
+			void Shutdown()
+			{
+				Detach();
+				mSegment.Shutdown();
+			}
+
+			/// IsNew
+			/// Returns true if Init created the ring rather than attaching to an existing one.
+			bool IsNew() const
+				{ return mSegment.IsNew(); }
+
+		protected:
+			Shared< RingBufferIPSegment<kCapacity> > mSegment;
+		};
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+#if defined(EA_DLL) && defined(EA_COMPILER_MSVC)
+	// re-enable warning 4251 (it's a level-1 warning and should not be suppressed globally)
+	EA_RESTORE_VC_WARNING()
+#endif
+
+
+#endif // EATHREAD_EATHREAD_RINGBUFFER_IP_H
@@ -35,11 +35,14 @@
 	{
 		int                   mnReadWaiters;
 		int                   mnWriteWaiters;
-		int                   mnReaders;
+		int                   mnReaders;            // Includes the upgradeable reader, if any.
+		bool                  mbUpgradeWaiting;     // True while the upgradeable reader is waiting in Upgrade.
 		EA::Thread::ThreadId  mThreadIdWriter;
+		EA::Thread::ThreadId  mThreadIdUpgrader;    // The thread holding the upgradeable read lock, if any.
 		EA::Thread::Mutex     mMutex;
-		EA::Thread::Condition mReadCondition;
+		EA::Thread::Condition mReadCondition;       // Waited on by both plain and upgradeable readers.
 		EA::Thread::Condition mWriteCondition;
+		EA::Thread::Condition mUpgradeCondition;    // Waited on by the upgradeable reader in Upgrade.
 
 		EARWMutexData();
 
@@ -72,6 +75,22 @@ namespace EA
 		/// This allows for significantly higher performance when data to be protected
 		/// is read much more frequently than written. In this case, a waiting writer
 		/// gets top priority and all new readers block after a waiter starts waiting.
+		///
+		/// In addition to read and write locks, a thread can take an upgradeable read
+		/// lock. An upgradeable read lock coexists with plain read locks but excludes
+		/// writers and other upgradeable readers. Its holder can later call Upgrade to
+		/// turn it into a write lock without releasing it, which is useful for
+		/// read-check-then-write code such as filling a cache on a miss: nobody can
+		/// change the data between the check and the write, so no re-validation is
+		/// needed. A write lock can likewise be turned into a read lock with Downgrade.
+		///
+		/// Example usage:
+		///     AutoRWMutex autoMutex(mutex, RWMutex::kLockTypeUpgradeableRead);
+		///     if(!cache.Find(key)) {
+		///         autoMutex.Upgrade();
+		///         cache.Insert(key, CreateValue(key));
+		///     }
+		///
 		class EATHREADLIB_API RWMutex
 		{
 		public:
@@ -85,7 +104,8 @@ namespace EA
 			{
 				kLockTypeNone  = 0,
 				kLockTypeRead  = 1,
-				kLockTypeWrite = 2
+				kLockTypeWrite = 2,
+				kLockTypeUpgradeableRead = 3   /// A read lock which can later be upgraded to a write lock. Only one thread at a time can hold one.
 			};
 
 			/// RWMutex
@@ -126,6 +146,21 @@ namespace EA
 			/// or is one of enum Result.
 			int Unlock();
 
+			/// Upgrade
+			/// Converts the calling thread's upgradeable read lock into a write lock, without
+			/// letting any other writer in between. New readers are held off while the upgrade
+			/// waits for existing readers to unlock. The calling thread must hold the
+			/// upgradeable read lock and no other read locks on this mutex.
+			/// Returns 1 (the new write lock count) upon success. Upon kResultTimeout, the
+			/// thread still holds the upgradeable read lock.
+			int Upgrade(const ThreadTime& timeoutAbsolute = EA::Thread::kTimeoutNone);
+
+			/// Downgrade
+			/// Converts the calling thread's write lock into a read lock, letting waiting
+			/// readers in. Writers waiting for the mutex continue to wait.
+			/// Returns the new read lock count.
+			int Downgrade();
+
 			/// GetLockCount
 			int GetLockCount(LockType lockType);
 
@@ -180,6 +215,8 @@ namespace EA
 		/// class AutoRWMutex
 		/// An AutoRWMutex locks the RWMutex in its constructor and 
 		/// unlocks the AutoRWMutex in its destructor (when it goes out of scope).
+		/// The lock can be upgraded or downgraded in between; the destructor
+		/// releases whatever kind of lock is held at that point.
 		class AutoRWMutex
 		{
 		public:
@@ -190,6 +227,12 @@ namespace EA
 		  ~AutoRWMutex()
 				{  mMutex.Unlock(); }
 
+			int Upgrade(const ThreadTime& timeoutAbsolute = EA::Thread::kTimeoutNone)
+				{ return mMutex.Upgrade(timeoutAbsolute); }
+
+			int Downgrade()
+				{ return mMutex.Downgrade(); }
+
 		protected:
 			RWMutex& mMutex;
 
@@ -21,6 +21,16 @@
 	EA_DISABLE_ALL_VC_WARNINGS()
 	#include <Windows.h>
 	EA_RESTORE_ALL_VC_WARNINGS()
+#elif EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+	#include <eathread/eathread_atomic.h>
+	#include <pthread.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <signal.h>
+	#include <errno.h>
+	#include <string.h>
 #endif
 
 #if defined(EA_PRAGMA_ONCE_SUPPORTED)
@@ -99,11 +109,13 @@ namespace EA
 			{
 				bool bReturnValue = false;
 
+				if(pName && (strlen(pName) >= sizeof(mName))) // A truncated name could refer to another object.
+					return false;
+
 				if(pName)
-					strncpy(mName, pName, sizeof(mName));
+					strcpy(mName, pName);
 				else
 					mName[0] = 0;
-				mName[sizeof(mName) - 1] = 0;
 		 
 				char mutexName[sizeof(mName) + 16];
 				strcpy(mutexName, mName);
@@ -189,6 +201,283 @@ namespace EA
 				return *pData32;
 			}
 
+		#elif EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+
+			/// Shared
+			///
+			/// Places a T in a POSIX shared memory object (shm_open) named by pName, so that
+			/// every process which uses the same name sees the same T. The first process
+			/// to Init the object creates the segment and constructs the T; later ones
+			/// attach to it. A reference count kept in the segment tracks the users, and
+			/// the last one to Shutdown destroys the T and unlinks the name.
+			///
+			/// An empty or NULL name creates an anonymous segment which is private to this
+			/// Shared, but which is still visible to child processes forked after Init.
+			/// Init fails, with errno set to ENAMETOOLONG, for names longer than 30 characters.
+			///
+			/// A process which attaches while the creator is constructing the T waits for
+			/// it. If the creator exits first, the segment is abandoned: the process which
+			/// notices removes its name and creates a new segment in its place. If the creator
+			/// is still running but hasn't finished after kCreatorTimeoutMilliseconds, Init
+			/// fails with errno set to ETIMEDOUT.
+			///
+			/// A process which exits without calling Shutdown leaves its reference behind,
+			/// and the segment then persists in /dev/shm until it is unlinked by hand.
+			///
+			template<typename T>
+			class Shared
+			{
+			public:
+				Shared();
+				Shared(const char* pName);
+			   ~Shared();
+
+				bool Init(const char* pName);
+				void Shutdown();
+				bool IsNew() const { return mbCreated; }
+				T*   operator->()  { return mpT; }
+
+			protected:
+				enum SegmentState
+				{
+					kSegmentStateConstructing = 0,  // A new segment is zero-filled, so it starts in this state.
+					kSegmentStateReady        = 1,
+					kSegmentStateAbandoned    = 2   // The creator exited before the segment was ready.
+				};
+
+				enum { kCreatorTimeoutMilliseconds = 10000 }; // How long Attach waits for a running creator.
+
+				struct Segment
+				{
+					AtomicInt32 mnState;
+					AtomicInt32 mnCreatorPid;       // Zero until the creator has mapped the segment.
+					AtomicInt32 mnRefCount;
+					alignas(T) char mData[sizeof(T)];
+				};
+
+				bool Attach();
+
+				Shared(const Shared&);
+				Shared& operator=(const Shared&);
+
+			protected:
+				Segment* mpSegment;
+				T*       mpT;
+				bool     mbCreated;
+				char     mName[32];     // Has a leading '/', as shm_open requires.
+			};
+
+
+			template <typename T>
+			inline Shared<T>::Shared()
+			  : mpSegment(NULL)
+			  , mpT(NULL)
+			  , mbCreated(false)
+			{
+				mName[0] = 0;
+			}
+
+
+			template <typename T>
+			inline Shared<T>::Shared(const char* pName)
+			  : mpSegment(NULL)
+			  , mpT(NULL)
+			  , mbCreated(false)
+			{
+				mName[0] = 0;
+				Init(pName);
+			}
+
+
+			template <typename T>
+			inline Shared<T>::~Shared()
+			{
+				Shutdown();
+			}
+
+
+			template <typename T>
+			inline bool Shared<T>::Init(const char* pName)
+			{
+				Shutdown();
+
+				mName[0] = 0;
+				if(pName && pName[0])
+				{
+					if(strlen(pName) > (sizeof(mName) - 2)) // A truncated name could refer to another segment.
+					{
+						errno = ENAMETOOLONG;
+						return false;
+					}
+
+					mName[0] = '/';
+					strcpy(mName + 1, pName);
+				}
+
+				if(mName[0] == 0)
+				{
+					void* const pData = mmap(NULL, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+					if(pData == MAP_FAILED)
+						return false;
+
+					mpSegment = static_cast<Segment*>(pData);
+					mbCreated = true;
+				}
+				else
+				{
+					// Another process may be tearing down a segment of the same name, in which 
+					// case we wait for it to unlink the name and then create a new segment.
+					while(!Attach())
+					{
+						if(errno != EAGAIN)
+							return false;
+						ThreadSleep(kTimeoutYield);
+					}
+				}
+
+				if(mbCreated)
+				{
+					mpT = new(mpSegment->mData) T;
+					mpSegment->mnRefCount.SetValue(1);
+					mpSegment->mnState.SetValue(kSegmentStateReady);
+				}
+				else
+					mpT = reinterpret_cast<T*>(mpSegment->mData);
+
+				return true;
+			}
+
+
+			template <typename T>
+			inline bool Shared<T>::Attach()
+			{
+				const ThreadTime timeoutAbsolute = GetThreadTime() + kCreatorTimeoutMilliseconds;
+
+				// O_EXCL tells us whether we are the process which creates the segment.
+				int fd = shm_open(mName, O_RDWR | O_CREAT | O_EXCL, 0666);
+
+				mbCreated = (fd >= 0);
+
+				if(mbCreated)
+				{
+					if(ftruncate(fd, (off_t)sizeof(Segment)) != 0)
+					{
+						close(fd);
+						shm_unlink(mName);
+						mbCreated = false;
+						return false;
+					}
+				}
+				else
+				{
+					if(errno != EEXIST)
+						return false;
+
+					fd = shm_open(mName, O_RDWR, 0666);
+
+					if(fd < 0)
+					{
+						if(errno == ENOENT) // It was unlinked after our first shm_open.
+							errno = EAGAIN;
+						return false;
+					}
+
+					// The creator may not have sized the segment yet.
+					struct stat fileStat;
+					while((fstat(fd, &fileStat) == 0) && (fileStat.st_size < (off_t)sizeof(Segment)))
+					{
+						if(GetThreadTime() >= timeoutAbsolute)
+						{
+							close(fd);
+							errno = ETIMEDOUT;
+							return false;
+						}
+						ThreadSleep(kTimeoutYield);
+					}
+				}
+
+				void* const pData = mmap(NULL, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+				close(fd); // The mapping stays valid after the descriptor is closed.
+
+				if(pData == MAP_FAILED)
+				{
+					if(mbCreated)
+						shm_unlink(mName);
+					mbCreated = false;
+					errno = ENOMEM;
+					return false;
+				}
+
+				mpSegment = static_cast<Segment*>(pData);
+
+				if(mbCreated)
+				{
+					mpSegment->mnCreatorPid.SetValue((int32_t)getpid());
+					return true;
+				}
+
+				int nError = EAGAIN;
+
+				while(mpSegment->mnState.GetValue() == kSegmentStateConstructing)
+				{
+					const pid_t nCreatorPid = (pid_t)mpSegment->mnCreatorPid.GetValue();
+
+					if((nCreatorPid != 0) && (kill(nCreatorPid, 0) != 0) && (errno == ESRCH))
+					{
+						// Only the process which marks the segment abandoned removes its name, so
+						// that no other process can remove the name of a segment created since.
+						if(mpSegment->mnState.SetValueConditional(kSegmentStateAbandoned, kSegmentStateConstructing))
+							shm_unlink(mName);
+						break;
+					}
+
+					if(GetThreadTime() >= timeoutAbsolute)
+					{
+						nError = ETIMEDOUT;
+						break;
+					}
+
+					ThreadSleep(kTimeoutYield);
+				}
+
+				// A reference count of zero means that the last user is destroying the segment.
+				if(mpSegment->mnState.GetValue() == kSegmentStateReady)
+				{
+					for(int32_t nRefCount = mpSegment->mnRefCount.GetValue(); nRefCount > 0; nRefCount = mpSegment->mnRefCount.GetValue())
+					{
+						if(mpSegment->mnRefCount.SetValueConditional(nRefCount + 1, nRefCount))
+							return true;
+					}
+				}
+
+				munmap(mpSegment, sizeof(Segment));
+				mpSegment = NULL;
+				errno     = nError;
+				return false;
+			}
+
+
+			template <typename T>
+			inline void Shared<T>::Shutdown()
+			{
+				if(mpSegment)
+				{
+					if(mpSegment->mnRefCount.Decrement() == 0)
+					{
+						mpT->~T();
+
+						if(mName[0])
+							shm_unlink(mName);
+					}
+
+					munmap(mpSegment, sizeof(Segment));
+					mpSegment = NULL;
+					mpT       = NULL;
+					mbCreated = false;
+				}
+			}
+
 		#else
 
 			template<typename T>
@@ -251,6 +540,35 @@ namespace EA
 				EARWMutexIPData& operator=(const EARWMutexIPData&);
 			};
 
+		#elif EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+
+			struct EATHREADLIB_API SharedData
+			{
+				pthread_rwlock_t mRWLock;       // Process-shared, so it works from any process which maps it.
+				AtomicInt32      mnReaders;
+				AtomicInt32      mnWriters;     // 1 while somebody holds the write lock, else 0.
+				bool             mbValid;
+
+				SharedData();
+			   ~SharedData();
+			};
+
+			struct EATHREADLIB_API EARWMutexIPData
+			{
+				Shared<SharedData> mSharedData;
+				SharedData*        mpSharedData;    // Our process' address of the data in mSharedData, or NULL if not initialized.
+
+				EARWMutexIPData();
+			   ~EARWMutexIPData();
+
+				bool Init(const char* pName);
+				void Shutdown();
+
+			private:
+				EARWMutexIPData(const EARWMutexIPData&);
+				EARWMutexIPData& operator=(const EARWMutexIPData&);
+			};
+
 		#else
 
 			struct EATHREADLIB_API EARWMutexIPData
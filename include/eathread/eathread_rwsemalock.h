@@ -12,6 +12,7 @@
 
 #include "eathread_atomic.h"
 #include "eathread_semaphore.h"
+#include "internal/eathread_futexword.h"
 
 #if defined(EA_PRAGMA_ONCE_SUPPORTED)
 	#pragma once // Some compilers (e.g. VC++) benefit significantly from using this. We've measured 3-4% build speed improvements in apps as a result.
@@ -197,6 +198,222 @@ namespace EA
 		};
 
 
+		//---------------------------------------------------------
+		// RWSemaLock64
+		//
+		// The same algorithm as RWSemaLock, but with the counts held in a 64 bit
+		// word with 21 bits per field, which allows for up to 2,097,151 readers,
+		// waiting readers and writers instead of 1023 of each.
+		//
+		// Where EATHREAD_FUTEX_WORD_AVAILABLE, blocked readers and writers park
+		// on two 32 bit wake counts inside the object rather than on Semaphores,
+		// which makes the object 24 bytes in size with no kernel objects to create
+		// or destroy. A hand-off makes a wake syscall only if a thread is parked.
+		// Elsewhere it falls back to a pair of Semaphores.
+		//---------------------------------------------------------
+		class RWSemaLock64
+		{
+		public:
+			RWSemaLock64() : mStatus(0)
+				#if EATHREAD_FUTEX_WORD_AVAILABLE
+					, mnReadWakeCount(0), mnWriteWakeCount(0), mnReadParkedCount(0), mnWriteParkedCount(0)
+				#endif
+				{}
+			RWSemaLock64(const RWSemaLock64&) = delete;
+			RWSemaLock64(RWSemaLock64&&) = delete;
+			RWSemaLock64& operator=(const RWSemaLock64&) = delete;
+			RWSemaLock64& operator=(RWSemaLock64&&) = delete;
+
+			void ReadLock()
+			{
+				int64_t oldStatus, newStatus;
+				do
+				{
+					oldStatus = mStatus.GetValue();
+
+					if (Writers(oldStatus) > 0)
+					{
+						EAT_ASSERT(WaitToRead(oldStatus) + 1 <= kMaximum);
+						newStatus = oldStatus + kIncrementWaitToRead;
+					}
+					else
+					{
+						EAT_ASSERT(Readers(oldStatus) + 1 <= kMaximum);
+						newStatus = oldStatus + kIncrementRead;
+					}
+					// CAS until successful.
+				}
+				while (!mStatus.SetValueConditional(newStatus, oldStatus));
+
+				if (Writers(oldStatus) > 0)
+				{
+					WaitRead();
+				}
+			}
+
+			bool ReadTryLock()
+			{
+				int64_t oldStatus;
+				do
+				{
+					oldStatus = mStatus.GetValue();
+
+					if (Writers(oldStatus) > 0)
+					{
+						return false;
+					}
+					// CAS until successful.
+				}
+				while (!mStatus.SetValueConditional(oldStatus + kIncrementRead, oldStatus));
+
+				return true;
+			}
+
+			void ReadUnlock()
+			{
+				const int64_t oldStatus = mStatus.Add(-kIncrementRead) + kIncrementRead;
+
+				EAT_ASSERT(Readers(oldStatus) > 0);
+				if (Readers(oldStatus) == 1 && Writers(oldStatus) > 0)
+				{
+					WakeWrite();
+				}
+			}
+
+			void WriteLock()
+			{
+				const int64_t oldStatus = mStatus.Add(kIncrementWrite) - kIncrementWrite;
+
+				EAT_ASSERT(Writers(oldStatus) + 1 <= kMaximum);
+				if (Readers(oldStatus) > 0 || Writers(oldStatus) > 0)
+				{
+					WaitWrite();
+				}
+			}
+
+			bool WriteTryLock()
+			{
+				int64_t oldStatus;
+				do
+				{
+					oldStatus = mStatus.GetValue();
+
+					if (Writers(oldStatus) > 0 || Readers(oldStatus) > 0)
+					{
+						return false;
+					}
+					// CAS until successful.
+				}
+				while (!mStatus.SetValueConditional(oldStatus + kIncrementWrite, oldStatus));
+
+				return true;
+			}
+
+			void WriteUnlock()
+			{
+				int64_t waitToRead = 0;
+				int64_t oldStatus, newStatus;
+				do
+				{
+					oldStatus = mStatus.GetValue();
+					EAT_ASSERT(Readers(oldStatus) == 0);
+					newStatus  = oldStatus - kIncrementWrite;
+					waitToRead = WaitToRead(oldStatus);
+					if (waitToRead > 0)
+					{
+						// Move all the waiting readers into the readers field.
+						newStatus = newStatus - (waitToRead * kIncrementWaitToRead) + (waitToRead * kIncrementRead);
+					}
+					// CAS until successful.
+				}
+				while (!mStatus.SetValueConditional(newStatus, oldStatus));
+
+				if (waitToRead > 0)
+				{
+					WakeRead((int32_t)waitToRead);
+				}
+				else if (Writers(oldStatus) > 1)
+				{
+					WakeWrite();
+				}
+			}
+
+			// See the note on IsReadLocked/IsWriteLocked in RWSemaLock.
+
+		protected:
+			static const int64_t kFieldBits           = 21;
+			static const int64_t kMaximum             = ((int64_t)1 << kFieldBits) - 1;
+			static const int64_t kIncrementRead       = (int64_t)1;
+			static const int64_t kIncrementWaitToRead = (int64_t)1 << kFieldBits;
+			static const int64_t kIncrementWrite      = (int64_t)1 << (kFieldBits * 2);
+
+			static int64_t Readers(int64_t status)    { return  status                     & kMaximum; }
+			static int64_t WaitToRead(int64_t status) { return (status >> kFieldBits)       & kMaximum; }
+			static int64_t Writers(int64_t status)    { return (status >> (kFieldBits * 2)) & kMaximum; }
+
+			#if EATHREAD_FUTEX_WORD_AVAILABLE
+				// The wake counts act as semaphores: a waker adds to the count and wakes that many
+				// parked threads, and a waiter consumes one unit of the count. A waiter counts
+				// itself as parked before it checks the count for the last time, and a waker
+				// checks the parked count after adding to the wake count, so a waker which sees
+				// no parked threads can skip the syscall; the waiter will see the wake count.
+				static void Wait(AtomicInt32& nWakeCount, AtomicInt32& nParkedCount)
+				{
+					// A hand-off often arrives within a short time, so poll briefly before parking.
+					for (int i = 0; ; i++)
+					{
+						const int32_t n = nWakeCount.GetValue();
+
+						if (n > 0)
+						{
+							if (nWakeCount.SetValueConditional(n - 1, n))
+								return;
+						}
+						else if (i < kSpinCount)
+							EAProcessorPause();
+						else
+						{
+							nParkedCount.Increment();
+							FutexWordWait(nWakeCount, 0); // Returns at once if the count is no longer 0.
+							nParkedCount.Decrement();
+						}
+					}
+				}
+
+				static void Wake(AtomicInt32& nWakeCount, AtomicInt32& nParkedCount, int32_t nCount)
+				{
+					nWakeCount.Add(nCount);
+
+					if (nParkedCount.GetValue() > 0)
+						FutexWordWake(nWakeCount, nCount);
+				}
+
+				void WaitRead()                { Wait(mnReadWakeCount, mnReadParkedCount); }
+				void WaitWrite()               { Wait(mnWriteWakeCount, mnWriteParkedCount); }
+				void WakeRead(int32_t nCount)  { Wake(mnReadWakeCount, mnReadParkedCount, nCount); }
+				void WakeWrite()               { Wake(mnWriteWakeCount, mnWriteParkedCount, 1); }
+
+				static const int kSpinCount = 64;
+			#else
+				void WaitRead()                { mReadSema.Wait(); }
+				void WaitWrite()               { mWriteSema.Wait(); }
+				void WakeRead(int32_t nCount)  { mReadSema.Post(nCount); }
+				void WakeWrite()               { mWriteSema.Post(); }
+			#endif
+
+			AtomicInt64 mStatus;
+			#if EATHREAD_FUTEX_WORD_AVAILABLE
+				AtomicInt32 mnReadWakeCount;
+				AtomicInt32 mnWriteWakeCount;
+				AtomicInt32 mnReadParkedCount;  // Threads in FutexWordWait on mnReadWakeCount, or about to be.
+				AtomicInt32 mnWriteParkedCount;
+			#else
+				Semaphore mReadSema;  // semaphores are non-copyable
+				Semaphore mWriteSema; // semaphores are non-copyable
+			#endif
+		};
+
+
 		//---------------------------------------------------------
 		// ReadLockGuard
 		//---------------------------------------------------------
@@ -247,6 +464,58 @@ namespace EA
 				m_lock.WriteUnlock();
 			}
 		};
+
+
+		//---------------------------------------------------------
+		// ReadLockGuard for RWSemaLock64
+		//---------------------------------------------------------
+		class AutoSemaReadLock64
+		{
+		private:
+			RWSemaLock64& m_lock;
+
+		public:
+			AutoSemaReadLock64(const AutoSemaReadLock64&) = delete;
+			AutoSemaReadLock64(AutoSemaReadLock64&&) = delete;
+			AutoSemaReadLock64& operator=(const AutoSemaReadLock64&) = delete;
+			AutoSemaReadLock64& operator=(AutoSemaReadLock64&&) = delete;
+
+			AutoSemaReadLock64(RWSemaLock64& lock) : m_lock(lock)
+			{
+				m_lock.ReadLock();
+			}
+
+			~AutoSemaReadLock64()
+			{
+				m_lock.ReadUnlock();
+			}
+		};
+
+
+		//---------------------------------------------------------
+		// WriteLockGuard for RWSemaLock64
+		//---------------------------------------------------------
+		class AutoSemaWriteLock64
+		{
+		private:
+			RWSemaLock64& m_lock;
+
+		public:
+			AutoSemaWriteLock64(const AutoSemaWriteLock64&) = delete;
+			AutoSemaWriteLock64(AutoSemaWriteLock64&&) = delete;
+			AutoSemaWriteLock64& operator=(const AutoSemaWriteLock64&) = delete;
+			AutoSemaWriteLock64& operator=(AutoSemaWriteLock64&&) = delete;
+
+			AutoSemaWriteLock64(RWSemaLock64& lock) : m_lock(lock)
+			{
+				m_lock.WriteLock();
+			}
+
+			~AutoSemaWriteLock64()
+			{
+				m_lock.WriteUnlock();
+			}
+		};
 	}
 }
 
@@ -15,6 +15,7 @@
 #include <eathread/eathread.h>
 #include <eathread/eathread_sync.h>
 #include <eathread/eathread_atomic.h>
+#include <eathread/eathread_backoff.h>
 #include <new>
 
 EA_DISABLE_VC_WARNING(4100) // (Compiler claims pRWSpinLock is unreferenced)
@@ -70,10 +71,27 @@ namespace EA
 		///     value == 0x01000000       ----> unlocked
 		///     0x01000000 < value <= 0   ----> write-locked
 		///
-		class RWSpinLock
+		/// A thread can also take an upgradeable read lock, which coexists with plain
+		/// read locks but not with writers or other upgradeable readers. Its holder
+		/// can later convert it to a write lock with Upgrade, without any writer
+		/// getting in between. This suits read-check-then-write code such as a cache
+		/// fill, which otherwise must drop its read lock, take the write lock and
+		/// re-validate what it read. Downgrade converts a write lock to a read lock.
+		/// Upgrade works by removing the upgrader's read lock and subtracting
+		/// kValueUnlocked - 1, which leaves the value at minus the number of other
+		/// readers. That keeps new readers and writers out (as with a write lock),
+		/// and the value reaches zero, which is write-locked, when the last of the
+		/// other readers unlocks.
+		///
+		/// RWSpinLock is RWSpinLockT<BackoffNone>. RWSpinLockT lets the user pick
+		/// a different backoff policy (see eathread_backoff.h), which decides how
+		/// long ReadLock and WriteLock wait between polls of the lock.
+		///
+		template <typename BackoffPolicy>
+		class RWSpinLockT
 		{
 		public:
-			RWSpinLock();
+			RWSpinLockT();
 
 			// This function cannot be called while the current thread  
 			// already has a write lock, else this function will hang. 
@@ -116,6 +134,35 @@ namespace EA
 			// Matches WriteLock or a successful WriteTryLock.
 			void WriteUnlock();
 
+			// Takes a read lock which can later be upgraded with Upgrade. Only one thread
+			// at a time can hold an upgradeable read lock; others wait here.
+			// This function cannot be called while the current thread already has
+			// a write lock or an upgradeable read lock, else this function will hang.
+			void UpgradeableReadLock();
+
+			// Returns false if another thread holds the upgradeable read lock or a writer
+			// holds the lock.
+			bool UpgradeableReadTryLock();
+
+			// Returns true if any thread currently has an upgradeable read lock, including
+			// one which is in the middle of upgrading.
+			bool IsUpgradeableReadLocked() const;
+
+			// Matches UpgradeableReadLock or a successful UpgradeableReadTryLock
+			// which hasn't been upgraded.
+			void UpgradeableReadUnlock();
+
+			// Converts the current thread's upgradeable read lock into a write lock,
+			// waiting for other readers to unlock while keeping new ones out.
+			// The result must be released with WriteUnlock (or Downgrade).
+			// The current thread must not hold plain read locks in addition to the
+			// upgradeable read lock, else this function will hang.
+			void Upgrade();
+
+			// Converts the current thread's write lock into a plain read lock,
+			// which must be released with ReadUnlock.
+			void Downgrade();
+
 			// Returns the address of mValue. This value should be read for 
 			// diagnostic purposes only and should not be written.
 			void* GetPlatformData();
@@ -127,6 +174,16 @@ namespace EA
 			};
 
 			AtomicInt32 mValue;
+			AtomicInt32 mUpgradeFlag; /// 1 while a thread holds the upgradeable read lock, else 0.
+		};
+
+
+		/// class RWSpinLock
+		///
+		/// The default RWSpinLock, which uses a single pause between polls.
+		///
+		class RWSpinLock : public RWSpinLockT<BackoffNone>
+		{
 		};
 
 
@@ -167,12 +224,19 @@ namespace EA
 			enum LockType
 			{
 				kLockTypeRead, 
-				kLockTypeWrite
+				kLockTypeWrite,
+				kLockTypeUpgradeableRead
 			};
 
 			AutoRWSpinLock(RWSpinLock& spinLock, LockType lockType) ;
 		   ~AutoRWSpinLock();
 
+			// Upgrades a kLockTypeUpgradeableRead lock to kLockTypeWrite.
+			void Upgrade();
+
+			// Downgrades a kLockTypeWrite lock to kLockTypeRead.
+			void Downgrade();
+
 		protected:
 			RWSpinLock& mSpinLock;
 			LockType    mLockType;
@@ -182,6 +246,30 @@ namespace EA
 			const AutoRWSpinLock& operator=(const AutoRWSpinLock&);
 		};
 
+
+		/// class AutoRWSpinLockT
+		///
+		/// The equivalent of AutoRWSpinLock for RWSpinLockT.
+		///
+		template <typename BackoffPolicy>
+		class AutoRWSpinLockT
+		{
+		public:
+			AutoRWSpinLockT(RWSpinLockT<BackoffPolicy>& spinLock, AutoRWSpinLock::LockType lockType) ;
+		   ~AutoRWSpinLockT();
+
+			void Upgrade();
+			void Downgrade();
+
+		protected:
+			RWSpinLockT<BackoffPolicy>& mSpinLock;
+			AutoRWSpinLock::LockType    mLockType;
+
+			// Prevent copying by default, as copying is dangerous.
+			AutoRWSpinLockT(const AutoRWSpinLockT&);
+			const AutoRWSpinLockT& operator=(const AutoRWSpinLockT&);
+		};
+
 	} // namespace Thread
 
 } // namespace EA
@@ -201,36 +289,36 @@ namespace EA
 	{
 
 		///////////////////////////////////////////////////////////////////////
-		// RWSpinLock
+		// RWSpinLockT
 		///////////////////////////////////////////////////////////////////////
 
+		template <typename BackoffPolicy>
 		inline
-		RWSpinLock::RWSpinLock()
-			: mValue(kValueUnlocked)
+		RWSpinLockT<BackoffPolicy>::RWSpinLockT()
+			: mValue(kValueUnlocked), mUpgradeFlag(0)
 		{
 		}
 
 
+		template <typename BackoffPolicy>
 		inline
-		void RWSpinLock::ReadLock()
+		void RWSpinLockT<BackoffPolicy>::ReadLock()
 		{
+			BackoffPolicy backoff;
+
 			Top: // Due to modern processor branch prediction, the compiler will optimize better for true branches and so we do a manual goto loop here.
 			if((unsigned)mValue.Decrement() < kValueUnlocked)
 				return;
 			mValue.Increment();
-			while(mValue.GetValueRaw() <= 0){ // It is better to do this polling loop as a first check than to 
-				#ifdef EA_THREAD_COOPERATIVE  // do an atomic decrement repeatedly, as the atomic lock is 
-					ThreadSleep();            // potentially not a cheap thing due to potential bus locks on some platforms..
-				#else
-					EAProcessorPause();       // We don't check for EA_TARGET_SMP here and instead sleep if not defined because you probably shouldn't be using a spinlock on a pre-emptive system unless it is a multi-processing system.     
-				#endif
-			}
+			while(mValue.GetValueRaw() <= 0) // It is better to do this polling loop as a first check than to do an atomic decrement repeatedly,
+				backoff.Pause();              // as the atomic lock is potentially not a cheap thing due to potential bus locks on some platforms.
 			goto Top;
 		}
 
 
+		template <typename BackoffPolicy>
 		inline
-		bool RWSpinLock::ReadTryLock()
+		bool RWSpinLockT<BackoffPolicy>::ReadTryLock()
 		{
 			const unsigned nNewValue = (unsigned)mValue.Decrement();
 			if(nNewValue < kValueUnlocked) // Given that nNewValue is unsigned, we don't need to test for < 0.
@@ -240,41 +328,42 @@ namespace EA
 		}
 
 
+		template <typename BackoffPolicy>
 		inline
-		bool RWSpinLock::IsReadLocked() const
+		bool RWSpinLockT<BackoffPolicy>::IsReadLocked() const
 		{
 			const unsigned nValue = (unsigned)mValue.GetValue();
 			return ((nValue - 1) < (kValueUnlocked - 1)); // Given that nNewValue is unsigned, this is faster than comparing ((n > 0) && (n < kValueUnlocked)), due to the presence of only one comparison instead of two.
 		}
 
 
+		template <typename BackoffPolicy>
 		inline
-		void RWSpinLock::ReadUnlock()
+		void RWSpinLockT<BackoffPolicy>::ReadUnlock()
 		{
 			mValue.Increment();
 		}
 
 
+		template <typename BackoffPolicy>
 		inline
-		void RWSpinLock::WriteLock()
+		void RWSpinLockT<BackoffPolicy>::WriteLock()
 		{
+			BackoffPolicy backoff;
+
 			Top: 
 			if(mValue.Add(-kValueUnlocked) == 0)
 				return;
 			mValue.Add(kValueUnlocked);
-			while(mValue.GetValueRaw() != kValueUnlocked){  // It is better to do this polling loop as a first check than to
-				#ifdef EA_THREAD_COOPERATIVE             // do an atomic decrement repeatedly, as the atomic lock is 
-					ThreadSleep();                       // potentially not a cheap thing due to potential bus locks on some platforms..
-				#else
-					EAProcessorPause();                  // We don't check for EA_TARGET_SMP here and instead sleep if not defined because you probably shouldn't be using a spinlock on a pre-emptive system unless it is a multi-processing system.     
-				#endif
-			}
+			while(mValue.GetValueRaw() != kValueUnlocked) // See ReadLock.
+				backoff.Pause();
 			goto Top;
 		}
 
 
+		template <typename BackoffPolicy>
 		inline
-		bool RWSpinLock::WriteTryLock()
+		bool RWSpinLockT<BackoffPolicy>::WriteTryLock()
 		{
 			if(mValue.Add(-kValueUnlocked) == 0)
 				return true;
@@ -283,22 +372,100 @@ namespace EA
 		}
 
 
+		template <typename BackoffPolicy>
 		inline
-		bool RWSpinLock::IsWriteLocked() const
+		bool RWSpinLockT<BackoffPolicy>::IsWriteLocked() const
 		{
 			 return (mValue.GetValue() <= 0); // This fails to work if 127 threads at once are in the middle of a failed write lock attempt.
 		}
 
 
+		template <typename BackoffPolicy>
 		inline
-		void RWSpinLock::WriteUnlock()
+		void RWSpinLockT<BackoffPolicy>::WriteUnlock()
 		{
 			mValue.Add(kValueUnlocked);
 		}
 
 
+		template <typename BackoffPolicy>
 		inline
-		void* RWSpinLock::GetPlatformData() 
+		void RWSpinLockT<BackoffPolicy>::UpgradeableReadLock()
+		{
+			BackoffPolicy backoff;
+
+			while(!mUpgradeFlag.SetValueConditional(1, 0))
+			{
+				while(mUpgradeFlag.GetValueRaw() != 0)
+					backoff.Pause();
+			}
+
+			ReadLock();
+		}
+
+
+		template <typename BackoffPolicy>
+		inline
+		bool RWSpinLockT<BackoffPolicy>::UpgradeableReadTryLock()
+		{
+			if(mUpgradeFlag.SetValueConditional(1, 0))
+			{
+				if(ReadTryLock())
+					return true;
+				mUpgradeFlag.SetValue(0);
+			}
+			return false;
+		}
+
+
+		template <typename BackoffPolicy>
+		inline
+		bool RWSpinLockT<BackoffPolicy>::IsUpgradeableReadLocked() const
+		{
+			return (mUpgradeFlag.GetValue() != 0);
+		}
+
+
+		template <typename BackoffPolicy>
+		inline
+		void RWSpinLockT<BackoffPolicy>::UpgradeableReadUnlock()
+		{
+			EAT_ASSERT(IsUpgradeableReadLocked());
+			mValue.Increment();
+			mUpgradeFlag.SetValue(0);
+		}
+
+
+		template <typename BackoffPolicy>
+		inline
+		void RWSpinLockT<BackoffPolicy>::Upgrade()
+		{
+			EAT_ASSERT(IsUpgradeableReadLocked());
+
+			BackoffPolicy backoff;
+
+			// Trade our read lock for a pending write lock. See the class documentation.
+			mValue.Add(-(kValueUnlocked - 1));
+			while(mValue.GetValueRaw() != 0)
+				backoff.Pause();
+
+			// The write lock excludes other upgradeable readers from here on.
+			mUpgradeFlag.SetValue(0);
+		}
+
+
+		template <typename BackoffPolicy>
+		inline
+		void RWSpinLockT<BackoffPolicy>::Downgrade()
+		{
+			// Turns the write lock's value of 0 into the value for one reader.
+			mValue.Add(kValueUnlocked - 1);
+		}
+
+
+		template <typename BackoffPolicy>
+		inline
+		void* RWSpinLockT<BackoffPolicy>::GetPlatformData() 
 		{
 			return &mValue;
 		}
@@ -369,8 +536,10 @@ namespace EA
 		{ 
 			if(mLockType == kLockTypeRead)
 				mSpinLock.ReadLock();
-			else
+			else if(mLockType == kLockTypeWrite)
 				mSpinLock.WriteLock();
+			else
+				mSpinLock.UpgradeableReadLock();
 		}
 
 
@@ -379,8 +548,80 @@ namespace EA
 		{ 
 			if(mLockType == kLockTypeRead)
 				mSpinLock.ReadUnlock();
+			else if(mLockType == kLockTypeWrite)
+				mSpinLock.WriteUnlock();
+			else
+				mSpinLock.UpgradeableReadUnlock();
+		}
+
+
+		inline
+		void AutoRWSpinLock::Upgrade()
+		{
+			EAT_ASSERT(mLockType == kLockTypeUpgradeableRead);
+			mSpinLock.Upgrade();
+			mLockType = kLockTypeWrite;
+		}
+
+
+		inline
+		void AutoRWSpinLock::Downgrade()
+		{
+			EAT_ASSERT(mLockType == kLockTypeWrite);
+			mSpinLock.Downgrade();
+			mLockType = kLockTypeRead;
+		}
+
+
+
+		///////////////////////////////////////////////////////////////////////
+		// AutoRWSpinLockT
+		///////////////////////////////////////////////////////////////////////
+
+		template <typename BackoffPolicy>
+		inline
+		AutoRWSpinLockT<BackoffPolicy>::AutoRWSpinLockT(RWSpinLockT<BackoffPolicy>& spinLock, AutoRWSpinLock::LockType lockType) 
+			: mSpinLock(spinLock), mLockType(lockType)
+		{ 
+			if(mLockType == AutoRWSpinLock::kLockTypeRead)
+				mSpinLock.ReadLock();
+			else if(mLockType == AutoRWSpinLock::kLockTypeWrite)
+				mSpinLock.WriteLock();
 			else
+				mSpinLock.UpgradeableReadLock();
+		}
+
+
+		template <typename BackoffPolicy>
+		inline
+		AutoRWSpinLockT<BackoffPolicy>::~AutoRWSpinLockT()
+		{ 
+			if(mLockType == AutoRWSpinLock::kLockTypeRead)
+				mSpinLock.ReadUnlock();
+			else if(mLockType == AutoRWSpinLock::kLockTypeWrite)
 				mSpinLock.WriteUnlock();
+			else
+				mSpinLock.UpgradeableReadUnlock();
+		}
+
+
+		template <typename BackoffPolicy>
+		inline
+		void AutoRWSpinLockT<BackoffPolicy>::Upgrade()
+		{
+			EAT_ASSERT(mLockType == AutoRWSpinLock::kLockTypeUpgradeableRead);
+			mSpinLock.Upgrade();
+			mLockType = AutoRWSpinLock::kLockTypeWrite;
+		}
+
+
+		template <typename BackoffPolicy>
+		inline
+		void AutoRWSpinLockT<BackoffPolicy>::Downgrade()
+		{
+			EAT_ASSERT(mLockType == AutoRWSpinLock::kLockTypeWrite);
+			mSpinLock.Downgrade();
+			mLockType = AutoRWSpinLock::kLockTypeRead;
 		}
 
 
@@ -46,6 +46,22 @@
 #endif
 
 
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_FUTEX_SEMAPHORE_ENABLED
+//
+// Defined as 0 or 1.
+// Enables an intra-process semaphore whose count is kept in user space, on
+// platforms where a thread can block on a word of memory (see
+// EATHREAD_FUTEX_WORD_AVAILABLE). Wait doesn't enter the kernel while the
+// count is positive, and Post(n) is a single atomic update plus, if there are
+// blocked waiters, a single system call that wakes up to n of them. Inter-process
+// semaphores still use the platform semaphore.
+//
+#ifndef EATHREAD_FUTEX_SEMAPHORE_ENABLED
+	#define EATHREAD_FUTEX_SEMAPHORE_ENABLED EATHREAD_FUTEX_WORD_AVAILABLE
+#endif
+
+
 /////////////////////////////////////////////////////////////////////////
 /// EASemaphoreData
 ///
@@ -120,7 +136,10 @@
 	struct EASemaphoreData
 	{
 		sem_t mSemaphore;
-		EA::Thread::AtomicInt32 mnCount;
+		EA::Thread::AtomicInt32 mnCount;        // With EATHREAD_FUTEX_SEMAPHORE_ENABLED and mbIntraProcess, this is the semaphore count itself and mSemaphore is unused.
+		#if EATHREAD_FUTEX_SEMAPHORE_ENABLED
+			EA::Thread::AtomicInt32 mnWaiterCount; // Number of threads blocked (or about to block) on mnCount. Lets Post skip the wake call.
+		#endif
 		int  mnMaxCount;
 		bool mbIntraProcess;
 
@@ -283,6 +302,7 @@ namespace EA
 
 			static size_t     GetSemaphoreSize();                       // Internally implemented as: return sizeof(Semaphore);
 			static Semaphore* ConstructSemaphore(void* pMemory);        // Internally implemented as: return new(pMemory) Semaphore;
+			static Semaphore* ConstructSemaphore(void* pMemory, const SemaphoreParameters* pSemaphoreParameters); // Internally implemented as: return new(pMemory) Semaphore(pSemaphoreParameters);
 			static void       DestructSemaphore(Semaphore* pSemaphore); // Internally implemented as: pSemaphore->~Semaphore();
 		};
 
@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Implements a counter for statistics which are updated by many threads.
+//
+// Incrementing a single AtomicInt from many threads makes every processor
+// fight for the cache line that holds it. ShardedCounter instead spreads
+// updates over a set of cache-line-sized shards, with each thread always
+// using the same shard, and sums the shards when the counter is read. 
+// Updates become cheap at the expense of reads, which suits event counters
+// that are written on every event and read once in a while.
+/////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef EATHREAD_EATHREAD_SHARDEDCOUNTER_H
+#define EATHREAD_EATHREAD_SHARDEDCOUNTER_H
+
+
+#include <EABase/eabase.h>
+#include <eathread/internal/config.h>
+#include <eathread/eathread_atomic.h>
+
+#if defined(EA_DLL) && defined(EA_COMPILER_MSVC)
+	// Suppress warning about class 'AtomicInt64' needs to have a
+	// dll-interface to be used by clients of class which have a templated member.
+	EA_DISABLE_VC_WARNING(4251)
+#endif
+
+#if defined(EA_PRAGMA_ONCE_SUPPORTED)
+	#pragma once // Some compilers (e.g. VC++) benefit significantly from using this. We've measured 3-4% build speed improvements in apps as a result.
+#endif
+
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		/// ShardedCounter
+		///
+		/// A 64 bit counter whose updates from different threads usually don't
+		/// touch the same cache line. 
+		///
+		/// Each shard occasionally folds its value into a central total once its
+		/// magnitude exceeds the fold threshold. GetApproximateValue reads only
+		/// the total, which makes it as cheap as reading an AtomicInt, at the cost
+		/// of lagging the exact value by up to GetShardCount() * fold threshold.
+		/// A fold threshold of 0 folds on every update, which gives an exact 
+		/// GetApproximateValue but gives up most of the benefit of sharding.
+		///
+		/// Values read while other threads are updating the counter are a 
+		/// snapshot of no particular instant, as with any sum of separate words.
+		/// Use an AtomicInt if readers make decisions based on exact values, such
+		/// as waiting for a count to drop to zero.
+		///
+		/// Example usage:
+		///     ShardedCounter gRequestCount;
+		///
+		///     gRequestCount.Increment();                          // In any thread, per request.
+		///     int64_t nRequests = gRequestCount.Reset();          // In a reporting thread, once per second.
+		///
+		class EATHREADLIB_API ShardedCounter
+		{
+		public:
+			static const int     kMaxShardCount        = 64;
+			static const int64_t kFoldThresholdDefault = 1024;
+
+			/// ShardedCounter
+			/// A shard count of 0 selects the processor count, rounded up to a power 
+			/// of two. Other counts are rounded up to a power of two as well, and all
+			/// are limited to kMaxShardCount.
+			ShardedCounter(int nShardCount = 0, int64_t nFoldThreshold = kFoldThresholdDefault);
+		   ~ShardedCounter();
+
+			/// Add
+			/// Adds n, which may be negative, to the counter.
+			void Add(int64_t n);
+
+			void Increment()
+				{ Add(1); }
+
+			void Decrement()
+				{ Add(-1); }
+
+			/// GetValue
+			/// Returns the sum of the total and all shards.
+			int64_t GetValue() const;
+
+			/// GetApproximateValue
+			/// Returns the total into which the shards fold. Doesn't read the shards.
+			int64_t GetApproximateValue() const
+				{ return mnTotal.GetValue(); }
+
+			/// Reset
+			/// Sets the counter to zero and returns the value it had. Each concurrent
+			/// update is counted either in the returned value or after the reset; 
+			/// none are lost. Thus Reset can be used to read counts per interval.
+			int64_t Reset();
+
+			/// GetShardCount
+			int GetShardCount() const
+				{ return mnShardMask + 1; }
+
+		protected:
+			EA_PREFIX_ALIGN(EATHREAD_CACHE_LINE_SIZE)
+			struct Shard
+			{
+				AtomicInt64 mnValue;
+			} EA_POSTFIX_ALIGN(EATHREAD_CACHE_LINE_SIZE);
+
+			Shard*      mpShardArray;
+			void*       mpShardMemory;
+			int         mnShardMask;
+			int64_t     mnFoldThreshold;
+			AtomicInt64 mnTotal;
+
+		private:
+			// Objects of this class are not copyable.
+			ShardedCounter(const ShardedCounter&);
+			ShardedCounter& operator=(const ShardedCounter&);
+		};
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+#if defined(EA_DLL) && defined(EA_COMPILER_MSVC)
+	// re-enable warning 4251 (it's a level-1 warning and should not be suppressed globally)
+	EA_RESTORE_VC_WARNING()
+#endif
+
+
+#endif // EATHREAD_EATHREAD_SHARDEDCOUNTER_H
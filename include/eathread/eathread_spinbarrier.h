@@ -0,0 +1,270 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Implements barriers for many-thread fork/join work, where a set of worker
+// threads meets at the barrier many times per second.
+//
+// Barrier takes a kernel mutex and broadcasts a condition variable (or posts
+// a semaphore) for each phase, which makes every thread block and be woken
+// by the kernel one after another. SpinBarrier and TreeBarrier instead keep
+// their state in atomic words: waiting threads poll for a short while before
+// parking, and the kernel is entered only if some thread actually parked.
+//
+// SpinBarrier is a sense-reversing barrier built on a single arrival
+// counter. TreeBarrier is a combining tree barrier, in which threads arrive
+// in small groups and only the last thread of each group moves up the tree,
+// so that no single counter is written by more than a handful of threads.
+// TreeBarrier is the better choice for more than roughly 16 participants.
+/////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef EATHREAD_EATHREAD_SPINBARRIER_H
+#define EATHREAD_EATHREAD_SPINBARRIER_H
+
+
+#include <EABase/eabase.h>
+#include <eathread/internal/config.h>
+#include <eathread/eathread.h>
+#include <eathread/eathread_atomic.h>
+#include <eathread/eathread_futex.h>
+
+#if !EATHREAD_FUTEX_WORD_AVAILABLE
+	#include <eathread/eathread_mutex.h>
+	#include <eathread/eathread_condition.h>
+#endif
+
+#if defined(EA_DLL) && defined(EA_COMPILER_MSVC)
+	// Suppress warning about class 'AtomicInt32' needs to have a
+	// dll-interface to be used by clients of class which have a templated member.
+	EA_DISABLE_VC_WARNING(4251)
+#endif
+
+#if defined(EA_PRAGMA_ONCE_SUPPORTED)
+	#pragma once // Some compilers (e.g. VC++) benefit significantly from using this. We've measured 3-4% build speed improvements in apps as a result.
+#endif
+
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		namespace detail
+		{
+			/// BarrierReleaseWord
+			///
+			/// This is used internally by SpinBarrier and TreeBarrier.
+			/// It holds the number of the barrier's current phase. Waiters poll it
+			/// for a while and then park on it; the primary thread of a phase
+			/// releases them by advancing the phase number.
+			///
+			class EATHREADLIB_API BarrierReleaseWord
+			{
+			public:
+				BarrierReleaseWord();
+
+				/// Returns the current phase number.
+				uint32_t GetPhase() const
+					{ return (uint32_t)mnWord.GetValue() >> 1; }
+
+				/// Waits until the phase is no longer nPhase. Polls up to nSpinCount
+				/// times before parking. Returns false if the timeout passed first.
+				bool Wait(uint32_t nPhase, int nSpinCount, const ThreadTime& timeoutAbsolute);
+
+				/// Sets the phase to nNewPhase and wakes any parked waiters.
+				void Release(uint32_t nNewPhase);
+
+			protected:
+				static const int32_t kWaitersFlag = 1; // Set while at least one waiter is parked.
+
+				AtomicInt32 mnWord;                    // (phase << 1) | kWaitersFlag
+
+				#if !EATHREAD_FUTEX_WORD_AVAILABLE
+					Mutex     mMutex;
+					Condition mCondition;
+				#endif
+
+			private:
+				BarrierReleaseWord(const BarrierReleaseWord&);
+				BarrierReleaseWord& operator=(const BarrierReleaseWord&);
+			};
+
+		} // namespace detail
+
+
+
+		/// SpinBarrier
+		///
+		/// A barrier with the same contract as Barrier -- including the primary
+		/// thread return value and timeout behaviour -- for intra-process use.
+		/// The height can be up to kMaxHeight.
+		///
+		/// Waiting threads poll for up to nSpinMicroseconds before parking in the
+		/// kernel. On single-processor systems they park right away, as there is
+		/// no other processor that could complete the phase while they poll.
+		/// The default suits fork/join work whose threads arrive within a few
+		/// microseconds of each other; use 0 for barriers at which threads
+		/// usually wait a long time.
+		///
+		/// Example usage:
+		///     SpinBarrier barrier(kWorkerCount);
+		///
+		///     // In each worker thread, once per frame step:
+		///     DoWork();
+		///     if(barrier.Wait() == SpinBarrier::kResultPrimary)
+		///         MergeResults();
+		///
+		class EATHREADLIB_API SpinBarrier
+		{
+		public:
+			enum Result{
+				kResultPrimary   =  0,  /// The barrier wait succeeded and this thread is the designated solitary primary thread.
+				kResultSecondary =  1,  /// The barrier wait succeeded and this thread is one of the secondary threads.
+				kResultError     = -1,  /// The barrier is not initialized.
+				kResultTimeout   = -2   /// The barrier wait timed out.
+			};
+
+			static const int kMaxHeight               = 65535;
+			static const int kSpinMicrosecondsDefault = 20;
+
+			/// SpinBarrier
+			/// For deferred initialization, use a height of 0 and later call Init.
+			SpinBarrier(int height = 0, int nSpinMicroseconds = kSpinMicrosecondsDefault);
+
+			/// Init
+			/// Sets the height and spin time. Must not be called while any thread
+			/// is waiting on the barrier. Returns false if height is out of range.
+			bool Init(int height, int nSpinMicroseconds = kSpinMicrosecondsDefault);
+
+			/// GetHeight
+			/// Returns the number of threads which must wait before all are released.
+			int GetHeight() const
+				{ return mnHeight; }
+
+			/// Wait
+			/// Causes the current thread to wait until the designated number of threads have called Wait.
+			/// Returns one of enum Result. The timeout is absolute, and a timed out thread gives up
+			/// its contribution to the height, exactly as with Barrier::Wait.
+			Result Wait(const ThreadTime& timeoutAbsolute = kTimeoutNone);
+
+		protected:
+			AtomicInt32                mnArrival;   // (phase << 16) | number of threads yet to arrive.
+			char                       mPadding[EATHREAD_CACHE_LINE_SIZE - sizeof(AtomicInt32)]; // Keeps arrivals from disturbing the pollers of mRelease.
+			detail::BarrierReleaseWord mRelease;
+			int                        mnHeight;
+			int                        mnSpinCount;
+
+		private:
+			// Objects of this class are not copyable.
+			SpinBarrier(const SpinBarrier&);
+			SpinBarrier& operator=(const SpinBarrier&);
+		};
+
+
+
+		/// TreeBarrier
+		///
+		/// A combining tree barrier for high participant counts. It has the same
+		/// contract as SpinBarrier, except that each participating thread
+		/// identifies itself by a participant index in the range of [0, height),
+		/// and at most one thread may use a given index at a time.
+		///
+		/// Participants are grouped into leaf nodes of nFanIn each, and the leaf
+		/// nodes are grouped in the same way into a tree. The last thread to
+		/// arrive at a node arrives on behalf of its group at the parent node, and
+		/// the thread which completes the root node is the primary thread. Other
+		/// threads poll the shared phase number only, which is written once per
+		/// phase. Each node occupies its own cache line.
+		///
+		/// Timeouts are more expensive than with SpinBarrier, as a thread whose
+		/// group has already moved up the tree must undo that under a lock.
+		/// They are meant for error recovery rather than for regular use.
+		///
+		/// Example usage:
+		///     TreeBarrier barrier(kWorkerCount);
+		///
+		///     // In worker thread i, once per frame step:
+		///     DoWork(i);
+		///     if(barrier.Wait(i) == TreeBarrier::kResultPrimary)
+		///         MergeResults();
+		///
+		class EATHREADLIB_API TreeBarrier
+		{
+		public:
+			enum Result{
+				kResultPrimary   =  0,  /// The barrier wait succeeded and this thread is the designated solitary primary thread.
+				kResultSecondary =  1,  /// The barrier wait succeeded and this thread is one of the secondary threads.
+				kResultError     = -1,  /// The barrier is not initialized or the participant index is out of range.
+				kResultTimeout   = -2   /// The barrier wait timed out.
+			};
+
+			static const int kFanInDefault = 4;
+			static const int kMaxFanIn     = 64;
+
+			/// TreeBarrier
+			/// For deferred initialization, use a height of 0 and later call Init.
+			TreeBarrier(int height = 0, int nFanIn = kFanInDefault, int nSpinMicroseconds = SpinBarrier::kSpinMicrosecondsDefault);
+
+			/// ~TreeBarrier
+			/// The TreeBarrier must not be waited on by any thread when destroyed.
+		   ~TreeBarrier();
+
+			/// Init
+			/// Sets the height, fan-in and spin time. Must not be called while any thread
+			/// is waiting on the barrier. Returns false if an argument is out of range or
+			/// the tree could not be allocated.
+			bool Init(int height, int nFanIn = kFanInDefault, int nSpinMicroseconds = SpinBarrier::kSpinMicrosecondsDefault);
+
+			/// GetHeight
+			/// Returns the number of threads which must wait before all are released.
+			int GetHeight() const
+				{ return mnHeight; }
+
+			/// Wait
+			/// Causes the current thread, as participant nParticipant, to wait until all
+			/// participants have called Wait. Returns one of enum Result. The timeout is
+			/// absolute, and a timed out thread gives up its contribution to the height.
+			Result Wait(int nParticipant, const ThreadTime& timeoutAbsolute = kTimeoutNone);
+
+		protected:
+			EA_PREFIX_ALIGN(EATHREAD_CACHE_LINE_SIZE)
+			struct Node
+			{
+				AtomicInt32 mnState;      // (phase << 8) | number of children yet to arrive, or kCountPropagated.
+				int         mnParent;     // Index of the parent node, or -1 for the root.
+				int         mnChildCount; // Number of participants (for leaves) or nodes that arrive here.
+			} EA_POSTFIX_ALIGN(EATHREAD_CACHE_LINE_SIZE);
+
+			bool Arrive(Node& node, uint32_t nPhase);
+			bool Withdraw(int nLeaf, uint32_t nPhase);
+			void FreeNodes();
+
+			Node*                      mpNodeArray;
+			void*                      mpNodeMemory;
+			int                        mnNodeCount;
+			int                        mnHeight;
+			int                        mnFanIn;
+			int                        mnSpinCount;
+			Futex                      mWithdrawalFutex; // Serializes timeouts.
+			detail::BarrierReleaseWord mRelease;
+
+		private:
+			// Objects of this class are not copyable.
+			TreeBarrier(const TreeBarrier&);
+			TreeBarrier& operator=(const TreeBarrier&);
+		};
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+#if defined(EA_DLL) && defined(EA_COMPILER_MSVC)
+	// re-enable warning 4251 (it's a level-1 warning and should not be suppressed globally)
+	EA_RESTORE_VC_WARNING()
+#endif
+
+
+#endif // EATHREAD_EATHREAD_SPINBARRIER_H
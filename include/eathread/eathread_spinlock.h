@@ -63,11 +63,47 @@
 	// We provide an implementation that works for all systems but is less optimal.
 	#include <eathread/eathread_sync.h>
 	#include <eathread/eathread_atomic.h>
+	#include <eathread/eathread_backoff.h>
 
 	namespace EA
 	{
 		namespace Thread
 		{
+			/// class SpinLockT
+			///
+			/// Implements SpinLock with a configurable backoff policy, which decides
+			/// how long a waiter waits between polls of the lock. See eathread_backoff.h
+			/// for the available policies. Most users will want to use SpinLock, which
+			/// is SpinLockT<BackoffNone>. A policy such as BackoffExponential can
+			/// significantly reduce coherence traffic when many processors contend
+			/// for the same lock.
+			///
+			/// Example usage:
+			///     SpinLockT< BackoffExponential<> > gLock;
+			///
+			///     void Function() {
+			///         AutoSpinLockT< BackoffExponential<> > autoLock(gLock);
+			///         // Do something
+			///     }
+			///
+			template <typename BackoffPolicy>
+			class SpinLockT
+			{
+			protected: // Declared at the top because otherwise some compilers fail to compile inline functions below.
+				AtomicInt32 mAI;  /// A value of 0 means unlocked, while 1 means locked.
+
+			public:
+				SpinLockT();
+
+				void Lock();
+				bool TryLock();
+				bool IsLocked();
+				void Unlock();
+
+				void* GetPlatformData();
+			};
+
+
 			/// class SpinLock
 			///
 			/// Spinlocks are high-performance locks designed for special circumstances.
@@ -89,20 +125,8 @@
 			/// higher performance than general mutexes, especially on platforms where mutex
 			/// locking is particularly expensive or on multiprocessing systems.
 			///
-			class SpinLock
+			class SpinLock : public SpinLockT<BackoffNone>
 			{
-			protected: // Declared at the top because otherwise some compilers fail to compile inline functions below.
-				AtomicInt32 mAI;  /// A value of 0 means unlocked, while 1 means locked.
-
-			public:
-				SpinLock();
-
-				void Lock();
-				bool TryLock();
-				bool IsLocked();
-				void Unlock();
-
-				void* GetPlatformData();
 			};
 
 
@@ -158,6 +182,25 @@ namespace EA
 			const AutoSpinLock& operator=(const AutoSpinLock&);
 		};
 
+
+		/// class AutoSpinLockT
+		/// The equivalent of AutoSpinLock for SpinLockT.
+		template <typename BackoffPolicy>
+		class AutoSpinLockT
+		{
+		public:
+			AutoSpinLockT(SpinLockT<BackoffPolicy>& spinLock);
+		   ~AutoSpinLockT();
+
+		protected:
+			SpinLockT<BackoffPolicy>& mSpinLock;
+
+		protected:
+			// Prevent copying by default, as copying is dangerous.
+			AutoSpinLockT(const AutoSpinLockT&);
+			const AutoSpinLockT& operator=(const AutoSpinLockT&);
+		};
+
 	} // namespace Thread
 
 } // namespace EA
@@ -179,18 +222,22 @@ namespace EA
 
 
 		///////////////////////////////////////////////////////////////////////
-		// SpinLock
+		// SpinLockT
 		///////////////////////////////////////////////////////////////////////
 
+		template <typename BackoffPolicy>
 		inline
-		SpinLock::SpinLock() 
+		SpinLockT<BackoffPolicy>::SpinLockT() 
 		  : mAI(0)
 		{
 		}
 
+		template <typename BackoffPolicy>
 		inline
-		void SpinLock::Lock()
+		void SpinLockT<BackoffPolicy>::Lock()
 		{
+			BackoffPolicy backoff;
+
 			Top: // Due to modern processor branch prediction, the compiler will optimize better for true branches and so we do a manual goto loop here.
 			if(mAI.SetValueConditional(1, 0))
 				return;
@@ -200,37 +247,35 @@ namespace EA
 			// thus we benefit by polling before attempting the real thing.
 			// This is a common practice and is recommended by Intel, etc.
 			while (mAI.GetValue() != 0)
-			{
-			#ifdef EA_THREAD_COOPERATIVE
-				ThreadSleep();
-			#else
-				EAProcessorPause();
-			#endif
-			}
+				backoff.Pause();
 			goto Top;                                          
 		}                                                
 
+		template <typename BackoffPolicy>
 		inline
-		bool SpinLock::TryLock()
+		bool SpinLockT<BackoffPolicy>::TryLock()
 		{
 			return mAI.SetValueConditional(1, 0);
 		}
 
+		template <typename BackoffPolicy>
 		inline
-		bool SpinLock::IsLocked()
+		bool SpinLockT<BackoffPolicy>::IsLocked()
 		{
 			return mAI.GetValueRaw() != 0;
 		}
 
+		template <typename BackoffPolicy>
 		inline
-		void SpinLock::Unlock()
+		void SpinLockT<BackoffPolicy>::Unlock()
 		{
 			EAT_ASSERT(IsLocked());
 			mAI.SetValue(0);
 		}
 
+		template <typename BackoffPolicy>
 		inline
-		void* SpinLock::GetPlatformData()
+		void* SpinLockT<BackoffPolicy>::GetPlatformData()
 		{
 			return &mAI;
 		}
@@ -299,6 +344,26 @@ namespace EA
 			mSpinLock.Unlock();
 		}
 
+
+		///////////////////////////////////////////////////////////////////////
+		// AutoSpinLockT
+		///////////////////////////////////////////////////////////////////////
+
+		template <typename BackoffPolicy>
+		inline
+		AutoSpinLockT<BackoffPolicy>::AutoSpinLockT(SpinLockT<BackoffPolicy>& spinLock) 
+		  : mSpinLock(spinLock)
+		{
+			mSpinLock.Lock();
+		}
+
+		template <typename BackoffPolicy>
+		inline
+		AutoSpinLockT<BackoffPolicy>::~AutoSpinLockT()
+		{
+			mSpinLock.Unlock();
+		}
+
 	} // namespace Thread
 
 } // namespace EA
@@ -22,6 +22,7 @@
 
 EA_DISABLE_VC_WARNING(4574)
 #include <stddef.h>
+#include <new>
 EA_RESTORE_VC_WARNING()
 
 #if defined(EA_PRAGMA_ONCE_SUPPORTED)
@@ -139,6 +140,26 @@ namespace EA
 
 
 
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_TLS_SLOT_VECTOR_ENABLED
+//
+// Defined as 0 or 1.
+// If enabled, ThreadLocalStorage doesn't use a pthread key per object. Instead
+// each object gets a slot id at construction, and each thread has a single
+// EA_THREAD_LOCAL pointer to its own vector of slots, which grows as needed.
+// GetValue is then a load of the thread's vector pointer plus a load of the
+// slot, and the number of ThreadLocalStorage objects isn't limited by
+// PTHREAD_KEYS_MAX. Slot ids are reused after their ThreadLocalStorage is
+// destroyed. A thread's vector is freed when the thread exits.
+//
+#ifndef EATHREAD_TLS_SLOT_VECTOR_ENABLED
+	#if defined(EA_THREAD_LOCAL) && EA_THREADS_AVAILABLE && defined(EA_PLATFORM_UNIX) && !defined(EA_PLATFORM_APPLE) && !defined(EA_PLATFORM_SONY)
+		#define EATHREAD_TLS_SLOT_VECTOR_ENABLED 1
+	#else
+		#define EATHREAD_TLS_SLOT_VECTOR_ENABLED 0
+	#endif
+#endif
+
 
 
 /////////////////////////////////////////////////////////////////////////
@@ -155,6 +176,14 @@ namespace EA
 		ScePthreadKey mKey;     // This is usually a pointer.
 		int           mResult;  // Result of call to scePthreadKeyCreate, so we can know if mKey is valid.
 	};
+#elif EATHREAD_TLS_SLOT_VECTOR_ENABLED
+	#include <EABase/eabase.h>
+
+	struct EAThreadLocalStorageData{
+		uint32_t mnSlot;        // Index into each thread's slot vector.
+		uint32_t mnGeneration;  // Distinguishes this object's values from those of earlier users of the same slot id. Never 0.
+	};
+
 #elif (defined(EA_PLATFORM_UNIX) || EA_POSIX_THREADS_AVAILABLE) && !defined(CS_UNDEFINED_STRING)
 	// In this case we will be using pthread_key_create, pthread_key_delete, pthread_getspecific, pthread_setspecific.
 	#include <pthread.h>
@@ -232,7 +261,9 @@ namespace EA
 		///
 		/// The implementation behind this class maps to the PThreads API under
 		/// Unix-like systems, maps to the Windows TLS SPI under Windows, and 
-		/// maps to a custom implementation otherwise. The PThreads API has a 
+		/// maps to a custom implementation otherwise. Where 
+		/// EATHREAD_TLS_SLOT_VECTOR_ENABLED, it instead maps to a per-thread slot
+		/// vector, which allows for any number of ThreadLocalStorage objects. The PThreads API has a 
 		/// mechanism whereby you can set a callback to execute when a thread
 		/// exits; the callback will call the callback once for each pointer 
 		/// that was stored in all thread local storage objects. Due to the 
@@ -314,37 +345,132 @@ namespace EA
 
 
 
-		// ThreadLocalPointer
-		// This is a class that adds pointer type awareness to ThreadLocalStorage.
-		// The interface is designed to look like the standard auto_ptr class.
-		//
-		// The following is disabled until we provide a way to enumerate and delete
-		// the pointers when the object goes out of scope or delete the thread-specific 
-		// pointer when the thread ends. Both are require before this class fully acts
-		// as one would expect.
-		//
-		//template <typename T>
-		//class ThreadLocalPointer
-		//{
-		//public:
-		//    T* get()        const { return  static_cast<T*>(mTLS.GetValue()); }
-		//    T* operator->() const { return  static_cast<T*>(mTLS.GetValue()); }
-		//    T& operator*()  const { return *static_cast<T*>(mTLS.GetValue()); }
-		//    void reset(T* pNew = 0){
-		//        T* const pTemp = get();
-		//        if(pNew != pTemp){
-		//            delete pTemp;
-		//            mTLS.SetValue(pTemp);
-		//        }
-		//    }
-		//
-		//protected:
-		//    ThreadLocalStorage mTLS;
-		//
-		//private:
-		//    ThreadLocalPointer(const ThreadLocalPointer&);
-		//    const ThreadLocalPointer& operator=(const ThreadLocalPointer&);
-		//};
+		/// DestroyThreadLocalPointers
+		///
+		/// Destroys the calling thread's instances of all ThreadLocalPointer objects.
+		/// This is done automatically at thread exit on platforms with PThreads, for
+		/// any thread, and for threads started by EA::Thread::Thread on Windows. Other
+		/// threads should call this before they exit; otherwise their instances live
+		/// until the ThreadLocalPointer objects themselves are destroyed.
+		///
+		EATHREADLIB_API void DestroyThreadLocalPointers();
+
+
+
+		/// ThreadLocalPointerBase
+		///
+		/// Implements the type-independent part of ThreadLocalPointer. 
+		/// Instances are found through a ThreadLocalStorage, and are additionally 
+		/// kept in one list per ThreadLocalPointer and one list per thread, so that
+		/// they can be enumerated and destroyed. The lists are protected by a single
+		/// library-wide lock, which is never taken by lookups of existing instances.
+		///
+		class EATHREADLIB_API ThreadLocalPointerBase
+		{
+		public:
+			typedef void (*ConstructFunction)(void* pMemory);
+			typedef void (*DestructFunction)(void* pObject);
+			typedef void (*EnumerateFunction)(void* pObject, void* pContext);
+
+			/// GetInstanceCount
+			/// Returns the number of threads which currently have an instance.
+			size_t GetInstanceCount() const;
+
+		protected:
+			ThreadLocalPointerBase(size_t nObjectSize, size_t nObjectAlignment, ConstructFunction pConstruct, DestructFunction pDestruct);
+		   ~ThreadLocalPointerBase();
+
+			void* GetInstance()
+			{
+				void* const pNode = mTLS.GetValue();
+				return pNode ? (static_cast<char*>(pNode) + mnObjectOffset) : CreateInstance();
+			}
+
+			void* GetExistingInstance()
+			{
+				void* const pNode = mTLS.GetValue();
+				return pNode ? (static_cast<char*>(pNode) + mnObjectOffset) : NULL;
+			}
+
+			void* CreateInstance();
+			void  DestroyInstance();
+			void  EnumerateInstances(EnumerateFunction pFunction, void* pContext);
+
+			ThreadLocalStorage mTLS;            // The calling thread's instance header. The instance itself follows it at mnObjectOffset.
+			void*              mpInstanceList;  // All instances of this ThreadLocalPointer.
+			size_t             mnObjectSize;
+			size_t             mnObjectAlignment;
+			size_t             mnObjectOffset;
+			ConstructFunction  mpConstruct;
+			DestructFunction   mpDestruct;
+
+		private:
+			// Disable copy and assignment
+			ThreadLocalPointerBase(const ThreadLocalPointerBase&);
+			ThreadLocalPointerBase& operator=(const ThreadLocalPointerBase&);
+		};
+
+
+
+		/// ThreadLocalPointer
+		///
+		/// Holds one default-constructed instance of T per thread. A thread's 
+		/// instance is constructed on its first access, and is destructed when 
+		/// the thread exits (see DestroyThreadLocalPointers), when the thread calls
+		/// reset, or when the ThreadLocalPointer is destructed, whichever is first.
+		/// The interface is designed to look like the standard auto_ptr class.
+		///
+		/// enumerate visits the instances of all threads, which allows per-thread
+		/// data such as statistics to be updated without atomic operations and
+		/// aggregated only when read. Instances are not destructed while they are
+		/// being visited, but their owning threads may be modifying them, so the
+		/// visited data must be safe to read concurrently (e.g. aligned words).
+		///
+		/// Example usage:
+		///     struct Stats { uint64_t mnRequestCount; Stats() : mnRequestCount(0) {} };
+		///     ThreadLocalPointer<Stats> gStats;
+		///
+		///     gStats->mnRequestCount++;   // In any thread. Lock-free after the first use.
+		///
+		///     uint64_t nTotal = 0;
+		///     gStats.enumerate([&](Stats& stats){ nTotal += stats.mnRequestCount; });
+		///
+		template <typename T>
+		class ThreadLocalPointer : public ThreadLocalPointerBase
+		{
+		public:
+			ThreadLocalPointer()
+				: ThreadLocalPointerBase(sizeof(T), EA_ALIGN_OF(T), &Construct, &Destruct) {}
+
+			/// Returns the calling thread's instance, constructing it if necessary.
+			/// Returns NULL only if the instance could not be allocated.
+			T* get()         { return  static_cast<T*>(GetInstance()); }
+			T* operator->()  { return  static_cast<T*>(GetInstance()); }
+			T& operator*()   { return *static_cast<T*>(GetInstance()); }
+
+			/// Returns the calling thread's instance, or NULL if it has none.
+			T* peek()        { return  static_cast<T*>(GetExistingInstance()); }
+
+			/// Destructs the calling thread's instance, if any. A later access constructs a new one.
+			void reset()     { DestroyInstance(); }
+
+			/// Calls function(T&) for the instance of every thread which has one.
+			/// function must not create or destroy ThreadLocalPointer instances.
+			template <typename Function>
+			void enumerate(Function function)
+				{ EnumerateInstances(&EnumerateThunk<Function>, &function); }
+
+		protected:
+			static void Construct(void* pMemory)
+				{ new(pMemory) T(); }
+
+			static void Destruct(void* pObject)
+				{ static_cast<T*>(pObject)->~T(); }
+
+			template <typename Function>
+			static void EnumerateThunk(void* pObject, void* pContext)
+				{ (*static_cast<Function*>(pContext))(*static_cast<T*>(pObject)); }
+		};
 		/////////////////////////////////////////////////////////////////////////
 
 
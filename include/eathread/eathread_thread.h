@@ -8,6 +8,7 @@
 #include <eathread/eathread.h>
 #include <eathread/eathread_semaphore.h>
 #include <eathread/eathread_atomic.h>
+#include <eathread/internal/eathread_callable.h>
 EA_DISABLE_ALL_VC_WARNINGS()
 #include <stddef.h>
 #include <stdlib.h>
@@ -190,7 +191,7 @@ EA_RESTORE_ALL_VC_WARNINGS()
 		pid_t                   mThreadPid;                     // For Linux this is the thread ID from gettid(). Otherwise it's the getpid() value.
 		volatile int            mnStatus;
 		intptr_t                mnReturnValue;
-		void*                   mpStartContext[2];
+		void*                   mpStartContext[3];             // The function or IRunnable, its context, and (for Thread::BeginGroup) the group start data.
 		void*                   mpBeginThreadUserWrapper;       // User-specified BeginThread function wrapper or class wrapper
 		void*                   mpStackBase; 
 		EA::Thread::AtomicInt32 mnRefCount;
@@ -199,6 +200,10 @@ EA_RESTORE_ALL_VC_WARNINGS()
 		EA::Thread::ThreadAffinityMask      mnThreadAffinityMask; // mStartupProcessor is deprecated in favor of using the the mnThreadAffinityMask and doesn't suffer from the limitations of only specifying the value at thread startup time.
 		EA::Thread::Mutex       mRunMutex;                      // Locked while the thread is running. The reason for this mutex is that it allows timeouts to be specified in the WaitForEnd function.
 		EA::Thread::Semaphore   mStartedSemaphore;              // Signaled when the thread starts. This allows us to know in a thread-safe way when the thread has actually started executing.
+		#if EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+		EA::Thread::ThreadScheduling mScheduling;               // The scheduling for the thread to apply to itself when it starts.
+		EA::Thread::AtomicInt32      mnSchedulingResult;        // The ThreadSchedulingResult of applying mScheduling.
+		#endif
 	};
 
 
@@ -410,6 +415,7 @@ namespace EA
 			const char* mpName;                                        /// A name to give to the thread. Useful for identifying threads in a descriptive way.
 			EA::Thread::ThreadAffinityMask mnAffinityMask;             /// A bitmask representing the cores that the thread is allowed to run on.  NOTE:  This affinity mask is only applied when mnProcessor is set to kProcessorAny.
 			bool        mbDisablePriorityBoost;                        /// Whether the system should override the default behavior of boosting the thread priority as they come out of a wait state (currently only supported on Windows).
+			ThreadScheduling mScheduling;                              /// The scheduling policy for the thread to apply to itself when it starts, which if not kThreadSchedulingPolicyDefault replaces mnPriority. See Thread::GetSchedulingResult (currently only supported where EATHREAD_SCHEDULING_POLICIES_AVAILABLE).
 
 			ThreadParameters();
 		};
@@ -519,6 +525,64 @@ namespace EA
 			/// \sa RunnableClassUserWrapper
 			ThreadId Begin(IRunnable* pRunnable, void* pContext = NULL, const ThreadParameters* pThreadParameters = NULL, RunnableClassUserWrapper pUserWrapper = GetGlobalRunnableClassUserWrapper());
 
+			/// Begin
+			/// Starts a thread which calls a callable object, such as a lambda with captures.
+			/// The callable takes no arguments. Its return value is the thread's return value if
+			/// it converts to intptr_t; otherwise, as with void, the thread returns 0.
+			/// A copy of it is moved to memory from the EAThread allocator and destroyed
+			/// when it returns. Returns kThreadIdInvalid if that memory couldn't be
+			/// allocated. Otherwise this works as the RunnableFunction version.
+			///
+			/// Example usage:
+			///     thread.Begin([&queue]{ return queue.ProcessAll(); });
+			template <typename Callable, typename = typename detail::EnableIfCallableObject<Callable, RunnableFunction>::type>
+			ThreadId Begin(Callable&& callable, const ThreadParameters* pThreadParameters = NULL, RunnableFunctionUserWrapper pUserWrapper = GetGlobalRunnableFunctionUserWrapper())
+			{
+				typedef std::decay_t<Callable> T;
+
+				detail::CallableBlock<T>* const pBlock = detail::NewCallable<T>(std::forward<Callable>(callable));
+
+				if(!pBlock)
+					return kThreadIdInvalid;
+
+				const ThreadId threadId = Begin(&detail::RunAndDeleteCallable<T>, pBlock, pThreadParameters, pUserWrapper);
+
+				if(threadId == kThreadIdInvalid)
+					detail::DeleteCallable(pBlock);
+				return threadId;
+			}
+
+			/// BeginGroup
+			/// Starts nThreadCount threads, one for each of the first nThreadCount objects
+			/// in pThreadArray, which all call pFunction. Thread i gets pContextArray[i]
+			/// as its context, or NULL if pContextArray is NULL. Returns the number of
+			/// threads started; a Thread object whose thread couldn't be started has an id
+			/// of kThreadIdInvalid.
+			///
+			/// All the threads are started with the one pThreadParameters, with these differences:
+			///     - If mpName is set, then thread i is named mpName followed by a space and i.
+			///     - If mnProcessor is a processor number, then thread i is given processor mnProcessor + i,
+			///       wrapped around by the processor count, so that the threads are spread over processors.
+			///     - mpStack must be NULL, as the threads can't share a stack.
+			///
+			/// On Unix, each thread sets its own name and affinity after it starts, and the caller
+			/// waits for one count of the threads yet to start to reach zero, rather than waiting
+			/// for each thread in turn as Begin does. The threads have all started and set their
+			/// names and affinities by the time this returns. On other platforms this calls Begin
+			/// for each thread.
+			///
+			/// Example usage:
+			///     Thread workerArray[16];
+			///     void*  contextArray[16];
+			///     ThreadParameters parameters;
+			///     parameters.mpName = "Worker";
+			///
+			///     for(int i = 0; i < 16; i++)
+			///         contextArray[i] = &workerDataArray[i];
+			///     Thread::BeginGroup(workerArray, 16, WorkerFunction, contextArray, &parameters);
+			static size_t BeginGroup(Thread* pThreadArray, size_t nThreadCount, RunnableFunction pFunction, void* const* pContextArray = NULL, 
+									 const ThreadParameters* pThreadParameters = NULL, RunnableFunctionUserWrapper pUserWrapper = GetGlobalRunnableFunctionUserWrapper());
+
 			/// WaitForEnd
 			/// Waits for the thread associated with an object of this class
 			/// to end. Returns one of enum Status to indicate the status upon
@@ -594,6 +658,20 @@ namespace EA
 			/// be considered in the future.
 			bool SetPriority(int priority);
 
+			#if EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+				/// SetScheduling
+				/// Sets the scheduling policy of the thread. See SetThreadScheduling.
+				/// Returns kThreadSchedulingResultInvalid if the thread hasn't begun.
+				ThreadSchedulingResult SetScheduling(const ThreadScheduling& scheduling);
+
+				/// GetSchedulingResult
+				/// Returns the result of the thread applying ThreadParameters::mScheduling
+				/// to itself when it started, or kThreadSchedulingResultPending if it
+				/// hasn't started yet. A thread whose scheduling couldn't be applied runs
+				/// with the default policy.
+				ThreadSchedulingResult GetSchedulingResult() const;
+			#endif
+
 			/// SetProcessor
 			/// Sets the processor the given thread should run on. Valid values 
 			/// are kThreadProcessorDefault, kThreadProcessorAny, or a processor
@@ -745,39 +823,8 @@ namespace EA
 		template <typename F>
 		auto MakeThread(F&& f, const EA::Thread::ThreadParameters& params = EA::Thread::ThreadParameters())
 		{
-			typedef std::decay_t<F> decayed_f_t;
-
-			auto get_memory = [] 
-			{
-				const auto sz = sizeof(decayed_f_t);
-				auto* pAllocator = EA::Thread::GetAllocator();
-
-				if(pAllocator)
-					return pAllocator->Alloc(sz);
-				else
-					return malloc(sz);
-			};
-
-			auto thread_enty = [](void* pMemory) -> intptr_t
-			{
-				auto free_memory = [](void* p)
-				{
-					auto* pAllocator = EA::Thread::GetAllocator();
-					if(pAllocator)
-						return pAllocator->Free(p);
-					else
-						return free(p);
-				};
-
-				auto* pF = reinterpret_cast<decayed_f_t*>(pMemory);
-				(*pF)();
-				pF->~decayed_f_t();
-				free_memory(pF);
-				return 0;
-			};
-
 			EA::Thread::Thread thread;
-			thread.Begin(thread_enty, new(get_memory()) decayed_f_t(std::forward<F>(f)), &params);  // deleted in the thread entry function
+			thread.Begin(std::forward<F>(f), &params);  // The callable is destroyed by the thread when it returns.
 			return thread;
 		}
 
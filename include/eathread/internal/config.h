@@ -500,6 +500,124 @@ EA_RESTORE_VC_WARNING()
 #endif
 
 
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_FRAME_POINTER_CALLSTACK_AVAILABLE
+//
+// Defined as 0 or 1.
+// Identifies whether GetCallstackFromFramePointers and SetCallstackUnwinder 
+// are available. These read callstacks by following the chain of saved frame
+// pointers, which is much faster than reading the compiler's unwind tables,
+// but works only for code compiled with -fno-omit-frame-pointer.
+//
+#ifndef EATHREAD_FRAME_POINTER_CALLSTACK_AVAILABLE
+	#if defined(EA_PLATFORM_LINUX) && !defined(EA_PLATFORM_ANDROID) && !defined(EA_PLATFORM_CYGWIN) && (defined(EA_COMPILER_GNUC) || defined(EA_COMPILER_CLANG)) && \
+		(defined(EA_PROCESSOR_X86) || defined(EA_PROCESSOR_X86_64) || defined(EA_PROCESSOR_ARM64)) && EATHREAD_GETCALLSTACK_SUPPORTED
+		#define EATHREAD_FRAME_POINTER_CALLSTACK_AVAILABLE 1
+	#else
+		#define EATHREAD_FRAME_POINTER_CALLSTACK_AVAILABLE 0
+	#endif
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_MODULE_MAP_AVAILABLE
+//
+// Defined as 0 or 1.
+// Identifies whether GetModuleFromAddress and GetModuleHandleFromAddress are 
+// implemented with a cached table of the loaded modules, built with 
+// dl_iterate_phdr, and whether UpdateModuleMap is available.
+//
+#ifndef EATHREAD_MODULE_MAP_AVAILABLE
+	#if defined(EA_PLATFORM_LINUX) && !defined(EA_PLATFORM_ANDROID) && !defined(EA_PLATFORM_CYGWIN) && (defined(EA_COMPILER_GNUC) || defined(EA_COMPILER_CLANG))
+		#define EATHREAD_MODULE_MAP_AVAILABLE 1
+	#else
+		#define EATHREAD_MODULE_MAP_AVAILABLE 0
+	#endif
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+//
+// Defined as 0 or 1.
+// Identifies whether SetThreadScheduling and GetThreadScheduling are available,
+// and whether ThreadParameters::mScheduling is applied to new threads. This is 
+// so on Linux, which has real-time (SCHED_FIFO, SCHED_RR), deadline 
+// (SCHED_DEADLINE, since 3.14) and background (SCHED_BATCH, SCHED_IDLE) policies.
+//
+#ifndef EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+	#if defined(EA_PLATFORM_LINUX) && !defined(EA_PLATFORM_CYGWIN) && EA_THREADS_AVAILABLE && EA_POSIX_THREADS_AVAILABLE && !EA_USE_CPP11_CONCURRENCY
+		#define EATHREAD_SCHEDULING_POLICIES_AVAILABLE 1
+	#else
+		#define EATHREAD_SCHEDULING_POLICIES_AVAILABLE 0
+	#endif
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_THREAD_CALLSTACK_AVAILABLE
+//
+// Defined as 0 or 1.
+// Identifies whether GetCallstack can read the callstack of another running
+// thread by its ThreadId, and whether GetThreadCallstacks is available.
+// On Linux this works by interrupting the thread with EATHREAD_CALLSTACK_SIGNAL
+// and having it read its own callstack from the signal handler.
+//
+#ifndef EATHREAD_THREAD_CALLSTACK_AVAILABLE
+	#if defined(EA_PLATFORM_LINUX) && !defined(EA_PLATFORM_ANDROID) && !defined(EA_PLATFORM_CYGWIN) && EATHREAD_GETCALLSTACK_SUPPORTED && EA_THREADS_AVAILABLE && EA_POSIX_THREADS_AVAILABLE && !EA_USE_CPP11_CONCURRENCY
+		#define EATHREAD_THREAD_CALLSTACK_AVAILABLE 1
+	#else
+		#define EATHREAD_THREAD_CALLSTACK_AVAILABLE 0
+	#endif
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_CALLSTACK_SIGNAL
+//
+// Defined as a signal number.
+// The signal with which EATHREAD_THREAD_CALLSTACK_AVAILABLE interrupts threads.
+// SIGURG is ignored by default, so a signal which arrives after its request
+// timed out does no harm. Signals which the application sends itself are 
+// passed on to any handler it installed before ours.
+//
+#if EATHREAD_THREAD_CALLSTACK_AVAILABLE && !defined(EATHREAD_CALLSTACK_SIGNAL)
+	#define EATHREAD_CALLSTACK_SIGNAL SIGURG
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_PROFILER_AVAILABLE
+//
+// Defined as 0 or 1.
+// Identifies whether the sampling Profiler (eathread_profiler.h) is available.
+// It samples each thread with a timer on the thread's CPU time clock, which 
+// delivers EATHREAD_PROFILER_SIGNAL to that thread.
+//
+#ifndef EATHREAD_PROFILER_AVAILABLE
+	#if EATHREAD_THREAD_CALLSTACK_AVAILABLE
+		#define EATHREAD_PROFILER_AVAILABLE 1
+	#else
+		#define EATHREAD_PROFILER_AVAILABLE 0
+	#endif
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_PROFILER_SIGNAL
+//
+// Defined as a signal number.
+// The signal which the Profiler's timers send to the threads they sample.
+// Once a Profiler has been started, the handler stays installed, so that 
+// signals from timers which expired just before the Profiler stopped do no
+// harm. Signals from other sources are passed on to any handler installed
+// before ours.
+//
+#if EATHREAD_PROFILER_AVAILABLE && !defined(EATHREAD_PROFILER_SIGNAL)
+	#define EATHREAD_PROFILER_SIGNAL SIGPROF
+#endif
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // EATHREAD_DEBUG_DETAIL_ENABLED
 //
@@ -598,6 +716,74 @@ EA_RESTORE_VC_WARNING()
 #endif
 
 
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_CACHE_LINE_SIZE
+//
+// Defined as a power of two number of bytes.
+// Used to pad and align data that is written by one thread and polled by
+// another, so that unrelated writers don't invalidate each other's cache lines.
+//
+#ifndef EATHREAD_CACHE_LINE_SIZE
+	#if defined(EA_CACHE_LINE_SIZE)
+		#define EATHREAD_CACHE_LINE_SIZE EA_CACHE_LINE_SIZE
+	#else
+		#define EATHREAD_CACHE_LINE_SIZE 64
+	#endif
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_FUTEX_WORD_AVAILABLE
+//
+// Defined as 0 or 1.
+// Indicates whether the platform lets a thread block directly on a 32 bit
+// word in user memory until another thread changes it (e.g. Linux futex(2)).
+// When available, some primitives park on words of their own state instead of
+// on separate kernel synchronization objects. See eathread_futexword.h.
+//
+#ifndef EATHREAD_FUTEX_WORD_AVAILABLE
+	#if defined(EA_PLATFORM_LINUX) && !defined(EA_PLATFORM_ANDROID) && !defined(EA_PLATFORM_CYGWIN) && EA_THREADS_AVAILABLE
+		#define EATHREAD_FUTEX_WORD_AVAILABLE 1
+	#else
+		#define EATHREAD_FUTEX_WORD_AVAILABLE 0
+	#endif
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+//
+// Defined as 0 or 1.
+// Indicates whether named POSIX shared memory (shm_open) and process-shared
+// pthread objects are available. When available, Shared<T> and RWMutexIP
+// (eathread_rwmutex_ip.h) are implemented with them and work between processes.
+//
+#ifndef EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+	#if defined(EA_PLATFORM_LINUX) && !defined(EA_PLATFORM_ANDROID) && !defined(EA_PLATFORM_CYGWIN) && EA_POSIX_THREADS_AVAILABLE
+		#define EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE 1
+	#else
+		#define EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE 0
+	#endif
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// EATHREAD_ROBUST_MUTEX_AVAILABLE
+//
+// Defined as 0 or 1.
+// Indicates whether Mutex supports MutexParameters::mbRobust, whereby the
+// next locker of a mutex whose owner ended while holding it is told so
+// (Mutex::kResultOwnerDied) instead of blocking forever.
+//
+#ifndef EATHREAD_ROBUST_MUTEX_AVAILABLE
+	#if defined(EA_PLATFORM_LINUX) && !defined(EA_PLATFORM_ANDROID) && !defined(EA_PLATFORM_CYGWIN) && EA_THREADS_AVAILABLE && EA_POSIX_THREADS_AVAILABLE && !EA_USE_CPP11_CONCURRENCY
+		#define EATHREAD_ROBUST_MUTEX_AVAILABLE 1
+	#else
+		#define EATHREAD_ROBUST_MUTEX_AVAILABLE 0
+	#endif
+#endif
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // EATHREAD_ALIGNMENT_CHECK
 //
@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Provides blocking on a 32 bit word of user memory (Linux futex(2)).
+//
+// This is a building block for primitives that keep their entire state in
+// a few atomic words and only enter the kernel to park or unpark a thread.
+// It is available only where EATHREAD_FUTEX_WORD_AVAILABLE is 1; primitives
+// built on it need a fallback for other platforms.
+/////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef EATHREAD_INTERNAL_EATHREAD_FUTEXWORD_H
+#define EATHREAD_INTERNAL_EATHREAD_FUTEXWORD_H
+
+
+#include <eathread/internal/config.h>
+#include <eathread/eathread.h>
+#include <eathread/eathread_atomic.h>
+
+#if defined(EA_PRAGMA_ONCE_SUPPORTED)
+	#pragma once // Some compilers (e.g. VC++) benefit significantly from using this. We've measured 3-4% build speed improvements in apps as a result.
+#endif
+
+
+
+#if EATHREAD_FUTEX_WORD_AVAILABLE
+
+	namespace EA
+	{
+		namespace Thread
+		{
+			/// FutexWordWait
+			///
+			/// Blocks the calling thread for as long as word holds nExpectedValue, until
+			/// another thread calls FutexWordWake on the same word or the absolute timeout
+			/// passes. The check of the value and the blocking are atomic with respect to
+			/// FutexWordWake, so a wake which follows a change to the word is never lost.
+			///
+			/// Returns false if the timeout passed, else true. A return value of true
+			/// doesn't guarantee that the word changed (spurious wakeups are possible),
+			/// so callers must re-check their condition in a loop.
+			///
+			/// bProcessShared must be true if the word is in memory shared with other
+			/// processes (e.g. Shared<T>), and must match the value used to wake it.
+			///
+			EATHREADLIB_API bool FutexWordWait(AtomicInt32& word, int32_t nExpectedValue, const ThreadTime& timeoutAbsolute = kTimeoutNone, bool bProcessShared = false);
+
+			/// FutexWordWake
+			///
+			/// Wakes up to nCount threads blocked in FutexWordWait on word.
+			/// Returns the number of threads woken.
+			///
+			EATHREADLIB_API int FutexWordWake(AtomicInt32& word, int nCount, bool bProcessShared = false);
+
+			/// FutexWordWakeAll
+			///
+			/// Wakes all threads blocked in FutexWordWait on word.
+			///
+			inline void FutexWordWakeAll(AtomicInt32& word, bool bProcessShared = false)
+				{ FutexWordWake(word, INT32_MAX, bProcessShared); }
+
+		} // namespace Thread
+
+	} // namespace EA
+
+#endif // EATHREAD_FUTEX_WORD_AVAILABLE
+
+
+#endif // EATHREAD_INTERNAL_EATHREAD_FUTEXWORD_H
@@ -0,0 +1,53 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Aligned allocation from the EAThread allocator, for the parts of the
+// package which allocate objects that need more than fundamental alignment
+// or which must be freed where they came from after SetAllocator has been
+// called again.
+/////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef EATHREAD_INTERNAL_EATHREAD_MEMORY_H
+#define EATHREAD_INTERNAL_EATHREAD_MEMORY_H
+
+
+#include <eathread/internal/config.h>
+#include <stddef.h>
+
+#if defined(EA_PRAGMA_ONCE_SUPPORTED)
+	#pragma once // Some compilers (e.g. VC++) benefit significantly from using this. We've measured 3-4% build speed improvements in apps as a result.
+#endif
+
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		namespace detail
+		{
+			/// AllocateAlignedMemory / FreeAlignedMemory
+			///
+			/// AllocateAlignedMemory allocates nSize bytes aligned to nAlignment, which must be a
+			/// power of two, from the Allocator given to SetAllocator if there is one, and from
+			/// operator new otherwise. Neither guarantees more than fundamental alignment, so the
+			/// memory is over-allocated and aligned here, and is preceded by a header which
+			/// records where it came from. Returns NULL if the memory couldn't be allocated.
+			///
+			/// FreeAlignedMemory frees memory from AllocateAlignedMemory where it came from, even
+			/// if SetAllocator has been called since. pBlock must not be NULL.
+			///
+			EATHREADLIB_API void* AllocateAlignedMemory(size_t nSize, size_t nAlignment, const char* pName);
+			EATHREADLIB_API void  FreeAlignedMemory(void* pBlock);
+
+		} // namespace detail
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+#endif // EATHREAD_INTERNAL_EATHREAD_MEMORY_H
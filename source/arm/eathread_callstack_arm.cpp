@@ -160,6 +160,14 @@ EATHREADLIB_API void ShutdownCallstack()
 
 	EATHREADLIB_API size_t GetCallstack(void* pReturnAddressArray[], size_t nReturnAddressArrayCapacity, const CallstackContext* pContext)
 	{
+		#if EATHREAD_FRAME_POINTER_CALLSTACK_AVAILABLE
+			if(pContext)
+				return ReadFramePointerCallstack(pReturnAddressArray, nReturnAddressArrayCapacity, *pContext, true);
+
+			if(GetCallstackUnwinder() == kCallstackUnwinderFramePointer)
+				return ReadFramePointerCallstack(pReturnAddressArray, nReturnAddressArrayCapacity, __builtin_frame_address(0));
+		#endif
+
 		void* p;
 		CallstackContext context;
 		size_t entryCount = 0;
@@ -239,19 +247,30 @@ EATHREADLIB_API void GetCallstackContext(CallstackContext& context, const Contex
 ///////////////////////////////////////////////////////////////////////////////
 // GetModuleFromAddress
 //
-EATHREADLIB_API size_t GetModuleFromAddress(const void* /*address*/, char* pModuleName, size_t /*moduleNameCapacity*/)
+EATHREADLIB_API size_t GetModuleFromAddress(const void* address, char* pModuleName, size_t moduleNameCapacity)
 {
-	pModuleName[0] = 0;
-	return 0;
+	#if EATHREAD_MODULE_MAP_AVAILABLE
+		return GetModuleFromAddressCached(address, pModuleName, moduleNameCapacity);
+	#else
+		EA_UNUSED(address);
+		EA_UNUSED(moduleNameCapacity);
+		pModuleName[0] = 0;
+		return 0;
+	#endif
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 // GetModuleHandleFromAddress
 //
-EATHREADLIB_API ModuleHandle GetModuleHandleFromAddress(const void* /*pAddress*/)
+EATHREADLIB_API ModuleHandle GetModuleHandleFromAddress(const void* pAddress)
 {
-	return 0;
+	#if EATHREAD_MODULE_MAP_AVAILABLE
+		return GetModuleHandleFromAddressCached(pAddress);
+	#else
+		EA_UNUSED(pAddress);
+		return 0;
+	#endif
 }
 
 
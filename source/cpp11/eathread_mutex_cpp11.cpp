@@ -7,6 +7,7 @@
 EAMutexData::EAMutexData() : mnLockCount(0) {}
 
 EA::Thread::MutexParameters::MutexParameters(bool /*bIntraProcess*/, const char* pName)
+	: mbRecursive(true), mbRobust(false) // Ignored; std::recursive_timed_mutex is always used.
 {
 	if(pName)
 	{
@@ -79,6 +80,11 @@ int EA::Thread::Mutex::Unlock()
 	return nReturnValue;
 }
 
+bool EA::Thread::Mutex::MarkConsistent()
+{
+	return true; // Robust mutexes are not supported on this platform.
+}
+
 int EA::Thread::Mutex::GetLockCount() const
 {
 	return mMutexData.mnLockCount;
@@ -4,8 +4,10 @@
 
 #include <eathread/internal/config.h>
 #include <eathread/eathread.h>
+#include <eathread/internal/eathread_memory.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <new>
 
 
 namespace EA
@@ -25,6 +27,50 @@ namespace EA
 		}
 
 
+		namespace
+		{
+			// Precedes each block from AllocateAlignedMemory.
+			struct AlignedMemoryHeader
+			{
+				Allocator* mpAllocator; // The allocator which allocated the memory, or NULL if it came from operator new.
+				void*      mpMemory;    // The start of the allocated memory.
+			};
+		}
+
+		EATHREADLIB_API void* detail::AllocateAlignedMemory(size_t nSize, size_t nAlignment, const char* pName)
+		{
+			if(nAlignment < EA_ALIGN_OF(AlignedMemoryHeader))
+				nAlignment = EA_ALIGN_OF(AlignedMemoryHeader);
+
+			EAT_ASSERT((nAlignment & (nAlignment - 1)) == 0);
+
+			Allocator* const pAllocator  = gpAllocator;
+			const size_t     nMemorySize = nSize + sizeof(AlignedMemoryHeader) + (nAlignment - 1);
+			void* const      pMemory     = pAllocator ? pAllocator->Alloc(nMemorySize, pName, 0) : new(std::nothrow) char[nMemorySize];
+
+			if(!pMemory)
+				return NULL;
+
+			const uintptr_t      nBlock  = ((uintptr_t)pMemory + sizeof(AlignedMemoryHeader) + (nAlignment - 1)) & ~(uintptr_t)(nAlignment - 1);
+			AlignedMemoryHeader* pHeader = reinterpret_cast<AlignedMemoryHeader*>(nBlock) - 1;
+
+			pHeader->mpAllocator = pAllocator;
+			pHeader->mpMemory    = pMemory;
+
+			return reinterpret_cast<void*>(nBlock);
+		}
+
+		EATHREADLIB_API void detail::FreeAlignedMemory(void* pBlock)
+		{
+			const AlignedMemoryHeader* const pHeader = static_cast<AlignedMemoryHeader*>(pBlock) - 1;
+
+			if(pHeader->mpAllocator)
+				pHeader->mpAllocator->Free(pHeader->mpMemory);
+			else
+				delete[] static_cast<char*>(pHeader->mpMemory);
+		}
+
+
 
 		// Currently we take advantage of the fact that ICoreAllocator
 		// is a binary mapping to EA::Thread::Allocator.
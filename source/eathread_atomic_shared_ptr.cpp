@@ -0,0 +1,42 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <eathread/atomic_shared_ptr_mt.h>
+#include <eathread/eathread_futex.h>
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		namespace
+		{
+			const size_t kSharedPtrStripeCount = 64;
+
+			// Futexes are recursive, so a thread can lock two pointer objects which
+			// happen to share a stripe. The array is never destroyed, as pointer 
+			// objects may be locked during static destruction.
+			Futex& GetSharedPtrStripe(const void* pAddress)
+			{
+				static Futex* const pStripeArray = new Futex[kSharedPtrStripeCount];
+
+				// Objects are at least pointer-aligned, so we ignore the low bits.
+				return pStripeArray[((uintptr_t)pAddress / sizeof(void*)) % kSharedPtrStripeCount];
+			}
+		}
+
+		namespace detail
+		{
+			void LockSharedPtrStripe(const void* pAddress)
+			{
+				GetSharedPtrStripe(pAddress).Lock();
+			}
+
+			void UnlockSharedPtrStripe(const void* pAddress)
+			{
+				GetSharedPtrStripe(pAddress).Unlock();
+			}
+		}
+	}
+}
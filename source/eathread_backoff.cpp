@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <eathread/eathread_backoff.h>
+#include <eathread/eathread_atomic.h>
+
+EA_DISABLE_VC_WARNING(4265 4365 4836 4571 4625 4626 4628 4193 4127 4548)
+#include <chrono>
+EA_RESTORE_VC_WARNING()
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		namespace
+		{
+			// 0 means not yet measured, and kMeasuring that a thread is measuring it.
+			const uint32_t kMeasuring = 0xffffffff;
+
+			AtomicUint32 gnProcessorPausesPerMicrosecond(0);
+
+
+			uint32_t MeasureProcessorPausesPerMicrosecond()
+			{
+				typedef std::chrono::steady_clock Clock;
+
+				// We time a fixed number of pauses several times and keep the fastest
+				// run, as the slower runs are most likely the ones that were interrupted.
+				const uint32_t kPauseCount  = 1000;
+				const int      kTrialCount  = 5;
+				int64_t        nBestNanoseconds = INT64_MAX;
+
+				for(int i = 0; i < kTrialCount; i++)
+				{
+					const Clock::time_point t0 = Clock::now();
+					ProcessorPause(kPauseCount);
+					const Clock::time_point t1 = Clock::now();
+
+					const int64_t nNanoseconds = (int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+
+					if(nNanoseconds < nBestNanoseconds)
+						nBestNanoseconds = nNanoseconds;
+				}
+
+				// A zero (or absurdly small) time means EAProcessorPause is a no-op on this platform
+				// or the clock is too coarse. In that case we cap the result, which keeps the backoff
+				// policies from computing enormous pause counts.
+				const uint32_t kMaxPausesPerMicrosecond = 1000;
+
+				if(nBestNanoseconds <= 0)
+					return kMaxPausesPerMicrosecond;
+
+				const uint64_t nPausesPerMicrosecond = ((uint64_t)kPauseCount * 1000) / (uint64_t)nBestNanoseconds;
+
+				if(nPausesPerMicrosecond < 1)
+					return 1;
+				if(nPausesPerMicrosecond > kMaxPausesPerMicrosecond)
+					return kMaxPausesPerMicrosecond;
+				return (uint32_t)nPausesPerMicrosecond;
+			}
+
+
+			// Measures the pause cost during static initialization, so that it isn't measured
+			// by the first contended lock. GetProcessorPausesPerMicrosecond measures it instead
+			// if it's called during static initialization before this runs.
+			struct ProcessorPauseCalibration
+			{
+				ProcessorPauseCalibration()
+					{ GetProcessorPausesPerMicrosecond(); }
+			};
+
+			ProcessorPauseCalibration gProcessorPauseCalibration;
+
+		} // namespace
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+
+uint32_t EA::Thread::GetProcessorPausesPerMicrosecond()
+{
+	uint32_t nValue = gnProcessorPausesPerMicrosecond.GetValue();
+
+	while((nValue == 0) || (nValue == kMeasuring))
+	{
+		// One thread measures, and any others wait for its result rather than measure too.
+		if((nValue == 0) && gnProcessorPausesPerMicrosecond.SetValueConditional(kMeasuring, 0))
+		{
+			nValue = MeasureProcessorPausesPerMicrosecond();
+			gnProcessorPausesPerMicrosecond.SetValueConditional(nValue, kMeasuring); // Fails if SetProcessorPausesPerMicrosecond was called meanwhile.
+		}
+		else
+			ThreadSleep(kTimeoutYield);
+
+		nValue = gnProcessorPausesPerMicrosecond.GetValue();
+	}
+
+	return nValue;
+}
+
+
+void EA::Thread::SetProcessorPausesPerMicrosecond(uint32_t nPausesPerMicrosecond)
+{
+	gnProcessorPausesPerMicrosecond.SetValue((nPausesPerMicrosecond == kMeasuring) ? (kMeasuring - 1) : nPausesPerMicrosecond);
+}
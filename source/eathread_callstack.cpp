@@ -3,6 +3,15 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <EABase/eabase.h>
+#include <eathread/internal/config.h>
+
+#if EATHREAD_FRAME_POINTER_CALLSTACK_AVAILABLE
+	#include "unix/eathread_callstack_framepointer.cpp" // This goes first, as the platform GetCallstack uses it.
+#endif
+
+#if EATHREAD_MODULE_MAP_AVAILABLE
+	#include "unix/eathread_callstack_modulemap.cpp" // This goes first, as the platform GetModuleFromAddress uses it.
+#endif
 
 #if defined(EA_PLATFORM_WIN32) && EA_WINAPI_FAMILY_PARTITION(EA_WINAPI_PARTITION_DESKTOP)
 	#include "pc/eathread_callstack_win32.cpp"
@@ -34,3 +43,7 @@
 #else
 	#include "null/eathread_callstack_null.cpp"
 #endif
+
+#if EATHREAD_THREAD_CALLSTACK_AVAILABLE
+	#include "unix/eathread_callstack_signal.cpp"
+#endif
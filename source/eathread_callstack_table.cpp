@@ -0,0 +1,251 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <eathread/eathread_callstack_table.h>
+#include <eathread/eathread_callstack.h>
+#include <eathread/eathread.h>
+#include <string.h>
+#include <new>
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		namespace
+		{
+			const size_t kMaxCaptureDepth = 64;
+
+
+			uint32_t HashCallstack(void* const* pCallstack, size_t nDepth)
+			{
+				uint64_t nHash = UINT64_C(14695981039346656037); // FNV-1a, a pointer at a time.
+
+				for(size_t i = 0; i < nDepth; i++)
+					nHash = (nHash ^ (uint64_t)(uintptr_t)pCallstack[i]) * UINT64_C(1099511628211);
+
+				return (uint32_t)(nHash ^ (nHash >> 32));
+			}
+
+
+			// Claims n of the counter's units if that doesn't take it past nLimit.
+			// Returns the counter's value before the claim, or -1 if it would. nLimit must be
+			// at most INT32_MAX, so that a successful claim is never mistaken for -1.
+			int32_t ClaimCount(AtomicInt32& counter, uint32_t n, uint32_t nLimit)
+			{
+				int32_t nValue;
+
+				do {
+					nValue = counter.GetValue();
+
+					if(((uint32_t)nValue + n) > nLimit)
+						return -1;
+				} while(!counter.SetValueConditional((int32_t)((uint32_t)nValue + n), nValue));
+
+				return nValue;
+			}
+
+		} // namespace
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+
+EA::Thread::CallstackTable::CallstackTable(size_t nMaxCallstackCount, size_t nFrameCapacity)
+  : mpSlotArray(NULL),
+	mpEntryArray(NULL),
+	mpFrameArray(NULL),
+	mpMemory(NULL),
+	mnMemorySize(0),
+	mnSlotMask(0),
+	mnMaxCallstackCount(0),
+	mnFrameCapacity(0),
+	mnAllocatedIdCount(0),
+	mnCallstackCount(0),
+	mnFrameCount(0)
+{
+	if(nMaxCallstackCount > kMaxCallstackCount)
+		nMaxCallstackCount = kMaxCallstackCount;
+	if(nFrameCapacity == kFrameCapacityDefault)
+		nFrameCapacity = nMaxCallstackCount * 16;
+	if(nFrameCapacity > kMaxFrameCapacity)
+		nFrameCapacity = kMaxFrameCapacity;
+
+	// The hash table is kept at most half full, so that probe sequences stay short
+	// and there is always an empty slot to end a search.
+	size_t nSlotCount = 2;
+	while(nSlotCount < (nMaxCallstackCount * 2))
+		nSlotCount *= 2;
+
+	const size_t nSlotArraySize  = nSlotCount * sizeof(AtomicInt32);
+	const size_t nEntryArraySize = nMaxCallstackCount * sizeof(Entry);
+	const size_t nMemorySize     = nSlotArraySize + nEntryArraySize + (nFrameCapacity * sizeof(void*)) + sizeof(void*);
+	Allocator*   pAllocator      = GetAllocator();
+
+	if(nMaxCallstackCount)
+		mpMemory = pAllocator ? pAllocator->Alloc(nMemorySize, "EAThread CallstackTable") : new(std::nothrow) char[nMemorySize];
+
+	if(mpMemory)
+	{
+		mpSlotArray  = static_cast<AtomicInt32*>(mpMemory);
+		mpEntryArray = reinterpret_cast<Entry*>(static_cast<char*>(mpMemory) + nSlotArraySize);
+
+		// The entries are 12 bytes each, so the frame arena may need aligning.
+		const uintptr_t nFrames = ((uintptr_t)mpEntryArray + nEntryArraySize + (sizeof(void*) - 1)) & ~(uintptr_t)(sizeof(void*) - 1);
+		mpFrameArray = reinterpret_cast<void**>(nFrames);
+
+		for(size_t i = 0; i < nSlotCount; i++)
+			new(&mpSlotArray[i]) AtomicInt32(0);
+
+		// An id which is never published keeps a hash of 0, which GetCallstack looks up and doesn't find.
+		memset(mpEntryArray, 0, nEntryArraySize);
+
+		mnMemorySize        = nMemorySize;
+		mnSlotMask          = (uint32_t)(nSlotCount - 1);
+		mnMaxCallstackCount = (uint32_t)nMaxCallstackCount;
+		mnFrameCapacity     = (uint32_t)nFrameCapacity;
+	}
+}
+
+
+EA::Thread::CallstackTable::~CallstackTable()
+{
+	if(mpMemory)
+	{
+		for(uint32_t i = 0; i <= mnSlotMask; i++)
+			mpSlotArray[i].~AtomicInt32();
+
+		Allocator* pAllocator = GetAllocator();
+
+		if(pAllocator)
+			pAllocator->Free(mpMemory);
+		else
+			delete[] static_cast<char*>(mpMemory);
+	}
+}
+
+
+const EA::Thread::CallstackTable::Entry* EA::Thread::CallstackTable::FindEntry(void* const* pCallstack, size_t nDepth, uint32_t nHash, size_t& nSlot) const
+{
+	for(nSlot = nHash & mnSlotMask; ; nSlot = (nSlot + 1) & mnSlotMask)
+	{
+		const int32_t nValue = mpSlotArray[nSlot].GetValue(); // This is a full barrier, after which the entry's contents are visible.
+
+		if(nValue == 0)
+			return NULL;
+
+		const Entry& entry = mpEntryArray[nValue - 1];
+
+		if((entry.mnHash == nHash) && (entry.mnDepth == nDepth) && (memcmp(mpFrameArray + entry.mnFrameIndex, pCallstack, nDepth * sizeof(void*)) == 0))
+			return &entry;
+	}
+}
+
+
+EA::Thread::CallstackId EA::Thread::CallstackTable::Insert(void* const* pCallstack, size_t nDepth)
+{
+	if(!mpMemory || (nDepth > mnFrameCapacity))
+		return kCallstackIdInvalid;
+
+	const uint32_t nHash = HashCallstack(pCallstack, nDepth);
+	size_t         nSlot;
+	const Entry*   pEntry = FindEntry(pCallstack, nDepth, nHash, nSlot);
+
+	if(pEntry)
+		return (CallstackId)(pEntry - mpEntryArray);
+
+	// We fill in a new entry before making it visible, so readers never see a partial one.
+	const int32_t nId = ClaimCount(mnAllocatedIdCount, 1, mnMaxCallstackCount);
+	if(nId < 0)
+		return kCallstackIdInvalid;
+
+	const int32_t nFrameIndex = ClaimCount(mnFrameCount, (uint32_t)nDepth, mnFrameCapacity);
+	if(nFrameIndex < 0)
+		return kCallstackIdInvalid;
+
+	Entry& entry = mpEntryArray[nId];
+	entry.mnHash       = nHash;
+	entry.mnDepth      = (uint32_t)nDepth;
+	entry.mnFrameIndex = (uint32_t)nFrameIndex;
+	memcpy(mpFrameArray + nFrameIndex, pCallstack, nDepth * sizeof(void*));
+
+	for(;;)
+	{
+		if(mpSlotArray[nSlot].SetValueConditional(nId + 1, 0)) // This is a full barrier, which publishes the entry.
+		{
+			mnCallstackCount.Increment();
+			return (CallstackId)nId;
+		}
+
+		// Another thread took the slot. If it inserted the same callstack, then ours is
+		// left unused. Otherwise we carry on along the probe sequence.
+		const int32_t nValue    = mpSlotArray[nSlot].GetValue();
+		const Entry&  slotEntry = mpEntryArray[nValue - 1];
+
+		if((slotEntry.mnHash == nHash) && (slotEntry.mnDepth == nDepth) && (memcmp(mpFrameArray + slotEntry.mnFrameIndex, pCallstack, nDepth * sizeof(void*)) == 0))
+			return (CallstackId)(nValue - 1);
+
+		pEntry = FindEntry(pCallstack, nDepth, nHash, nSlot);
+
+		if(pEntry)
+			return (CallstackId)(pEntry - mpEntryArray);
+	}
+}
+
+
+EA::Thread::CallstackId EA::Thread::CallstackTable::Find(void* const* pCallstack, size_t nDepth) const
+{
+	size_t       nSlot;
+	const Entry* pEntry = mpMemory ? FindEntry(pCallstack, nDepth, HashCallstack(pCallstack, nDepth), nSlot) : NULL;
+
+	return pEntry ? (CallstackId)(pEntry - mpEntryArray) : kCallstackIdInvalid;
+}
+
+
+EA_NO_INLINE EA::Thread::CallstackId EA::Thread::CallstackTable::Capture(size_t nMaxDepth)
+{
+	void* callstack[kMaxCaptureDepth + 1];
+
+	if(nMaxDepth > kMaxCaptureDepth)
+		nMaxDepth = kMaxCaptureDepth;
+
+	// The first entry is in this function, which the caller isn't interested in.
+	const size_t nDepth = EA::Thread::GetCallstack(callstack, nMaxDepth + 1, (const CallstackContext*)NULL);
+
+	return Insert(callstack + 1, nDepth ? (nDepth - 1) : 0);
+}
+
+
+void* const* EA::Thread::CallstackTable::GetCallstack(CallstackId id, size_t* pDepth) const
+{
+	// Ids lost to a race or to a full frame arena, and ids which are still being filled
+	// in, have been handed out but aren't in the hash table. So we look the id up there.
+	if(id < (CallstackId)mnAllocatedIdCount.GetValue())
+	{
+		const Entry& entry = mpEntryArray[id];
+
+		for(size_t nSlot = entry.mnHash & mnSlotMask; ; nSlot = (nSlot + 1) & mnSlotMask)
+		{
+			const int32_t nValue = mpSlotArray[nSlot].GetValue(); // This is a full barrier, after which the entry's contents are visible.
+
+			if(nValue == 0)
+				break;
+
+			if(nValue == (int32_t)(id + 1))
+			{
+				if(pDepth)
+					*pDepth = entry.mnDepth;
+
+				return mpFrameArray + entry.mnFrameIndex;
+			}
+		}
+	}
+
+	if(pDepth)
+		*pDepth = 0;
+
+	return NULL;
+}
@@ -246,6 +246,11 @@ EA::Thread::Condition* EA::Thread::ConditionFactory::ConstructCondition(void* pM
 	return new(pMemory) EA::Thread::Condition;
 }
 
+EA::Thread::Condition* EA::Thread::ConditionFactory::ConstructCondition(void* pMemory, const ConditionParameters* pConditionParameters)
+{
+	return new(pMemory) EA::Thread::Condition(pConditionParameters);
+}
+
 void EA::Thread::ConditionFactory::DestructCondition(EA::Thread::Condition* pCondition)
 {
 	pCondition->~Condition();
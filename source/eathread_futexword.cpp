@@ -0,0 +1,45 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <eathread/internal/config.h>
+#include <eathread/internal/eathread_futexword.h>
+
+#if EATHREAD_FUTEX_WORD_AVAILABLE
+
+	#include <errno.h>
+	#include <limits.h>
+	#include <unistd.h>
+	#include <sys/syscall.h>
+	#include <linux/futex.h>
+
+
+	// The kernel operates on the raw 32 bit value, so AtomicInt32 must be nothing more than that.
+	EAT_COMPILETIME_ASSERT(sizeof(EA::Thread::AtomicInt32) == sizeof(int32_t));
+
+
+	bool EA::Thread::FutexWordWait(AtomicInt32& word, int32_t nExpectedValue, const ThreadTime& timeoutAbsolute, bool bProcessShared)
+	{
+		// FUTEX_WAIT_BITSET takes an absolute timeout, and FUTEX_CLOCK_REALTIME makes it use the
+		// same clock as GetThreadTime. This avoids recomputing a relative timeout after wakeups.
+		const timespec* pTimeout = (timeoutAbsolute == kTimeoutNone) ? NULL : &timeoutAbsolute;
+		const int       nPrivate = bProcessShared ? 0 : FUTEX_PRIVATE_FLAG;
+
+		const long result = syscall(SYS_futex, reinterpret_cast<int32_t*>(&word), FUTEX_WAIT_BITSET | nPrivate | FUTEX_CLOCK_REALTIME,
+									nExpectedValue, pTimeout, NULL, FUTEX_BITSET_MATCH_ANY);
+
+		// EAGAIN means the word no longer held nExpectedValue, and EINTR means a signal
+		// arrived. Both are reported as a (possibly spurious) wakeup.
+		return (result == 0) || (errno != ETIMEDOUT);
+	}
+
+
+	int EA::Thread::FutexWordWake(AtomicInt32& word, int nCount, bool bProcessShared)
+	{
+		const int  nPrivate = bProcessShared ? 0 : FUTEX_PRIVATE_FLAG;
+		const long result   = syscall(SYS_futex, reinterpret_cast<int32_t*>(&word), FUTEX_WAKE | nPrivate, nCount, NULL, NULL, 0);
+
+		return (result > 0) ? (int)result : 0;
+	}
+
+#endif // EATHREAD_FUTEX_WORD_AVAILABLE
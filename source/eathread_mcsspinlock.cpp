@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <eathread/eathread_mcsspinlock.h>
+#include <eathread/eathread_storage.h>
+#include <new>
+
+
+EAT_COMPILETIME_ASSERT((EATHREAD_MCS_SPINLOCK_NODE_COUNT >= 1) && (EATHREAD_MCS_SPINLOCK_NODE_COUNT <= 32));
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		namespace
+		{
+			#if defined(EA_THREAD_LOCAL)
+				// The per-thread node pool is plain data so that it can be declared EA_THREAD_LOCAL,
+				// which doesn't support constructors. Nodes are constructed in place the first time
+				// they are handed out. MCSSpinLockNode is trivially destructible in practice, so
+				// nothing needs to happen at thread exit.
+				struct MCSSpinLockNodePool
+				{
+					EA_PREFIX_ALIGN(EATHREAD_CACHE_LINE_SIZE)
+					char     mNodeMemory[EATHREAD_MCS_SPINLOCK_NODE_COUNT][sizeof(MCSSpinLockNode)] EA_POSTFIX_ALIGN(EATHREAD_CACHE_LINE_SIZE);
+					uint32_t mnConstructedMask;
+					uint32_t mnUsedMask;
+				};
+
+				static EA_THREAD_LOCAL MCSSpinLockNodePool tMCSSpinLockNodePool;
+			#endif
+
+
+			MCSSpinLockNode* AllocateMCSSpinLockNode()
+			{
+				#if defined(EA_THREAD_LOCAL)
+					MCSSpinLockNodePool& pool = tMCSSpinLockNodePool;
+
+					for(uint32_t i = 0; i < EATHREAD_MCS_SPINLOCK_NODE_COUNT; i++)
+					{
+						const uint32_t nBit = (uint32_t)1 << i;
+
+						if((pool.mnUsedMask & nBit) == 0)
+						{
+							pool.mnUsedMask |= nBit;
+
+							if((pool.mnConstructedMask & nBit) == 0)
+							{
+								pool.mnConstructedMask |= nBit;
+								return new(pool.mNodeMemory[i]) MCSSpinLockNode;
+							}
+
+							return reinterpret_cast<MCSSpinLockNode*>(pool.mNodeMemory[i]);
+						}
+					}
+				#endif
+
+				// The thread has more node-less MCSSpinLock acquisitions outstanding than
+				// EATHREAD_MCS_SPINLOCK_NODE_COUNT, or the platform lacks EA_THREAD_LOCAL.
+				Allocator* pAllocator = GetAllocator();
+
+				if(pAllocator)
+					return new(pAllocator->Alloc(sizeof(MCSSpinLockNode), EATHREAD_ALLOC_PREFIX "MCSSpinLockNode", 0, EATHREAD_CACHE_LINE_SIZE)) MCSSpinLockNode;
+				else
+					return new MCSSpinLockNode;
+			}
+
+
+			void FreeMCSSpinLockNode(MCSSpinLockNode* pNode)
+			{
+				#if defined(EA_THREAD_LOCAL)
+					MCSSpinLockNodePool& pool   = tMCSSpinLockNodePool;
+					const char*          pBegin = pool.mNodeMemory[0];
+					const char*          pEnd   = pool.mNodeMemory[EATHREAD_MCS_SPINLOCK_NODE_COUNT];
+					const char*          p      = reinterpret_cast<const char*>(pNode);
+
+					if((p >= pBegin) && (p < pEnd))
+					{
+						const uint32_t i = (uint32_t)((p - pBegin) / sizeof(MCSSpinLockNode));
+						pool.mnUsedMask &= ~((uint32_t)1 << i);
+						return;
+					}
+				#endif
+
+				Allocator* pAllocator = GetAllocator();
+
+				if(pAllocator)
+				{
+					pNode->~MCSSpinLockNode();
+					pAllocator->Free(pNode);
+				}
+				else
+					delete pNode;
+			}
+
+		} // namespace
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+
+void EA::Thread::MCSSpinLock::Lock()
+{
+	MCSSpinLockNode* const pNode = AllocateMCSSpinLockNode();
+
+	Lock(*pNode);
+	mpOwnerNode = pNode;
+}
+
+
+bool EA::Thread::MCSSpinLock::TryLock()
+{
+	MCSSpinLockNode* const pNode = AllocateMCSSpinLockNode();
+
+	if(TryLock(*pNode))
+	{
+		mpOwnerNode = pNode;
+		return true;
+	}
+
+	FreeMCSSpinLockNode(pNode);
+	return false;
+}
+
+
+void EA::Thread::MCSSpinLock::Unlock()
+{
+	// mpOwnerNode must be read before the lock is released, as the next owner will overwrite it.
+	MCSSpinLockNode* const pNode = mpOwnerNode;
+	EAT_ASSERT(pNode != NULL);
+
+	mpOwnerNode = NULL;
+	Unlock(*pNode);
+	FreeMCSSpinLockNode(pNode);
+}
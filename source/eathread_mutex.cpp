@@ -63,6 +63,11 @@ EA::Thread::Mutex* EA::Thread::MutexFactory::ConstructMutex(void* pMemory)
 	return new(pMemory) EA::Thread::Mutex;
 }
 
+EA::Thread::Mutex* EA::Thread::MutexFactory::ConstructMutex(void* pMemory, const MutexParameters* pMutexParameters)
+{
+	return new(pMemory) EA::Thread::Mutex(pMutexParameters);
+}
+
 void EA::Thread::MutexFactory::DestructMutex(EA::Thread::Mutex* pMutex)
 {
 	pMutex->~Mutex();
@@ -84,7 +89,7 @@ void EA::Thread::MutexFactory::DestructMutex(EA::Thread::Mutex* pMutex)
 
 
 	EA::Thread::MutexParameters::MutexParameters(bool /*bIntraProcess*/, const char* /*pName*/)
-	  : mbIntraProcess(true)
+	  : mbIntraProcess(true), mbRecursive(true), mbRobust(false)
 	{
 	}
 
@@ -130,6 +135,12 @@ void EA::Thread::MutexFactory::DestructMutex(EA::Thread::Mutex* pMutex)
 	}
 
 
+	bool EA::Thread::Mutex::MarkConsistent()
+	{
+		return true; // There is no other thread to die while holding the mutex.
+	}
+
+
 	int EA::Thread::Mutex::GetLockCount() const
 	{
 		return mMutexData.mnLockCount;
@@ -5,8 +5,11 @@
 #include <eathread/internal/config.h>
 #include <eathread/eathread_pool.h>
 #include <eathread/eathread_sync.h>
+#include <eathread/eathread_backoff.h>
+#include <eathread/internal/eathread_futexword.h>
 #include <string.h>
 #include <new>
+#include <utility>
 
 // 6011: Dereferencing NULL pointer 'gpAllocator'
 // 6211: Leaking memory 'pThreadInfo' due to an exception.
@@ -28,14 +31,145 @@ EA::Thread::ThreadPoolParameters::ThreadPoolParameters()
 	mnInitialCount(EA::Thread::ThreadPool::kDefaultInitialCount),
 	mnIdleTimeoutMilliseconds(EA::Thread::ThreadPool::kDefaultIdleTimeout), // This is a relative time, not an absolute time. Can be a millisecond value or Thread::kTimeoutNone or Thread::kTimeoutImmediate.
 	mnProcessorMask(0xffffffff),
+	mnIdleSpinMicroseconds(EA::Thread::ThreadPool::kDefaultIdleSpinMicroseconds),
 	mDefaultThreadParameters()
 {
 	// Empty
 }
 
 
+EA::Thread::JobGroup::JobGroup()
+  : mnWord(0)
+{
+}
+
+
+EA::Thread::JobGroup::~JobGroup()
+{
+	EAT_ASSERT(GetPendingCount() == 0);
+}
+
+
+void EA::Thread::JobGroup::Add(int nCount)
+{
+	#if EATHREAD_FUTEX_WORD_AVAILABLE
+		mnWord.Add(nCount << 1);
+	#else
+		mMutex.Lock();
+		mnWord.Add(nCount << 1);
+		mMutex.Unlock();
+	#endif
+}
+
+
+void EA::Thread::JobGroup::Done()
+{
+	#if EATHREAD_FUTEX_WORD_AVAILABLE
+		// The count and the waiters flag are updated in a single operation, as a waiter
+		// may destroy the JobGroup as soon as it sees a count of zero. Only the wake
+		// call follows, and a wake call on a stale address does no harm.
+		int32_t nWord, nNewWord;
+
+		do{
+			nWord    = mnWord.GetValue();
+			nNewWord = nWord - 2;
+
+			if((nNewWord >> 1) == 0)
+				nNewWord = 0;
+		} while(!mnWord.SetValueConditional(nNewWord, nWord));
+
+		EAT_ASSERT((nWord >> 1) > 0);
+
+		if((nNewWord == 0) && (nWord & kWaitersFlag))
+			FutexWordWakeAll(mnWord);
+	#else
+		// Here both the count and the wait are handled with mMutex locked, so that a
+		// waiter can't return and destroy the JobGroup while we still use mMutex.
+		mMutex.Lock();
+		EAT_ASSERT(GetPendingCount() > 0);
+		if(mnWord.Add(-2) == kWaitersFlag)
+		{
+			mnWord.SetValue(0);
+			mCondition.Signal(true);
+		}
+		mMutex.Unlock();
+	#endif
+}
+
+
+bool EA::Thread::JobGroup::Wait(const ThreadTime& timeoutAbsolute)
+{
+	#if EATHREAD_FUTEX_WORD_AVAILABLE
+		for(;;)
+		{
+			const int32_t nWord = mnWord.GetValue();
+
+			if((nWord >> 1) == 0)
+				return true;
+
+			// The flag tells Done that it needs to make a wake call.
+			if(!(nWord & kWaitersFlag) && !mnWord.SetValueConditional(nWord | kWaitersFlag, nWord))
+				continue;
+
+			if(!FutexWordWait(mnWord, nWord | kWaitersFlag, timeoutAbsolute))
+				return (GetPendingCount() == 0);
+		}
+	#else
+		bool bDone = true;
+
+		mMutex.Lock();
+
+		while(GetPendingCount() != 0)
+		{
+			mnWord.SetValue(mnWord.GetValue() | kWaitersFlag);
+
+			if(mCondition.Wait(&mMutex, timeoutAbsolute) == Condition::kResultTimeout)
+			{
+				bDone = (GetPendingCount() == 0);
+				break;
+			}
+		}
+
+		mMutex.Unlock();
+
+		return bDone;
+	#endif
+}
+
+
+// JobRecord
+// Each queued job has a record, which lets WaitForJobCompletion park on the job without
+// holding the pool's lock. The record is in the pool's hash table from when the job is
+// queued until it completes, and is reused once the job and every waiter are done with it.
+struct EA::Thread::ThreadPool::JobRecord
+{
+	AtomicInt32 mnState;        // One of the kJobRecordState values below, which waiters park on.
+	int         mnJobID;        // The id of the job, which is the record's hash key. Guarded by mThreadMutex.
+	int         mnRefCount;     // One for the job until it is retired, plus one per waiting thread. Guarded by mThreadMutex.
+	JobRecord*  mpNext;         // Next record in the hash chain or in the free list. Guarded by mThreadMutex.
+	Allocator*  mpAllocator;    // The allocator the record came from, or NULL if it came from operator new.
+};
+
+static const int32_t kJobRecordStateQueued  = 0; // The job has not completed.
+static const int32_t kJobRecordStateWaiters = 1; // The job has not completed and at least one thread waits for it.
+static const int32_t kJobRecordStateDone    = 2; // The job has completed or was discarded.
+
+
+static void FreeJobRecord(EA::Thread::ThreadPool::JobRecord* pJobRecord)
+{
+	EA::Thread::Allocator* const pAllocator = pJobRecord->mpAllocator;
+
+	pJobRecord->~JobRecord();
+
+	if(pAllocator)
+		pAllocator->Free(pJobRecord);
+	else
+		::operator delete(pJobRecord);
+}
+
+
 EA::Thread::ThreadPool::Job::Job()
-  : mpRunnable(NULL), mpFunction(NULL), mpContext(NULL)
+  : mnJobID(0), mpRunnable(NULL), mpFunction(NULL), mpContext(NULL), mpJobGroup(NULL), mpJobRecord(NULL)
 {
 	// Empty
 }
@@ -65,12 +199,21 @@ EA::Thread::ThreadPool::ThreadPool(const ThreadPoolParameters* pThreadPoolParame
 	mnNextProcessor(0),
 	mnPauseCount(0),
 	mnLastJobID(0),
+	mnIdleSpinCount(0),
+	mnSpinningCount(0),
+	mnJobQueueSequence(0),
+	mnCompletedJobCount(),
 	mDefaultThreadParameters(),
 	mThreadCondition(NULL, false),  // Explicitly don't initialize.
 	mThreadMutex(NULL, false),      // Explicitly don't initialize.
 	mThreadInfoList(),
-	mJobList()
+	mJobList(),
+	mAllJobGroup(),
+	mpFreeJobRecordList(NULL)
 {
+	for(int i = 0; i < kJobRecordHashSize; i++)
+		mJobRecordHash[i] = NULL;
+
 	if(!pThreadPoolParameters && bDefaultParameters)
 	{
 		ThreadPoolParameters parameters;
@@ -85,6 +228,22 @@ EA::Thread::ThreadPool::~ThreadPool()
 {
 	Shutdown(kJobWaitAll, kTimeoutNone);
 	EAT_ASSERT(mJobList.empty() && mThreadInfoList.empty() && (mnCurrentCount == 0) && (mnActiveCount == 0) && (mThreadMutex.GetLockCount() == 0));
+
+	// Records of jobs which were left queued are still in the hash table.
+	for(int i = 0; i < kJobRecordHashSize; i++)
+	{
+		while(JobRecord* const pJobRecord = mJobRecordHash[i])
+		{
+			mJobRecordHash[i] = pJobRecord->mpNext;
+			FreeJobRecord(pJobRecord);
+		}
+	}
+
+	while(JobRecord* const pJobRecord = mpFreeJobRecordList)
+	{
+		mpFreeJobRecordList = pJobRecord->mpNext;
+		FreeJobRecord(pJobRecord);
+	}
 }
 
 
@@ -104,6 +263,26 @@ EA_DISABLE_VC_WARNING(4296 4706) // '>=' : expression is always true and assignm
 static const int kThreadPoolParametersProcessorDefault = -1;
 
 
+
+
+// Converts ThreadPoolParameters::mnIdleSpinMicroseconds to a number of polls.
+// Polling is pointless with a single processor, as the thread which would queue
+// the next job can't run while we poll.
+static int CalculateIdleSpinCount(int nSpinMicroseconds, uint32_t nProcessorCount)
+{
+	#ifdef EA_THREAD_COOPERATIVE
+		EA_UNUSED(nSpinMicroseconds); EA_UNUSED(nProcessorCount);
+		return 0;
+	#else
+		if((nSpinMicroseconds <= 0) || (nProcessorCount <= 1))
+			return 0;
+
+		const uint64_t nSpinCount = (uint64_t)nSpinMicroseconds * EA::Thread::GetProcessorPausesPerMicrosecond();
+		return (nSpinCount > INT32_MAX) ? INT32_MAX : (int)nSpinCount;
+	#endif
+}
+
+
 bool EA::Thread::ThreadPool::Init(const ThreadPoolParameters* pThreadPoolParameters)
 {
 	if(!mbInitialized)
@@ -119,6 +298,7 @@ bool EA::Thread::ThreadPool::Init(const ThreadPoolParameters* pThreadPoolParamet
 			mnProcessorMask           = pThreadPoolParameters->mnProcessorMask;
 			mDefaultThreadParameters  = pThreadPoolParameters->mDefaultThreadParameters;
 			mnProcessorCount          = (uint32_t)EA::Thread::GetProcessorCount();  // We currently assume this value is constant at runtime.
+			mnIdleSpinCount           = CalculateIdleSpinCount(pThreadPoolParameters->mnIdleSpinMicroseconds, mnProcessorCount);
 
 			// Do bounds checking. 
 			//if(mnMinCount < 0)  // This check is unnecessary because mnMinCount is of an 
@@ -180,7 +360,21 @@ bool EA::Thread::ThreadPool::Shutdown(JobWait jobWait, const ThreadTime& timeout
 
 		// If jobWait is kJobWaitNone, then we nuke all existing jobs.
 		if(jobWait == kJobWaitNone)
+		{
+			// Discarded jobs count as completed for anybody waiting for them.
+			for(JobList::iterator it(mJobList.begin()); it != mJobList.end(); ++it)
+			{
+				const Job& job = *it;
+
+				if(job.HasWork())
+				{
+					CompleteJob(job);
+					RetireJob(job);
+				}
+			}
+
 			mJobList.clear();
+		}
 
 		// Leave a message to tell the thread to quit.
 		for(ThreadInfoList::iterator it(mThreadInfoList.begin()), itEnd(mThreadInfoList.end()); it != itEnd; )
@@ -231,23 +425,37 @@ intptr_t EA::Thread::ThreadPool::ThreadFunction(void* pContext)
 	Condition*  const pCondition  = &pThreadPool->mThreadCondition;
 	Mutex*      const pMutex      = &pThreadPool->mThreadMutex;
 
+	bool bPolled = false; // True if we have already polled for a job since we last waited or worked.
+
 	pMutex->Lock();
 
 	while(!pThreadInfo->mbQuit)
 	{
 		if(!pThreadPool->mJobList.empty())
 		{
-			pThreadInfo->mCurrentJob = pThreadPool->mJobList.front();
+			bPolled = false;
+			pThreadInfo->mCurrentJob = std::move(pThreadPool->mJobList.front());
 			pThreadPool->mJobList.pop_front();
 			pThreadInfo->mbActive = true;
 			++pThreadPool->mnActiveCount; // Atomic integer operation.
 			pMutex->Unlock();
 
 			// Do the job here. It's important that we keep the mutex unlocked while doing the job.
-			if(pThreadInfo->mCurrentJob.mpRunnable)
-				pThreadInfo->mCurrentJob.mpRunnable->Run(pThreadInfo->mCurrentJob.mpContext);
-			else if(pThreadInfo->mCurrentJob.mpFunction)
-				pThreadInfo->mCurrentJob.mpFunction(pThreadInfo->mCurrentJob.mpContext);
+			if(pThreadInfo->mCurrentJob.HasWork())
+			{
+				if(pThreadInfo->mCurrentJob.mpRunnable)
+					pThreadInfo->mCurrentJob.mpRunnable->Run(pThreadInfo->mCurrentJob.mpContext);
+				else if(pThreadInfo->mCurrentJob.mpFunction)
+					pThreadInfo->mCurrentJob.mpFunction(pThreadInfo->mCurrentJob.mpContext);
+				else
+				{
+					pThreadInfo->mCurrentJob.mCallable.Invoke();
+					pThreadInfo->mCurrentJob.mCallable.Reset(); // Release the callable's captures before the job counts as complete.
+				}
+
+				pThreadPool->mnCompletedJobCount.Increment();
+				pThreadPool->CompleteJob(pThreadInfo->mCurrentJob);
+			}
 			else
 				pThreadInfo->mbQuit = true;  // Tell ourself to quit.
 
@@ -259,11 +467,39 @@ intptr_t EA::Thread::ThreadPool::ThreadFunction(void* pContext)
 
 			pMutex->Lock();
 
+			if(pThreadInfo->mCurrentJob.mpJobRecord) // HasWork is false by now for a callable job.
+				pThreadPool->RetireJob(pThreadInfo->mCurrentJob);
+
 			--pThreadPool->mnActiveCount; // Atomic integer operation.
 			pThreadInfo->mbActive = false;
 		}
+		else if(pThreadPool->mnIdleSpinCount && !bPolled)
+		{
+			// Poll for a new job for a while before waiting on the condition. A job queued
+			// during this time doesn't signal the condition, so it is picked up without a
+			// kernel wakeup on either side. We register as a polling thread before unlocking,
+			// so that QueueJob can see us by the time it can add a job.
+			const int32_t nSequence = pThreadPool->mnJobQueueSequence.GetValue();
+
+			bPolled = true;
+			++pThreadPool->mnSpinningCount; // Atomic integer operation.
+			pMutex->Unlock();
+
+			for(int i = pThreadPool->mnIdleSpinCount; (i > 0) && (pThreadPool->mnJobQueueSequence.GetValue() == nSequence) && !pThreadInfo->mbQuit; i--)
+				EAProcessorPause();
+
+			// Unregister, unless a queued job has already claimed us. Either way we re-check
+			// mJobList under the mutex before waiting, which is why it is safe for QueueJob
+			// not to signal while it sees a positive mnSpinningCount.
+			for(int32_t n = pThreadPool->mnSpinningCount.GetValue(); (n > 0) && !pThreadPool->mnSpinningCount.SetValueConditional(n - 1, n); )
+				n = pThreadPool->mnSpinningCount.GetValue();
+
+			pMutex->Lock();
+		}
 		else
 		{
+			bPolled = false;
+
 			// The wait call here will unlock the condition variable and will re-lock it upon return.
 			EA::Thread::ThreadTime timeoutAbsolute = (GetThreadTime() + pThreadPool->mnIdleTimeoutMilliseconds);
 
@@ -289,21 +525,37 @@ intptr_t EA::Thread::ThreadPool::ThreadFunction(void* pContext)
 }
 
 
-EA::Thread::ThreadPool::Result EA::Thread::ThreadPool::QueueJob(const Job& job, Thread** ppThread, bool /*bEnableDeferred*/)
+EA::Thread::ThreadPool::Result EA::Thread::ThreadPool::QueueJob(Job& job, Thread** ppThread, bool /*bEnableDeferred*/)
 {
 	if(mbInitialized){
 		mThreadMutex.Lock();
 
+		if(job.HasWork() && !TrackJob(job)){
+			mThreadMutex.Unlock();
+			return kResultError;
+		}
+
 		// If there are other threads busy with jobs or other threads soon to be busy with jobs and if the thread count is less than the maximum allowable, bump up the thread count by one.
 		EAT_ASSERT(mnActiveCount <= mnCurrentCount);
 		if((((int)mnActiveCount >= mnCurrentCount) || !mJobList.empty()) && (mnCurrentCount < (int)mnMaxCount))
 			AdjustThreadCount((unsigned)(mnCurrentCount + 1));
 
-		mJobList.push_back(job);
+		mJobList.push_back(std::move(job)); // job.mnJobID remains valid for the caller.
+		++mnJobQueueSequence; // Atomic integer operation.
 		FixThreads();
 
 		if(mnPauseCount == 0)
-			mThreadCondition.Signal(false); // Wake up one thread to work on this.
+		{
+			// If a thread is polling for jobs, claim it for this job instead of waking up
+			// a waiting thread. Each polling thread can be claimed by only one job.
+			bool bClaimed = false;
+
+			for(int32_t n = mnSpinningCount.GetValue(); (n > 0) && !bClaimed; n = mnSpinningCount.GetValue())
+				bClaimed = mnSpinningCount.SetValueConditional(n - 1, n);
+
+			if(!bClaimed)
+				mThreadCondition.Signal(false); // Wake up one thread to work on this.
+		}
 
 		mThreadMutex.Unlock();
 
@@ -321,13 +573,14 @@ EA::Thread::ThreadPool::Result EA::Thread::ThreadPool::QueueJob(const Job& job,
 }
 
 
-int EA::Thread::ThreadPool::Begin(IRunnable* pRunnable, void* pContext, Thread** ppThread, bool bEnableDeferred)
+int EA::Thread::ThreadPool::Begin(IRunnable* pRunnable, void* pContext, Thread** ppThread, bool bEnableDeferred, JobGroup* pJobGroup)
 {
 	Job job;
 	job.mnJobID    = mnLastJobID.Increment();
 	job.mpRunnable = pRunnable;
 	job.mpFunction = NULL;
 	job.mpContext  = pContext;
+	job.mpJobGroup = pJobGroup;
 
 	if(QueueJob(job, ppThread, bEnableDeferred) != kResultError)
 		return job.mnJobID;
@@ -335,13 +588,25 @@ int EA::Thread::ThreadPool::Begin(IRunnable* pRunnable, void* pContext, Thread**
 }
 
 
-int EA::Thread::ThreadPool::Begin(RunnableFunction pFunction, void* pContext, Thread** ppThread, bool bEnableDeferred)
+int EA::Thread::ThreadPool::BeginJob(Job& job, JobGroup* pJobGroup)
+{
+	job.mnJobID    = mnLastJobID.Increment();
+	job.mpJobGroup = pJobGroup;
+
+	if(QueueJob(job, NULL, false) != kResultError)
+		return job.mnJobID;
+	return kResultError;
+}
+
+
+int EA::Thread::ThreadPool::Begin(RunnableFunction pFunction, void* pContext, Thread** ppThread, bool bEnableDeferred, JobGroup* pJobGroup)
 {
 	Job job;
-	job.mnJobID     = mnLastJobID.Increment();
+	job.mnJobID    = mnLastJobID.Increment();
 	job.mpRunnable = NULL;
 	job.mpFunction = pFunction;
 	job.mpContext  = pContext;
+	job.mpJobGroup = pJobGroup;
 
 	if(QueueJob(job, ppThread, bEnableDeferred) != kResultError)
 		return job.mnJobID;
@@ -377,69 +642,23 @@ int EA::Thread::ThreadPool::WaitForJobCompletion(int nJob, JobWait jobWait, cons
 		}
 		else{ // jobWait == kJobWaitAll
 			// Wait for all current and queued jobs to complete.
-			bool shouldContinue = true;
-
-			while(shouldContinue)
-			{
-				mThreadMutex.Lock();
-				shouldContinue = (((mnActiveCount != 0) || !mJobList.empty()) && (GetThreadTime() < timeoutAbsolute));
-				mThreadMutex.Unlock();
-				if(shouldContinue)
-					ThreadSleep(10);
-			}
-
-			mThreadMutex.Lock();
-
-			if((mnActiveCount == 0) && mJobList.empty())
-				nResult = kResultOK;
-			else
-				nResult = kResultTimeout;
-
-			mThreadMutex.Unlock();
+			nResult = mAllJobGroup.Wait(timeoutAbsolute) ? kResultOK : kResultTimeout;
 		}
 	}
 	else{
-		// Like above we do the wait via polling. Ideally we want to set up a 
-		// mechanism whereby we sleep until an alarm wakes us. This can perhaps
-		// be done by setting a flag in the job which causes the job to signal
-		// the alarm when complete. In the meantime we will follow the simpler
-		// behaviour we have here.
+		// A job which has no record has completed, or never existed.
+		mThreadMutex.Lock();
+		JobRecord* const pJobRecord = AcquireJobRecord(nJob);
+		mThreadMutex.Unlock();
 
-		bool bJobExists;
+		if(pJobRecord){
+			nResult = WaitForJobRecord(pJobRecord, timeoutAbsolute);
 
-		for(;;){
-			bJobExists = false;
 			mThreadMutex.Lock();
-			
-			// Search the list of jobs yet to become active to see if the job exists in there.
-			for(JobList::iterator it(mJobList.begin()); it != mJobList.end(); ++it){
-				const Job& job = *it;
-
-				if(job.mnJobID == nJob){ // If the user's job was found...
-					bJobExists = true;
-					nResult = kResultTimeout;
-				}
-			}
-
-			// Search the list of jobs actively executing as well.
-			for(ThreadInfoList::iterator it(mThreadInfoList.begin()); it != mThreadInfoList.end(); ++it){
-				const ThreadInfo* const pThreadInfo = *it;
-				const Job& job = pThreadInfo->mCurrentJob;
-
-				// Note the thread must be active for the Job assigned to it be valid.
-				if(pThreadInfo->mbActive && job.mnJobID == nJob){ // If the user's job was found...
-					bJobExists = true;
-					nResult = kResultTimeout;
-				}
-			}
-	  
+			ReleaseJobRecord(pJobRecord);
 			mThreadMutex.Unlock();
-			if(!bJobExists || (GetThreadTime() >= timeoutAbsolute))
-				break;
-			ThreadSleep(10);
 		}
-
-		if(!bJobExists)
+		else
 			nResult = kResultOK;
 	}
 
@@ -546,6 +765,169 @@ int EA::Thread::ThreadPool::GetThreadCount()
 }
 
 
+int64_t EA::Thread::ThreadPool::GetCompletedJobCount(bool bReset)
+{
+	return bReset ? mnCompletedJobCount.Reset() : mnCompletedJobCount.GetValue();
+}
+
+
+bool EA::Thread::ThreadPool::TrackJob(Job& job)
+{
+	// Assumes that the mutex is locked.
+	JobRecord* pJobRecord = mpFreeJobRecordList;
+
+	if(pJobRecord)
+		mpFreeJobRecordList = pJobRecord->mpNext;
+	else
+	{
+		Allocator* const pAllocator = gpAllocator;
+		void*      const pMemory    = pAllocator ? pAllocator->Alloc(sizeof(JobRecord), EATHREAD_ALLOC_PREFIX "ThreadPool", 0)
+		                                         : ::operator new(sizeof(JobRecord), std::nothrow);
+		if(!pMemory)
+			return false;
+
+		pJobRecord = new(pMemory) JobRecord;
+		pJobRecord->mpAllocator = pAllocator;
+	}
+
+	JobRecord*& pBucket = mJobRecordHash[(uint32_t)job.mnJobID & (kJobRecordHashSize - 1)];
+
+	pJobRecord->mnState.SetValue(kJobRecordStateQueued);
+	pJobRecord->mnJobID    = job.mnJobID;
+	pJobRecord->mnRefCount = 1;
+	pJobRecord->mpNext     = pBucket;
+	pBucket                = pJobRecord;
+	job.mpJobRecord        = pJobRecord;
+
+	mAllJobGroup.Add();
+
+	if(job.mpJobGroup)
+		job.mpJobGroup->Add();
+
+	return true;
+}
+
+
+void EA::Thread::ThreadPool::CompleteJob(const Job& job)
+{
+	// This is called without the mutex locked, so the record stays in the hash table
+	// until RetireJob. Waiters which find it there see that the job is done.
+	AtomicInt32& state = job.mpJobRecord->mnState;
+
+	if(state.SetValue(kJobRecordStateDone) == kJobRecordStateWaiters)
+	{
+		#if EATHREAD_FUTEX_WORD_AVAILABLE
+			FutexWordWakeAll(state);
+		#else
+			// A waiter sets kJobRecordStateWaiters and checks the state with mJobRecordMutex locked,
+			// so taking mJobRecordMutex here guarantees that it is either waiting or will see the change.
+			mJobRecordMutex.Lock();
+			mJobRecordCondition.Signal(true);
+			mJobRecordMutex.Unlock();
+		#endif
+	}
+
+	if(job.mpJobGroup)
+		job.mpJobGroup->Done();
+
+	mAllJobGroup.Done();
+}
+
+
+void EA::Thread::ThreadPool::RetireJob(const Job& job)
+{
+	// Assumes that the mutex is locked.
+	JobRecord* const pJobRecord = job.mpJobRecord;
+
+	for(JobRecord** ppLink = &mJobRecordHash[(uint32_t)job.mnJobID & (kJobRecordHashSize - 1)]; *ppLink; ppLink = &(*ppLink)->mpNext)
+	{
+		if(*ppLink == pJobRecord)
+		{
+			*ppLink = pJobRecord->mpNext;
+			break;
+		}
+	}
+
+	ReleaseJobRecord(pJobRecord);
+}
+
+
+EA::Thread::ThreadPool::JobRecord* EA::Thread::ThreadPool::AcquireJobRecord(int nJob)
+{
+	// Assumes that the mutex is locked.
+	for(JobRecord* pJobRecord = mJobRecordHash[(uint32_t)nJob & (kJobRecordHashSize - 1)]; pJobRecord; pJobRecord = pJobRecord->mpNext)
+	{
+		if(pJobRecord->mnJobID == nJob)
+		{
+			pJobRecord->mnRefCount++;
+			return pJobRecord;
+		}
+	}
+
+	return NULL;
+}
+
+
+void EA::Thread::ThreadPool::ReleaseJobRecord(JobRecord* pJobRecord)
+{
+	// Assumes that the mutex is locked.
+	if(--pJobRecord->mnRefCount == 0)
+	{
+		pJobRecord->mpNext  = mpFreeJobRecordList;
+		mpFreeJobRecordList = pJobRecord;
+	}
+}
+
+
+EA::Thread::ThreadPool::Result EA::Thread::ThreadPool::WaitForJobRecord(JobRecord* pJobRecord, const ThreadTime& timeoutAbsolute)
+{
+	AtomicInt32& state = pJobRecord->mnState;
+
+	#if EATHREAD_FUTEX_WORD_AVAILABLE
+		for(;;)
+		{
+			const int32_t nState = state.GetValue();
+
+			if(nState == kJobRecordStateDone)
+				return kResultOK;
+
+			// kJobRecordStateWaiters tells CompleteJob that it needs to make a wake call.
+			if((nState == kJobRecordStateQueued) && !state.SetValueConditional(kJobRecordStateWaiters, kJobRecordStateQueued))
+				continue;
+
+			if(!FutexWordWait(state, kJobRecordStateWaiters, timeoutAbsolute))
+				return (state.GetValue() == kJobRecordStateDone) ? kResultOK : kResultTimeout;
+		}
+	#else
+		Result result = kResultOK;
+
+		mJobRecordMutex.Lock();
+
+		for(;;)
+		{
+			const int32_t nState = state.GetValue();
+
+			if(nState == kJobRecordStateDone)
+				break;
+
+			if((nState == kJobRecordStateQueued) && !state.SetValueConditional(kJobRecordStateWaiters, kJobRecordStateQueued))
+				continue;
+
+			if(mJobRecordCondition.Wait(&mJobRecordMutex, timeoutAbsolute) == Condition::kResultTimeout)
+			{
+				if(state.GetValue() != kJobRecordStateDone)
+					result = kResultTimeout;
+				break;
+			}
+		}
+
+		mJobRecordMutex.Unlock();
+
+		return result;
+	#endif
+}
+
+
 EA::Thread::ThreadPool::ThreadInfo* EA::Thread::ThreadPool::CreateThreadInfo()
 {
 	// Currently we assume that allocation never fails.
@@ -586,7 +968,8 @@ void EA::Thread::ThreadPool::AdjustThreadCount(unsigned nDesiredCount)
 	while(nAdjustment < 0) // If we are to quit threads...
 	{
 		// An empty job is a signal for a thread to quit.
-		QueueJob(Job(), NULL, true);
+		Job quitJob;
+		QueueJob(quitJob, NULL, true);
 		nAdjustment++;
 	}
 
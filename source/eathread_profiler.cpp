@@ -0,0 +1,737 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <eathread/eathread_profiler.h>
+
+#if EATHREAD_PROFILER_AVAILABLE
+
+#include <eathread/eathread_callstack.h>
+#include <eathread/eathread_thread.h>
+#include <eathread/eathread_atomic.h>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <new>
+
+#ifndef sigev_notify_thread_id // Older glibc versions don't name this union member.
+	#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		// The sampling state of one thread. The thread's signal handler is the only writer
+		// of the sample buffer and mnWriteCount, and Collect is the only writer of mnReadCount.
+		struct ProfilerThread
+		{
+			ThreadId    mThreadId;
+			pid_t       mThreadPid;             // The kernel's id for the thread. The signal handler compares it with its own, as the signal may be stale. 0 if unused.
+			timer_t     mTimer;
+			bool        mbTimerCreated;
+			void*       mpStackBase;            // The thread's stack bounds, for the frame pointer unwinder.
+			void*       mpStackLimit;
+			uint32_t*   mpDepthArray;           // The depth of each sample in the buffer.
+			void**      mpCallstackArray;       // mnMaxDepth entries per sample.
+			uint32_t    mnSampleMask;           // The buffer's sample capacity - 1.
+			uint32_t    mnMaxDepth;
+			AtomicInt32 mnWriteCount;
+			AtomicInt32 mnReadCount;
+			AtomicInt32 mnDroppedCount;
+			AtomicInt64 mnSampleNanoseconds;
+
+			ProfilerThread()
+				: mThreadId(kThreadIdInvalid), mThreadPid(0), mTimer(), mbTimerCreated(false), mpStackBase(NULL), mpStackLimit(NULL),
+				  mpDepthArray(NULL), mpCallstackArray(NULL), mnSampleMask(0), mnMaxDepth(0), mnWriteCount(0), mnReadCount(0), mnDroppedCount(0), mnSampleNanoseconds(0) {}
+		};
+
+
+		namespace
+		{
+			const int    kProfilerSignalTag     = 0x45500000; // Identifies our timers' signals. The low 16 bits are the thread's index.
+			const int    kProfilerSignalTagMask = (int)0xffff0000;
+			const size_t kMaxProfilerThreads    = 0x10000;
+			const size_t kMaxEnumeratedThreads  = 128; // The same as kMaxThreadDynamicDataCount, which isn't a compile-time constant.
+
+			AtomicPointer    gpProfiler;                    // The started Profiler, if any.
+			AtomicPointer    gpProfilerThreadArray;         // Its ProfilerThread array, which the signal handler reads.
+			size_t           gnProfilerThreadCapacity = 0;  // Written before gpProfilerThreadArray is set.
+			AtomicInt32      gnProfilerHandlerCount;        // The number of signal handlers which may be using gpProfilerThreadArray.
+			pthread_once_t   gProfilerSignalOnce = PTHREAD_ONCE_INIT;
+			struct sigaction gPreviousProfilerAction;
+			bool             gbProfilerSignalInstalled = false;
+
+
+			void* AllocProfilerMemory(size_t nSize)
+			{
+				Allocator* pAllocator = GetAllocator();
+
+				return pAllocator ? pAllocator->Alloc(nSize, "EAThread Profiler") : new(std::nothrow) char[nSize];
+			}
+
+
+			void FreeProfilerMemory(void* pMemory)
+			{
+				if(pMemory)
+				{
+					Allocator* pAllocator = GetAllocator();
+
+					if(pAllocator)
+						pAllocator->Free(pMemory);
+					else
+						delete[] static_cast<char*>(pMemory);
+				}
+			}
+
+
+			inline uint64_t GetNanoseconds(const timespec& ts)
+				{ return ((uint64_t)ts.tv_sec * UINT64_C(1000000000)) + (uint64_t)ts.tv_nsec; }
+
+
+			// Runs in the signal handler, so everything it calls must be async-signal-safe.
+			void TakeSample(ProfilerThread& thread, void* pSignalContext)
+			{
+				timespec tsStart, tsEnd;
+				clock_gettime(CLOCK_MONOTONIC, &tsStart);
+
+				const uint32_t nWriteCount = (uint32_t)thread.mnWriteCount.GetValueRaw(); // We are its only writer.
+				const uint32_t nReadCount  = (uint32_t)thread.mnReadCount.GetValue();
+
+				if((nWriteCount - nReadCount) > thread.mnSampleMask)
+					thread.mnDroppedCount.Increment();
+				else
+				{
+					const uint32_t nSample = nWriteCount & thread.mnSampleMask;
+
+					thread.mpDepthArray[nSample] = (uint32_t)GetSignalCallstack(thread.mpCallstackArray + (nSample * thread.mnMaxDepth), thread.mnMaxDepth,
+																			   pSignalContext, thread.mpStackBase, thread.mpStackLimit);
+					thread.mnWriteCount.SetValue((int32_t)(nWriteCount + 1)); // This is a full barrier, which publishes the sample to Collect.
+				}
+
+				clock_gettime(CLOCK_MONOTONIC, &tsEnd);
+				thread.mnSampleNanoseconds.Add((int64_t)(GetNanoseconds(tsEnd) - GetNanoseconds(tsStart)));
+			}
+
+
+			void ProfilerSignalHandler(int nSignal, siginfo_t* pSignalInfo, void* pSignalContext)
+			{
+				const int nSavedErrno = errno;
+
+				if((pSignalInfo->si_code == SI_TIMER) && ((pSignalInfo->si_value.sival_int & kProfilerSignalTagMask) == kProfilerSignalTag))
+				{
+					// Stop waits for the count to return to 0 before it frees the thread array.
+					gnProfilerHandlerCount.Increment();
+
+					ProfilerThread* const pThreadArray = static_cast<ProfilerThread*>(gpProfilerThreadArray.GetValue());
+					const size_t          nIndex       = (size_t)(pSignalInfo->si_value.sival_int & ~kProfilerSignalTagMask);
+
+					// The signal may be from a timer which expired just before its Profiler stopped,
+					// in which case the array is gone, or belongs to a Profiler started since.
+					if(pThreadArray && (nIndex < gnProfilerThreadCapacity) && (pThreadArray[nIndex].mThreadPid == (pid_t)syscall(SYS_gettid)))
+						TakeSample(pThreadArray[nIndex], pSignalContext);
+
+					gnProfilerHandlerCount.Decrement();
+				}
+				else if(gPreviousProfilerAction.sa_flags & SA_SIGINFO)
+				{
+					if(gPreviousProfilerAction.sa_sigaction)
+						gPreviousProfilerAction.sa_sigaction(nSignal, pSignalInfo, pSignalContext);
+				}
+				else if((gPreviousProfilerAction.sa_handler != SIG_DFL) && (gPreviousProfilerAction.sa_handler != SIG_IGN))
+					gPreviousProfilerAction.sa_handler(nSignal);
+
+				errno = nSavedErrno;
+			}
+
+
+			void InstallProfilerSignal()
+			{
+				// Some GetCallstack implementations (e.g. glibc's backtrace) load what they need on first
+				// use, which isn't safe to do in a signal handler. So we make sure that's already done.
+				void* callstack[4];
+				GetCallstack(callstack, EAArrayCount(callstack), (const CallstackContext*)NULL);
+
+				struct sigaction action;
+				memset(&action, 0, sizeof(action));
+				action.sa_sigaction = ProfilerSignalHandler;
+				action.sa_flags     = SA_SIGINFO | SA_RESTART | SA_ONSTACK;
+				sigemptyset(&action.sa_mask);
+
+				gbProfilerSignalInstalled = (sigaction(EATHREAD_PROFILER_SIGNAL, &action, &gPreviousProfilerAction) == 0);
+			}
+
+
+			void FreeThreadBuffers(ProfilerThread& thread)
+			{
+				FreeProfilerMemory(thread.mpDepthArray);
+				FreeProfilerMemory(thread.mpCallstackArray);
+				thread.mpDepthArray     = NULL;
+				thread.mpCallstackArray = NULL;
+			}
+
+
+			// Sets up thread (whose index is nIndex) to sample the thread described by pData, and
+			// starts its timer. Returns false if the thread couldn't be sampled, in which case
+			// no signal refers to nIndex, and it can be used for another thread.
+			bool StartThreadTimer(ProfilerThread& thread, const EAThreadDynamicData* pData, size_t nIndex, const ProfilerParameters& parameters)
+			{
+				const size_t nSampleCapacity = parameters.mnSampleCapacity;
+
+				thread.mThreadId         = pData->mThreadId;
+				thread.mnSampleMask      = (uint32_t)(nSampleCapacity - 1);
+				thread.mnMaxDepth        = (uint32_t)parameters.mnMaxDepth;
+				thread.mpDepthArray      = static_cast<uint32_t*>(AllocProfilerMemory(nSampleCapacity * sizeof(uint32_t)));
+				thread.mpCallstackArray  = static_cast<void**>(AllocProfilerMemory(nSampleCapacity * parameters.mnMaxDepth * sizeof(void*)));
+				thread.mpStackBase       = NULL;
+				thread.mpStackLimit      = NULL;
+				thread.mnWriteCount.SetValue(0);
+				thread.mnReadCount.SetValue(0);
+
+				pthread_attr_t attr;
+				void*          pStackAddress;
+				size_t         nStackSize;
+
+				if(pthread_getattr_np(thread.mThreadId, &attr) == 0)
+				{
+					if(pthread_attr_getstack(&attr, &pStackAddress, &nStackSize) == 0)
+					{
+						thread.mpStackLimit = pStackAddress;
+						thread.mpStackBase  = static_cast<char*>(pStackAddress) + nStackSize;
+					}
+
+					pthread_attr_destroy(&attr);
+				}
+
+				clockid_t clockId;
+
+				if(thread.mpDepthArray && thread.mpCallstackArray && (pthread_getcpuclockid(thread.mThreadId, &clockId) == 0))
+				{
+					thread.mThreadPid = pData->mThreadPid; // The signal handler accepts signals for this slot from here on.
+
+					sigevent event;
+					memset(&event, 0, sizeof(event));
+					event.sigev_notify            = SIGEV_THREAD_ID;
+					event.sigev_signo             = EATHREAD_PROFILER_SIGNAL;
+					event.sigev_value.sival_int   = kProfilerSignalTag | (int)nIndex;
+					event.sigev_notify_thread_id  = pData->mThreadPid;
+
+					if(timer_create(clockId, &event, &thread.mTimer) == 0)
+					{
+						itimerspec spec;
+						spec.it_interval.tv_sec  = parameters.mnSampleIntervalUs / 1000000;
+						spec.it_interval.tv_nsec = (parameters.mnSampleIntervalUs % 1000000) * 1000;
+						spec.it_value            = spec.it_interval;
+
+						if(timer_settime(thread.mTimer, 0, &spec, NULL) == 0)
+						{
+							thread.mbTimerCreated = true;
+							return true;
+						}
+
+						timer_delete(thread.mTimer);
+					}
+
+					thread.mThreadPid = 0;
+				}
+
+				FreeThreadBuffers(thread);
+				return false;
+			}
+
+
+			inline bool IsSameThread(const ProfilerThread& thread, const EAThreadDynamicData* pData)
+			{
+				return pthread_equal(thread.mThreadId, pData->mThreadId) && (thread.mThreadPid == pData->mThreadPid);
+			}
+
+
+			uint64_t HashCallstack(void* const* pCallstack, size_t nDepth)
+			{
+				uint64_t nHash = UINT64_C(14695981039346656037); // FNV-1a, a pointer at a time.
+
+				for(size_t i = 0; i < nDepth; i++)
+					nHash = (nHash ^ (uint64_t)(uintptr_t)pCallstack[i]) * UINT64_C(1099511628211);
+
+				nHash ^= (nHash >> 32);
+
+				return nHash ? nHash : 1; // 0 marks an unused table entry.
+			}
+
+
+			struct FoldedStackWriter
+			{
+				Profiler::WriteFunction mpWriteFunction;
+				void*                   mpContext;
+
+				void Write(const char* pText)
+					{ mpWriteFunction(pText, strlen(pText), mpContext); }
+			};
+
+
+			void WriteFrameName(FoldedStackWriter& writer, void* pAddress, bool bReturnAddress)
+			{
+				// A return address may be just past the end of its function, if the call is the
+				// function's last instruction (e.g. to a function which doesn't return), so we
+				// look up the call instruction instead.
+				const uintptr_t nAddress = (uintptr_t)pAddress - (bReturnAddress ? 1 : 0);
+				char            buffer[384];
+				Dl_info         info;
+				memset(&info, 0, sizeof(info)); // dladdr sometimes leaves fields untouched.
+
+				if(dladdr((void*)nAddress, &info) && info.dli_sname)
+				{
+					int   nStatus     = 0;
+					char* pDemangled  = abi::__cxa_demangle(info.dli_sname, NULL, NULL, &nStatus);
+
+					writer.Write(pDemangled ? pDemangled : info.dli_sname);
+					free(pDemangled);
+				}
+				else if(info.dli_fname && info.dli_fname[0])
+				{
+					const char* pFileName = strrchr(info.dli_fname, '/');
+
+					snprintf(buffer, sizeof(buffer), "%s+0x%llx", pFileName ? (pFileName + 1) : info.dli_fname, (unsigned long long)(nAddress - (uintptr_t)info.dli_fbase));
+					writer.Write(buffer);
+				}
+				else
+				{
+					snprintf(buffer, sizeof(buffer), "0x%llx", (unsigned long long)nAddress);
+					writer.Write(buffer);
+				}
+			}
+
+
+			void WriteFoldedStack(void* const* pCallstack, size_t nDepth, uint64_t nCount, void* pContext)
+			{
+				FoldedStackWriter& writer = *static_cast<FoldedStackWriter*>(pContext);
+				char               buffer[32];
+
+				if(nDepth == 0)
+					writer.Write("[unknown]");
+
+				for(size_t i = nDepth; i > 0; i--)
+				{
+					WriteFrameName(writer, pCallstack[i - 1], (i - 1) != 0);
+
+					if(i > 1)
+						writer.Write(";");
+				}
+
+				snprintf(buffer, sizeof(buffer), " %llu\n", (unsigned long long)nCount);
+				writer.Write(buffer);
+			}
+
+		} // namespace
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+
+EA::Thread::ProfilerParameters::ProfilerParameters()
+  : mnSampleIntervalUs(10000),
+	mnMaxDepth(32),
+	mnSampleCapacity(256),
+	mnMaxThreadCount(64)
+{
+}
+
+
+EA::Thread::Profiler::Profiler()
+  : mMutex(),
+	mParameters(),
+	mbStarted(false),
+	mpThreadArray(NULL),
+	mnThreadCount(0),
+	mpStackTable(NULL),
+	mnStackTableCapacity(0),
+	mnStackCount(0),
+	mpFrameArray(NULL),
+	mnFrameCount(0),
+	mnFrameCapacity(0),
+	mnSampleCount(0),
+	mnDroppedSampleCount(0),
+	mnSampleNanoseconds(0)
+{
+}
+
+
+EA::Thread::Profiler::~Profiler()
+{
+	Stop();
+	ClearProfile();
+}
+
+
+bool EA::Thread::Profiler::Start(const ProfilerParameters* pParameters)
+{
+	AutoMutex autoMutex(mMutex);
+
+	if(mbStarted)
+		return false;
+
+	pthread_once(&gProfilerSignalOnce, InstallProfilerSignal);
+
+	if(!gbProfilerSignalInstalled || !gpProfiler.SetValueConditional(this, NULL))
+		return false;
+
+	mParameters = pParameters ? *pParameters : ProfilerParameters();
+
+	if(mParameters.mnSampleIntervalUs < 1)
+		mParameters.mnSampleIntervalUs = 1;
+	if(mParameters.mnMaxDepth < 1)
+		mParameters.mnMaxDepth = 1;
+	if(mParameters.mnMaxDepth > kMaxDepth)
+		mParameters.mnMaxDepth = kMaxDepth;
+	if(mParameters.mnMaxThreadCount < 1)
+		mParameters.mnMaxThreadCount = 1;
+	if(mParameters.mnMaxThreadCount > kMaxProfilerThreads)
+		mParameters.mnMaxThreadCount = kMaxProfilerThreads;
+
+	size_t nSampleCapacity = 2;
+	while((nSampleCapacity < mParameters.mnSampleCapacity) && (nSampleCapacity < 0x100000))
+		nSampleCapacity *= 2;
+	mParameters.mnSampleCapacity = nSampleCapacity;
+
+	ClearProfile();
+
+	mpThreadArray = static_cast<ProfilerThread*>(AllocProfilerMemory(mParameters.mnMaxThreadCount * sizeof(ProfilerThread)));
+
+	if(!mpThreadArray)
+	{
+		gpProfiler.SetValue(NULL);
+		return false;
+	}
+
+	for(size_t i = 0; i < mParameters.mnMaxThreadCount; i++)
+		new(&mpThreadArray[i]) ProfilerThread;
+
+	mnThreadCount            = 0;
+	gnProfilerThreadCapacity = mParameters.mnMaxThreadCount;
+	gpProfilerThreadArray.SetValue(mpThreadArray); // This is a full barrier, which publishes the capacity too.
+	mbStarted = true;
+
+	UpdateThreads();
+
+	return true;
+}
+
+
+void EA::Thread::Profiler::Stop()
+{
+	AutoMutex autoMutex(mMutex);
+
+	if(mbStarted)
+	{
+		StopThreads();
+		mbStarted = false;
+		gpProfiler.SetValue(NULL);
+	}
+}
+
+
+bool EA::Thread::Profiler::IsStarted() const
+{
+	AutoMutex autoMutex(mMutex);
+
+	return mbStarted;
+}
+
+
+size_t EA::Thread::Profiler::UpdateThreads()
+{
+	AutoMutex autoMutex(mMutex);
+
+	if(!mbStarted)
+		return 0;
+
+	ThreadEnumData enumData[kMaxEnumeratedThreads];
+	size_t         nEnumCount   = EnumerateThreads(enumData, EAArrayCount(enumData));
+	size_t         nActiveCount = 0;
+
+	if(nEnumCount > EAArrayCount(enumData))
+		nEnumCount = EAArrayCount(enumData);
+
+	// Stop sampling the threads which ended. A thread's slot isn't reused for another
+	// thread, as a signal for it may still be on its way.
+	for(size_t i = 0; i < mnThreadCount; i++)
+	{
+		ProfilerThread& thread   = mpThreadArray[i];
+		bool            bRunning = false;
+
+		for(size_t j = 0; (j < nEnumCount) && !bRunning && thread.mbTimerCreated; j++)
+			bRunning = IsSameThread(thread, enumData[j].mpThreadDynamicData) && (enumData[j].mpThreadDynamicData->mnStatus != Thread::kStatusEnded);
+
+		if(bRunning)
+			nActiveCount++;
+		else if(thread.mbTimerCreated)
+		{
+			timer_delete(thread.mTimer);
+			thread.mbTimerCreated = false;
+		}
+	}
+
+	// Start sampling the threads which started.
+	for(size_t j = 0; (j < nEnumCount) && (mnThreadCount < mParameters.mnMaxThreadCount); j++)
+	{
+		const EAThreadDynamicData* const pData  = enumData[j].mpThreadDynamicData;
+		bool                             bKnown = false;
+
+		// A thread sets mThreadPid after it starts, so one that hasn't yet is picked up next time.
+		// The pthread_t of an ended thread may be invalid.
+		if((pData->mThreadPid == 0) || (pData->mnStatus == Thread::kStatusEnded))
+			continue;
+
+		for(size_t i = 0; (i < mnThreadCount) && !bKnown; i++)
+			bKnown = IsSameThread(mpThreadArray[i], pData);
+
+		if(!bKnown && StartThreadTimer(mpThreadArray[mnThreadCount], pData, mnThreadCount, mParameters))
+		{
+			mnThreadCount++;
+			nActiveCount++;
+		}
+	}
+
+	return nActiveCount;
+}
+
+
+size_t EA::Thread::Profiler::Collect()
+{
+	AutoMutex autoMutex(mMutex);
+
+	UpdateThreads();
+
+	return CollectSamples();
+}
+
+
+EA::Thread::ProfilerStats EA::Thread::Profiler::GetStats() const
+{
+	AutoMutex     autoMutex(mMutex);
+	ProfilerStats stats;
+
+	stats.mnSampleCount        = mnSampleCount;
+	stats.mnDroppedSampleCount = mnDroppedSampleCount;
+	stats.mnSampleNanoseconds  = mnSampleNanoseconds;
+	stats.mnThreadCount        = mnThreadCount;
+	stats.mnStackCount         = mnStackCount;
+
+	// Include what the threads have counted since the last Collect.
+	for(size_t i = 0; mpThreadArray && (i < mnThreadCount); i++)
+	{
+		stats.mnDroppedSampleCount += (uint64_t)mpThreadArray[i].mnDroppedCount.GetValue();
+		stats.mnSampleNanoseconds  += (uint64_t)mpThreadArray[i].mnSampleNanoseconds.GetValue();
+	}
+
+	return stats;
+}
+
+
+void EA::Thread::Profiler::EnumerateStacks(StackFunction pStackFunction, void* pContext) const
+{
+	AutoMutex autoMutex(mMutex);
+
+	for(size_t i = 0; i < mnStackTableCapacity; i++)
+	{
+		const StackEntry& entry = mpStackTable[i];
+
+		if(entry.mnHash)
+			pStackFunction(mpFrameArray + entry.mnFrameIndex, entry.mnDepth, entry.mnCount, pContext);
+	}
+}
+
+
+void EA::Thread::Profiler::WriteFoldedStacks(WriteFunction pWriteFunction, void* pContext) const
+{
+	FoldedStackWriter writer = { pWriteFunction, pContext };
+
+	EnumerateStacks(WriteFoldedStack, &writer);
+}
+
+
+void EA::Thread::Profiler::StopThreads()
+{
+	for(size_t i = 0; i < mnThreadCount; i++)
+	{
+		if(mpThreadArray[i].mbTimerCreated)
+		{
+			timer_delete(mpThreadArray[i].mTimer);
+			mpThreadArray[i].mbTimerCreated = false;
+		}
+	}
+
+	// A signal from a timer which expired before we deleted it may still arrive, so we make
+	// sure that any handler which runs from here on ignores it, and wait for those running now.
+	gpProfilerThreadArray.SetValue(NULL);
+
+	while(gnProfilerHandlerCount.GetValue() != 0)
+		ThreadSleep(kTimeoutYield);
+
+	CollectSamples();
+
+	for(size_t i = 0; i < mParameters.mnMaxThreadCount; i++)
+	{
+		FreeThreadBuffers(mpThreadArray[i]);
+		mpThreadArray[i].~ProfilerThread();
+	}
+
+	FreeProfilerMemory(mpThreadArray);
+	mpThreadArray = NULL;
+}
+
+
+size_t EA::Thread::Profiler::CollectSamples()
+{
+	size_t nCollected = 0;
+
+	for(size_t i = 0; mpThreadArray && (i < mnThreadCount); i++)
+	{
+		ProfilerThread& thread      = mpThreadArray[i];
+		const uint32_t  nReadCount  = (uint32_t)thread.mnReadCount.GetValueRaw(); // We are its only writer.
+		const uint32_t  nWriteCount = (uint32_t)thread.mnWriteCount.GetValue();
+
+		for(uint32_t n = nReadCount; n != nWriteCount; n++)
+		{
+			const uint32_t nSample = n & thread.mnSampleMask;
+
+			if(AddSample(thread.mpCallstackArray + (nSample * thread.mnMaxDepth), thread.mpDepthArray[nSample]))
+				nCollected++;
+			else
+				mnDroppedSampleCount++;
+		}
+
+		thread.mnReadCount.SetValue((int32_t)nWriteCount); // Gives the space back to the signal handler.
+
+		mnDroppedSampleCount += (uint64_t)thread.mnDroppedCount.SetValue(0);
+		mnSampleNanoseconds  += (uint64_t)thread.mnSampleNanoseconds.SetValue(0);
+	}
+
+	mnSampleCount += nCollected;
+
+	return nCollected;
+}
+
+
+bool EA::Thread::Profiler::AddSample(void* const* pCallstack, size_t nDepth)
+{
+	// We keep the table at most half full, so that probe sequences are short.
+	if(((mnStackCount + 1) * 2 > mnStackTableCapacity) && !GrowStackTable())
+		return false;
+
+	const uint64_t nHash = HashCallstack(pCallstack, nDepth);
+	const size_t   nMask = mnStackTableCapacity - 1;
+	size_t         i     = (size_t)nHash & nMask;
+
+	for(; mpStackTable[i].mnHash; i = (i + 1) & nMask)
+	{
+		StackEntry& entry = mpStackTable[i];
+
+		if((entry.mnHash == nHash) && (entry.mnDepth == nDepth) && (memcmp(mpFrameArray + entry.mnFrameIndex, pCallstack, nDepth * sizeof(void*)) == 0))
+		{
+			entry.mnCount++;
+			return true;
+		}
+	}
+
+	if(((mnFrameCount + nDepth) > mnFrameCapacity) && !GrowFrameArray(mnFrameCount + nDepth))
+		return false;
+
+	memcpy(mpFrameArray + mnFrameCount, pCallstack, nDepth * sizeof(void*));
+
+	StackEntry& entry  = mpStackTable[i];
+	entry.mnHash       = nHash;
+	entry.mnCount      = 1;
+	entry.mnFrameIndex = mnFrameCount;
+	entry.mnDepth      = nDepth;
+
+	mnFrameCount += nDepth;
+	mnStackCount++;
+
+	return true;
+}
+
+
+bool EA::Thread::Profiler::GrowStackTable()
+{
+	const size_t      nCapacity = mnStackTableCapacity ? (mnStackTableCapacity * 2) : 256;
+	StackEntry* const pTable    = static_cast<StackEntry*>(AllocProfilerMemory(nCapacity * sizeof(StackEntry)));
+
+	if(!pTable)
+		return false;
+
+	memset(pTable, 0, nCapacity * sizeof(StackEntry));
+
+	for(size_t i = 0; i < mnStackTableCapacity; i++)
+	{
+		if(mpStackTable[i].mnHash)
+		{
+			size_t j = (size_t)mpStackTable[i].mnHash & (nCapacity - 1);
+
+			while(pTable[j].mnHash)
+				j = (j + 1) & (nCapacity - 1);
+
+			pTable[j] = mpStackTable[i];
+		}
+	}
+
+	FreeProfilerMemory(mpStackTable);
+	mpStackTable         = pTable;
+	mnStackTableCapacity = nCapacity;
+
+	return true;
+}
+
+
+bool EA::Thread::Profiler::GrowFrameArray(size_t nMinCapacity)
+{
+	size_t nCapacity = mnFrameCapacity ? (mnFrameCapacity * 2) : 4096;
+
+	while(nCapacity < nMinCapacity)
+		nCapacity *= 2;
+
+	void** const pArray = static_cast<void**>(AllocProfilerMemory(nCapacity * sizeof(void*)));
+
+	if(!pArray)
+		return false;
+
+	if(mnFrameCount)
+		memcpy(pArray, mpFrameArray, mnFrameCount * sizeof(void*));
+
+	FreeProfilerMemory(mpFrameArray);
+	mpFrameArray    = pArray;
+	mnFrameCapacity = nCapacity;
+
+	return true;
+}
+
+
+void EA::Thread::Profiler::ClearProfile()
+{
+	FreeProfilerMemory(mpStackTable);
+	FreeProfilerMemory(mpFrameArray);
+
+	mpStackTable         = NULL;
+	mnStackTableCapacity = 0;
+	mnStackCount         = 0;
+	mpFrameArray         = NULL;
+	mnFrameCount         = 0;
+	mnFrameCapacity      = 0;
+	mnSampleCount        = 0;
+	mnDroppedSampleCount = 0;
+	mnSampleNanoseconds  = 0;
+}
+
+
+#endif // EATHREAD_PROFILER_AVAILABLE
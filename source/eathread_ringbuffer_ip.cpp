@@ -0,0 +1,410 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <eathread/eathread_ringbuffer_ip.h>
+#include <eathread/eathread_backoff.h>
+#include <eathread/eathread_sync.h>
+#include <eathread/internal/eathread_futexword.h>
+#include <string.h>
+
+#if EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+	#include <signal.h>
+	#include <unistd.h>
+	#include <errno.h>
+#endif
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		namespace
+		{
+			// Every record starts with this. Records are padded to a multiple of its size,
+			// so that every record, and the data in it, is 16 byte aligned, and so that
+			// the padding at the end of the buffer always has room for a header.
+			struct RecordHeader
+			{
+				uint32_t mnSize;        // Size of the record's data, kPaddingSize, or kUncommittedSize.
+				uint32_t mnExtent;      // Size of the record including this header and padding.
+				uint32_t mnBegin;       // Position of the reservation the record belongs to. Written last by Reserve.
+				int32_t  mnProducerId;  // Process id of the producer which reserved the record.
+			};
+
+			// Marks the filler which a producer puts at the end of the buffer when
+			// its record doesn't fit before the end, as records never wrap.
+			const uint32_t kPaddingSize = 0xffffffff;
+
+			// Marks a record which hasn't been committed. The consumer sees this only in
+			// a record which was skipped because its producer exited, and skips it too.
+			const uint32_t kUncommittedSize = 0xfffffffe;
+
+			// How long a thread waits behind an uncommitted reservation before it checks
+			// whether the reservation's producer has exited.
+			const int kAbandonCheckMilliseconds = 100;
+
+			inline uint32_t RecordExtent(uint32_t nSize)
+				{ return (uint32_t)sizeof(RecordHeader) + ((nSize + 15) & ~15u); }
+
+
+			// Polling is pointless with a single processor, as the process which
+			// would change the position can't run while we poll.
+			int CalculateSpinCount(int nSpinMicroseconds)
+			{
+				#ifdef EA_THREAD_COOPERATIVE
+					EA_UNUSED(nSpinMicroseconds);
+					return 0;
+				#else
+					if((nSpinMicroseconds <= 0) || (GetProcessorCount() <= 1))
+						return 0;
+
+					const uint64_t nSpinCount = (uint64_t)nSpinMicroseconds * GetProcessorPausesPerMicrosecond();
+					return (nSpinCount > INT32_MAX) ? INT32_MAX : (int)nSpinCount;
+				#endif
+			}
+
+
+			#if EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+				int32_t GetProducerId()
+					{ return (int32_t)getpid(); }
+
+				bool HasProducerExited(int32_t nProducerId)
+					{ return (nProducerId > 0) && (kill((pid_t)nProducerId, 0) != 0) && (errno == ESRCH); }
+			#else
+				// Without a way to tell that another process has exited, no reservation is ever skipped.
+				int32_t GetProducerId()
+					{ return 0; }
+
+				bool HasProducerExited(int32_t)
+					{ return false; }
+			#endif
+
+		} // namespace
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RingBufferIPControl
+///////////////////////////////////////////////////////////////////////////////
+
+EA::Thread::RingBufferIPControl::RingBufferIPControl(uint32_t nCapacity)
+  : mnReservePosition(0),
+	mnCommitPosition(0),
+	mnCommitWaiters(0),
+	mnReleasePosition(0),
+	mnReleaseWaiters(0),
+	mnCapacity(nCapacity)
+{
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RingBufferIPBase
+///////////////////////////////////////////////////////////////////////////////
+
+EA::Thread::RingBufferIPBase::RingBufferIPBase()
+  : mpControl(NULL), mpBuffer(NULL), mnCapacity(0), mnPeekEnd(0), mnSpinCount(0)
+{
+	EAT_COMPILETIME_ASSERT((sizeof(RecordHeader) == kRecordHeaderSize) && ((kRecordHeaderSize % 8) == 0));
+}
+
+
+void EA::Thread::RingBufferIPBase::Attach(RingBufferIPControl* pControl, char* pBuffer, uint32_t nCapacity, int nSpinMicroseconds)
+{
+	mpControl   = pControl;
+	mpBuffer    = pBuffer;
+	mnCapacity  = nCapacity;
+	mnPeekEnd   = (uint32_t)pControl->mnReleasePosition.GetValue();
+	mnSpinCount = CalculateSpinCount(nSpinMicroseconds);
+}
+
+
+void EA::Thread::RingBufferIPBase::Detach()
+{
+	mpControl  = NULL;
+	mpBuffer   = NULL;
+	mnCapacity = 0;
+}
+
+
+bool EA::Thread::RingBufferIPBase::WaitWhileEqual(AtomicInt32& position, uint32_t nPosition, AtomicInt32& nWaiters, const ThreadTime& timeoutAbsolute)
+{
+	// Polling is pointless if the timeout has already passed, as with a timeout of kTimeoutImmediate.
+	if((timeoutAbsolute == kTimeoutNone) || (GetThreadTime() < timeoutAbsolute))
+	{
+		for(int i = 0; i < mnSpinCount; i++)
+		{
+			if((uint32_t)position.GetValue() != nPosition)
+				return true;
+			EAProcessorPause();
+		}
+	}
+
+	// The waker changes the position and then reads nWaiters, while we increment nWaiters
+	// and then read the position. Both are full barriers, so at least one of us sees the
+	// other's change, and a parked waiter is never missed.
+	nWaiters.Increment();
+
+	bool bChanged = false;
+
+	for(;;)
+	{
+		if((uint32_t)position.GetValue() != nPosition)
+		{
+			bChanged = true;
+			break;
+		}
+
+		#if EATHREAD_FUTEX_WORD_AVAILABLE
+			if(!FutexWordWait(position, (int32_t)nPosition, timeoutAbsolute, true))
+			{
+				bChanged = ((uint32_t)position.GetValue() != nPosition);
+				break;
+			}
+		#else
+			// Without futex words there is no way to park on memory shared with other processes.
+			if((timeoutAbsolute != kTimeoutNone) && (GetThreadTime() >= timeoutAbsolute))
+				break;
+			ThreadSleep(1);
+		#endif
+	}
+
+	nWaiters.Decrement();
+
+	return bChanged;
+}
+
+
+void EA::Thread::RingBufferIPBase::Wake(AtomicInt32& position, AtomicInt32& nWaiters)
+{
+	if(nWaiters.GetValue() > 0)
+	{
+		#if EATHREAD_FUTEX_WORD_AVAILABLE
+			FutexWordWakeAll(position, true);
+		#else
+			EA_UNUSED(position);
+		#endif
+	}
+}
+
+
+bool EA::Thread::RingBufferIPBase::Reserve(Reservation& reservation, uint32_t nSize, const ThreadTime& timeoutAbsolute)
+{
+	if(!mpControl || (nSize > GetMaxRecordSize()))
+	{
+		EAT_ASSERT(mpControl && (nSize <= GetMaxRecordSize()));
+		return false;
+	}
+
+	const uint32_t nExtent = RecordExtent(nSize);
+	uint32_t       nReserve, nPadding, nEnd;
+
+	for(;;)
+	{
+		// Read the release position first. It can't then pass the reserve position we read.
+		const uint32_t nRelease = (uint32_t)mpControl->mnReleasePosition.GetValue();
+		nReserve                = (uint32_t)mpControl->mnReservePosition.GetValue();
+		const uint32_t nOffset  = nReserve & (mnCapacity - 1);
+
+		nPadding = ((nOffset + nExtent) > mnCapacity) ? (mnCapacity - nOffset) : 0;
+		nEnd     = nReserve + nPadding + nExtent;
+
+		if((nEnd - nRelease) > mnCapacity) // If the ring is full...
+		{
+			if(!WaitWhileEqual(mpControl->mnReleasePosition, nRelease, mpControl->mnReleaseWaiters, timeoutAbsolute))
+				return false;
+		}
+		else if(mpControl->mnReservePosition.SetValueConditional((int32_t)nEnd, (int32_t)nReserve))
+			break;
+	}
+
+	// SkipAbandoned trusts a header only once its mnBegin matches, so we write mnBegin last,
+	// and the padding header, which comes first in the ring, after the record header.
+	const int32_t       nProducerId = GetProducerId();
+	RecordHeader* const pHeader     = reinterpret_cast<RecordHeader*>(mpBuffer + ((nReserve + nPadding) & (mnCapacity - 1)));
+
+	pHeader->mnSize       = kUncommittedSize;
+	pHeader->mnExtent     = nExtent;
+	pHeader->mnProducerId = nProducerId;
+	EAWriteBarrier();
+	pHeader->mnBegin      = nReserve;
+
+	if(nPadding)
+	{
+		RecordHeader* const pPadding = reinterpret_cast<RecordHeader*>(mpBuffer + (nReserve & (mnCapacity - 1)));
+		pPadding->mnSize       = kPaddingSize;
+		pPadding->mnExtent     = nPadding;
+		pPadding->mnProducerId = nProducerId;
+		EAWriteBarrier();
+		pPadding->mnBegin      = nReserve;
+	}
+
+	reservation.mpData  = pHeader + 1;
+	reservation.mnSize  = nSize;
+	reservation.mnBegin = nReserve;
+	reservation.mnEnd   = nEnd;
+
+	return true;
+}
+
+
+void EA::Thread::RingBufferIPBase::Commit(const Reservation& reservation)
+{
+	RecordHeader* const pHeader = static_cast<RecordHeader*>(reservation.mpData) - 1;
+
+	EAT_ASSERT(RecordExtent(reservation.mnSize) <= pHeader->mnExtent);
+	pHeader->mnSize = reservation.mnSize;
+
+	// Records become visible in the order in which they were reserved, so wait for the producers before us.
+	// If the one we wait behind has exited without committing, we skip its reservation.
+	for(uint32_t nCommit = (uint32_t)mpControl->mnCommitPosition.GetValue(); nCommit != reservation.mnBegin; nCommit = (uint32_t)mpControl->mnCommitPosition.GetValue())
+	{
+		if(!WaitWhileEqual(mpControl->mnCommitPosition, nCommit, mpControl->mnCommitWaiters, GetThreadTime() + kAbandonCheckMilliseconds))
+			SkipAbandoned(nCommit);
+	}
+
+	mpControl->mnCommitPosition.SetValue((int32_t)reservation.mnEnd); // This is a full barrier, so the record is written before the consumer can see it.
+	Wake(mpControl->mnCommitPosition, mpControl->mnCommitWaiters);
+}
+
+
+bool EA::Thread::RingBufferIPBase::Write(const void* pData, uint32_t nSize, const ThreadTime& timeoutAbsolute)
+{
+	Reservation reservation;
+
+	if(Reserve(reservation, nSize, timeoutAbsolute))
+	{
+		memcpy(reservation.mpData, pData, nSize);
+		Commit(reservation);
+		return true;
+	}
+
+	return false;
+}
+
+
+void* EA::Thread::RingBufferIPBase::Peek(uint32_t& nSize, const ThreadTime& timeoutAbsolute)
+{
+	if(!mpControl)
+	{
+		EAT_ASSERT(false);
+		return NULL;
+	}
+
+	for(;;)
+	{
+		const uint32_t nRelease = (uint32_t)mpControl->mnReleasePosition.GetValue();
+		const uint32_t nCommit  = (uint32_t)mpControl->mnCommitPosition.GetValue();
+
+		if(nCommit == nRelease) // If the ring is empty...
+		{
+			// If a reservation is outstanding, its producer may have exited without committing it,
+			// and no other producer may be left to notice. So we check after waiting a while.
+			bool       bCheckAbandoned = false;
+			ThreadTime timeoutWait     = timeoutAbsolute;
+
+			if((uint32_t)mpControl->mnReservePosition.GetValue() != nCommit)
+			{
+				const ThreadTime timeoutAbandonCheck = GetThreadTime() + kAbandonCheckMilliseconds;
+
+				if((timeoutAbsolute == kTimeoutNone) || (timeoutAbandonCheck < timeoutAbsolute))
+				{
+					timeoutWait     = timeoutAbandonCheck;
+					bCheckAbandoned = true;
+				}
+			}
+
+			if(!WaitWhileEqual(mpControl->mnCommitPosition, nCommit, mpControl->mnCommitWaiters, timeoutWait))
+			{
+				if(bCheckAbandoned && SkipAbandoned(nCommit))
+					continue;
+
+				if((timeoutAbsolute != kTimeoutNone) && (GetThreadTime() >= timeoutAbsolute))
+					return NULL;
+			}
+			continue;
+		}
+
+		RecordHeader* const pHeader = reinterpret_cast<RecordHeader*>(mpBuffer + (nRelease & (mnCapacity - 1)));
+
+		if((pHeader->mnSize == kPaddingSize) || (pHeader->mnSize == kUncommittedSize)) // Padding, or a record skipped by SkipAbandoned.
+			ReleaseTo(nRelease + pHeader->mnExtent);
+		else
+		{
+			mnPeekEnd = nRelease + pHeader->mnExtent;
+			nSize     = pHeader->mnSize;
+			return pHeader + 1;
+		}
+	}
+}
+
+
+void EA::Thread::RingBufferIPBase::Release()
+{
+	EAT_ASSERT(mpControl && (mnPeekEnd != (uint32_t)mpControl->mnReleasePosition.GetValue())); // Release must follow a successful Peek.
+
+	if(mpControl)
+		ReleaseTo(mnPeekEnd);
+}
+
+
+bool EA::Thread::RingBufferIPBase::SkipAbandoned(uint32_t nCommit)
+{
+	// The space from the commit position to the reserve position belongs to reservations
+	// which are still outstanding, so it isn't reused while we look at it. But the producer
+	// of the oldest one may not have written its headers yet, which mnBegin tells us.
+	if((uint32_t)mpControl->mnReservePosition.GetValue() == nCommit)
+		return false;
+
+	const volatile RecordHeader* pHeader = reinterpret_cast<const RecordHeader*>(mpBuffer + (nCommit & (mnCapacity - 1)));
+
+	if(pHeader->mnBegin != nCommit)
+		return false;
+	EAReadBarrier();
+
+	uint32_t nEnd = nCommit + pHeader->mnExtent;
+
+	if(pHeader->mnSize == kPaddingSize) // The record itself follows the padding, at the start of the buffer.
+	{
+		pHeader = reinterpret_cast<const RecordHeader*>(mpBuffer + (nEnd & (mnCapacity - 1)));
+		if(pHeader->mnBegin != nCommit) // The record header is written before the padding header, so this shouldn't happen.
+			return false;
+		nEnd += pHeader->mnExtent;
+	}
+
+	if(!HasProducerExited(pHeader->mnProducerId))
+		return false;
+
+	// The record's size is still kUncommittedSize, which tells the consumer to skip it. 
+	// If another thread skipped it first, the commit position has moved on and we do nothing.
+	if(!mpControl->mnCommitPosition.SetValueConditional((int32_t)nEnd, (int32_t)nCommit))
+		return false;
+
+	Wake(mpControl->mnCommitPosition, mpControl->mnCommitWaiters);
+	return true;
+}
+
+
+void EA::Thread::RingBufferIPBase::ReleaseTo(uint32_t nPosition)
+{
+	mpControl->mnReleasePosition.SetValue((int32_t)nPosition); // This is a full barrier, so we are done reading the record before a producer can reuse its space.
+	Wake(mpControl->mnReleasePosition, mpControl->mnReleaseWaiters);
+}
+
+
+uint32_t EA::Thread::RingBufferIPBase::GetUsedSize() const
+{
+	if(mpControl)
+	{
+		const uint32_t nRelease = (uint32_t)mpControl->mnReleasePosition.GetValue();
+		return (uint32_t)mpControl->mnReservePosition.GetValue() - nRelease;
+	}
+
+	return 0;
+}
@@ -19,10 +19,13 @@ EA_DISABLE_VC_WARNING(4996) // This function or variable may be unsafe / depreca
 	  : mnReadWaiters(0), 
 		mnWriteWaiters(0), 
 		mnReaders(0),
+		mbUpgradeWaiting(false),
 		mThreadIdWriter(EA::Thread::kThreadIdInvalid), 
+		mThreadIdUpgrader(EA::Thread::kThreadIdInvalid), 
 		mMutex(NULL, false),
 		mReadCondition(NULL, false),
-		mWriteCondition(NULL, false)
+		mWriteCondition(NULL, false),
+		mUpgradeCondition(NULL, false)
 	{
 		// Empty
 	}
@@ -77,6 +80,7 @@ EA_DISABLE_VC_WARNING(4996) // This function or variable may be unsafe / depreca
 			ConditionParameters mop(pRWMutexParameters->mbIntraProcess);
 			mRWMutexData.mReadCondition.Init(&mop);
 			mRWMutexData.mWriteCondition.Init(&mop);
+			mRWMutexData.mUpgradeCondition.Init(&mop);
 			return true;
 		}
 
@@ -94,13 +98,19 @@ EA_DISABLE_VC_WARNING(4996) // This function or variable may be unsafe / depreca
 		// We cannot obtain a write lock recursively, else we will deadlock.
 		// Alternatively, we can build a bunch of extra logic to deal with this.
 		EAT_ASSERT(mRWMutexData.mThreadIdWriter != GetThreadId());
+
+		// A write or upgradeable read lock can't be taken while holding an upgradeable read lock; use Upgrade instead.
+		EAT_ASSERT((lockType == kLockTypeRead) || (mRWMutexData.mThreadIdUpgrader != GetThreadId()));
 	
 		// Assert that there aren't both readers and writers at the same time.
 		EAT_ASSERT(!((mRWMutexData.mThreadIdWriter != kThreadIdInvalid) && mRWMutexData.mnReaders));
 	
-		if(lockType == kLockTypeRead)
+		if((lockType == kLockTypeRead) || (lockType == kLockTypeUpgradeableRead))
 		{
-			while(mRWMutexData.mThreadIdWriter != kThreadIdInvalid)
+			// Readers also wait while an upgrade is pending, else the upgrader could be starved.
+			// An upgradeable reader additionally waits for any other upgradeable reader.
+			while((mRWMutexData.mThreadIdWriter != kThreadIdInvalid) || mRWMutexData.mbUpgradeWaiting ||
+				  ((lockType == kLockTypeUpgradeableRead) && (mRWMutexData.mThreadIdUpgrader != kThreadIdInvalid)))
 			{
 				EAT_ASSERT(mRWMutexData.mMutex.GetLockCount() == 1);
 	
@@ -119,6 +129,9 @@ EA_DISABLE_VC_WARNING(4996) // This function or variable may be unsafe / depreca
 			}
 	
 			result = ++mRWMutexData.mnReaders; // This is not an atomic operation. We are within a mutex lock.
+
+			if(lockType == kLockTypeUpgradeableRead)
+				mRWMutexData.mThreadIdUpgrader = GetThreadId();
 		}
 		else if(lockType == kLockTypeWrite)
 		{
@@ -179,8 +192,23 @@ EA_DISABLE_VC_WARNING(4996) // This function or variable may be unsafe / depreca
 			//}
 	
 			const int nNewReaders = --mRWMutexData.mnReaders; // This is not an atomic operation. We are within a mutex lock.
+
+			// Unlock can't tell which of a thread's read locks is being released, so a thread which holds
+			// plain read locks in addition to the upgradeable one gives up the latter on its first Unlock.
+			if((mRWMutexData.mThreadIdUpgrader != kThreadIdInvalid) && (mRWMutexData.mThreadIdUpgrader == GetThreadId()))
+			{
+				mRWMutexData.mThreadIdUpgrader = kThreadIdInvalid;
+
+				if(mRWMutexData.mnReadWaiters > 0) // Let in a waiting upgradeable reader.
+					mRWMutexData.mReadCondition.Signal(true);
+			}
+
 			if(nNewReaders > 0)
 			{
+				// If the upgrader is waiting for the other readers to leave and only it remains, wake it.
+				if((nNewReaders == 1) && mRWMutexData.mbUpgradeWaiting)
+					mRWMutexData.mUpgradeCondition.Signal(false);
+
 				EAT_ASSERT(mRWMutexData.mMutex.GetLockCount() == 1);
 				mRWMutexData.mMutex.Unlock();
 				return nNewReaders;
@@ -199,12 +227,77 @@ EA_DISABLE_VC_WARNING(4996) // This function or variable may be unsafe / depreca
 	}
 	
 	
+	int EA::Thread::RWMutex::Upgrade(const ThreadTime& timeoutAbsolute)
+	{
+		mRWMutexData.mMutex.Lock();
+		EAT_ASSERT(mRWMutexData.mMutex.GetLockCount() == 1);
+		EAT_ASSERT(mRWMutexData.mThreadIdUpgrader == GetThreadId());
+		EAT_ASSERT(mRWMutexData.mnReaders >= 1);
+
+		// mbUpgradeWaiting holds off new readers, so we only need to wait for the current ones.
+		// Writers can't get in while we hold our read lock.
+		mRWMutexData.mbUpgradeWaiting = true;
+
+		while(mRWMutexData.mnReaders > 1)
+		{
+			const Condition::Result mresult = mRWMutexData.mUpgradeCondition.Wait(&mRWMutexData.mMutex, timeoutAbsolute);
+
+			EAT_ASSERT(mresult != EA::Thread::Condition::kResultError);
+			EAT_ASSERT(mRWMutexData.mMutex.GetLockCount() == 1);
+
+			if(mresult == Condition::kResultTimeout)
+			{
+				// We keep the upgradeable read lock, but must let the readers we held off in.
+				mRWMutexData.mbUpgradeWaiting = false;
+
+				if(mRWMutexData.mnReadWaiters > 0)
+					mRWMutexData.mReadCondition.Signal(true);
+
+				mRWMutexData.mMutex.Unlock();
+				return kResultTimeout;
+			}
+		}
+
+		mRWMutexData.mbUpgradeWaiting = false;
+		mRWMutexData.mnReaders        = 0;
+		mRWMutexData.mThreadIdUpgrader = kThreadIdInvalid;
+		mRWMutexData.mThreadIdWriter  = GetThreadId();
+
+		EAT_ASSERT(mRWMutexData.mMutex.GetLockCount() == 1);
+		mRWMutexData.mMutex.Unlock();
+
+		return 1;
+	}
+
+
+	int EA::Thread::RWMutex::Downgrade()
+	{
+		mRWMutexData.mMutex.Lock();
+		EAT_ASSERT(mRWMutexData.mMutex.GetLockCount() == 1);
+		EAT_ASSERT(mRWMutexData.mThreadIdWriter == GetThreadId());
+		EAT_ASSERT(mRWMutexData.mnReaders == 0);
+
+		mRWMutexData.mThreadIdWriter = kThreadIdInvalid;
+		mRWMutexData.mnReaders       = 1;
+
+		if(mRWMutexData.mnReadWaiters > 0)
+			mRWMutexData.mReadCondition.Signal(true);
+
+		EAT_ASSERT(mRWMutexData.mMutex.GetLockCount() == 1);
+		mRWMutexData.mMutex.Unlock();
+
+		return 1;
+	}
+
+
 	int EA::Thread::RWMutex::GetLockCount(LockType lockType)
 	{
 		if(lockType == kLockTypeRead)
 			return mRWMutexData.mnReaders;
 		else if((lockType == kLockTypeWrite) && (mRWMutexData.mThreadIdWriter != kThreadIdInvalid))
 			return 1;
+		else if((lockType == kLockTypeUpgradeableRead) && (mRWMutexData.mThreadIdUpgrader != kThreadIdInvalid))
+			return 1;
 		return 0;
 	}
 
@@ -267,6 +267,224 @@
 	}
 
 
+#elif EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+
+	///////////////////////////////////////////////////////////////////////////
+	// SharedData
+	///////////////////////////////////////////////////////////////////////////
+
+	EA::Thread::SharedData::SharedData()
+	  : mnReaders(0),
+		mnWriters(0),
+		mbValid(false)
+	{
+		pthread_rwlockattr_t attr;
+
+		if(pthread_rwlockattr_init(&attr) == 0)
+		{
+			pthread_rwlockattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+
+			#if defined(__GLIBC__)
+				// RWMutexIP gives waiting writers priority over new readers. The glibc default is the reverse.
+				pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+			#endif
+
+			mbValid = (pthread_rwlock_init(&mRWLock, &attr) == 0);
+			pthread_rwlockattr_destroy(&attr);
+		}
+
+		EAT_ASSERT(mbValid);
+	}
+
+	EA::Thread::SharedData::~SharedData()
+	{
+		if(mbValid)
+			pthread_rwlock_destroy(&mRWLock);
+	}
+
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// EARWMutexIPData
+	///////////////////////////////////////////////////////////////////////////
+
+	EA::Thread::EARWMutexIPData::EARWMutexIPData()
+	  : mSharedData(),  // This still needs to be Init-ed.
+		mpSharedData(NULL)
+	{
+	}
+
+	EA::Thread::EARWMutexIPData::~EARWMutexIPData()
+	{
+		// mSharedData.Shutdown(); // This shouldn't be necessary, as the SharedData dtor will do this itself.
+	}
+
+	bool EA::Thread::EARWMutexIPData::Init(const char* pName)
+	{
+		Shutdown();
+
+		if(mSharedData.Init(pName))
+		{
+			if(mSharedData->mbValid)
+			{
+				mpSharedData = mSharedData.operator->();
+				return true;
+			}
+
+			mSharedData.Shutdown();
+		}
+
+		return false;
+	}
+
+	void EA::Thread::EARWMutexIPData::Shutdown()
+	{
+		mpSharedData = NULL;
+		mSharedData.Shutdown();
+	}
+
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// RWMutexIPParameters
+	///////////////////////////////////////////////////////////////////////////
+
+	EA::Thread::RWMutexIPParameters::RWMutexIPParameters(bool bIntraProcess, const char* pName)
+		: mbIntraProcess(bIntraProcess)
+	{
+		if(pName)
+		{
+			strncpy(mName, pName, sizeof(mName)-1);
+			mName[sizeof(mName)-1] = 0;
+		}
+		else
+			mName[0] = 0;
+	}
+
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// RWMutexIP
+	///////////////////////////////////////////////////////////////////////////
+
+	EA::Thread::RWMutexIP::RWMutexIP(const RWMutexIPParameters* pRWMutexIPParameters, bool bDefaultParameters)
+	{
+		if(!pRWMutexIPParameters && bDefaultParameters)
+		{
+			RWMutexIPParameters parameters;
+			Init(&parameters);
+		}
+		else
+			Init(pRWMutexIPParameters);
+	}
+	
+	
+	EA::Thread::RWMutexIP::~RWMutexIP()
+	{
+	}
+	
+
+	bool EA::Thread::RWMutexIP::Init(const RWMutexIPParameters* pRWMutexIPParameters)
+	{
+		if(pRWMutexIPParameters)
+		{
+			// Must provide a valid name for inter-process RWMutex.
+			EAT_ASSERT(pRWMutexIPParameters->mbIntraProcess || pRWMutexIPParameters->mName[0]);
+
+			return mRWMutexIPData.Init(pRWMutexIPParameters->mName);
+		}
+
+		return false;
+	}
+
+
+	int EA::Thread::RWMutexIP::Lock(LockType lockType, const ThreadTime& timeoutAbsolute)
+	{
+		SharedData* const pSharedData = mRWMutexIPData.mpSharedData;
+
+		if(!pSharedData)
+		{
+			EAT_ASSERT(false); // The mutex wasn't successfully initialized.
+			return kResultError;
+		}
+
+		if((lockType != kLockTypeRead) && (lockType != kLockTypeWrite))
+			return 0;
+
+		const bool bRead = (lockType == kLockTypeRead);
+		int result;
+
+		if(timeoutAbsolute == kTimeoutNone)
+			result = bRead ? pthread_rwlock_rdlock(&pSharedData->mRWLock) : pthread_rwlock_wrlock(&pSharedData->mRWLock);
+		else if(timeoutAbsolute == kTimeoutImmediate)
+			result = bRead ? pthread_rwlock_tryrdlock(&pSharedData->mRWLock) : pthread_rwlock_trywrlock(&pSharedData->mRWLock);
+		else
+			result = bRead ? pthread_rwlock_timedrdlock(&pSharedData->mRWLock, &timeoutAbsolute) : pthread_rwlock_timedwrlock(&pSharedData->mRWLock, &timeoutAbsolute);
+
+		if(result != 0)
+		{
+			if((result == EBUSY) || (result == ETIMEDOUT))
+				return kResultTimeout;
+
+			// We cannot obtain a write lock recursively, else we will deadlock (EDEADLK).
+			EAT_ASSERT(false);
+			return kResultError;
+		}
+
+		if(bRead)
+			return pSharedData->mnReaders.Increment();
+
+		EAT_ASSERT(pSharedData->mnReaders.GetValue() == 0);
+		pSharedData->mnWriters.SetValue(1);
+		return 1;
+	}
+
+
+	int EA::Thread::RWMutexIP::Unlock()
+	{
+		SharedData* const pSharedData = mRWMutexIPData.mpSharedData;
+
+		if(!pSharedData)
+		{
+			EAT_ASSERT(false); // The mutex wasn't successfully initialized.
+			return kResultError;
+		}
+
+		// Nobody else can hold a lock while a write lock is held, so if there is a 
+		// writer then it's us. The counts are updated before the lock is released, 
+		// so that the next owner never sees ours.
+		int nNewLockCount = 0;
+
+		if(pSharedData->mnWriters.GetValue() != 0) // If we have a write lock...
+			pSharedData->mnWriters.SetValue(0);
+		else // Else we have a read lock...
+		{
+			EAT_ASSERT(pSharedData->mnReaders.GetValue() >= 1);
+			nNewLockCount = pSharedData->mnReaders.Decrement();
+		}
+
+		const int result = pthread_rwlock_unlock(&pSharedData->mRWLock);
+		EAT_ASSERT(result == 0);
+
+		return (result == 0) ? nNewLockCount : kResultError;
+	}
+
+
+	int EA::Thread::RWMutexIP::GetLockCount(LockType lockType)
+	{
+		SharedData* const pSharedData = mRWMutexIPData.mpSharedData;
+
+		if(pSharedData)
+		{
+			if(lockType == kLockTypeRead)
+				return pSharedData->mnReaders.GetValue();
+			else if(lockType == kLockTypeWrite)
+				return pSharedData->mnWriters.GetValue();
+		}
+		return 0;
+	}
+
+
 #else
 
 	EA::Thread::RWMutexIPParameters::RWMutexIPParameters(bool /*bIntraProcess*/, const char* /*pName*/)
@@ -67,6 +67,11 @@ EA::Thread::Semaphore* EA::Thread::SemaphoreFactory::ConstructSemaphore(void* pM
 	return new(pMemory) EA::Thread::Semaphore;
 }
 
+EA::Thread::Semaphore* EA::Thread::SemaphoreFactory::ConstructSemaphore(void* pMemory, const SemaphoreParameters* pSemaphoreParameters)
+{
+	return new(pMemory) EA::Thread::Semaphore(pSemaphoreParameters);
+}
+
 void EA::Thread::SemaphoreFactory::DestructSemaphore(EA::Thread::Semaphore* pSemaphore)
 {
 	pSemaphore->~Semaphore();
@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <eathread/eathread_shardedcounter.h>
+#include <eathread/eathread.h>
+#include <new>
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		namespace
+		{
+			#if defined(EA_THREAD_LOCAL)
+				volatile unsigned gnShardedCounterThreadCount = 0;
+
+				// One more than the calling thread's shard index, or 0 if it hasn't been
+				// assigned yet. Threads are assigned shards in the order of first use,
+				// which spreads them evenly regardless of the shard count.
+				EA_THREAD_LOCAL unsigned tnShardedCounterIndex = 0;
+			#endif
+
+
+			inline unsigned GetThreadShardIndex()
+			{
+				#if defined(EA_THREAD_LOCAL)
+					unsigned nIndex = tnShardedCounterIndex;
+
+					if(EATHREAD_UNLIKELY(nIndex == 0))
+					{
+						nIndex = AtomicFetchIncrement(&gnShardedCounterThreadCount) + 1;
+						if(nIndex == 0) // Wrapped around; 0 is reserved.
+							nIndex = 1;
+						tnShardedCounterIndex = nIndex;
+					}
+
+					return nIndex - 1;
+				#else
+					return (unsigned)GetThreadProcessor();
+				#endif
+			}
+
+		} // namespace
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+
+EA::Thread::ShardedCounter::ShardedCounter(int nShardCount, int64_t nFoldThreshold)
+  : mpShardArray(NULL), mpShardMemory(NULL), mnShardMask(0), mnFoldThreshold(nFoldThreshold), mnTotal(0)
+{
+	if(nShardCount <= 0)
+		nShardCount = GetProcessorCount();
+	if(nShardCount > kMaxShardCount)
+		nShardCount = kMaxShardCount;
+
+	int nPow2 = 1;
+	while(nPow2 < nShardCount)
+		nPow2 *= 2;
+
+	if(nPow2 > 1)
+	{
+		const size_t nMemorySize = (nPow2 * sizeof(Shard)) + EATHREAD_CACHE_LINE_SIZE;
+		Allocator*   pAllocator  = GetAllocator();
+
+		mpShardMemory = pAllocator ? pAllocator->Alloc(nMemorySize, "EAThread ShardedCounter") : new(std::nothrow) char[nMemorySize];
+
+		if(mpShardMemory)
+		{
+			const uintptr_t nAligned = ((uintptr_t)mpShardMemory + (EATHREAD_CACHE_LINE_SIZE - 1)) & ~(uintptr_t)(EATHREAD_CACHE_LINE_SIZE - 1);
+			mpShardArray = reinterpret_cast<Shard*>(nAligned);
+
+			for(int i = 0; i < nPow2; i++)
+				new(&mpShardArray[i]) Shard;
+
+			mnShardMask = nPow2 - 1;
+		}
+	}
+
+	if(!mpShardArray) // With a single shard (or no memory), everything goes straight to the total.
+		mnFoldThreshold = -1;
+}
+
+
+EA::Thread::ShardedCounter::~ShardedCounter()
+{
+	if(mpShardMemory)
+	{
+		for(int i = 0; i <= mnShardMask; i++)
+			mpShardArray[i].~Shard();
+
+		Allocator* pAllocator = GetAllocator();
+
+		if(pAllocator)
+			pAllocator->Free(mpShardMemory);
+		else
+			delete[] static_cast<char*>(mpShardMemory);
+	}
+}
+
+
+void EA::Thread::ShardedCounter::Add(int64_t n)
+{
+	if(mnFoldThreshold < 0)
+	{
+		mnTotal.Add(n);
+		return;
+	}
+
+	AtomicInt64&  shardValue = mpShardArray[GetThreadShardIndex() & (unsigned)mnShardMask].mnValue;
+	const int64_t nValue     = shardValue.Add(n);
+
+	// Exchanging the shard with zero, rather than subtracting what we fold, makes sure 
+	// that a concurrent Reset or fold by another thread in the same shard counts each
+	// update exactly once.
+	if((nValue > mnFoldThreshold) || (nValue < -mnFoldThreshold))
+		mnTotal.Add(shardValue.SetValue(0));
+}
+
+
+int64_t EA::Thread::ShardedCounter::GetValue() const
+{
+	int64_t nValue = mnTotal.GetValue();
+
+	for(int i = 0; mpShardArray && (i <= mnShardMask); i++)
+		nValue += mpShardArray[i].mnValue.GetValue();
+
+	return nValue;
+}
+
+
+int64_t EA::Thread::ShardedCounter::Reset()
+{
+	int64_t nValue = 0;
+
+	// The shards go first, as a fold moves a shard's value into the total.
+	for(int i = 0; mpShardArray && (i <= mnShardMask); i++)
+		nValue += mpShardArray[i].mnValue.SetValue(0);
+
+	return nValue + mnTotal.SetValue(0);
+}
@@ -0,0 +1,443 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <eathread/eathread_spinbarrier.h>
+#include <eathread/eathread_backoff.h>
+#include <eathread/internal/eathread_futexword.h>
+#include <new>
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		namespace
+		{
+			int CalculateSpinCount(int nSpinMicroseconds)
+			{
+				#ifdef EA_THREAD_COOPERATIVE
+					EA_UNUSED(nSpinMicroseconds);
+					return 0;
+				#else
+					if((nSpinMicroseconds <= 0) || (GetProcessorCount() <= 1))
+						return 0;
+
+					const uint64_t nSpinCount = (uint64_t)nSpinMicroseconds * GetProcessorPausesPerMicrosecond();
+					return (nSpinCount > INT32_MAX) ? INT32_MAX : (int)nSpinCount;
+				#endif
+			}
+
+
+			// SpinBarrier arrival word.
+			const uint32_t kArrivalPhaseMask = 0xffff;
+
+			inline int32_t  MakeArrival(uint32_t nPhase, int nCount) { return (int32_t)(((nPhase & kArrivalPhaseMask) << 16) | (uint32_t)nCount); }
+			inline uint32_t ArrivalPhase(int32_t nArrival)           { return ((uint32_t)nArrival >> 16) & kArrivalPhaseMask; }
+			inline int      ArrivalCount(int32_t nArrival)           { return (int)(nArrival & 0xffff); }
+
+
+			// TreeBarrier node state.
+			const uint32_t kNodePhaseMask    = 0xffffff;
+			const int      kCountPropagated  = 0xff; // The node completed and its arrival at the parent node has been made.
+
+			inline int32_t  MakeNodeState(uint32_t nPhase, int nCount) { return (int32_t)(((nPhase & kNodePhaseMask) << 8) | (uint32_t)nCount); }
+			inline uint32_t NodeStatePhase(int32_t nState)             { return ((uint32_t)nState >> 8) & kNodePhaseMask; }
+			inline int      NodeStateCount(int32_t nState)             { return (int)(nState & 0xff); }
+
+		} // namespace
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// BarrierReleaseWord
+///////////////////////////////////////////////////////////////////////////////
+
+EA::Thread::detail::BarrierReleaseWord::BarrierReleaseWord()
+  : mnWord(0)
+{
+}
+
+
+bool EA::Thread::detail::BarrierReleaseWord::Wait(uint32_t nPhase, int nSpinCount, const ThreadTime& timeoutAbsolute)
+{
+	const int32_t nWord = (int32_t)(nPhase << 1);
+
+	// Polling is pointless if the timeout has already passed, as with a timeout of kTimeoutImmediate.
+	if((timeoutAbsolute == kTimeoutNone) || (GetThreadTime() < timeoutAbsolute))
+	{
+		for(int i = 0; i < nSpinCount; i++)
+		{
+			if((mnWord.GetValue() & ~kWaitersFlag) != nWord)
+				return true;
+			EAProcessorPause();
+		}
+	}
+
+	#if EATHREAD_FUTEX_WORD_AVAILABLE
+		for(;;)
+		{
+			const int32_t nCurrentWord = mnWord.GetValue();
+
+			if((nCurrentWord & ~kWaitersFlag) != nWord)
+				return true;
+
+			// The flag tells Release that it needs to make a wake call.
+			if(!(nCurrentWord & kWaitersFlag) && !mnWord.SetValueConditional(nWord | kWaitersFlag, nWord))
+				continue;
+
+			if(!FutexWordWait(mnWord, nWord | kWaitersFlag, timeoutAbsolute))
+				return ((mnWord.GetValue() & ~kWaitersFlag) != nWord);
+		}
+	#else
+		bool bReleased = false;
+
+		mMutex.Lock();
+
+		for(;;)
+		{
+			const int32_t nCurrentWord = mnWord.GetValue();
+
+			if((nCurrentWord & ~kWaitersFlag) != nWord)
+			{
+				bReleased = true;
+				break;
+			}
+
+			if(!(nCurrentWord & kWaitersFlag) && !mnWord.SetValueConditional(nWord | kWaitersFlag, nWord))
+				continue;
+
+			if(mCondition.Wait(&mMutex, timeoutAbsolute) == Condition::kResultTimeout)
+			{
+				bReleased = ((mnWord.GetValue() & ~kWaitersFlag) != nWord);
+				break;
+			}
+		}
+
+		mMutex.Unlock();
+
+		return bReleased;
+	#endif
+}
+
+
+void EA::Thread::detail::BarrierReleaseWord::Release(uint32_t nNewPhase)
+{
+	const int32_t nOldWord = mnWord.SetValue((int32_t)(nNewPhase << 1));
+
+	if(nOldWord & kWaitersFlag)
+	{
+		#if EATHREAD_FUTEX_WORD_AVAILABLE
+			FutexWordWakeAll(mnWord);
+		#else
+			// A waiter sets the flag and checks the phase with mMutex locked, so taking
+			// mMutex here guarantees that it is either waiting on mCondition or will see the new phase.
+			mMutex.Lock();
+			mCondition.Signal(true);
+			mMutex.Unlock();
+		#endif
+	}
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// SpinBarrier
+///////////////////////////////////////////////////////////////////////////////
+
+EA::Thread::SpinBarrier::SpinBarrier(int height, int nSpinMicroseconds)
+  : mnArrival(0), mRelease(), mnHeight(0), mnSpinCount(0)
+{
+	if(height > 0)
+		Init(height, nSpinMicroseconds);
+}
+
+
+bool EA::Thread::SpinBarrier::Init(int height, int nSpinMicroseconds)
+{
+	if((height <= 0) || (height > kMaxHeight))
+	{
+		EAT_ASSERT(false);
+		return false;
+	}
+
+	mnHeight    = height;
+	mnSpinCount = CalculateSpinCount(nSpinMicroseconds);
+	mnArrival.SetValue(MakeArrival(mRelease.GetPhase(), height));
+
+	return true;
+}
+
+
+EA::Thread::SpinBarrier::Result EA::Thread::SpinBarrier::Wait(const ThreadTime& timeoutAbsolute)
+{
+	if(mnHeight <= 0)
+	{
+		EAT_ASSERT(false);
+		return kResultError;
+	}
+
+	// The last thread to arrive resets the count for the next phase in the same
+	// atomic operation as it completes this one, so no thread can arrive for the
+	// next phase until it is safe to do so.
+	int32_t  nOldArrival, nNewArrival;
+	uint32_t nPhase;
+
+	do{
+		nOldArrival = mnArrival.GetValue();
+		nPhase      = ArrivalPhase(nOldArrival);
+
+		if(ArrivalCount(nOldArrival) == 1)
+			nNewArrival = MakeArrival(nPhase + 1, mnHeight);
+		else
+			nNewArrival = nOldArrival - 1;
+	} while(!mnArrival.SetValueConditional(nNewArrival, nOldArrival));
+
+	if(ArrivalCount(nOldArrival) == 1)
+	{
+		mRelease.Release((nPhase + 1) & kArrivalPhaseMask);
+		return kResultPrimary;
+	}
+
+	if(mRelease.Wait(nPhase, mnSpinCount, timeoutAbsolute))
+		return kResultSecondary;
+
+	// Timed out. Give back our arrival, unless the phase completed in the meantime.
+	for(;;)
+	{
+		nOldArrival = mnArrival.GetValue();
+
+		if(ArrivalPhase(nOldArrival) != nPhase)
+			return kResultSecondary;
+
+		if(mnArrival.SetValueConditional(nOldArrival + 1, nOldArrival))
+			return kResultTimeout;
+	}
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TreeBarrier
+///////////////////////////////////////////////////////////////////////////////
+
+EA::Thread::TreeBarrier::TreeBarrier(int height, int nFanIn, int nSpinMicroseconds)
+  : mpNodeArray(NULL), mpNodeMemory(NULL), mnNodeCount(0), mnHeight(0), mnFanIn(0), mnSpinCount(0), mWithdrawalFutex(), mRelease()
+{
+	if(height > 0)
+		Init(height, nFanIn, nSpinMicroseconds);
+}
+
+
+EA::Thread::TreeBarrier::~TreeBarrier()
+{
+	FreeNodes();
+}
+
+
+bool EA::Thread::TreeBarrier::Init(int height, int nFanIn, int nSpinMicroseconds)
+{
+	if((height <= 0) || (nFanIn < 2) || (nFanIn > kMaxFanIn))
+	{
+		EAT_ASSERT(false);
+		return false;
+	}
+
+	FreeNodes();
+
+	// Count the nodes: the leaves, then each level above them up to the single root.
+	int nNodeCount = 0;
+
+	for(int nLevelCount = height; ; )
+	{
+		nLevelCount  = (nLevelCount + nFanIn - 1) / nFanIn;
+		nNodeCount  += nLevelCount;
+
+		if(nLevelCount == 1)
+			break;
+	}
+
+	const size_t nMemorySize = (sizeof(Node) * (size_t)nNodeCount) + EATHREAD_CACHE_LINE_SIZE;
+	Allocator*   pAllocator  = GetAllocator();
+
+	mpNodeMemory = pAllocator ? pAllocator->Alloc(nMemorySize, "EAThread TreeBarrier") : new(std::nothrow) char[nMemorySize];
+
+	if(!mpNodeMemory)
+		return false;
+
+	const uintptr_t nAligned = ((uintptr_t)mpNodeMemory + (EATHREAD_CACHE_LINE_SIZE - 1)) & ~(uintptr_t)(EATHREAD_CACHE_LINE_SIZE - 1);
+	mpNodeArray = reinterpret_cast<Node*>(nAligned);
+
+	// Nodes are stored level by level, starting with the leaves.
+	const uint32_t nPhase       = mRelease.GetPhase();
+	int            nLevelStart  = 0;
+	int            nChildCount  = height; // Number of participants or nodes below the current level.
+
+	for(;;)
+	{
+		const int nLevelCount     = (nChildCount + nFanIn - 1) / nFanIn;
+		const int nNextLevelStart = nLevelStart + nLevelCount;
+
+		for(int i = 0; i < nLevelCount; i++)
+		{
+			Node* const pNode = new(&mpNodeArray[nLevelStart + i]) Node;
+			const int   nLast = nChildCount - (i * nFanIn);
+
+			pNode->mnChildCount = (nLast < nFanIn) ? nLast : nFanIn;
+			pNode->mnParent     = (nLevelCount == 1) ? -1 : (nNextLevelStart + (i / nFanIn));
+			pNode->mnState.SetValue(MakeNodeState(nPhase, pNode->mnChildCount));
+		}
+
+		if(nLevelCount == 1)
+			break;
+
+		nLevelStart = nNextLevelStart;
+		nChildCount = nLevelCount;
+	}
+
+	mnNodeCount = nNodeCount;
+	mnHeight    = height;
+	mnFanIn     = nFanIn;
+	mnSpinCount = CalculateSpinCount(nSpinMicroseconds);
+
+	return true;
+}
+
+
+void EA::Thread::TreeBarrier::FreeNodes()
+{
+	if(mpNodeMemory)
+	{
+		for(int i = 0; i < mnNodeCount; i++)
+			mpNodeArray[i].~Node();
+
+		Allocator* pAllocator = GetAllocator();
+
+		if(pAllocator)
+			pAllocator->Free(mpNodeMemory);
+		else
+			delete[] static_cast<char*>(mpNodeMemory);
+
+		mpNodeArray  = NULL;
+		mpNodeMemory = NULL;
+		mnNodeCount  = 0;
+		mnHeight     = 0;
+	}
+}
+
+
+// Makes one arrival at node for nPhase. Returns true if this was the last arrival.
+bool EA::Thread::TreeBarrier::Arrive(Node& node, uint32_t nPhase)
+{
+	for(;;)
+	{
+		const int32_t nState = node.mnState.GetValue();
+
+		// A node which still holds an earlier phase's state is reset by its first arrival.
+		const int nCount = (NodeStatePhase(nState) == nPhase) ? NodeStateCount(nState) : node.mnChildCount;
+		EAT_ASSERT((nCount > 0) && (nCount != kCountPropagated));
+
+		if(node.mnState.SetValueConditional(MakeNodeState(nPhase, nCount - 1), nState))
+			return (nCount == 1);
+	}
+}
+
+
+// Takes back the arrival of a participant of leaf nLeaf for nPhase. Returns false if
+// that couldn't be done because the phase completed.
+//
+// Our arrival is represented in the lowest node along our path up the tree which
+// has not yet completed. Taking it back means counting one more child as missing
+// there and reopening each completed node below it for one arrival (ours). A
+// completed node whose arrival at its parent is still in progress is waited for,
+// as until then we can't tell whether the parent counts it.
+//
+bool EA::Thread::TreeBarrier::Withdraw(int nLeaf, uint32_t nPhase)
+{
+	AutoFutex                autoFutex(mWithdrawalFutex);
+	BackoffSpinYieldSleep<>  backoff;
+
+	for(;;)
+	{
+		if(mRelease.GetPhase() != nPhase)
+			return false;
+
+		for(int nNode = nLeaf; ; )
+		{
+			Node&         node   = mpNodeArray[nNode];
+			const int32_t nState = node.mnState.GetValue();
+			const int     nCount = NodeStateCount(nState);
+
+			if((NodeStatePhase(nState) != nPhase) || (nCount == 0)) // If an arrival at or above this node is still in progress...
+				break;
+
+			if(nCount == kCountPropagated)
+			{
+				EAT_ASSERT(node.mnParent >= 0);
+				nNode = node.mnParent;
+				continue;
+			}
+
+			if(!node.mnState.SetValueConditional(nState + 1, nState))
+				break;
+
+			// No other thread can touch the completed nodes below, as all of their
+			// participants have arrived and other timeouts wait for our lock.
+			for(int n = nLeaf; n != nNode; n = mpNodeArray[n].mnParent)
+				mpNodeArray[n].mnState.SetValue(MakeNodeState(nPhase, 1));
+
+			return true;
+		}
+
+		backoff.Pause();
+	}
+}
+
+
+EA::Thread::TreeBarrier::Result EA::Thread::TreeBarrier::Wait(int nParticipant, const ThreadTime& timeoutAbsolute)
+{
+	if((mnHeight <= 0) || (nParticipant < 0) || (nParticipant >= mnHeight))
+	{
+		EAT_ASSERT(false);
+		return kResultError;
+	}
+
+	const uint32_t nPhase = mRelease.GetPhase();
+	const int      nLeaf  = nParticipant / mnFanIn;
+
+	if(Arrive(mpNodeArray[nLeaf], nPhase))
+	{
+		for(int nNode = nLeaf; ; )
+		{
+			Node&     node    = mpNodeArray[nNode];
+			const int nParent = node.mnParent;
+
+			if(nParent < 0)
+			{
+				mRelease.Release((nPhase + 1) & kNodePhaseMask);
+				return kResultPrimary;
+			}
+
+			// We are the last of our group and so arrive at the parent on its behalf. Only
+			// then is the node marked as propagated, which is what Withdraw waits for.
+			const bool bParentComplete = Arrive(mpNodeArray[nParent], nPhase);
+
+			// This fails harmlessly if the barrier has already been released and the node reused for the next phase.
+			node.mnState.SetValueConditional(MakeNodeState(nPhase, kCountPropagated), MakeNodeState(nPhase, 0));
+
+			if(!bParentComplete)
+				break;
+
+			nNode = nParent;
+		}
+	}
+
+	if(mRelease.Wait(nPhase, mnSpinCount, timeoutAbsolute))
+		return kResultSecondary;
+
+	return Withdraw(nLeaf, nPhase) ? kResultTimeout : kResultSecondary;
+}
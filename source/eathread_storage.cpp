@@ -43,6 +43,198 @@ EA_RESTORE_VC_WARNING()
 
 
 
+#elif EATHREAD_TLS_SLOT_VECTOR_ENABLED
+	#include <eathread/eathread_atomic.h>
+	#include <eathread/eathread_sync.h>
+	#include <pthread.h>
+	#include <string.h>
+
+	namespace EA
+	{
+		namespace Thread
+		{
+			namespace
+			{
+				struct TLSSlot
+				{
+					const void* mpData;
+					uint32_t    mnGeneration; // Generation of the ThreadLocalStorage which set mpData, or 0 if none did.
+				};
+
+				struct TLSSlotVector
+				{
+					uint32_t mnCapacity;
+					TLSSlot  mSlotArray[1]; // Actually mnCapacity in size.
+				};
+
+				// The thread's slot vector. It is found through the EA_THREAD_LOCAL pointer, which
+				// is fast, and is also registered with a pthread key, whose destructor frees it at thread exit.
+				EA_THREAD_LOCAL TLSSlotVector* tpTLSSlotVector = NULL;
+
+				pthread_key_t  gTLSSlotVectorKey;
+				pthread_once_t gTLSSlotVectorKeyOnce = PTHREAD_ONCE_INIT;
+
+				// The slot id registry. ThreadLocalStorage objects are commonly globals, so these
+				// are plain data that are initialized before any constructor runs.
+				volatile int      gnTLSSlotLock          = 0;
+				volatile unsigned gnTLSGeneration        = 0;
+				uint32_t          gnTLSSlotCount         = 0;    // Number of slot ids handed out so far, including freed ones.
+				uint32_t*         gpTLSFreeSlotArray     = NULL; // Freed slot ids, available for reuse.
+				uint32_t          gnTLSFreeSlotCount     = 0;
+				uint32_t          gnTLSFreeSlotCapacity  = 0;
+
+
+				struct TLSSlotLock
+				{
+					TLSSlotLock()
+					{
+						while(!AtomicSetValueConditional(&gnTLSSlotLock, 1, 0))
+							EA_THREAD_DO_SPIN();
+					}
+
+				   ~TLSSlotLock()
+						{ AtomicSetValue(&gnTLSSlotLock, 0); }
+				};
+
+
+				void DestroyTLSSlotVector(void* pVector)
+				{
+					// This runs in the exiting thread, after which its EA_THREAD_LOCAL data is gone.
+					tpTLSSlotVector = NULL;
+					delete[] static_cast<char*>(pVector);
+				}
+
+
+				void CreateTLSSlotVectorKey()
+				{
+					const int result = pthread_key_create(&gTLSSlotVectorKey, DestroyTLSSlotVector);
+					EAT_ASSERT(result == 0); EA_UNUSED(result);
+				}
+
+
+				// Grows the calling thread's slot vector so that it includes nSlot.
+				TLSSlotVector* GrowTLSSlotVector(uint32_t nSlot)
+				{
+					TLSSlotVector* const pOldVector   = tpTLSSlotVector;
+					const uint32_t       nOldCapacity = pOldVector ? pOldVector->mnCapacity : 0;
+					uint32_t             nNewCapacity = nOldCapacity ? nOldCapacity : 16;
+
+					while(nNewCapacity <= nSlot)
+						nNewCapacity *= 2;
+
+					const size_t   nSize      = offsetof(TLSSlotVector, mSlotArray) + (nNewCapacity * sizeof(TLSSlot));
+					char* const    pMemory    = new(std::nothrow) char[nSize];
+
+					if(!pMemory)
+						return NULL;
+
+					TLSSlotVector* const pNewVector = reinterpret_cast<TLSSlotVector*>(pMemory);
+
+					memset(pMemory, 0, nSize);
+					if(pOldVector)
+						memcpy(pNewVector->mSlotArray, pOldVector->mSlotArray, nOldCapacity * sizeof(TLSSlot));
+					pNewVector->mnCapacity = nNewCapacity;
+
+					pthread_once(&gTLSSlotVectorKeyOnce, CreateTLSSlotVectorKey);
+					pthread_setspecific(gTLSSlotVectorKey, pNewVector);
+
+					tpTLSSlotVector = pNewVector;
+					delete[] reinterpret_cast<char*>(pOldVector);
+
+					return pNewVector;
+				}
+
+			} // namespace
+
+		} // namespace Thread
+
+	} // namespace EA
+
+
+	EA::Thread::ThreadLocalStorage::ThreadLocalStorage()
+		: mTLSData()
+	{
+		// Generation 0 is reserved for slots which were never set.
+		do{
+			mTLSData.mnGeneration = (uint32_t)AtomicFetchIncrement(&gnTLSGeneration) + 1;
+		} while(mTLSData.mnGeneration == 0);
+
+		TLSSlotLock lock;
+
+		if(gnTLSFreeSlotCount)
+			mTLSData.mnSlot = gpTLSFreeSlotArray[--gnTLSFreeSlotCount];
+		else
+			mTLSData.mnSlot = gnTLSSlotCount++;
+	}
+
+
+	EA::Thread::ThreadLocalStorage::~ThreadLocalStorage()
+	{
+		// Values that threads stored in our slot stay behind in their slot vectors, but
+		// the next user of the slot id has a different generation and so won't see them.
+		TLSSlotLock lock;
+
+		if(gnTLSFreeSlotCount == gnTLSFreeSlotCapacity)
+		{
+			const uint32_t  nNewCapacity = gnTLSFreeSlotCapacity ? (gnTLSFreeSlotCapacity * 2) : 64;
+			uint32_t* const pNewArray    = new(std::nothrow) uint32_t[nNewCapacity];
+
+			if(!pNewArray) // If we can't record the slot id as free, we let it go unused.
+				return;
+
+			if(gpTLSFreeSlotArray)
+				memcpy(pNewArray, gpTLSFreeSlotArray, gnTLSFreeSlotCount * sizeof(uint32_t));
+			delete[] gpTLSFreeSlotArray;
+
+			gpTLSFreeSlotArray    = pNewArray;
+			gnTLSFreeSlotCapacity = nNewCapacity;
+		}
+
+		gpTLSFreeSlotArray[gnTLSFreeSlotCount++] = mTLSData.mnSlot;
+	}
+
+
+	void* EA::Thread::ThreadLocalStorage::GetValue()
+	{
+		const TLSSlotVector* const pVector = tpTLSSlotVector;
+
+		if(pVector && (mTLSData.mnSlot < pVector->mnCapacity))
+		{
+			const TLSSlot& slot = pVector->mSlotArray[mTLSData.mnSlot];
+
+			if(slot.mnGeneration == mTLSData.mnGeneration)
+				return const_cast<void*>(slot.mpData);
+		}
+
+		return NULL;
+	}
+
+
+	bool EA::Thread::ThreadLocalStorage::SetValue(const void* pData)
+	{
+		TLSSlotVector* pVector = tpTLSSlotVector;
+
+		if(!pVector || (mTLSData.mnSlot >= pVector->mnCapacity))
+		{
+			if(!pData) // Nothing to clear, as GetValue already returns NULL.
+				return true;
+
+			pVector = GrowTLSSlotVector(mTLSData.mnSlot);
+
+			if(!pVector)
+				return false;
+		}
+
+		TLSSlot& slot = pVector->mSlotArray[mTLSData.mnSlot];
+
+		slot.mpData       = pData;
+		slot.mnGeneration = mTLSData.mnGeneration;
+
+		return true;
+	}
+
+
+
 #elif (defined(EA_PLATFORM_UNIX) || EA_POSIX_THREADS_AVAILABLE) && !defined(CS_UNDEFINED_STRING)
 	#if defined(EA_PLATFORM_UNIX)
 		#include <unistd.h>
@@ -346,5 +538,305 @@ void EA::Thread::ThreadLocalStorageFactory::DestructThreadLocalStorage(EA::Threa
 }
 
 
+
+///////////////////////////////////////////////////////////////////////////////
+// ThreadLocalPointer
+///////////////////////////////////////////////////////////////////////////////
+
+#include <eathread/eathread_futex.h>
+#include <eathread/internal/eathread_memory.h>
+#include <string.h>
+
+// Where available, a pthread key destructor lets us destroy a thread's instances 
+// when it exits, regardless of whether the thread was started by EAThread.
+#if (defined(EA_PLATFORM_UNIX) || EA_POSIX_THREADS_AVAILABLE) && EA_THREADS_AVAILABLE && !defined(EA_PLATFORM_SONY) && !defined(EA_PLATFORM_MICROSOFT)
+	#define EATHREAD_TLP_EXIT_KEY 1
+	#include <pthread.h>
+#else
+	#define EATHREAD_TLP_EXIT_KEY 0
+#endif
+
+
+namespace EA
+{
+	namespace Thread
+	{
+		namespace
+		{
+			// The header of each instance. The instance itself follows at ThreadLocalPointerBase::mnObjectOffset.
+			struct TLPNode
+			{
+				TLPNode*            mpOwnerPrev;    // Links in the ThreadLocalPointerBase::mpInstanceList list.
+				TLPNode*            mpOwnerNext;
+				TLPNode*            mpThreadPrev;   // Links in the owning thread's list, which is circular and starts at a sentinel node.
+				TLPNode*            mpThreadNext;
+				void**              mppOwnerList;   // Points to ThreadLocalPointerBase::mpInstanceList.
+				ThreadLocalStorage* mpOwnerTLS;     // Points to ThreadLocalPointerBase::mTLS.
+				ThreadLocalPointerBase::DestructFunction mpDestruct;
+				void*               mpObject;
+			};
+
+
+			// Protects all instance lists. It is never destroyed, as threads 
+			// may exit and ThreadLocalPointers may be destroyed during or after
+			// static destruction.
+			Futex& GetTLPFutex()
+			{
+				static Futex* const pFutex = new Futex;
+				return *pFutex;
+			}
+
+
+			// The calling thread's list sentinel, or NULL if the thread has no instances.
+			#if defined(EA_THREAD_LOCAL)
+				EA_THREAD_LOCAL TLPNode* tpTLPThreadList = NULL;
+
+				TLPNode* GetTLPThreadList()
+					{ return tpTLPThreadList; }
+
+				void SetTLPThreadList(TLPNode* pList)
+					{ tpTLPThreadList = pList; }
+			#else
+				ThreadLocalStorage& GetTLPThreadListTLS()
+				{
+					static ThreadLocalStorage* const pTLS = new ThreadLocalStorage;
+					return *pTLS;
+				}
+
+				TLPNode* GetTLPThreadList()
+					{ return static_cast<TLPNode*>(GetTLPThreadListTLS().GetValue()); }
+
+				void SetTLPThreadList(TLPNode* pList)
+					{ GetTLPThreadListTLS().SetValue(pList); }
+			#endif
+
+
+			void UnlinkFromOwner(TLPNode* pNode)
+			{
+				if(pNode->mpOwnerPrev)
+					pNode->mpOwnerPrev->mpOwnerNext = pNode->mpOwnerNext;
+				else
+					*pNode->mppOwnerList = pNode->mpOwnerNext;
+
+				if(pNode->mpOwnerNext)
+					pNode->mpOwnerNext->mpOwnerPrev = pNode->mpOwnerPrev;
+			}
+
+
+			void UnlinkFromThread(TLPNode* pNode)
+			{
+				pNode->mpThreadPrev->mpThreadNext = pNode->mpThreadNext;
+				pNode->mpThreadNext->mpThreadPrev = pNode->mpThreadPrev;
+			}
+
+
+			// Destructs and frees a list of nodes linked through mpThreadNext. This 
+			// is done outside the lock, as destructors may use ThreadLocalPointers.
+			void DestroyTLPNodes(TLPNode* pNode)
+			{
+				while(pNode)
+				{
+					TLPNode* const pNext = pNode->mpThreadNext;
+					pNode->mpDestruct(pNode->mpObject);
+					detail::FreeAlignedMemory(pNode);
+					pNode = pNext;
+				}
+			}
+
+
+			// Destroys all instances in a thread's list, and the list sentinel itself.
+			// Must be called by the thread which owns the list.
+			void DestroyTLPThreadList(TLPNode* pList)
+			{
+				TLPNode* pDetached = NULL;
+
+				{
+					AutoFutex autoFutex(GetTLPFutex());
+
+					for(TLPNode* pNode = pList->mpThreadNext, *pNext; pNode != pList; pNode = pNext)
+					{
+						pNext = pNode->mpThreadNext;
+						UnlinkFromOwner(pNode);
+						pNode->mpOwnerTLS->SetValue(NULL); // The owner can't be destroyed while we hold the lock and the node is in its list.
+						pNode->mpThreadNext = pDetached;
+						pDetached = pNode;
+					}
+				}
+
+				detail::FreeAlignedMemory(pList);
+				DestroyTLPNodes(pDetached);
+			}
+
+
+			#if EATHREAD_TLP_EXIT_KEY
+				pthread_key_t  gTLPExitKey;
+				pthread_once_t gTLPExitKeyOnce = PTHREAD_ONCE_INIT;
+
+				void OnTLPThreadExit(void* pList)
+				{
+					// This runs in the exiting thread. If destructors create new instances,
+					// the key is set again and PThreads calls us again.
+					if(GetTLPThreadList() == pList)
+						SetTLPThreadList(NULL);
+					DestroyTLPThreadList(static_cast<TLPNode*>(pList));
+				}
+
+				void CreateTLPExitKey()
+				{
+					const int result = pthread_key_create(&gTLPExitKey, OnTLPThreadExit);
+					EAT_ASSERT(result == 0); EA_UNUSED(result);
+				}
+			#endif
+
+		} // namespace
+
+	} // namespace Thread
+
+} // namespace EA
+
+
+void EA::Thread::DestroyThreadLocalPointers()
+{
+	TLPNode* const pList = GetTLPThreadList();
+
+	if(pList)
+	{
+		SetTLPThreadList(NULL);
+		#if EATHREAD_TLP_EXIT_KEY
+			pthread_setspecific(gTLPExitKey, NULL);
+		#endif
+		DestroyTLPThreadList(pList);
+	}
+}
+
+
+EA::Thread::ThreadLocalPointerBase::ThreadLocalPointerBase(size_t nObjectSize, size_t nObjectAlignment, ConstructFunction pConstruct, DestructFunction pDestruct)
+	: mTLS()
+	, mpInstanceList(NULL)
+	, mnObjectSize(nObjectSize)
+	, mnObjectAlignment((nObjectAlignment > EA_ALIGN_OF(TLPNode)) ? nObjectAlignment : EA_ALIGN_OF(TLPNode))
+	, mnObjectOffset((sizeof(TLPNode) + (mnObjectAlignment - 1)) & ~(mnObjectAlignment - 1))
+	, mpConstruct(pConstruct)
+	, mpDestruct(pDestruct)
+{
+}
+
+
+EA::Thread::ThreadLocalPointerBase::~ThreadLocalPointerBase()
+{
+	// Destroys the instances of all threads. Threads must not be using them any more.
+	TLPNode* pDetached = NULL;
+
+	{
+		AutoFutex autoFutex(GetTLPFutex());
+
+		while(mpInstanceList)
+		{
+			TLPNode* const pNode = static_cast<TLPNode*>(mpInstanceList);
+			UnlinkFromOwner(pNode);
+			UnlinkFromThread(pNode);
+			pNode->mpThreadNext = pDetached;
+			pDetached = pNode;
+		}
+	}
+
+	DestroyTLPNodes(pDetached);
+}
+
+
+size_t EA::Thread::ThreadLocalPointerBase::GetInstanceCount() const
+{
+	AutoFutex autoFutex(GetTLPFutex());
+
+	size_t nCount = 0;
+	for(const TLPNode* pNode = static_cast<const TLPNode*>(mpInstanceList); pNode; pNode = pNode->mpOwnerNext)
+		nCount++;
+	return nCount;
+}
+
+
+void* EA::Thread::ThreadLocalPointerBase::CreateInstance()
+{
+	TLPNode* pList = GetTLPThreadList();
+
+	if(!pList)
+	{
+		pList = static_cast<TLPNode*>(detail::AllocateAlignedMemory(sizeof(TLPNode), EA_ALIGN_OF(TLPNode), EATHREAD_ALLOC_PREFIX "ThreadLocalPointer"));
+		if(!pList)
+			return NULL;
+
+		memset(pList, 0, sizeof(TLPNode));
+		pList->mpThreadPrev = pList->mpThreadNext = pList;
+		SetTLPThreadList(pList);
+
+		#if EATHREAD_TLP_EXIT_KEY
+			pthread_once(&gTLPExitKeyOnce, CreateTLPExitKey);
+			pthread_setspecific(gTLPExitKey, pList);
+		#endif
+	}
+
+	char* const pMemory = static_cast<char*>(detail::AllocateAlignedMemory(mnObjectOffset + mnObjectSize, mnObjectAlignment, EATHREAD_ALLOC_PREFIX "ThreadLocalPointer"));
+	if(!pMemory)
+		return NULL;
+
+	TLPNode* const pNode = reinterpret_cast<TLPNode*>(pMemory);
+
+	pNode->mpOwnerPrev  = NULL;
+	pNode->mppOwnerList = &mpInstanceList;
+	pNode->mpOwnerTLS   = &mTLS;
+	pNode->mpDestruct   = mpDestruct;
+	pNode->mpObject     = pMemory + mnObjectOffset;
+
+	mpConstruct(pNode->mpObject); // Outside the lock, as constructors may use ThreadLocalPointers.
+
+	{
+		AutoFutex autoFutex(GetTLPFutex());
+
+		pNode->mpOwnerNext = static_cast<TLPNode*>(mpInstanceList);
+		if(pNode->mpOwnerNext)
+			pNode->mpOwnerNext->mpOwnerPrev = pNode;
+		mpInstanceList = pNode;
+
+		pNode->mpThreadPrev = pList->mpThreadPrev;
+		pNode->mpThreadNext = pList;
+		pList->mpThreadPrev->mpThreadNext = pNode;
+		pList->mpThreadPrev = pNode;
+	}
+
+	mTLS.SetValue(pNode);
+	return pNode->mpObject;
+}
+
+
+void EA::Thread::ThreadLocalPointerBase::DestroyInstance()
+{
+	TLPNode* const pNode = static_cast<TLPNode*>(mTLS.GetValue());
+
+	if(pNode)
+	{
+		mTLS.SetValue(NULL);
+
+		{
+			AutoFutex autoFutex(GetTLPFutex());
+			UnlinkFromOwner(pNode);
+			UnlinkFromThread(pNode);
+		}
+
+		pNode->mpThreadNext = NULL;
+		DestroyTLPNodes(pNode);
+	}
+}
+
+
+void EA::Thread::ThreadLocalPointerBase::EnumerateInstances(EnumerateFunction pFunction, void* pContext)
+{
+	// Holding the lock keeps exiting threads from destroying the instances while we visit them.
+	AutoFutex autoFutex(GetTLPFutex());
+
+	for(TLPNode* pNode = static_cast<TLPNode*>(mpInstanceList); pNode; pNode = pNode->mpOwnerNext)
+		pFunction(pNode->mpObject, pContext);
+}
+
+
 #undef OSEnableInterrupts   
 #undef OSDisableInterrupts
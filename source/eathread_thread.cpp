@@ -7,6 +7,7 @@
 #include <eathread/eathread_thread.h>
 #include <eathread/eathread_mutex.h>
 #include <new> // include new for placement new operator
+#include <stdio.h>
 
 #if !EA_THREADS_AVAILABLE
 	// Do nothing
@@ -260,3 +261,43 @@ size_t EA::Thread::EnumerateThreads(ThreadEnumData* pDataArray, size_t dataArray
 
 #endif // !EA_THREADS_AVAILABLE
 
+
+
+///////////////////////////////////////////////////////////////////////////////
+// generic BeginGroup, for platforms without their own
+///////////////////////////////////////////////////////////////////////////////
+
+#if !defined(EATHREAD_THREAD_BEGIN_GROUP_NATIVE)
+
+	size_t EA::Thread::Thread::BeginGroup(Thread* pThreadArray, size_t nThreadCount, RunnableFunction pFunction, void* const* pContextArray, const ThreadParameters* pTP, RunnableFunctionUserWrapper pUserWrapper)
+	{
+		ThreadParameters parameters;
+		char             name[EATHREAD_NAME_SIZE];
+		size_t           nStartedCount = 0;
+
+		if(pTP)
+		{
+			EAT_ASSERT_MSG(!pTP->mpStack, "Thread::BeginGroup: The threads of a group can't share a stack.");
+			parameters = *pTP;
+			parameters.mpStack = NULL;
+		}
+
+		for(size_t i = 0; i < nThreadCount; i++)
+		{
+			if(pTP && pTP->mpName)
+			{
+				snprintf(name, sizeof(name), "%s %u", pTP->mpName, (unsigned)i);
+				parameters.mpName = name;
+			}
+
+			if(pTP && (pTP->mnProcessor >= 0))
+				parameters.mnProcessor = (int)((pTP->mnProcessor + i) % (size_t)GetProcessorCount());
+
+			if(pThreadArray[i].Begin(pFunction, pContextArray ? pContextArray[i] : NULL, pTP ? &parameters : NULL, pUserWrapper) != kThreadIdInvalid)
+				nStartedCount++;
+		}
+
+		return nStartedCount;
+	}
+
+#endif
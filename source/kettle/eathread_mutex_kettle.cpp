@@ -35,7 +35,7 @@ void EAMutexData::SimulateLock(bool bLock)
 
 
 EA::Thread::MutexParameters::MutexParameters(bool bIntraProcess, const char* pName)
-	: mbIntraProcess(bIntraProcess)
+	: mbIntraProcess(bIntraProcess), mbRecursive(true), mbRobust(false) // mbRecursive and mbRobust are currently ignored on this platform.
 {
 	mName[0] = '\0';
 
@@ -178,6 +178,12 @@ int EA::Thread::Mutex::Unlock()
 }
 
 
+bool EA::Thread::Mutex::MarkConsistent()
+{
+	return true; // Robust mutexes are not supported on this platform.
+}
+
+
 int EA::Thread::Mutex::GetLockCount() const
 {
 	return mMutexData.mnLockCount;
@@ -109,180 +109,14 @@ static _Unwind_Reason_Code UnwindCallback(_Unwind_Context* pUnwindContext, void*
 
 
 
-
-
-/*
-
-The following commented-out code is for reading the callstack of a thread other than the current one.
-The code below is originally for BSD Unix, and probably needs to be tweaked to support Linux.
-
-namespace Local
-{
-	enum EAThreadBacktraceState
-	{
-		// Positive thread lwp ids are here implicitly.
-		EATHREAD_BACKTRACE_STATE_NONE    = -1,
-		EATHREAD_BACKTRACE_STATE_DUMPING = -2,
-		EATHREAD_BACKTRACE_STATE_DONE    = -3,
-		EATHREAD_BACKTRACE_STATE_CANCEL  = -4
-	};
-
-	struct ThreadBacktraceState
-	{
-		EA::Thread::AtomicInt32 mState;              // One of enum EAThreadBacktraceState or (initially) the thread id of the thread we are targeting.
-		void**                  mCallstack;          // Output param
-		size_t                  mCallstackCapacity;  // Input param, refers to array capacity of mCallstack.
-		size_t                  mCallstackCount;     // Output param
-		pthread_t               mPthread;            // Output param
-
-		ThreadBacktraceState() : mState(EATHREAD_BACKTRACE_STATE_NONE), mCallstackCapacity(0), mCallstackCount(0), mPthread(NULL){}
-	};
-
-
-	static pthread_mutex_t      gThreadBacktraceMutex = PTHREAD_MUTEX_INITIALIZER;
-	static ThreadBacktraceState gThreadBacktraceState; // Protected by gThreadBacktraceMutex.
-
-
-	static void gThreadBacktraceSignalHandler(int sigNum, siginfo_t* pSigInfo, void* pSigContextVoid)
-	{
-		int32_t lwpSelf = *(int32_t*)pthread_self();
-
-		if(gThreadBacktraceState.mState.SetValueConditional(EATHREAD_BACKTRACE_STATE_DUMPING, lwpSelf))
-		{
-			gThreadBacktraceState.mPthread = pthread_self();
-
-			if(gThreadBacktraceState.mCallstackCapacity)
-			{
-				gThreadBacktraceState.mCallstackCount = GetCallstack(gThreadBacktraceState.mCallstack, gThreadBacktraceState.mCallstackCapacity, (const CallstackContext*)NULL);
-
-				// At this point we need to remove the top 6 entries and insert an entry for where the thread's instruction pointer is.
-				if(gThreadBacktraceState.mCallstackCount >= 6) // This should always be true.
-				{
-					gThreadBacktraceState.mCallstackCount -= 5;
-					memmove(&gThreadBacktraceState.mCallstack[1], &gThreadBacktraceState.mCallstack[6], (gThreadBacktraceState.mCallstackCount - 1) * sizeof(void*));
-				}
-				else
-					gThreadBacktraceState.mCallstackCount = 1;
-
-				gThreadBacktraceState.mCallstack[0] = pSigContextVoid ? reinterpret_cast<void*>(reinterpret_cast<sigcontext*>((uintptr_t)pSigContextVoid + 48)->sc_rip) : NULL;
-			}
-			else
-				gThreadBacktraceState.mCallstackCount = 0;
-
-			gThreadBacktraceState.mState.SetValue(EATHREAD_BACKTRACE_STATE_DONE);
-		}
-		// else this thread received an unexpected SIGURG. This can happen if it was so delayed that 
-		// we timed out waiting for it to happen and moved on.
-	}
-}
-
-
-/// GetCallstack
-///
-/// This is a version of GetCallstack which gets the callstack of a thread based on its thread id as opposed to 
-/// its register state. It works by injecting a signal handler into the given thread and reading the self callstack
-/// then exiting from the signal handler. The GetCallstack function sets this up, generates the signal for the 
-/// other thread, then waits for it to complete. It uses the SIGURG signal for this.
-///
-/// Primary causes of failure:
-///     The target thread has SIGURG explicitly ignored.
-///     The target thread somehow is getting too little CPU time to respond to the signal.
-///
-/// To do: Change this function to take a ThreadInfo as a last parameter instead of pthread_t. And have the 
-/// ThreadInfo return additional basic thread information. Or maybe even change this function to be a 
-/// GetThreadInfo function instead of GetCallstack.
-///
-EATHREADLIB_API size_t GetCallstack(void* pReturnAddressArray[], size_t nReturnAddressArrayCapacity, pthread_t& pthread)
-{
-	using namespace Local;
-
-	size_t callstackCount = 0;
-
-	if(pthread)
-	{
-		pthread_t pthreadSelf    = pthread_self();
-		int32_t   lwp            = *(int32_t*)pthread;
-		int32_t   lwpSelf        = *(int32_t*)pthreadSelf;
-
-		if(lwp == lwpSelf) // This function can be called only for a thread other than self.
-			callstackCount = GetCallstack(pReturnAddressArray, nReturnAddressArrayCapacity, (const CallstackContext*)NULL);
-		else
-		{
-			struct sigaction act;   memset(&act, 0, sizeof(act));
-			struct sigaction oact;  memset(&oact, 0, sizeof(oact));
-	
-			act.sa_sigaction = gThreadBacktraceSignalHandler;
-			act.sa_flags     = SA_RESTART | SA_SIGINFO | SA_ONSTACK;
-
-			pthread_mutex_lock(&gThreadBacktraceMutex);
-
-			if(sigaction(SIGURG, &act, &oact) == 0)
-			{
-				gThreadBacktraceState.mCallstack         = pReturnAddressArray;
-				gThreadBacktraceState.mCallstackCapacity = nReturnAddressArrayCapacity;
-				gThreadBacktraceState.mState.SetValue(lwp);
-
-				// Signal the specific thread that we want to dump.
-				int32_t stateTemp = lwp;
-
-				if(pthread_kill(pthread, SIGURG) == 0)
-				{
-					// Wait for the other thread to start dumping the stack, or time out.
-					for(int waitMS = 200; waitMS; waitMS--)
-					{
-						stateTemp = gThreadBacktraceState.mState.GetValue();
-
-						if(stateTemp != lwp)
-							break;
-
-						usleep(1000); // This sleep gives the OS the opportunity to execute the target thread, even if it's of a lower priority than this thread.
-					}
-				} 
-				// else apparently failed to send SIGURG to the thread, or the thread was paused in a way that it couldn't receive it.
-
-				if(stateTemp == lwp) // If the operation timed out or seemingly never started...
-				{
-					if(gThreadBacktraceState.mState.SetValueConditional(EATHREAD_BACKTRACE_STATE_CANCEL, lwp)) // If the backtrace still didn't start, and we were able to stop it by setting the state to cancel...
-						stateTemp = EATHREAD_BACKTRACE_STATE_CANCEL;
-					else
-						stateTemp = gThreadBacktraceState.mState.GetValue();    // It looks like the backtrace thread did in fact get a late start and is now executing
-				}
-
-				// Wait indefinitely for the dump to finish or be canceled.
-				// We cannot apply a timeout here because the other thread is accessing state that
-				// is owned by this thread.
-				for(int waitMS = 100; (stateTemp == EATHREAD_BACKTRACE_STATE_DUMPING) && waitMS; waitMS--) // If the thread is (still) busy writing it out its callstack...
-				{
-					usleep(1000);
-					stateTemp = gThreadBacktraceState.mState.GetValue();
-				}
-
-				if(stateTemp == EATHREAD_BACKTRACE_STATE_DONE)
-					callstackCount = gThreadBacktraceState.mCallstackCount;
-				// Else give up on it. It's OK to just fall through.
-
-				// Restore the original SIGURG handler.
-				sigaction(SIGURG, &oact, NULL);
-			}
-
-			pthread_mutex_unlock(&gThreadBacktraceMutex);
-		}
-	}
-
-	return callstackCount;
-}
-*/
-
-
-
 ///////////////////////////////////////////////////////////////////////////////
 // GetCallstack
 //
 EATHREADLIB_API size_t GetCallstack(void* pReturnAddressArray[], size_t nReturnAddressArrayCapacity, const CallstackContext* pContext)
 {
-	// libunwind can only read the stack from the current thread.
-	// However, we can accomplish this for another thread by injecting a signal handler into that thread.
-	// See the EAThreadBacktrace() function source code above.
+	// libunwind can only read the stack from the current thread. Where EATHREAD_THREAD_CALLSTACK_AVAILABLE,
+	// GetCallstack(callstack, maxDepth, threadId, timeout) reads another thread's callstack by having that 
+	// thread call this function from a signal handler. See unix/eathread_callstack_signal.cpp.
 
 	if(pContext == NULL) // If reading the current thread's context...
 	{
@@ -450,7 +284,9 @@ EATHREADLIB_API void GetCallstackContext(CallstackContext& context, const Contex
 //
 EATHREADLIB_API size_t GetModuleFromAddress(const void* address, char* pModuleName, size_t moduleNameCapacity)
 {
-	#if 0 // Disabled until testable: defined(EA_PLATFORM_LINUX)
+	#if EATHREAD_MODULE_MAP_AVAILABLE
+		return GetModuleFromAddressCached(address, pModuleName, moduleNameCapacity);
+	#elif 0 // Disabled until testable: defined(EA_PLATFORM_LINUX)
 		// The output of reading /proc/self/maps is like the following (there's no leading space on each line).
 		// We look for entries that have r-x as the first three flags, as they are executable modules.
 		// The format is (http://linux.die.net/man/5/proc):
@@ -606,13 +442,17 @@ EATHREADLIB_API size_t GetModuleFromAddress(const void* address, char* pModuleNa
 ///////////////////////////////////////////////////////////////////////////////
 // GetModuleHandleFromAddress
 //
-EATHREADLIB_API ModuleHandle GetModuleHandleFromAddress(const void* /*pAddress*/)
+EATHREADLIB_API ModuleHandle GetModuleHandleFromAddress(const void* pAddress)
 {
-	// This is doable for Linux-based platforms via fopen("/proc/self/maps")
-	// Probably also doable for BSD.
-	// http://freebsd.1045724.n5.nabble.com/How-to-get-stack-bounds-of-current-process-td4053477.html
-	// Not currently implemented for the given platform.
-	return 0;
+	#if EATHREAD_MODULE_MAP_AVAILABLE
+		return GetModuleHandleFromAddressCached(pAddress);
+	#else
+		// Probably doable for BSD.
+		// http://freebsd.1045724.n5.nabble.com/How-to-get-stack-bounds-of-current-process-td4053477.html
+		// Not currently implemented for the given platform.
+		EA_UNUSED(pAddress);
+		return 0;
+	#endif
 }
 
 
@@ -34,7 +34,7 @@
 
 
 	EA::Thread::MutexParameters::MutexParameters(bool bIntraProcess, const char* pName)
-		: mbIntraProcess(bIntraProcess)
+		: mbIntraProcess(bIntraProcess), mbRecursive(true), mbRobust(false) // mbRecursive is ignored; critical sections and kernel mutexes are always recursive.
 	{
 		if(pName)
 		{
@@ -188,6 +188,12 @@
 	}
 
 
+	bool EA::Thread::Mutex::MarkConsistent()
+	{
+		return true; // Robust mutexes are not supported on this platform.
+	}
+
+
 	int EA::Thread::Mutex::GetLockCount() const
 	{
 		return mMutexData.mnLockCount;
@@ -6,6 +6,7 @@
 #include "eathread/eathread.h"
 #include "eathread/eathread_callstack.h"
 #include "eathread/eathread_mutex.h"
+#include "eathread/eathread_storage.h"
 #include "eathread/eathread_sync.h"
 #include "eathread/eathread_thread.h"
 #include "eathread/internal/eathread_global.h"
@@ -371,6 +372,7 @@ EA_DISABLE_VC_WARNING(6312 6322)
 		}
 		
 		const unsigned int nReturnValue = (unsigned int)pTDD->mnReturnValue;
+		EA::Thread::DestroyThreadLocalPointers(); // Windows has no thread exit callbacks for us to do this automatically.
 		EA::Thread::SetCurrentThreadHandle(0, false);
 		pTDD->mnStatus = EA::Thread::Thread::kStatusEnded;
 		pTDD->Release();
@@ -518,6 +520,7 @@ EA_DISABLE_VC_WARNING(6312 6322)
 			 pTDD->mnReturnValue = pRunnable->Run(pCallContext);
 
 		const unsigned int nReturnValue = (unsigned int)pTDD->mnReturnValue;
+		EA::Thread::DestroyThreadLocalPointers(); // Windows has no thread exit callbacks for us to do this automatically.
 		EA::Thread::SetCurrentThreadHandle(0, false);
 		pTDD->mnStatus = EA::Thread::Thread::kStatusEnded;
 		pTDD->Release();
@@ -135,7 +135,10 @@
 					// Under SMP systems, pthread_cond_wait can return the success value 'spuriously'. 
 					// This is by design and we must retest the predicate condition and if it has
 					// not true, we must go back to waiting. 
-					result = pthread_cond_timedwait(&mBarrierData.mCV, &mBarrierData.mMutex, &timeoutAbsolute);
+					if(timeoutAbsolute == kTimeoutNone)
+						result = pthread_cond_wait(&mBarrierData.mCV, &mBarrierData.mMutex);
+					else
+						result = pthread_cond_timedwait(&mBarrierData.mCV, &mBarrierData.mMutex, &timeoutAbsolute);
 				} while((result == 0) && (nCurrentCycle == mBarrierData.mnCycle));
 				if(result != 0)
 					break;
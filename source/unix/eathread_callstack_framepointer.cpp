@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// This file implements a callstack reader which follows the chain of saved
+// frame pointers. On x86, x86-64 and ARM64 every function compiled with
+// frame pointers starts its frame with the caller's frame pointer followed
+// by the return address, so reading a callstack costs two loads per frame.
+// The unwind table readers (glibc backtrace, _Unwind_Backtrace) instead
+// look up and interpret each frame's unwind information, which costs some
+// microseconds per callstack.
+//
+// The chain is broken by any function which was compiled without frame
+// pointers, so every frame is checked against the bounds of the stack
+// before it is read, and the callstack ends at the first one that fails.
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <eathread/internal/config.h>
+
+#if EATHREAD_FRAME_POINTER_CALLSTACK_AVAILABLE
+
+#include <eathread/eathread_callstack.h>
+#include <eathread/eathread_callstack_context.h>
+#include <eathread/eathread_atomic.h>
+#include <eathread/eathread_storage.h>
+#include <ucontext.h>
+
+
+namespace EA
+{
+namespace Thread
+{
+namespace
+{
+	AtomicInt32 gCallstackUnwinder(kCallstackUnwinderDefault);
+
+	// The calling thread's stack bounds, which are looked up on first use, as
+	// looking them up isn't async-signal-safe. 0 until then.
+	EA_THREAD_LOCAL uintptr_t tnFramePointerStackLimit = 0;
+	EA_THREAD_LOCAL uintptr_t tnFramePointerStackBase  = 0;
+
+
+	// Gets the calling thread's stack bounds. If they aren't known yet then they are looked
+	// up if bLookUp is true, and otherwise false is returned.
+	bool GetFramePointerStackBounds(uintptr_t& nLimit, uintptr_t& nBase, bool bLookUp)
+	{
+		if(!tnFramePointerStackBase && bLookUp)
+		{
+			tnFramePointerStackLimit = (uintptr_t)GetStackLimit();
+			tnFramePointerStackBase  = (uintptr_t)GetStackBase();
+		}
+
+		nLimit = tnFramePointerStackLimit;
+		nBase  = tnFramePointerStackBase;
+
+		return (nBase != 0);
+	}
+
+
+	// Appends the return addresses of the frames from nFrame on to callstack[nDepth...].
+	// Returns the new depth. This must be async-signal-safe.
+	size_t WalkFramePointers(void* callstack[], size_t maxDepth, size_t nDepth, uintptr_t nFrame, uintptr_t nLimit, uintptr_t nBase)
+	{
+		while((nDepth < maxDepth) && (nFrame >= nLimit) && (nFrame <= (nBase - (2 * sizeof(uintptr_t)))) && ((nFrame & (sizeof(uintptr_t) - 1)) == 0))
+		{
+			const uintptr_t* const pFrame = reinterpret_cast<const uintptr_t*>(nFrame);
+
+			if(pFrame[1] == 0) // The outermost frame (e.g. that of clone or _start) has no return address.
+				break;
+
+			callstack[nDepth++] = reinterpret_cast<void*>(pFrame[1]);
+
+			// The stack grows down, so each caller's frame is above its callee's.
+			// Requiring this also guarantees that the loop ends.
+			if(pFrame[0] <= nFrame)
+				break;
+
+			nFrame = pFrame[0];
+		}
+
+		return nDepth;
+	}
+
+
+	// Reads the callstack that starts at pContext's instruction pointer and frame pointer.
+	// If bLookUpBounds is false then this is async-signal-safe, but returns 0 if pContext
+	// doesn't give the stack bounds and the calling thread's aren't known yet.
+	size_t ReadFramePointerCallstack(void* callstack[], size_t maxDepth, const CallstackContext& context, bool bLookUpBounds)
+	{
+		uintptr_t nLimit = context.mStackLimit;
+		uintptr_t nBase  = context.mStackBase;
+
+		if(!nBase && !GetFramePointerStackBounds(nLimit, nBase, bLookUpBounds))
+			return 0;
+
+		#if defined(EA_PROCESSOR_X86_64)
+			const uintptr_t nPC = (uintptr_t)context.mRIP, nFrame = (uintptr_t)context.mRBP;
+		#elif defined(EA_PROCESSOR_X86)
+			const uintptr_t nPC = (uintptr_t)context.mEIP, nFrame = (uintptr_t)context.mEBP;
+		#else
+			const uintptr_t nPC = (uintptr_t)context.mPC, nFrame = (uintptr_t)context.mFP;
+		#endif
+
+		if(!maxDepth || !nPC)
+			return 0;
+
+		callstack[0] = reinterpret_cast<void*>(nPC);
+
+		return WalkFramePointers(callstack, maxDepth, 1, nFrame, nLimit, nBase);
+	}
+
+
+	// Reads the callstack of the calling thread, from the frame pFrame (which is usually
+	// __builtin_frame_address(0) of the caller) on. So the first entry is in pFrame's caller.
+	inline size_t ReadFramePointerCallstack(void* callstack[], size_t maxDepth, void* pFrame)
+	{
+		uintptr_t nLimit, nBase;
+
+		if(GetFramePointerStackBounds(nLimit, nBase, true))
+		{
+			// The frames below pFrame aren't callers of it.
+			if((uintptr_t)pFrame > nLimit)
+				nLimit = (uintptr_t)pFrame;
+
+			return WalkFramePointers(callstack, maxDepth, 0, (uintptr_t)pFrame, nLimit, nBase);
+		}
+
+		return 0;
+	}
+
+
+	// Fills in context from the ucontext_t which a SA_SIGINFO signal handler receives.
+	// The stack bounds are left 0, which means the calling thread's.
+	inline void GetCallstackContextFromSignal(CallstackContext& context, const void* pSignalContext)
+	{
+		const ucontext_t* const pUContext = static_cast<const ucontext_t*>(pSignalContext);
+
+		#if defined(EA_PROCESSOR_X86_64)
+			context.mRIP = (uint64_t)pUContext->uc_mcontext.gregs[REG_RIP];
+			context.mRSP = (uint64_t)pUContext->uc_mcontext.gregs[REG_RSP];
+			context.mRBP = (uint64_t)pUContext->uc_mcontext.gregs[REG_RBP];
+		#elif defined(EA_PROCESSOR_X86)
+			context.mEIP = (uint32_t)pUContext->uc_mcontext.gregs[REG_EIP];
+			context.mESP = (uint32_t)pUContext->uc_mcontext.gregs[REG_ESP];
+			context.mEBP = (uint32_t)pUContext->uc_mcontext.gregs[REG_EBP];
+		#else
+			context.mPC = (uint64_t)pUContext->uc_mcontext.pc;
+			context.mSP = (uint64_t)pUContext->uc_mcontext.sp;
+			context.mFP = (uint64_t)pUContext->uc_mcontext.regs[29];
+		#endif
+	}
+
+} // namespace
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// SetCallstackUnwinder
+//
+EATHREADLIB_API void SetCallstackUnwinder(CallstackUnwinder unwinder)
+{
+	gCallstackUnwinder.SetValue((int32_t)unwinder);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// GetCallstackUnwinder
+//
+EATHREADLIB_API CallstackUnwinder GetCallstackUnwinder()
+{
+	// This is read for every GetCallstack call, so we don't pay for a barrier.
+	return (CallstackUnwinder)gCallstackUnwinder.GetValueRaw();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// GetCallstackFromFramePointers
+//
+EATHREADLIB_API size_t GetCallstackFromFramePointers(void* callstack[], size_t maxDepth, const CallstackContext* pContext)
+{
+	if(pContext)
+		return ReadFramePointerCallstack(callstack, maxDepth, *pContext, true);
+
+	return ReadFramePointerCallstack(callstack, maxDepth, __builtin_frame_address(0));
+}
+
+
+} // namespace Thread
+} // namespace EA
+
+#endif // EATHREAD_FRAME_POINTER_CALLSTACK_AVAILABLE
@@ -146,21 +146,32 @@ EATHREADLIB_API void GetCallstackContext(CallstackContext& context, const Contex
 ///////////////////////////////////////////////////////////////////////////////
 // GetModuleFromAddress
 //
-EATHREADLIB_API size_t GetModuleFromAddress(const void* /*address*/, char* pModuleName, size_t /*moduleNameCapacity*/)
+EATHREADLIB_API size_t GetModuleFromAddress(const void* address, char* pModuleName, size_t moduleNameCapacity)
 {
-	// Not currently implemented for the given platform.
-	pModuleName[0] = 0;
-	return 0;
+	#if EATHREAD_MODULE_MAP_AVAILABLE
+		return GetModuleFromAddressCached(address, pModuleName, moduleNameCapacity);
+	#else
+		EA_UNUSED(address);
+		EA_UNUSED(moduleNameCapacity);
+		// Not currently implemented for the given platform.
+		pModuleName[0] = 0;
+		return 0;
+	#endif
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 // GetModuleHandleFromAddress
 //
-EATHREADLIB_API ModuleHandle GetModuleHandleFromAddress(const void* /*pAddress*/)
+EATHREADLIB_API ModuleHandle GetModuleHandleFromAddress(const void* pAddress)
 {
-	// Not currently implemented for the given platform.
-	return 0;
+	#if EATHREAD_MODULE_MAP_AVAILABLE
+		return GetModuleHandleFromAddressCached(pAddress);
+	#else
+		EA_UNUSED(pAddress);
+		// Not currently implemented for the given platform.
+		return 0;
+	#endif
 }
 
 
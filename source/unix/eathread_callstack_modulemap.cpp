@@ -0,0 +1,366 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// This file implements GetModuleFromAddress and GetModuleHandleFromAddress
+// for Linux with a table of the loaded modules' segments, sorted by address
+// and searched with a binary search. The table is built with
+// dl_iterate_phdr, which reads the dynamic loader's own list of modules
+// instead of parsing /proc/self/maps. The loader counts the modules it has
+// loaded and unloaded (dlpi_adds and dlpi_subs), so each lookup compares
+// those counts with the ones the table was built with, and rebuilds the
+// table only when a module was loaded or unloaded since.
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <eathread/internal/config.h>
+
+#if EATHREAD_MODULE_MAP_AVAILABLE
+
+#include <eathread/eathread_callstack.h>
+#include <dlfcn.h>
+#include <link.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <new>
+
+
+namespace EA
+{
+namespace Thread
+{
+namespace
+{
+	struct ModuleSegment
+	{
+		uintptr_t mnBegin;
+		uintptr_t mnEnd;
+		size_t    mnModuleIndex;
+	};
+
+	struct ModuleEntry
+	{
+		size_t       mnNameOffset;      // The offset of the module's file path in the name pool.
+		size_t       mnNameLength;
+		uintptr_t    mnLoadAddress;     // dlpi_addr, which is what the module's addresses are relative to.
+		ModuleHandle mHandle;           // The same handle that dlopen returns for the module.
+	};
+
+	struct ModuleMap
+	{
+		ModuleSegment*     mpSegmentArray;  // Sorted by mnBegin.
+		size_t             mnSegmentCount;
+		size_t             mnSegmentCapacity;
+		ModuleEntry*       mpModuleArray;
+		size_t             mnModuleCount;
+		size_t             mnModuleCapacity;
+		char*              mpNamePool;
+		size_t             mnNamePoolSize;
+		size_t             mnNamePoolCapacity;
+		unsigned long long mnAddCount;      // The loader's dlpi_adds and dlpi_subs as of when the map was built.
+		unsigned long long mnSubCount;
+		bool               mbBuilt;
+		bool               mbOverflow;      // Set while building if the arrays turn out to be too small.
+	};
+
+	pthread_mutex_t gModuleMapMutex = PTHREAD_MUTEX_INITIALIZER; // Statically initialized, as lookups may happen during static initialization.
+	ModuleMap       gModuleMap;                                  // Zero-initialized.
+	char            gExecutablePath[512];
+
+
+	void* AllocModuleMapMemory(size_t nSize)
+	{
+		Allocator* pAllocator = GetAllocator();
+
+		return pAllocator ? pAllocator->Alloc(nSize, "EAThread ModuleMap") : new(std::nothrow) char[nSize];
+	}
+
+
+	void FreeModuleMapMemory(void* pMemory)
+	{
+		if(pMemory)
+		{
+			Allocator* pAllocator = GetAllocator();
+
+			if(pAllocator)
+				pAllocator->Free(pMemory);
+			else
+				delete[] static_cast<char*>(pMemory);
+		}
+	}
+
+
+	// The loader reports the executable with an empty name.
+	const char* GetModuleName(const dl_phdr_info* pInfo)
+	{
+		if(pInfo->dlpi_name && pInfo->dlpi_name[0])
+			return pInfo->dlpi_name;
+
+		if(!gExecutablePath[0])
+		{
+			const ssize_t nLength = readlink("/proc/self/exe", gExecutablePath, sizeof(gExecutablePath) - 1);
+			gExecutablePath[(nLength > 0) ? nLength : 0] = 0;
+		}
+
+		return gExecutablePath;
+	}
+
+
+	int ReadLoaderCounts(dl_phdr_info* pInfo, size_t nInfoSize, void* pContext)
+	{
+		unsigned long long* const pCounts = static_cast<unsigned long long*>(pContext);
+
+		if(nInfoSize >= (offsetof(dl_phdr_info, dlpi_subs) + sizeof(pInfo->dlpi_subs)))
+		{
+			pCounts[0] = pInfo->dlpi_adds;
+			pCounts[1] = pInfo->dlpi_subs;
+		}
+
+		return 1; // The counts are the same for every module, so we stop after the first.
+	}
+
+
+	// Adds pInfo's module and its loaded segments to gModuleMap, or sets mbOverflow if they don't fit.
+	// This is called with the loader's lock held, so it must not call into the loader (e.g. dladdr).
+	int AddModule(dl_phdr_info* pInfo, size_t nInfoSize, void* pContext)
+	{
+		ModuleMap&   map          = *static_cast<ModuleMap*>(pContext);
+		const char*  pName        = GetModuleName(pInfo);
+		const size_t nNameLength  = strlen(pName);
+		size_t       nLoadCount   = 0;
+
+		for(ElfW(Half) i = 0; i < pInfo->dlpi_phnum; i++)
+		{
+			if(pInfo->dlpi_phdr[i].p_type == PT_LOAD)
+				nLoadCount++;
+		}
+
+		if((map.mnModuleCount == map.mnModuleCapacity) || ((map.mnSegmentCount + nLoadCount) > map.mnSegmentCapacity) ||
+		   ((map.mnNamePoolSize + nNameLength + 1) > map.mnNamePoolCapacity))
+		{
+			map.mbOverflow = true;
+			return 1;
+		}
+
+		if(nInfoSize >= (offsetof(dl_phdr_info, dlpi_subs) + sizeof(pInfo->dlpi_subs)))
+		{
+			map.mnAddCount = pInfo->dlpi_adds;
+			map.mnSubCount = pInfo->dlpi_subs;
+		}
+
+		ModuleEntry& module  = map.mpModuleArray[map.mnModuleCount];
+		module.mnNameOffset  = map.mnNamePoolSize;
+		module.mnNameLength  = nNameLength;
+		module.mnLoadAddress = (uintptr_t)pInfo->dlpi_addr;
+		module.mHandle       = NULL;
+
+		memcpy(map.mpNamePool + map.mnNamePoolSize, pName, nNameLength + 1);
+		map.mnNamePoolSize += nNameLength + 1;
+
+		for(ElfW(Half) i = 0; i < pInfo->dlpi_phnum; i++)
+		{
+			const ElfW(Phdr)& phdr = pInfo->dlpi_phdr[i];
+
+			if((phdr.p_type == PT_LOAD) && phdr.p_memsz)
+			{
+				ModuleSegment& segment = map.mpSegmentArray[map.mnSegmentCount++];
+				segment.mnBegin       = (uintptr_t)(pInfo->dlpi_addr + phdr.p_vaddr);
+				segment.mnEnd         = segment.mnBegin + (uintptr_t)phdr.p_memsz;
+				segment.mnModuleIndex = map.mnModuleCount;
+			}
+		}
+
+		map.mnModuleCount++;
+
+		return 0;
+	}
+
+
+	int CompareModuleSegments(const void* pA, const void* pB)
+	{
+		const uintptr_t nA = static_cast<const ModuleSegment*>(pA)->mnBegin;
+		const uintptr_t nB = static_cast<const ModuleSegment*>(pB)->mnBegin;
+
+		return (nA < nB) ? -1 : ((nA > nB) ? 1 : 0);
+	}
+
+
+	bool GrowModuleMap(ModuleMap& map)
+	{
+		const size_t   nSegmentCapacity  = map.mnSegmentCapacity  ? (map.mnSegmentCapacity  * 2) : 256;
+		const size_t   nModuleCapacity   = map.mnModuleCapacity   ? (map.mnModuleCapacity   * 2) : 64;
+		const size_t   nNamePoolCapacity = map.mnNamePoolCapacity ? (map.mnNamePoolCapacity * 2) : 4096;
+		ModuleSegment* pSegmentArray     = static_cast<ModuleSegment*>(AllocModuleMapMemory(nSegmentCapacity * sizeof(ModuleSegment)));
+		ModuleEntry*   pModuleArray      = static_cast<ModuleEntry*>(AllocModuleMapMemory(nModuleCapacity * sizeof(ModuleEntry)));
+		char*          pNamePool         = static_cast<char*>(AllocModuleMapMemory(nNamePoolCapacity));
+
+		if(!pSegmentArray || !pModuleArray || !pNamePool)
+		{
+			FreeModuleMapMemory(pSegmentArray);
+			FreeModuleMapMemory(pModuleArray);
+			FreeModuleMapMemory(pNamePool);
+			return false;
+		}
+
+		// The contents needn't be kept, as the map is rebuilt after growing.
+		FreeModuleMapMemory(map.mpSegmentArray);
+		FreeModuleMapMemory(map.mpModuleArray);
+		FreeModuleMapMemory(map.mpNamePool);
+
+		map.mpSegmentArray     = pSegmentArray;
+		map.mnSegmentCapacity  = nSegmentCapacity;
+		map.mpModuleArray      = pModuleArray;
+		map.mnModuleCapacity   = nModuleCapacity;
+		map.mpNamePool         = pNamePool;
+		map.mnNamePoolCapacity = nNamePoolCapacity;
+
+		return true;
+	}
+
+
+	// Must be called with gModuleMapMutex locked.
+	bool BuildModuleMap(ModuleMap& map)
+	{
+		map.mbBuilt = false;
+
+		for(;;)
+		{
+			map.mnSegmentCount = map.mnModuleCount = map.mnNamePoolSize = 0;
+			map.mbOverflow     = false;
+
+			if(map.mnModuleCapacity)
+				dl_iterate_phdr(AddModule, &map);
+
+			if(map.mnModuleCapacity && !map.mbOverflow)
+				break;
+
+			if(!GrowModuleMap(map))
+				return false;
+		}
+
+		qsort(map.mpSegmentArray, map.mnSegmentCount, sizeof(ModuleSegment), CompareModuleSegments);
+
+		// The loader's handle for a module is its link_map, which dladdr1 finds from any address in it.
+		for(size_t i = 0; i < map.mnSegmentCount; i++)
+		{
+			ModuleEntry& module = map.mpModuleArray[map.mpSegmentArray[i].mnModuleIndex];
+			Dl_info      info;
+			void*        pLinkMap = NULL;
+
+			if(!module.mHandle && dladdr1((void*)map.mpSegmentArray[i].mnBegin, &info, &pLinkMap, RTLD_DL_LINKMAP) && pLinkMap &&
+			   (static_cast<link_map*>(pLinkMap)->l_addr == module.mnLoadAddress))
+			{
+				module.mHandle = pLinkMap;
+			}
+		}
+
+		map.mbBuilt = true;
+		return true;
+	}
+
+
+	// Must be called with gModuleMapMutex locked.
+	void UpdateModuleMapIfChanged(ModuleMap& map)
+	{
+		unsigned long long counts[2] = { 0, 0 };
+
+		if(map.mbBuilt)
+			dl_iterate_phdr(ReadLoaderCounts, counts);
+
+		if(!map.mbBuilt || (counts[0] != map.mnAddCount) || (counts[1] != map.mnSubCount))
+			BuildModuleMap(map);
+	}
+
+
+	// Must be called with gModuleMapMutex locked. Returns NULL if pAddress isn't in any module.
+	const ModuleEntry* FindModule(const ModuleMap& map, const void* pAddress)
+	{
+		const uintptr_t nAddress = (uintptr_t)pAddress;
+		size_t          nLow     = 0;
+		size_t          nHigh    = map.mnSegmentCount;
+
+		// Find the first segment which begins after the address. The one before it is the only candidate.
+		while(nLow < nHigh)
+		{
+			const size_t nMid = nLow + ((nHigh - nLow) / 2);
+
+			if(map.mpSegmentArray[nMid].mnBegin <= nAddress)
+				nLow = nMid + 1;
+			else
+				nHigh = nMid;
+		}
+
+		if(nLow && (nAddress < map.mpSegmentArray[nLow - 1].mnEnd))
+			return &map.mpModuleArray[map.mpSegmentArray[nLow - 1].mnModuleIndex];
+
+		return NULL;
+	}
+
+
+	size_t GetModuleFromAddressCached(const void* pAddress, char* pModuleName, size_t moduleNameCapacity)
+	{
+		size_t nLength = 0;
+
+		pthread_mutex_lock(&gModuleMapMutex);
+		UpdateModuleMapIfChanged(gModuleMap);
+
+		const ModuleEntry* const pModule = gModuleMap.mbBuilt ? FindModule(gModuleMap, pAddress) : NULL;
+
+		if(pModule && (moduleNameCapacity > 0))
+		{
+			const size_t nCopyLength = (pModule->mnNameLength < moduleNameCapacity) ? pModule->mnNameLength : (moduleNameCapacity - 1);
+
+			memcpy(pModuleName, gModuleMap.mpNamePool + pModule->mnNameOffset, nCopyLength);
+			pModuleName[nCopyLength] = 0;
+			nLength = pModule->mnNameLength;
+		}
+		else if(moduleNameCapacity > 0)
+			pModuleName[0] = 0;
+
+		pthread_mutex_unlock(&gModuleMapMutex);
+
+		return nLength;
+	}
+
+
+	ModuleHandle GetModuleHandleFromAddressCached(const void* pAddress)
+	{
+		ModuleHandle handle = NULL;
+
+		pthread_mutex_lock(&gModuleMapMutex);
+		UpdateModuleMapIfChanged(gModuleMap);
+
+		const ModuleEntry* const pModule = gModuleMap.mbBuilt ? FindModule(gModuleMap, pAddress) : NULL;
+
+		if(pModule)
+			handle = pModule->mHandle;
+
+		pthread_mutex_unlock(&gModuleMapMutex);
+
+		return handle;
+	}
+
+} // namespace
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// UpdateModuleMap
+//
+EATHREADLIB_API bool UpdateModuleMap()
+{
+	pthread_mutex_lock(&gModuleMapMutex);
+	const bool bResult = BuildModuleMap(gModuleMap);
+	pthread_mutex_unlock(&gModuleMapMutex);
+
+	return bResult;
+}
+
+
+} // namespace Thread
+} // namespace EA
+
+#endif // EATHREAD_MODULE_MAP_AVAILABLE
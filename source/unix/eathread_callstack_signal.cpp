@@ -0,0 +1,405 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// This file implements reading the callstack of another thread, for the
+// platforms where GetCallstack can read only the calling thread's callstack.
+// The requesting thread interrupts the target thread with a signal, and the
+// target reads its own callstack from within its signal handler.
+//
+// Each request has its own slot in a fixed table, so that any number of
+// threads can request callstacks of any number of threads at once. A slot
+// is claimed and released with compare-and-swap only, as the signal handler
+// can't use a mutex. The signal doesn't identify the request, because a
+// signal sent to a thread which already has it pending is merged with the
+// pending one. Instead the handler serves every pending request for its
+// thread. The slot state carries a generation count, so that a slot which
+// timed out and was claimed again is never mistaken for the old request.
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <eathread/internal/config.h>
+
+#if EATHREAD_THREAD_CALLSTACK_AVAILABLE
+
+#include <eathread/eathread_callstack.h>
+#include <eathread/eathread_callstack_context.h>
+#include <eathread/eathread_thread.h>
+#include <eathread/eathread_atomic.h>
+#include <eathread/internal/eathread_futexword.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <ucontext.h>
+
+
+namespace EA
+{
+namespace Thread
+{
+namespace
+{
+	enum CallstackRequestState
+	{
+		kRequestStateFree,          // The slot can be claimed by a requester.
+		kRequestStateClaimed,       // A requester is filling in the slot.
+		kRequestStatePending,       // The signal was (or is about to be) sent, and the target hasn't responded yet.
+		kRequestStateCapturing,     // The target is reading its callstack into the slot.
+		kRequestStateDone,          // The callstack is ready for the requester.
+		kRequestStateAbandoned      // The requester timed out while the target was capturing. The target frees the slot.
+	};
+
+	const int32_t  kRequestStateBits      = 3;
+	const int32_t  kRequestStateMask      = (1 << kRequestStateBits) - 1;
+	const int32_t  kRequestGenerationMask = 0x00ffffff;
+	const int      kRequestSignalTag      = 0x45415448; // Identifies the signals that we send, as opposed to ones the application sends.
+	const size_t   kRequestCount          = 32;
+	const size_t   kRequestCaptureDepth   = ThreadCallstack::kMaxDepth + 16; // Room for the signal handler's own frames, which we strip.
+	const size_t   kMaxEnumeratedThreads  = 128; // The same as kMaxThreadDynamicDataCount, which isn't a compile-time constant.
+
+	struct CallstackRequest
+	{
+		AtomicInt32 mnState;        // (generation << kRequestStateBits) | CallstackRequestState.
+		ThreadId    mThreadId;      // The thread whose callstack is requested. Written before the signal is sent.
+		size_t      mnDepth;
+		void*       mCallstack[ThreadCallstack::kMaxDepth];
+	};
+
+	CallstackRequest gCallstackRequests[kRequestCount];
+	pthread_once_t   gCallstackSignalOnce = PTHREAD_ONCE_INIT;
+	struct sigaction gPreviousSignalAction;
+	bool             gbCallstackSignalInstalled = false;
+
+
+	inline int32_t MakeRequestState(int32_t nGeneration, CallstackRequestState state)
+		{ return ((nGeneration & kRequestGenerationMask) << kRequestStateBits) | state; }
+
+	inline int32_t GetRequestGeneration(int32_t nState)
+		{ return (nState >> kRequestStateBits) & kRequestGenerationMask; }
+
+
+	inline void* GetInterruptedInstructionPointer(void* pSignalContext)
+	{
+		const ucontext_t* const pContext = static_cast<const ucontext_t*>(pSignalContext);
+
+		#if defined(EA_PROCESSOR_X86_64)
+			return (void*)pContext->uc_mcontext.gregs[REG_RIP];
+		#elif defined(EA_PROCESSOR_X86)
+			return (void*)pContext->uc_mcontext.gregs[REG_EIP];
+		#elif defined(EA_PROCESSOR_ARM64)
+			return (void*)pContext->uc_mcontext.pc;
+		#elif defined(EA_PROCESSOR_ARM32)
+			return (void*)pContext->uc_mcontext.arm_pc;
+		#else
+			EA_UNUSED(pContext);
+			return NULL;
+		#endif
+	}
+
+
+	// Reads the calling thread's callstack, starting with the interrupted function rather than 
+	// the signal handler. This runs in the signal handler, so everything it calls must be 
+	// async-signal-safe once GetCallstack has been warmed up by InstallCallstackSignal.
+	// The stack bounds are used by the frame pointer unwinder, and may be NULL.
+	size_t CaptureInterruptedCallstack(void* callstack[kRequestCaptureDepth], void* pSignalContext, void* pStackBase = NULL, void* pStackLimit = NULL)
+	{
+		#if EATHREAD_FRAME_POINTER_CALLSTACK_AVAILABLE
+			if(GetCallstackUnwinder() == kCallstackUnwinderFramePointer)
+			{
+				// This starts at the interrupted frame, so there's nothing to strip. It fails if 
+				// no stack bounds were given and this thread's aren't known yet, in which case 
+				// we fall through.
+				CallstackContext context;
+				GetCallstackContextFromSignal(context, pSignalContext);
+				context.mStackBase  = (uintptr_t)pStackBase;
+				context.mStackLimit = (uintptr_t)pStackLimit;
+
+				const size_t nDepth = ReadFramePointerCallstack(callstack, kRequestCaptureDepth, context, false);
+				if(nDepth)
+					return nDepth;
+			}
+		#endif
+
+		void* const  pInterrupted = GetInterruptedInstructionPointer(pSignalContext);
+		const size_t nDepth       = GetCallstack(callstack, kRequestCaptureDepth, (const CallstackContext*)NULL);
+		size_t       nFirst       = 0;
+
+		// Unwinders which understand signal frames report the interrupted instruction itself, so
+		// everything before it is the handler. Others stop at the signal frame, or skip over the
+		// interrupted function, in which case we report only the interrupted instruction.
+		while((nFirst < nDepth) && (callstack[nFirst] != pInterrupted))
+			++nFirst;
+
+		if(nFirst < nDepth)
+		{
+			memmove(callstack, callstack + nFirst, (nDepth - nFirst) * sizeof(void*));
+			return nDepth - nFirst;
+		}
+
+		callstack[0] = pInterrupted;
+		return pInterrupted ? 1 : 0;
+	}
+
+
+	void CallstackSignalHandler(int nSignal, siginfo_t* pSignalInfo, void* pSignalContext)
+	{
+		const int nSavedErrno = errno;
+
+		if((pSignalInfo->si_code == SI_QUEUE) && (pSignalInfo->si_pid == getpid()) && (pSignalInfo->si_value.sival_int == kRequestSignalTag))
+		{
+			void*  callstack[kRequestCaptureDepth];
+			size_t nDepth = (size_t)-1; // We capture only once we find a request for us, as the signal may be stale.
+
+			for(size_t i = 0; i < kRequestCount; i++)
+			{
+				CallstackRequest& request     = gCallstackRequests[i];
+				const int32_t     nState      = request.mnState.GetValue();
+				const int32_t     nGeneration = GetRequestGeneration(nState);
+
+				// If the CAS succeeds then the slot was pending the whole time, so mThreadId was 
+				// the requested thread's. Otherwise the requester just timed out and freed it.
+				if(((nState & kRequestStateMask) == kRequestStatePending) && pthread_equal(request.mThreadId, pthread_self()) &&
+				   request.mnState.SetValueConditional(MakeRequestState(nGeneration, kRequestStateCapturing), nState))
+				{
+					if(nDepth == (size_t)-1)
+						nDepth = CaptureInterruptedCallstack(callstack, pSignalContext);
+
+					request.mnDepth = (nDepth < ThreadCallstack::kMaxDepth) ? nDepth : ThreadCallstack::kMaxDepth;
+					memcpy(request.mCallstack, callstack, request.mnDepth * sizeof(void*));
+
+					if(request.mnState.SetValueConditional(MakeRequestState(nGeneration, kRequestStateDone), MakeRequestState(nGeneration, kRequestStateCapturing)))
+					{
+						#if EATHREAD_FUTEX_WORD_AVAILABLE
+							FutexWordWakeAll(request.mnState);
+						#endif
+					}
+					else // Else the requester gave up on us while we were capturing, and left the slot to us to free.
+						request.mnState.SetValue(MakeRequestState(nGeneration, kRequestStateFree));
+				}
+			}
+		}
+		else if(gPreviousSignalAction.sa_flags & SA_SIGINFO)
+		{
+			if(gPreviousSignalAction.sa_sigaction)
+				gPreviousSignalAction.sa_sigaction(nSignal, pSignalInfo, pSignalContext);
+		}
+		else if((gPreviousSignalAction.sa_handler != SIG_DFL) && (gPreviousSignalAction.sa_handler != SIG_IGN))
+			gPreviousSignalAction.sa_handler(nSignal);
+
+		errno = nSavedErrno;
+	}
+
+
+	void InstallCallstackSignal()
+	{
+		// Some GetCallstack implementations (e.g. glibc's backtrace) load what they need on first
+		// use, which isn't safe to do in a signal handler. So we make sure that's already done.
+		void* callstack[4];
+		GetCallstack(callstack, EAArrayCount(callstack), (const CallstackContext*)NULL);
+
+		struct sigaction action;
+		memset(&action, 0, sizeof(action));
+		action.sa_sigaction = CallstackSignalHandler;
+		action.sa_flags     = SA_SIGINFO | SA_RESTART | SA_ONSTACK;
+		sigemptyset(&action.sa_mask);
+
+		gbCallstackSignalInstalled = (sigaction(EATHREAD_CALLSTACK_SIGNAL, &action, &gPreviousSignalAction) == 0);
+	}
+
+
+	// Claims a slot and sends the signal to threadId.
+	// Returns the slot index, or -1 if all slots are in use, or -2 if the thread couldn't be signaled.
+	int BeginCallstackRequest(const ThreadId& threadId)
+	{
+		for(size_t i = 0; i < kRequestCount; i++)
+		{
+			CallstackRequest& request = gCallstackRequests[i];
+			const int32_t     nState  = request.mnState.GetValue();
+
+			if((nState & kRequestStateMask) == kRequestStateFree)
+			{
+				const int32_t nGeneration = GetRequestGeneration(nState) + 1;
+
+				// Signal handlers look at pending slots only, so we fill in the slot before making it pending.
+				if(request.mnState.SetValueConditional(MakeRequestState(nGeneration, kRequestStateClaimed), nState))
+				{
+					request.mThreadId = threadId;
+					request.mnDepth   = 0;
+					request.mnState.SetValue(MakeRequestState(nGeneration, kRequestStatePending)); // This is a full barrier.
+
+					sigval value;
+					value.sival_int = kRequestSignalTag;
+
+					if(pthread_sigqueue(threadId, EATHREAD_CALLSTACK_SIGNAL, value) == 0)
+						return (int)i;
+
+					request.mnState.SetValue(MakeRequestState(nGeneration, kRequestStateFree));
+					return -2;
+				}
+			}
+		}
+
+		return -1;
+	}
+
+
+	// Waits for the request in slot nIndex, copies its result to callstack, and frees the slot.
+	// Returns the number of entries copied, which is 0 if the request timed out.
+	size_t EndCallstackRequest(int nIndex, void* callstack[], size_t maxDepth, const ThreadTime& timeoutAbsolute)
+	{
+		CallstackRequest& request     = gCallstackRequests[nIndex];
+		int32_t           nState      = request.mnState.GetValue();
+		const int32_t     nGeneration = GetRequestGeneration(nState);
+		const int32_t     nDone       = MakeRequestState(nGeneration, kRequestStateDone);
+
+		while(nState != nDone)
+		{
+			if((timeoutAbsolute != kTimeoutNone) && (GetThreadTime() >= timeoutAbsolute))
+			{
+				// If the target hasn't started, we take the slot back. If it's capturing, it's writing to 
+				// the slot, so we must not free it, and instead leave it to the target to free when done.
+				if(request.mnState.SetValueConditional(MakeRequestState(nGeneration, kRequestStateFree), MakeRequestState(nGeneration, kRequestStatePending)) ||
+				   request.mnState.SetValueConditional(MakeRequestState(nGeneration, kRequestStateAbandoned), MakeRequestState(nGeneration, kRequestStateCapturing)))
+				{
+					return 0;
+				}
+			}
+			else
+			{
+				#if EATHREAD_FUTEX_WORD_AVAILABLE
+					FutexWordWait(request.mnState, nState, timeoutAbsolute);
+				#else
+					ThreadSleep(1);
+				#endif
+			}
+
+			nState = request.mnState.GetValue();
+		}
+
+		const size_t nDepth = (request.mnDepth < maxDepth) ? request.mnDepth : maxDepth;
+		memcpy(callstack, request.mCallstack, nDepth * sizeof(void*));
+		request.mnState.SetValue(MakeRequestState(nGeneration, kRequestStateFree));
+
+		return nDepth;
+	}
+
+} // namespace
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// GetCallstack
+//
+EATHREADLIB_API size_t GetCallstack(void* callstack[], size_t maxDepth, const ThreadId& threadId, const ThreadTime& timeoutAbsolute)
+{
+	if(pthread_equal(threadId, pthread_self()))
+		return GetCallstack(callstack, maxDepth, (const CallstackContext*)NULL);
+
+	pthread_once(&gCallstackSignalOnce, InstallCallstackSignal);
+
+	if(gbCallstackSignalInstalled)
+	{
+		int nIndex;
+
+		// All slots are in use only if many threads are requesting callstacks at once, so we poll.
+		while((nIndex = BeginCallstackRequest(threadId)) == -1)
+		{
+			if((timeoutAbsolute != kTimeoutNone) && (GetThreadTime() >= timeoutAbsolute))
+				return 0;
+			ThreadSleep(1);
+		}
+
+		if(nIndex >= 0)
+			return EndCallstackRequest(nIndex, callstack, maxDepth, timeoutAbsolute);
+	}
+
+	return 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// GetSignalCallstack
+//
+EATHREADLIB_API size_t GetSignalCallstack(void* callstack[], size_t maxDepth, void* pSignalContext, void* pStackBase, void* pStackLimit)
+{
+	void*        captured[kRequestCaptureDepth];
+	const size_t nCaptured = CaptureInterruptedCallstack(captured, pSignalContext, pStackBase, pStackLimit);
+	size_t       nDepth    = (nCaptured < maxDepth) ? nCaptured : maxDepth;
+
+	if(nDepth > ThreadCallstack::kMaxDepth)
+		nDepth = ThreadCallstack::kMaxDepth;
+
+	memcpy(callstack, captured, nDepth * sizeof(void*));
+
+	return nDepth;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// GetThreadCallstacks
+//
+EATHREADLIB_API size_t GetThreadCallstacks(ThreadCallstack* pCallstackArray, size_t nCapacity, const ThreadTime& timeoutAbsolute)
+{
+	ThreadEnumData enumData[kMaxEnumeratedThreads];
+	int            requestIndex[kMaxEnumeratedThreads];
+	const size_t   nThreadCount = EnumerateThreads(enumData, EAArrayCount(enumData));
+	size_t         nCount       = (nThreadCount < nCapacity) ? nThreadCount : nCapacity;
+	size_t         nEnded       = 0; // Requests before this index have been ended.
+
+	if(nCount > EAArrayCount(enumData))
+		nCount = EAArrayCount(enumData);
+
+	pthread_once(&gCallstackSignalOnce, InstallCallstackSignal);
+
+	// We send all the signals before waiting for any of them, so that the threads capture
+	// their callstacks concurrently, and the overall wait is that of the slowest thread.
+	for(size_t i = 0; i < nCount; i++)
+	{
+		const EAThreadDynamicData* const pData = enumData[i].mpThreadDynamicData;
+		ThreadCallstack&                 tc    = pCallstackArray[i];
+
+		tc.mThreadId = pData->mThreadId;
+		tc.mnDepth   = 0;
+		memcpy(tc.mName, pData->mName, sizeof(tc.mName));
+		tc.mName[EAArrayCount(tc.mName) - 1] = 0;
+		requestIndex[i] = -2;
+
+		if(pthread_equal(tc.mThreadId, pthread_self()))
+			tc.mnDepth = GetCallstack(tc.mCallstack, ThreadCallstack::kMaxDepth, (const CallstackContext*)NULL);
+		else if(gbCallstackSignalInstalled && (pData->mnStatus != Thread::kStatusEnded)) // The pthread_t of an ended thread may be invalid.
+		{
+			// If the slots are all in use, we make room by ending our oldest request. If none of them are
+			// ours then other threads are requesting callstacks at the same time, and we wait for them.
+			while((requestIndex[i] = BeginCallstackRequest(tc.mThreadId)) == -1)
+			{
+				if(nEnded < i)
+				{
+					if(requestIndex[nEnded] >= 0)
+						pCallstackArray[nEnded].mnDepth = EndCallstackRequest(requestIndex[nEnded], pCallstackArray[nEnded].mCallstack, ThreadCallstack::kMaxDepth, timeoutAbsolute);
+					nEnded++;
+				}
+				else if((timeoutAbsolute == kTimeoutNone) || (GetThreadTime() < timeoutAbsolute))
+					ThreadSleep(1);
+				else
+					break;
+			}
+		}
+	}
+
+	for(; nEnded < nCount; nEnded++)
+	{
+		if(requestIndex[nEnded] >= 0)
+			pCallstackArray[nEnded].mnDepth = EndCallstackRequest(requestIndex[nEnded], pCallstackArray[nEnded].mCallstack, ThreadCallstack::kMaxDepth, timeoutAbsolute);
+	}
+
+	return nThreadCount;
+}
+
+
+} // namespace Thread
+} // namespace EA
+
+#endif // EATHREAD_THREAD_CALLSTACK_AVAILABLE
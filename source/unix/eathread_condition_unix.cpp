@@ -113,6 +113,17 @@
 		else
 			result = pthread_cond_timedwait(&mConditionData.mCV, pMutex_t, &timeoutAbsolute);
 
+		#if EATHREAD_ROBUST_MUTEX_AVAILABLE
+			if(result == EOWNERDEAD)
+			{
+				// We have the mutex back, but a robust mutex's previous owner died holding it,
+				// possibly with its lock count changed. See Mutex::kResultOwnerDied.
+				pMutexData->mnLockCount = 0;
+				pMutexData->SimulateLock(true);
+				return kResultOwnerDied;
+			}
+		#endif
+
 		pMutexData->SimulateLock(true);
 		EAT_ASSERT(!pMutex || (pMutex->GetLockCount() == 1));
 
@@ -53,7 +53,7 @@
 
 
 	EA::Thread::MutexParameters::MutexParameters(bool bIntraProcess, const char* /*pName*/)
-		: mbIntraProcess(bIntraProcess)
+		: mbIntraProcess(bIntraProcess), mbRecursive(true), mbRobust(false)
 	{
 		// Empty
 	}
@@ -87,7 +87,20 @@
 			pthread_mutexattr_t attr;
 			pthread_mutexattr_init(&attr);
 
-			pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+			if(pMutexParameters->mbRecursive)
+				pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+			else
+			{
+				#if EAT_ASSERT_ENABLED
+					// Error-checking mutexes fail re-entrant locks with EDEADLK instead of hanging.
+					pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_ERRORCHECK);
+				#elif defined(PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP)
+					// glibc's adaptive mutex spins briefly before sleeping, which suits short critical sections.
+					pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_ADAPTIVE_NP);
+				#else
+					pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_NORMAL);
+				#endif
+			}
 
 				#if defined(PTHREAD_PROCESS_PRIVATE)    // Some pthread implementations don't recognize this.
 					#if defined(PTHREAD_PROCESS_SHARED)
@@ -100,6 +113,11 @@
 					#endif
 				#endif
 
+			#if EATHREAD_ROBUST_MUTEX_AVAILABLE
+				if(pMutexParameters->mbRobust)
+					pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+			#endif
+
 			const int result = pthread_mutex_init(&mMutexData.mMutex, &attr);
 			pthread_mutexattr_destroy(&attr);
 
@@ -118,41 +136,14 @@
 		EAT_ASSERT(mMutexData.mnLockCount < 100000);
 
 		if(timeoutAbsolute == kTimeoutNone)
-		{
 			result = pthread_mutex_lock(&mMutexData.mMutex);
-
-			if(result != 0)
-			{
-				EAT_ASSERT(false);
-				return kResultError;
-			}
-		}
 		else if(timeoutAbsolute == kTimeoutImmediate)
-		{
 			result = pthread_mutex_trylock(&mMutexData.mMutex);
-
-			if(result != 0)
-			{
-				if(result == EBUSY)
-					return kResultTimeout;
-
-				EAT_ASSERT(false);
-				return kResultError;
-			}
-		}
 		else
 		{
 			#if (defined(EA_PLATFORM_LINUX) || defined(EA_PLATFORM_WINDOWS)) && !defined(EA_PLATFORM_CYGWIN) && !defined(EA_PLATFORM_ANDROID)
 				const timespec* pTimeSpec = &timeoutAbsolute;
 				result = pthread_mutex_timedlock(&mMutexData.mMutex, const_cast<timespec*>(pTimeSpec)); // Some pthread implementations use non-const timespec, so cast for them.
-
-				if(result != 0)
-				{
-					if(result == ETIMEDOUT)
-						return kResultTimeout;
-					EAT_ASSERT(false);
-					return kResultError;
-				}
 			#else // OSX, BSD
 				// Some Posix systems don't have pthread_mutex_timedlock. In these
 				// cases we fall back to a polling mechanism. However, polling really
@@ -161,15 +152,29 @@
 				// might not work as well as desired.
 				while(((result = pthread_mutex_trylock(&mMutexData.mMutex)) != 0) && (GetThreadTime() < timeoutAbsolute))
 					ThreadSleep(1);
+			#endif
+		}
+
+		if(result != 0)
+		{
+			if((result == EBUSY) || (result == ETIMEDOUT))
+				return kResultTimeout;
 
-				if(result != 0)
+			#if EATHREAD_ROBUST_MUTEX_AVAILABLE
+				if(result == EOWNERDEAD)
 				{
-					if(result == EBUSY)
-						return kResultTimeout;
-					EAT_ASSERT(false);
-					return kResultError;
+					// We have the lock, but the lock count is still the one the dead owner left.
+					mMutexData.mnLockCount = 0;
+					mMutexData.SimulateLock(true);
+					return kResultOwnerDied;
 				}
+
+				if(result == ENOTRECOVERABLE) // A previous owner unlocked without calling MarkConsistent.
+					return kResultError;
 			#endif
+
+			EAT_ASSERT(false);
+			return kResultError;
 		}
 
 		EAT_ASSERT(mMutexData.mThreadId = EA::Thread::GetThreadId()); // Intentionally '=' here and not '=='.
@@ -195,6 +200,18 @@
 	}
 
 
+	bool EA::Thread::Mutex::MarkConsistent()
+	{
+		EAT_ASSERT(mMutexData.mnLockCount > 0);
+
+		#if EATHREAD_ROBUST_MUTEX_AVAILABLE
+			return (pthread_mutex_consistent(&mMutexData.mMutex) == 0);
+		#else
+			return true;
+		#endif
+	}
+
+
 	int EA::Thread::Mutex::GetLockCount() const
 	{
 		return mMutexData.mnLockCount;
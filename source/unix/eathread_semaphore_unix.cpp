@@ -5,6 +5,7 @@
 
 #include <EABase/eabase.h>
 #include <eathread/eathread_semaphore.h>
+#include <eathread/internal/eathread_futexword.h>
 
 
 #if defined(EA_PLATFORM_UNIX) || EA_POSIX_THREADS_AVAILABLE
@@ -25,7 +26,11 @@
 
 
 	EASemaphoreData::EASemaphoreData()
-		: mnCount(0), mnMaxCount(INT_MAX)
+		: mnCount(0),
+		#if EATHREAD_FUTEX_SEMAPHORE_ENABLED
+		  mnWaiterCount(0),
+		#endif
+		  mnMaxCount(INT_MAX), mbIntraProcess(true)
 	{
 		memset(&mSemaphore, 0, sizeof(mSemaphore)); 
 	}
@@ -58,6 +63,11 @@
 
 	EA::Thread::Semaphore::~Semaphore()
 	{
+		#if EATHREAD_FUTEX_SEMAPHORE_ENABLED
+			if(mSemaphoreData.mbIntraProcess) // There is no kernel object to destroy.
+				return;
+		#endif
+
 		#if defined(EA_PLATFORM_ANDROID)
 			sem_destroy(&mSemaphoreData.mSemaphore);   // Android's sem_destroy is broken. http://code.google.com/p/android/issues/detail?id=3106
 		#else
@@ -90,20 +100,18 @@
 
 			mSemaphoreData.mbIntraProcess = pSemaphoreParameters->mbIntraProcess;
 
-			int result = sem_init(&mSemaphoreData.mSemaphore, mSemaphoreData.mbIntraProcess ? 1 : 0, (unsigned)mSemaphoreData.mnCount);
+			#if EATHREAD_FUTEX_SEMAPHORE_ENABLED
+				if(mSemaphoreData.mbIntraProcess)
+					return true;
+			#endif
 
-			// To consider: Remove this fallback and simply return false if the first attempt failed.
-			if((result == -1) && mSemaphoreData.mbIntraProcess)
-			{
-				result = sem_init(&mSemaphoreData.mSemaphore, 0, (unsigned)mSemaphoreData.mnCount);
+			// The second argument is pshared, which is non-zero for a semaphore shared between processes.
+			const int result = sem_init(&mSemaphoreData.mSemaphore, mSemaphoreData.mbIntraProcess ? 0 : 1, (unsigned)mSemaphoreData.mnCount);
 
-				if(result == -1)
-				{
-					EAT_ASSERT(false);
-					memset(&mSemaphoreData.mSemaphore, 0, sizeof(mSemaphoreData.mSemaphore));
-				}
-				else
-					mSemaphoreData.mbIntraProcess = false;
+			if(result == -1)
+			{
+				EAT_ASSERT(false);
+				memset(&mSemaphoreData.mSemaphore, 0, sizeof(mSemaphoreData.mSemaphore));
 			}
 
 			return (result != -1);
@@ -113,8 +121,76 @@
 	}
 
 
+	#if EATHREAD_FUTEX_SEMAPHORE_ENABLED
+		// The count lives in mnCount and waiters block on it directly, so the
+		// kernel is entered only to block while the count is zero.
+		static int FutexSemaphoreWait(EASemaphoreData& data, const EA::Thread::ThreadTime& timeoutAbsolute)
+		{
+			using namespace EA::Thread;
+
+			for(;;)
+			{
+				const int32_t nCount = data.mnCount.GetValue();
+
+				if(nCount > 0)
+				{
+					if(data.mnCount.SetValueConditional(nCount - 1, nCount))
+						return (int)(nCount - 1);
+					continue;
+				}
+
+				if(timeoutAbsolute == kTimeoutImmediate)
+					return Semaphore::kResultTimeout;
+
+				// We register as a waiter before blocking. FutexWordWait blocks only if the count is
+				// still zero, so a Post which doesn't see us in mnWaiterCount will be seen by FutexWordWait.
+				data.mnWaiterCount.Increment();
+				const bool bWoken = FutexWordWait(data.mnCount, 0, timeoutAbsolute);
+				data.mnWaiterCount.Decrement();
+
+				if(!bWoken)
+				{
+					// Timed out. Take a count that may have been posted as the timeout was passing, else give up.
+					for(int32_t n = data.mnCount.GetValue(); n > 0; n = data.mnCount.GetValue())
+					{
+						if(data.mnCount.SetValueConditional(n - 1, n))
+							return (int)(n - 1);
+					}
+
+					return Semaphore::kResultTimeout;
+				}
+			}
+		}
+
+
+		static int FutexSemaphorePost(EASemaphoreData& data, int count)
+		{
+			using namespace EA::Thread;
+
+			int32_t nCount;
+
+			do{
+				nCount = data.mnCount.GetValue();
+
+				if((data.mnMaxCount - count) < nCount) // If count would cause an overflow...
+					return Semaphore::kResultError;
+			} while(!data.mnCount.SetValueConditional(nCount + count, nCount));
+
+			if(data.mnWaiterCount.GetValue() > 0)
+				FutexWordWake(data.mnCount, count);
+
+			return (int)(nCount + count);
+		}
+	#endif
+
+
 	int EA::Thread::Semaphore::Wait(const ThreadTime& timeoutAbsolute)
 	{
+		#if EATHREAD_FUTEX_SEMAPHORE_ENABLED
+			if(mSemaphoreData.mbIntraProcess)
+				return FutexSemaphoreWait(mSemaphoreData, timeoutAbsolute);
+		#endif
+
 		int result;
 
 		if(timeoutAbsolute == kTimeoutNone)
@@ -210,6 +286,11 @@
 
 	int EA::Thread::Semaphore::Post(int count)
 	{
+		#if EATHREAD_FUTEX_SEMAPHORE_ENABLED
+			if(mSemaphoreData.mbIntraProcess)
+				return FutexSemaphorePost(mSemaphoreData, count);
+		#endif
+
 		// Some systems have a sem_post_multiple which we could take advantage 
 		// of here to atomically post multiple times.
 		EAT_ASSERT(mSemaphoreData.mnCount >= 0);
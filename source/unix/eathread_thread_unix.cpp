@@ -8,6 +8,7 @@
 #include <eathread/eathread.h>
 #include <eathread/eathread_callstack.h>
 #include <eathread/eathread_sync.h>
+#include <eathread/internal/eathread_futexword.h>
 #include "eathread/internal/eathread_global.h"
 
 
@@ -241,6 +242,22 @@ namespace
         // affinity when it starts.
     }
 
+    // The thread applies ThreadParameters::mScheduling to itself, rather than it being set in the
+    // creation attributes, so that a thread which lacks the privilege for its policy still starts.
+    static void SetPlatformThreadScheduling(EAThreadDynamicData* pTDD)
+    {
+        #if EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+            EA::Thread::ThreadSchedulingResult result = EA::Thread::kThreadSchedulingResultSuccess;
+
+            if(pTDD->mScheduling.mPolicy != EA::Thread::kThreadSchedulingPolicyDefault)
+                result = EA::Thread::SetThreadScheduling(pTDD->mScheduling);
+
+            pTDD->mnSchedulingResult.SetValue(result);
+        #else
+            EA_UNUSED(pTDD);
+        #endif
+    }
+
 #ifdef EA_PLATFORM_ANDROID
     static JavaVM* gJavaVM = NULL;
     static jclass  gEAThreadClass = NULL;
@@ -404,6 +421,10 @@ EAThreadDynamicData::EAThreadDynamicData()
 {
     memset(mpStartContext, 0, sizeof(mpStartContext));
     memset(mName, 0, sizeof(mName));
+
+    #if EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+        mnSchedulingResult.SetValue(EA::Thread::kThreadSchedulingResultPending);
+    #endif
 }
 
 
@@ -549,6 +570,8 @@ static void* RunnableFunctionInternal(void* pContext)
         pTDD->mThreadPid = 0;
     #endif
 
+    SetPlatformThreadScheduling(pTDD);
+
     // Lock the runtime mutex which is used to allow other threads to wait on this thread with a timeout.
     pTDD->mRunMutex.Lock();         // Important that this be before the semaphore post.
     pTDD->mStartedSemaphore.Post(); // Announce that the thread has started.
@@ -613,6 +636,8 @@ static void* RunnableObjectInternal(void* pContext)
         pTDD->mThreadPid = 0;
     #endif
 
+    SetPlatformThreadScheduling(pTDD);
+
     pTDD->mRunMutex.Lock();         // Important that this be before the semaphore post.
     pTDD->mStartedSemaphore.Post();
 
@@ -650,19 +675,98 @@ static void* RunnableObjectInternal(void* pContext)
 }
 
 
-/// BeginThreadInternal
-/// Extraction of both RunnableFunction and RunnableObject EA::Thread::Begin in order to have thread initialization
-/// in one place
-static EA::Thread::ThreadId BeginThreadInternal(EAThreadData& mThreadData, void* pRunnableOrFunction, void* pContext, const EA::Thread::ThreadParameters* pTP,
-                                                void* pUserWrapper, void* (*InternalThreadFunction)(void*))
+/// ThreadGroupStart
+/// Shared by the threads that Thread::BeginGroup starts. It lives on the stack of
+/// BeginGroup, which doesn't return until every one of the threads is done with it.
+struct ThreadGroupStart
 {
-    using namespace EA::Thread;
+    EA::Thread::AtomicInt32 mnPendingCount; // Threads yet to start, plus one for BeginGroup until it has created them all.
+
+    ThreadGroupStart() : mnPendingCount(1) {}
+};
+
+
+static void* GroupRunnableFunctionInternal(void* pContext)
+{
+    EAThreadDynamicData* const   pTDD        = (EAThreadDynamicData*)pContext;
+    EA::Thread::RunnableFunction pFunction   = (EA::Thread::RunnableFunction)pTDD->mpStartContext[0];
+    void* pCallContext                       = pTDD->mpStartContext[1];
+    ThreadGroupStart* const      pGroupStart = (ThreadGroupStart*)pTDD->mpStartContext[2];
+
+    // Unlike with Begin, BeginGroup leaves all of the setup of the thread to the thread,
+    // so that the threads of a group do it in parallel. This includes setting mThreadId,
+    // which BeginGroup doesn't wait for pthread_create to do.
+    pTDD->mThreadId = pthread_self();
+
+    #if defined(EA_PLATFORM_LINUX) && defined(__NR_gettid)
+        pTDD->mThreadPid = (pid_t)syscall(__NR_gettid);
+
+        if(pTDD->mStartupProcessor != EA::Thread::kProcessorDefault && pTDD->mStartupProcessor != EA::Thread::kProcessorAny)
+            SetPlatformThreadAffinity(pTDD);
+        else if(pTDD->mStartupProcessor == EA::Thread::kProcessorAny)
+            EA::Thread::SetThreadAffinityMask(pTDD->mnThreadAffinityMask);
+    #elif !defined(EA_PLATFORM_CONSOLE) && !defined(EA_PLATFORM_MOBILE)
+        pTDD->mThreadPid = getpid(); // We can't set a thread affinity with a process id. 
+    #else
+        pTDD->mThreadPid = 0;
+    #endif
+
+    SetPlatformThreadScheduling(pTDD);
+
+    // The started semaphore isn't posted, as the thread is running by the time BeginGroup returns.
+    pTDD->mRunMutex.Lock();
+    pTDD->mnStatus = EA::Thread::Thread::kStatusRunning;
+    pTDD->mpStackBase = EA::Thread::GetStackBase();
+
+#ifdef EA_PLATFORM_ANDROID
+    JNIEnv* jni = AttachJavaThread();
+    if(pTDD->mName[0])
+        SetCurrentThreadNameJava(jni, pTDD->mName);
+#elif !EATHREAD_OTHER_THREAD_NAMING_SUPPORTED
+    if(pTDD->mName[0])
+		EA::Thread::SetThreadName(pTDD->mThreadId, pTDD->mName);
+#endif
+
+    // The last thread to start wakes BeginGroup. pGroupStart must not be used after the
+    // decrement, as BeginGroup may then return. The wake may thus be for a word which is
+    // no longer there, which at worst is a spurious wakeup for some other futex user.
+    pTDD->mpStartContext[2] = NULL;
+
+    if(pGroupStart->mnPendingCount.Decrement() == 0)
+    {
+        #if EATHREAD_FUTEX_WORD_AVAILABLE
+            EA::Thread::FutexWordWake(pGroupStart->mnPendingCount, 1);
+        #endif
+    }
+
+    if(pTDD->mpBeginThreadUserWrapper)
+    {
+        EA::Thread::RunnableFunctionUserWrapper pWrapperFunction = (EA::Thread::RunnableFunctionUserWrapper)pTDD->mpBeginThreadUserWrapper;
+        pTDD->mnReturnValue = pWrapperFunction(pFunction, pCallContext);
+    }
+    else
+        pTDD->mnReturnValue = pFunction(pCallContext);
+
+    #ifdef EA_PLATFORM_ANDROID
+        DetachJavaThread();
+    #endif
+
+    void* const pReturnValue = (void*)pTDD->mnReturnValue;
+    pTDD->mnStatus = EA::Thread::Thread::kStatusEnded;
+    pTDD->mRunMutex.Unlock();
+    pTDD->Release();
+
+    return pReturnValue;
+}
 
-    // The parent thread is sharing memory with us and we need to
-    // make sure our view of it is synchronized with the parent.
-    EAReadWriteBarrier();
 
-    // Check there is an entry for the current thread context in our ThreadDynamicData array.
+/// RegisterExternalThread
+/// Makes sure there is an entry for the current thread context in our ThreadDynamicData array,
+/// as there isn't if the thread wasn't created by this library.
+static void RegisterExternalThread()
+{
+    using namespace EA::Thread;
+
     EA::Thread::ThreadId thisThreadId = EA::Thread::GetThreadId();
     if(!FindThreadDynamicData(thisThreadId))
     {
@@ -680,7 +784,23 @@ static EA::Thread::ThreadId BeginThreadInternal(EAThreadData& mThreadData, void*
             pData->mpStackBase = EA::Thread::GetStackBase();
         }
     }
-    
+}
+
+
+/// BeginThreadInternal
+/// Extraction of both RunnableFunction and RunnableObject EA::Thread::Begin in order to have thread initialization
+/// in one place
+static EA::Thread::ThreadId BeginThreadInternal(EAThreadData& mThreadData, void* pRunnableOrFunction, void* pContext, const EA::Thread::ThreadParameters* pTP,
+                                                void* pUserWrapper, void* (*InternalThreadFunction)(void*))
+{
+    using namespace EA::Thread;
+
+    // The parent thread is sharing memory with us and we need to
+    // make sure our view of it is synchronized with the parent.
+    EAReadWriteBarrier();
+
+    RegisterExternalThread();
+
     if(mThreadData.mpData)
         mThreadData.mpData->Release(); // Matches the "AddRef for ourselves" below.
 
@@ -709,6 +829,10 @@ static EA::Thread::ThreadId BeginThreadInternal(EAThreadData& mThreadData, void*
 		if(pTP && pTP->mpName)
 			strncpy(pData->mName, pTP->mpName, EATHREAD_NAME_SIZE);
 		pData->mName[EATHREAD_NAME_SIZE - 1] = 0;
+        #if EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+            pData->mScheduling = pTP ? pTP->mScheduling : ThreadScheduling();
+            pData->mnSchedulingResult.SetValue(kThreadSchedulingResultPending);
+        #endif
         
         // Pass NULL attribute pointer if there are no special setup steps
         pthread_attr_t* pCreationAttribs = NULL;
@@ -796,6 +920,102 @@ EA::Thread::ThreadId EA::Thread::Thread::Begin(IRunnable* pRunnable, void* pCont
 }
 
 
+// Tells eathread_thread.cpp not to define its generic version of BeginGroup.
+#define EATHREAD_THREAD_BEGIN_GROUP_NATIVE 1
+
+size_t EA::Thread::Thread::BeginGroup(Thread* pThreadArray, size_t nThreadCount, RunnableFunction pFunction, void* const* pContextArray, const ThreadParameters* pTP, RunnableFunctionUserWrapper pUserWrapper)
+{
+    EAReadWriteBarrier();
+
+    RegisterExternalThread();
+
+    // The threads share one set of attributes. They can't share a user-supplied stack.
+    ThreadParameters parameters;
+
+    if(pTP)
+    {
+        EAT_ASSERT_MSG(!pTP->mpStack, "Thread::BeginGroup: The threads of a group can't share a stack.");
+        parameters = *pTP;
+        parameters.mpStack = NULL;
+    }
+
+    pthread_attr_t creationAttribs;
+    pthread_attr_init(&creationAttribs);
+	#ifndef EA_PLATFORM_ANDROID
+		pthread_attr_setinheritsched(&creationAttribs, PTHREAD_EXPLICIT_SCHED);
+	#endif
+    SetupThreadAttributes(creationAttribs, pTP ? &parameters : NULL);
+
+    const int        nProcessorCount = GetProcessorCount();
+    ThreadGroupStart groupStart;
+    size_t           nStartedCount = 0;
+
+    for(size_t i = 0; i < nThreadCount; i++)
+    {
+        EAThreadData& threadData = pThreadArray[i].mThreadData;
+
+        if(threadData.mpData)
+            threadData.mpData->Release(); // Matches the "AddRef for ourselves" below.
+
+        EAThreadDynamicData* const pData = new(AllocateThreadDynamicData()) EAThreadDynamicData;
+        threadData.mpData = pData;
+
+        pData->AddRef(); // AddRef for the Thread object.
+        pData->AddRef(); // AddRef for the thread, to be released upon the thread exiting.
+        pData->mpStartContext[0] = reinterpret_cast<void*>((uintptr_t)pFunction);
+        pData->mpStartContext[1] = pContextArray ? pContextArray[i] : NULL;
+        pData->mpStartContext[2] = &groupStart;
+        pData->mpBeginThreadUserWrapper = reinterpret_cast<void*>((uintptr_t)pUserWrapper);
+
+        // A processor number is the first of a range of processors that the threads are spread over.
+        if(pTP && (pTP->mnProcessor >= 0))
+            pData->mStartupProcessor = (int)((pTP->mnProcessor + i) % (size_t)nProcessorCount);
+        else
+            pData->mStartupProcessor = pTP ? pTP->mnProcessor : kProcessorDefault;
+        pData->mnThreadAffinityMask = pTP ? pTP->mnAffinityMask : kThreadAffinityMaskAny;
+
+        if(pTP && pTP->mpName)
+            snprintf(pData->mName, EATHREAD_NAME_SIZE, "%s %u", pTP->mpName, (unsigned)i);
+        #if EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+            if(pTP)
+                pData->mScheduling = pTP->mScheduling;
+        #endif
+
+        groupStart.mnPendingCount.Increment();
+
+        pthread_t threadId;
+        const int result = pthread_create(&threadId, &creationAttribs, GroupRunnableFunctionInternal, pData);
+
+        if(result == 0)
+            nStartedCount++;
+        else
+        {
+            groupStart.mnPendingCount.Decrement();
+            pData->Release(); // Matches AddRef for thread above.
+            pData->Release(); // Matches AddRef for the Thread object above.
+            threadData.mpData = NULL;
+        }
+    }
+
+    pthread_attr_destroy(&creationAttribs);
+
+    // Wait for the threads to start, which costs one wakeup rather than one per thread.
+    int32_t nPendingCount = groupStart.mnPendingCount.Decrement();
+
+    while(nPendingCount != 0)
+    {
+        #if EATHREAD_FUTEX_WORD_AVAILABLE
+            FutexWordWait(groupStart.mnPendingCount, nPendingCount);
+        #else
+            ThreadSleep(1);
+        #endif
+        nPendingCount = groupStart.mnPendingCount.GetValue();
+    }
+
+    return nStartedCount;
+}
+
+
 EA::Thread::Thread::Status EA::Thread::Thread::WaitForEnd(const ThreadTime& timeoutAbsolute, intptr_t* pThreadReturnValue)
 {
     // In order to support timeoutAbsolute, we don't just call pthread_join, as that's an infinitely blocking call.
@@ -967,6 +1187,29 @@ bool EA::Thread::Thread::SetPriority(int nPriority)
 }
 
 
+#if EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+
+    EA::Thread::ThreadSchedulingResult EA::Thread::Thread::SetScheduling(const ThreadScheduling& scheduling)
+    {
+        // mThreadId is invalid if the thread was never started, or once WaitForEnd has joined it.
+        if(mThreadData.mpData && (mThreadData.mpData->mThreadId != kThreadIdInvalid))
+            return SetThreadScheduling(mThreadData.mpData->mThreadId, scheduling);
+
+        return kThreadSchedulingResultInvalid;
+    }
+
+
+    EA::Thread::ThreadSchedulingResult EA::Thread::Thread::GetSchedulingResult() const
+    {
+        if(mThreadData.mpData)
+            return (ThreadSchedulingResult)mThreadData.mpData->mnSchedulingResult.GetValue();
+
+        return kThreadSchedulingResultPending;
+    }
+
+#endif
+
+
 // To consider: Make it so we return a value.
 void EA::Thread::Thread::SetProcessor(int nProcessor)
 {
@@ -35,6 +35,12 @@
 			#include <sys/prctl.h>
 		#endif
 
+		#if EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+			#include <sys/resource.h>
+			#include <sys/syscall.h>
+			#include <errno.h>
+		#endif
+
 		#if defined(EA_PLATFORM_APPLE)
 			#include <dlfcn.h>
 		#endif
@@ -192,6 +198,237 @@
 	}
 
 
+	#if EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+
+		namespace
+		{
+			// SCHED_DEADLINE and struct sched_attr, which older headers don't declare, and which 
+			// newer ones declare in different places. The layout is fixed by the kernel's ABI.
+			const int kSchedDeadline = 6;
+
+			struct LinuxSchedAttr
+			{
+				uint32_t mSize;
+				uint32_t mPolicy;
+				uint64_t mFlags;
+				int32_t  mNice;
+				uint32_t mPriority;
+				uint64_t mRuntime;
+				uint64_t mDeadline;
+				uint64_t mPeriod;
+			};
+
+
+			// Returns the kernel's id for the thread, which SCHED_DEADLINE needs, 
+			// or 0 if the thread isn't known or hasn't started.
+			pid_t GetThreadPid(const EA::Thread::ThreadId& id)
+			{
+				if(pthread_equal(id, pthread_self()))
+					return (pid_t)syscall(SYS_gettid);
+
+				EAThreadDynamicData* const pTDD = EA::Thread::FindThreadDynamicData(id);
+				return pTDD ? pTDD->mThreadPid : 0;
+			}
+
+
+			EA::Thread::ThreadSchedulingResult GetSchedulingResult(int error)
+			{
+				using namespace EA::Thread;
+
+				switch(error)
+				{
+					case 0:
+						return kThreadSchedulingResultSuccess;
+					case EPERM:
+						return kThreadSchedulingResultNotPermitted;
+					case EBUSY:
+						return kThreadSchedulingResultBusy;
+					case ENOSYS:
+					case EOPNOTSUPP:
+						return kThreadSchedulingResultNotSupported;
+					default: // EINVAL, ESRCH
+						return kThreadSchedulingResultInvalid;
+				}
+			}
+
+
+			EA::Thread::ThreadSchedulingPolicy GetSchedulingPolicy(int policy)
+			{
+				using namespace EA::Thread;
+
+				#if defined(SCHED_RESET_ON_FORK)
+					policy &= ~SCHED_RESET_ON_FORK;
+				#endif
+
+				switch(policy)
+				{
+					case SCHED_FIFO:
+						return kThreadSchedulingPolicyFifo;
+					case SCHED_RR:
+						return kThreadSchedulingPolicyRoundRobin;
+					case SCHED_BATCH:
+						return kThreadSchedulingPolicyBatch;
+					case SCHED_IDLE:
+						return kThreadSchedulingPolicyIdle;
+					case kSchedDeadline:
+						return kThreadSchedulingPolicyDeadline;
+					default:
+						return kThreadSchedulingPolicyDefault;
+				}
+			}
+
+		} // namespace
+
+
+		EA::Thread::ThreadSchedulingResult EA::Thread::SetThreadScheduling(const ThreadScheduling& scheduling)
+		{
+			return SetThreadScheduling(pthread_self(), scheduling);
+		}
+
+
+		EA::Thread::ThreadSchedulingResult EA::Thread::SetThreadScheduling(const EA::Thread::ThreadId& id, const ThreadScheduling& scheduling)
+		{
+			if(id == kThreadIdInvalid)
+				return kThreadSchedulingResultInvalid;
+
+			int policy;
+
+			switch(scheduling.mPolicy)
+			{
+				case kThreadSchedulingPolicyDefault:
+					policy = SCHED_OTHER;
+					break;
+				case kThreadSchedulingPolicyFifo:
+					policy = SCHED_FIFO;
+					break;
+				case kThreadSchedulingPolicyRoundRobin:
+					policy = SCHED_RR;
+					break;
+				case kThreadSchedulingPolicyBatch:
+					policy = SCHED_BATCH;
+					break;
+				case kThreadSchedulingPolicyIdle:
+					policy = SCHED_IDLE;
+					break;
+
+				case kThreadSchedulingPolicyDeadline:
+				{
+					// pthreads has no interface for SCHED_DEADLINE; it is set with sched_setattr (Linux 3.14+),
+					// which takes the kernel's id for the thread. Note that this bypasses the pthreads
+					// library's record of the policy, so pthread_getschedparam doesn't report it.
+					#if defined(SYS_sched_setattr)
+						const pid_t threadPid = GetThreadPid(id);
+						if(threadPid == 0)
+							return kThreadSchedulingResultInvalid;
+
+						LinuxSchedAttr attr;
+						memset(&attr, 0, sizeof(attr));
+						attr.mSize     = sizeof(attr);
+						attr.mPolicy   = kSchedDeadline;
+						attr.mRuntime  = scheduling.mnRuntimeNs;
+						attr.mDeadline = scheduling.mnDeadlineNs ? scheduling.mnDeadlineNs : scheduling.mnPeriodNs;
+						attr.mPeriod   = scheduling.mnPeriodNs   ? scheduling.mnPeriodNs   : attr.mDeadline;
+
+						if(syscall(SYS_sched_setattr, threadPid, &attr, 0) == 0)
+							return kThreadSchedulingResultSuccess;
+						return GetSchedulingResult(errno);
+					#else
+						return kThreadSchedulingResultNotSupported;
+					#endif
+				}
+
+				default:
+					return kThreadSchedulingResultInvalid;
+			}
+
+			const bool  bRealTime = (policy == SCHED_FIFO) || (policy == SCHED_RR);
+			sched_param param;
+
+			memset(&param, 0, sizeof(param));
+
+			if(bRealTime)
+			{
+				if((scheduling.mnPriority < sched_get_priority_min(policy)) || (scheduling.mnPriority > sched_get_priority_max(policy)))
+					return kThreadSchedulingResultInvalid;
+				param.sched_priority = scheduling.mnPriority;
+			}
+
+			// We use pthread_setschedparam rather than sched_setscheduler, as the pthreads library 
+			// keeps its own record of the policy, which pthread_getschedparam (and GetPriority) reports.
+			const int result = pthread_setschedparam(id, policy, &param);
+
+			if((result == EPERM) && bRealTime)
+			{
+				// Without CAP_SYS_NICE, a process may use real-time priorities up to its RLIMIT_RTPRIO.
+				rlimit limit;
+
+				if((getrlimit(RLIMIT_RTPRIO, &limit) == 0) && (limit.rlim_cur > 0) && (limit.rlim_cur < (rlim_t)scheduling.mnPriority))
+				{
+					param.sched_priority = (int)limit.rlim_cur;
+
+					if(pthread_setschedparam(id, policy, &param) == 0)
+						return kThreadSchedulingResultPriorityReduced;
+				}
+			}
+
+			return GetSchedulingResult(result);
+		}
+
+
+		bool EA::Thread::GetThreadScheduling(ThreadScheduling& scheduling)
+		{
+			return GetThreadScheduling(pthread_self(), scheduling);
+		}
+
+
+		bool EA::Thread::GetThreadScheduling(const EA::Thread::ThreadId& id, ThreadScheduling& scheduling)
+		{
+			if(id == kThreadIdInvalid)
+				return false;
+
+			scheduling = ThreadScheduling();
+
+			// sched_getattr reports the policy as the kernel has it, including SCHED_DEADLINE.
+			#if defined(SYS_sched_getattr)
+				const pid_t threadPid = GetThreadPid(id);
+
+				if(threadPid)
+				{
+					LinuxSchedAttr attr;
+					memset(&attr, 0, sizeof(attr));
+
+					if(syscall(SYS_sched_getattr, threadPid, &attr, sizeof(attr), 0) == 0)
+					{
+						scheduling.mPolicy   = GetSchedulingPolicy((int)attr.mPolicy);
+						scheduling.mnPriority = (int)attr.mPriority;
+
+						if(scheduling.mPolicy == kThreadSchedulingPolicyDeadline)
+						{
+							scheduling.mnRuntimeNs  = attr.mRuntime;
+							scheduling.mnDeadlineNs = attr.mDeadline;
+							scheduling.mnPeriodNs   = attr.mPeriod;
+						}
+
+						return true;
+					}
+				}
+			#endif
+
+			int         policy;
+			sched_param param;
+
+			if(pthread_getschedparam(id, &policy, &param) != 0)
+				return false;
+
+			scheduling.mPolicy    = GetSchedulingPolicy(policy);
+			scheduling.mnPriority = param.sched_priority;
+
+			return true;
+		}
+
+	#endif // EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+
+
 	void* EA::Thread::GetThreadStackBase()
 	{
 		#if defined(EA_PLATFORM_APPLE)
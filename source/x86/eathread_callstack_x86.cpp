@@ -278,6 +278,14 @@ static _Unwind_Reason_Code UnwindCallback(struct _Unwind_Context* context, void*
 //
 EATHREADLIB_API size_t GetCallstack(void* pReturnAddressArray[], size_t nReturnAddressArrayCapacity, const CallstackContext* pContext)
 {
+	#if EATHREAD_FRAME_POINTER_CALLSTACK_AVAILABLE
+		if(pContext)
+			return ReadFramePointerCallstack(pReturnAddressArray, nReturnAddressArrayCapacity, *pContext, true);
+
+		if(GetCallstackUnwinder() == kCallstackUnwinderFramePointer)
+			return ReadFramePointerCallstack(pReturnAddressArray, nReturnAddressArrayCapacity, __builtin_frame_address(0));
+	#endif
+
 	#if EATHREAD_GLIBC_BACKTRACE_AVAILABLE
 		size_t count = 0;
 
@@ -382,6 +390,8 @@ EATHREADLIB_API size_t GetModuleFromAddress(const void* address, char* pModuleNa
 			if(hModule)
 				return GetModuleFileNameA(hModule, pModuleName, (DWORD)moduleNameCapacity);
 		}
+	#elif EATHREAD_MODULE_MAP_AVAILABLE
+		return GetModuleFromAddressCached(address, pModuleName, moduleNameCapacity);
 	#else
 		// Not currently implemented for the given platform.
 		EA_UNUSED(address);
@@ -403,6 +413,8 @@ EATHREADLIB_API ModuleHandle GetModuleHandleFromAddress(const void* pAddress)
 
 		if(VirtualQuery(pAddress, &mbi, sizeof(mbi)))
 			return (ModuleHandle)mbi.AllocationBase;
+	#elif EATHREAD_MODULE_MAP_AVAILABLE
+		return GetModuleHandleFromAddressCached(pAddress);
 	#else
 		// Not currently implemented for the given platform.
 		EA_UNUSED(pAddress);
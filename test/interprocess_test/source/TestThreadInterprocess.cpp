@@ -139,6 +139,11 @@ int EAMain(int argc, char** argv)
 	TestApplication testSuite("EAThread Interprocess Unit Tests", argc, argv);
 
 	testSuite.AddTest("RWMutex", TestThreadRWMutex);
+	#if EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+		testSuite.AddTest("RWMutexProcesses", TestThreadRWMutexProcesses);
+		testSuite.AddTest("MutexProcesses", TestThreadMutexProcesses);
+		testSuite.AddTest("RingBuffer", TestThreadRingBuffer);
+	#endif
 
 	nErrorCount += testSuite.Run();
 
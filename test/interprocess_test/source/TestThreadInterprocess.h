@@ -12,6 +12,9 @@ extern unsigned int gTestLengthSeconds;
 
 // Individual test functions
 int TestThreadRWMutex();
+int TestThreadRWMutexProcesses();
+int TestThreadMutexProcesses();
+int TestThreadRingBuffer();
 
 
 #endif // Header include guard
@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <EATest/EATest.h>
+#include <eathread/eathread.h>
+#include <eathread/eathread_mutex.h>
+#include <eathread/eathread_condition.h>
+#include <eathread/eathread_semaphore.h>
+#include "TestThreadInterprocess.h"
+#include <stdio.h>
+
+#if EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+	#include <sys/mman.h>
+	#include <sys/wait.h>
+	#include <unistd.h>
+#endif
+
+
+#if EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+
+using namespace EA::Thread;
+
+
+// The memory which the test processes share. The objects in it are built
+// with the factories' Construct functions by the parent process only.
+struct SharedSyncMemory
+{
+	alignas(Mutex)     char mMutexMemory[sizeof(Mutex)];
+	alignas(Mutex)     char mUnrepairedMutexMemory[sizeof(Mutex)];
+	alignas(Condition) char mConditionMemory[sizeof(Condition)];
+	alignas(Semaphore) char mSemaphoreMemory[sizeof(Semaphore)];
+	volatile int            mnValue;
+};
+
+
+static bool WaitForMutexProcess(pid_t pid)
+{
+	int status = 0;
+
+	return (pid > 0) && (waitpid(pid, &status, 0) == pid) && WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+}
+
+
+// Locks the mutex and ends the process without unlocking it.
+static pid_t ForkAndDieHoldingMutex(Mutex* pMutex, SharedSyncMemory* pMemory, int nValue)
+{
+	fflush(stdout);
+	const pid_t pid = fork();
+
+	if(pid == 0)
+	{
+		if(pMutex->Lock() <= 0)
+			_exit(1);
+
+		pMemory->mnValue = -1; // Leave the protected state half-modified.
+		pMemory->mnValue = nValue;
+		_exit(0);
+	}
+
+	return pid;
+}
+
+
+int TestThreadMutexProcesses()
+{
+	int nErrorCount(0);
+
+	EA::UnitTest::Report("Interprocess Mutex test\n");
+
+	void* const pMapping = mmap(NULL, sizeof(SharedSyncMemory), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	EATEST_VERIFY(pMapping != MAP_FAILED);
+
+	if(pMapping == MAP_FAILED)
+		return nErrorCount;
+
+	SharedSyncMemory* const pMemory = static_cast<SharedSyncMemory*>(pMapping);
+	pMemory->mnValue = 0;
+
+	MutexParameters mutexParameters(false);
+	mutexParameters.mbRobust = true;
+
+	ConditionParameters conditionParameters(false);
+	SemaphoreParameters semaphoreParameters(0, false);
+
+	Mutex*     const pMutex            = MutexFactory::ConstructMutex(pMemory->mMutexMemory, &mutexParameters);
+	Mutex*     const pUnrepairedMutex  = MutexFactory::ConstructMutex(pMemory->mUnrepairedMutexMemory, &mutexParameters);
+	Condition* const pCondition        = ConditionFactory::ConstructCondition(pMemory->mConditionMemory, &conditionParameters);
+	Semaphore* const pSemaphore        = SemaphoreFactory::ConstructSemaphore(pMemory->mSemaphoreMemory, &semaphoreParameters);
+
+	{   // Test Semaphore between processes.
+		fflush(stdout);
+		const pid_t pid = fork();
+
+		if(pid == 0)
+			_exit((pSemaphore->Wait(GetThreadTime() + 10000) >= 0) && (pSemaphore->Post() >= 0) ? 0 : 1);
+
+		EATEST_VERIFY(pSemaphore->Post() >= 0);
+		ThreadSleep(50);
+		EATEST_VERIFY(WaitForMutexProcess(pid));
+		EATEST_VERIFY(pSemaphore->Wait(kTimeoutImmediate) == 0); // The child posted back.
+		EATEST_VERIFY(pSemaphore->Wait(kTimeoutImmediate) == Semaphore::kResultTimeout);
+	}
+
+	{   // Test Mutex and Condition between processes.
+		EATEST_VERIFY(pMutex->Lock() == 1);
+
+		fflush(stdout);
+		const pid_t pid = fork();
+
+		if(pid == 0)
+		{
+			// The parent holds the mutex until it waits on the condition.
+			if(pMutex->Lock() != 1)
+				_exit(1);
+			pMemory->mnValue = 1;
+			pCondition->Signal();
+			pMutex->Unlock();
+			_exit(0);
+		}
+
+		const ThreadTime timeoutAbsolute = GetThreadTime() + 10000;
+
+		while((pMemory->mnValue == 0) && (pCondition->Wait(pMutex, timeoutAbsolute) == Condition::kResultOK))
+			{ }
+
+		EATEST_VERIFY(pMemory->mnValue == 1);
+		EATEST_VERIFY(pMutex->GetLockCount() == 1);
+		EATEST_VERIFY(pMutex->Unlock() == 0);
+		EATEST_VERIFY(WaitForMutexProcess(pid));
+	}
+
+	#if EATHREAD_ROBUST_MUTEX_AVAILABLE
+		{   // Test that the death of a process which holds the mutex is reported, and that the state can be repaired.
+			EATEST_VERIFY(WaitForMutexProcess(ForkAndDieHoldingMutex(pMutex, pMemory, 2)));
+
+			EATEST_VERIFY(pMutex->Lock(GetThreadTime() + 10000) == Mutex::kResultOwnerDied);
+			EATEST_VERIFY(pMutex->GetLockCount() == 1);
+			EATEST_VERIFY(pMemory->mnValue == 2);
+			pMemory->mnValue = 0;
+			EATEST_VERIFY(pMutex->MarkConsistent());
+			EATEST_VERIFY(pMutex->Unlock() == 0);
+
+			// The mutex is now usable as before.
+			EATEST_VERIFY(pMutex->Lock(kTimeoutImmediate) == 1);
+			EATEST_VERIFY(pMutex->Unlock() == 0);
+		}
+
+		{   // Test that the death is reported to a waiter on a condition.
+			EATEST_VERIFY(pMutex->Lock() == 1);
+
+			fflush(stdout);
+			const pid_t pid = fork();
+
+			if(pid == 0)
+			{
+				if(pMutex->Lock() != 1)
+					_exit(1);
+				pMemory->mnValue = 3;
+				pCondition->Signal();
+				_exit(0);
+			}
+
+			const ThreadTime timeoutAbsolute = GetThreadTime() + 10000;
+			Condition::Result result;
+
+			while(((result = pCondition->Wait(pMutex, timeoutAbsolute)) == Condition::kResultOK) && (pMemory->mnValue != 3))
+				{ }
+
+			EATEST_VERIFY(result == Condition::kResultOwnerDied);
+			EATEST_VERIFY(pMutex->GetLockCount() == 1);
+			EATEST_VERIFY(pMutex->MarkConsistent());
+			EATEST_VERIFY(pMutex->Unlock() == 0);
+			EATEST_VERIFY(WaitForMutexProcess(pid));
+		}
+
+		{   // Test that a mutex which was unlocked without being repaired can't be locked again.
+			EATEST_VERIFY(WaitForMutexProcess(ForkAndDieHoldingMutex(pUnrepairedMutex, pMemory, 4)));
+
+			EATEST_VERIFY(pUnrepairedMutex->Lock(GetThreadTime() + 10000) == Mutex::kResultOwnerDied);
+			EATEST_VERIFY(pUnrepairedMutex->Unlock() == 0);
+			EATEST_VERIFY(pUnrepairedMutex->Lock() == Mutex::kResultError);
+			EATEST_VERIFY(pUnrepairedMutex->Lock(kTimeoutImmediate) == Mutex::kResultError);
+			EATEST_VERIFY(pUnrepairedMutex->GetLockCount() == 0);
+		}
+	#endif
+
+	SemaphoreFactory::DestructSemaphore(pSemaphore);
+	ConditionFactory::DestructCondition(pCondition);
+	MutexFactory::DestructMutex(pUnrepairedMutex);
+	MutexFactory::DestructMutex(pMutex);
+	munmap(pMapping, sizeof(SharedSyncMemory));
+
+	return nErrorCount;
+}
+
+#endif // EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
@@ -13,6 +13,16 @@
 #include <eathread/eathread_rwmutex_ip.h>
 #include "TestThreadInterprocess.h"
 #include <stdlib.h>
+#include <stdio.h>
+
+#if EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+	#include <sys/mman.h>
+	#include <sys/wait.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <errno.h>
+	#include <string.h>
+#endif
 
 
 struct RWMWorkDataInterProcess
@@ -257,3 +267,231 @@ int TestThreadRWMutex()
 	return nErrorCount;
 }
 
+
+
+#if EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+
+struct RWMWorkDataForked
+{
+	int mnValue;          // Intentionally not atomic; protected by the RWMutexIP.
+	int mnShadowValue;    // Always equal to mnValue outside of the write lock.
+
+	RWMWorkDataForked() : mnValue(0), mnShadowValue(0) { }
+};
+
+static const int kForkedProcessCount   = 4;
+static const int kForkedIterationCount = 2000;
+static const int kForkedWriteInterval  = 4;   // Every fourth iteration takes the write lock.
+
+
+// Runs in each process. Each process opens the mutex and data by name itself, as 
+// an unrelated process would, rather than relying on what it inherited from fork.
+static int RWMutexForkedWork(const char* pMutexName, const char* pDataName)
+{
+	using namespace EA::Thread;
+
+	int nErrorCount = 0;
+
+	RWMutexIPParameters       parameters(false, pMutexName);
+	RWMutexIP                 rwMutexIP(&parameters);
+	Shared<RWMWorkDataForked> sharedData(pDataName);
+
+	for(int i = 0; i < kForkedIterationCount; i++)
+	{
+		if((i % kForkedWriteInterval) == 0)
+		{
+			int nLockResult = rwMutexIP.Lock(RWMutexIP::kLockTypeWrite);
+			EATEST_VERIFY_MSG(nLockResult == 1, "RWMutexIP failure: forked write lock.");
+
+			if(nLockResult == 1)
+			{
+				EATEST_VERIFY(rwMutexIP.GetLockCount(RWMutexIP::kLockTypeRead) == 0);
+
+				sharedData->mnValue++;
+				ThreadSleep(kTimeoutYield); // Give other processes a chance to see the half-done update if the lock doesn't work.
+				sharedData->mnShadowValue++;
+
+				nLockResult = rwMutexIP.Unlock();
+				EATEST_VERIFY_MSG(nLockResult == 0, "RWMutexIP failure: forked write unlock.");
+			}
+		}
+		else
+		{
+			int nLockResult = rwMutexIP.Lock(RWMutexIP::kLockTypeRead);
+			EATEST_VERIFY_MSG(nLockResult >= 1, "RWMutexIP failure: forked read lock.");
+
+			if(nLockResult >= 1)
+			{
+				EATEST_VERIFY(rwMutexIP.GetLockCount(RWMutexIP::kLockTypeWrite) == 0);
+				EATEST_VERIFY_MSG(sharedData->mnValue == sharedData->mnShadowValue, "RWMutexIP failure: forked read saw a partial write.");
+
+				nLockResult = rwMutexIP.Unlock();
+				EATEST_VERIFY_MSG(nLockResult >= 0, "RWMutexIP failure: forked read unlock.");
+			}
+		}
+	}
+
+	return nErrorCount;
+}
+
+
+// Runs in a child process while the parent holds the write lock.
+static int RWMutexForkedTimeout(const char* pMutexName)
+{
+	using namespace EA::Thread;
+
+	int nErrorCount = 0;
+
+	RWMutexIPParameters parameters(false, pMutexName);
+	RWMutexIP           rwMutexIP(&parameters);
+
+	EATEST_VERIFY(rwMutexIP.GetLockCount(RWMutexIP::kLockTypeWrite) == 1);
+	EATEST_VERIFY(rwMutexIP.Lock(RWMutexIP::kLockTypeRead,  kTimeoutImmediate) == RWMutexIP::kResultTimeout);
+	EATEST_VERIFY(rwMutexIP.Lock(RWMutexIP::kLockTypeRead,  GetThreadTime() + 50) == RWMutexIP::kResultTimeout);
+	EATEST_VERIFY(rwMutexIP.Lock(RWMutexIP::kLockTypeWrite, GetThreadTime() + 50) == RWMutexIP::kResultTimeout);
+
+	return nErrorCount;
+}
+
+
+// Exits the process from its constructor when sbExitInConstructor is set, which leaves
+// a shared memory segment behind in the middle of construction.
+struct SharedExitingConstructor
+{
+	static bool sbExitInConstructor;
+
+	int mnValue;
+
+	SharedExitingConstructor() : mnValue(17) { if(sbExitInConstructor) _exit(0); }
+};
+
+bool SharedExitingConstructor::sbExitInConstructor = false;
+
+
+// Returns the number of child processes which failed.
+static int WaitForChildProcesses(const pid_t* pPidArray, int nCount)
+{
+	int nFailureCount = 0;
+
+	for(int i = 0; i < nCount; i++)
+	{
+		int status = 0;
+
+		if((pPidArray[i] <= 0) || (waitpid(pPidArray[i], &status, 0) != pPidArray[i]) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+			nFailureCount++;
+	}
+
+	return nFailureCount;
+}
+
+
+int TestThreadRWMutexProcesses()
+{
+	using namespace EA::Thread;
+
+	int nErrorCount(0);
+
+	EA::UnitTest::Report("RWMutexIP multi-process test\n");
+
+	// Use names of our own, so that segments left behind by a killed run don't interfere.
+	char mutexName[16];
+	char dataName[16];
+	snprintf(mutexName, sizeof(mutexName), "RWMP%d", (int)getpid());
+	snprintf(dataName,  sizeof(dataName),  "RWMD%d", (int)getpid());
+
+	{
+		RWMutexIPParameters       parameters(false, mutexName);
+		RWMutexIP                 rwMutexIP(&parameters);
+		Shared<RWMWorkDataForked> sharedData(dataName);
+
+		EATEST_VERIFY(sharedData.IsNew());
+
+		{   // Test that a second user attaches to the existing data.
+			Shared<RWMWorkDataForked> sharedData2(dataName);
+			EATEST_VERIFY(!sharedData2.IsNew());
+		}
+
+		{   // Test that locks held by one process time out in another.
+			EATEST_VERIFY(rwMutexIP.Lock(RWMutexIP::kLockTypeWrite) == 1);
+
+			fflush(stdout);
+			const pid_t pid = fork();
+
+			if(pid == 0)
+				_exit(RWMutexForkedTimeout(mutexName) ? 1 : 0);
+
+			EATEST_VERIFY_MSG(WaitForChildProcesses(&pid, 1) == 0, "RWMutexIP failure: lock held by another process didn't time out.");
+			EATEST_VERIFY(rwMutexIP.Unlock() == 0);
+		}
+
+		{   // Test readers and writers across processes.
+			pid_t pidArray[kForkedProcessCount];
+
+			fflush(stdout);
+			for(int i = 0; i < kForkedProcessCount; i++)
+			{
+				pidArray[i] = fork();
+
+				if(pidArray[i] == 0)
+					_exit(RWMutexForkedWork(mutexName, dataName) ? 1 : 0); // _exit, so that we don't run the parent's destructors.
+			}
+
+			nErrorCount += RWMutexForkedWork(mutexName, dataName);
+
+			EATEST_VERIFY_MSG(WaitForChildProcesses(pidArray, kForkedProcessCount) == 0, "RWMutexIP failure: child process failed.");
+
+			const int kExpectedValue = (kForkedProcessCount + 1) * (kForkedIterationCount / kForkedWriteInterval);
+			EATEST_VERIFY(sharedData->mnValue       == kExpectedValue);
+			EATEST_VERIFY(sharedData->mnShadowValue == kExpectedValue);
+			EATEST_VERIFY(rwMutexIP.GetLockCount(RWMutexIP::kLockTypeRead)  == 0);
+			EATEST_VERIFY(rwMutexIP.GetLockCount(RWMutexIP::kLockTypeWrite) == 0);
+		}
+	}
+
+	{   // Test that names which would be truncated are rejected.
+		char longName[40];
+
+		memset(longName, 'x', sizeof(longName) - 1);
+		longName[sizeof(longName) - 1] = 0;
+
+		Shared<RWMWorkDataForked> sharedData;
+		EATEST_VERIFY(!sharedData.Init(longName) && (errno == ENAMETOOLONG));
+	}
+
+	{   // Test that a segment whose creator exited during construction is replaced.
+		char abandonedName[16];
+		snprintf(abandonedName, sizeof(abandonedName), "RWMA%d", (int)getpid());
+
+		fflush(stdout);
+		const pid_t pid = fork();
+
+		if(pid == 0)
+		{
+			SharedExitingConstructor::sbExitInConstructor = true;
+			Shared<SharedExitingConstructor> sharedData(abandonedName);
+			_exit(1); // Not reached.
+		}
+
+		EATEST_VERIFY_MSG(WaitForChildProcesses(&pid, 1) == 0, "Shared failure: creator didn't exit in its constructor.");
+
+		const ThreadTime nStartTime = GetThreadTime();
+		Shared<SharedExitingConstructor> sharedData(abandonedName);
+
+		EATEST_VERIFY_MSG(sharedData.IsNew() && (sharedData->mnValue == 17), "Shared failure: abandoned segment wasn't replaced.");
+		EATEST_VERIFY_MSG((GetThreadTime() - nStartTime) < 5000, "Shared failure: waited for an exited creator.");
+	}
+
+	{   // Test that the last user removed the shared memory names.
+		char shmName[20];
+
+		snprintf(shmName, sizeof(shmName), "/%s", dataName);
+		EATEST_VERIFY((shm_open(shmName, O_RDWR, 0) == -1) && (errno == ENOENT));
+
+		snprintf(shmName, sizeof(shmName), "/%s", mutexName);
+		EATEST_VERIFY((shm_open(shmName, O_RDWR, 0) == -1) && (errno == ENOENT));
+	}
+
+	return nErrorCount;
+}
+
+#endif // EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
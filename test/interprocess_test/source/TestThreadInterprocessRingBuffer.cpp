@@ -0,0 +1,350 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <EATest/EATest.h>
+#include <EAStdC/EAStopwatch.h>
+#include <eathread/eathread.h>
+#include <eathread/eathread_ringbuffer_ip.h>
+#include "TestThreadInterprocess.h"
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+	#include <sys/wait.h>
+	#include <unistd.h>
+#endif
+
+
+#if EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
+
+using namespace EA::Thread;
+
+
+typedef RingBufferIP<65536> TestRingBuffer;
+
+struct RingMessageHeader
+{
+	uint32_t mnProducer;
+	uint32_t mnSequence;
+};
+
+static const int      kRingProducerCount   = 3;
+static const uint32_t kRingMessageCount    = 100000;   // Per producer.
+static const uint32_t kRingMaxPayloadSize  = 200;
+static const int      kRingRoundTripCount  = 20000;
+
+
+static uint32_t RingPayloadSize(uint32_t nSequence)
+{
+	return nSequence % kRingMaxPayloadSize;
+}
+
+static uint8_t RingPayloadByte(uint32_t nProducer, uint32_t nSequence, uint32_t i)
+{
+	return (uint8_t)(nProducer + nSequence + i);
+}
+
+
+static int RingProducerProcess(const char* pName, uint32_t nProducer)
+{
+	int nErrorCount = 0;
+
+	TestRingBuffer ring(pName);
+	EATEST_VERIFY(ring.GetCapacity() == 65536);
+
+	for(uint32_t nSequence = 0; nSequence < kRingMessageCount; nSequence++)
+	{
+		const uint32_t nPayloadSize = RingPayloadSize(nSequence);
+		TestRingBuffer::Reservation reservation;
+
+		if(ring.Reserve(reservation, sizeof(RingMessageHeader) + nPayloadSize))
+		{
+			RingMessageHeader* const pMessage = static_cast<RingMessageHeader*>(reservation.mpData);
+			uint8_t* const           pPayload = reinterpret_cast<uint8_t*>(pMessage + 1);
+
+			pMessage->mnProducer = nProducer;
+			pMessage->mnSequence = nSequence;
+			for(uint32_t i = 0; i < nPayloadSize; i++)
+				pPayload[i] = RingPayloadByte(nProducer, nSequence, i);
+
+			ring.Commit(reservation);
+		}
+		else
+			EATEST_VERIFY_MSG(false, "RingBufferIP failure: producer reserve.");
+	}
+
+	return nErrorCount;
+}
+
+
+static int RingEchoProcess(const char* pRequestName, const char* pResponseName)
+{
+	int nErrorCount = 0;
+
+	TestRingBuffer requestRing(pRequestName);
+	TestRingBuffer responseRing(pResponseName);
+
+	for(int i = 0; i < kRingRoundTripCount; i++)
+	{
+		uint32_t    nSize;
+		void* const pRequest = requestRing.Peek(nSize, GetThreadTime() + 10000);
+
+		EATEST_VERIFY_MSG(pRequest != NULL, "RingBufferIP failure: echo peek.");
+		if(!pRequest)
+			break;
+
+		EATEST_VERIFY(responseRing.Write(pRequest, nSize));
+		requestRing.Release();
+	}
+
+	return nErrorCount;
+}
+
+
+// Returns the number of child processes which failed.
+static int WaitForRingProcesses(const pid_t* pPidArray, int nCount)
+{
+	int nFailureCount = 0;
+
+	for(int i = 0; i < nCount; i++)
+	{
+		int status = 0;
+
+		if((pPidArray[i] <= 0) || (waitpid(pPidArray[i], &status, 0) != pPidArray[i]) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+			nFailureCount++;
+	}
+
+	return nFailureCount;
+}
+
+
+int TestThreadRingBuffer()
+{
+	int nErrorCount(0);
+
+	EA::UnitTest::Report("RingBufferIP test\n");
+
+	// Use names of our own, so that segments left behind by a killed run don't interfere.
+	char ringName[16];
+	char responseName[16];
+	snprintf(ringName,     sizeof(ringName),     "RBIP%d", (int)getpid());
+	snprintf(responseName, sizeof(responseName), "RBIR%d", (int)getpid());
+
+	{   // Test basic functionality within this process.
+		RingBufferIP<256> ring(ringName);
+		uint32_t          nSize;
+
+		EATEST_VERIFY(ring.IsNew());
+		EATEST_VERIFY(ring.GetCapacity() == 256);
+		EATEST_VERIFY(ring.GetMaxRecordSize() == 112);
+		EATEST_VERIFY(ring.GetUsedSize() == 0);
+		EATEST_VERIFY(ring.Peek(nSize, kTimeoutImmediate) == NULL);
+		EATEST_VERIFY(ring.Peek(nSize, GetThreadTime() + 20) == NULL);
+
+		// Test that a full ring times out, and that reservations can shrink.
+		RingBufferIP<256>::Reservation reservation;
+
+		EATEST_VERIFY(ring.Reserve(reservation, 112, kTimeoutImmediate));
+		reservation.mnSize = 3;
+		memcpy(reservation.mpData, "abc", 3);
+		ring.Commit(reservation);
+		EATEST_VERIFY(ring.Reserve(reservation, 88, kTimeoutImmediate));
+		ring.Commit(reservation);
+		EATEST_VERIFY(!ring.Reserve(reservation, 88, kTimeoutImmediate));
+		EATEST_VERIFY(!ring.Reserve(reservation, 88, GetThreadTime() + 20));
+
+		const void* const pRecord = ring.Peek(nSize);
+		EATEST_VERIFY((nSize == 3) && (memcmp(pRecord, "abc", 3) == 0));
+		ring.Release();
+		EATEST_VERIFY(ring.Reserve(reservation, 88, kTimeoutImmediate)); // This one goes after padding at the end of the buffer.
+		ring.Commit(reservation);
+
+		for(int i = 0; i < 2; i++)
+		{
+			EATEST_VERIFY((ring.Peek(nSize, kTimeoutImmediate) != NULL) && (nSize == 88));
+			ring.Release();
+		}
+		EATEST_VERIFY(ring.GetUsedSize() == 0);
+
+		// Go around the ring a number of times, with sizes that make records straddle the end.
+		for(uint32_t i = 0; i < 100; i++)
+		{
+			char     buffer[120];
+			uint32_t nWriteSize = (i * 7) % 88;
+
+			memset(buffer, (int)i, sizeof(buffer));
+			EATEST_VERIFY(ring.Write(buffer, nWriteSize, kTimeoutImmediate));
+			EATEST_VERIFY(ring.Write(buffer, 88 - nWriteSize, kTimeoutImmediate));
+
+			for(uint32_t j = 0; j < 2; j++)
+			{
+				const char* const pRecord = static_cast<const char*>(ring.Peek(nSize, kTimeoutImmediate));
+
+				EATEST_VERIFY(pRecord != NULL);
+				if(pRecord)
+				{
+					EATEST_VERIFY(((uintptr_t)pRecord % 8) == 0);
+					EATEST_VERIFY(nSize == (j ? (88 - nWriteSize) : nWriteSize));
+					for(uint32_t k = 0; k < nSize; k++)
+						EATEST_VERIFY(pRecord[k] == (char)i);
+					ring.Release();
+				}
+			}
+
+			EATEST_VERIFY(ring.GetUsedSize() == 0);
+		}
+
+		{   // Test that a second user attaches to the existing ring.
+			RingBufferIP<256> ring2(ringName);
+
+			EATEST_VERIFY(!ring2.IsNew());
+			EATEST_VERIFY(ring2.GetUsedSize() == ring.GetUsedSize());
+		}
+	}
+
+	{   // Test that a reservation whose producer exits without committing it is skipped.
+		RingBufferIP<256> ring(ringName);
+		uint32_t          nSize;
+
+		fflush(stdout);
+		const pid_t pid = fork();
+
+		if(pid == 0)
+		{
+			RingBufferIP<256>::Reservation reservation;
+			_exit(ring.Reserve(reservation, 100, kTimeoutImmediate) ? 0 : 1); // Exit without committing.
+		}
+
+		EATEST_VERIFY_MSG(WaitForRingProcesses(&pid, 1) == 0, "RingBufferIP failure: abandoning process failed.");
+		EATEST_VERIFY(ring.GetUsedSize() != 0);
+
+		// A producer behind the abandoned reservation skips it.
+		EATEST_VERIFY(ring.Write("def", 3, kTimeoutImmediate));
+
+		const void* const pRecord = ring.Peek(nSize, GetThreadTime() + 10000);
+		EATEST_VERIFY((pRecord != NULL) && (nSize == 3) && (memcmp(pRecord, "def", 3) == 0));
+		ring.Release();
+		EATEST_VERIFY(ring.GetUsedSize() == 0);
+
+		// With no producer behind it, the consumer skips it.
+		fflush(stdout);
+		const pid_t pid2 = fork();
+
+		if(pid2 == 0)
+		{
+			RingBufferIP<256>::Reservation reservation;
+			_exit(ring.Reserve(reservation, 100, kTimeoutImmediate) ? 0 : 1); // This one goes after padding at the end of the buffer.
+		}
+
+		EATEST_VERIFY_MSG(WaitForRingProcesses(&pid2, 1) == 0, "RingBufferIP failure: abandoning process failed.");
+		EATEST_VERIFY(ring.Peek(nSize, GetThreadTime() + 500) == NULL);
+		EATEST_VERIFY(ring.GetUsedSize() == 0);
+		EATEST_VERIFY(ring.Write("ghi", 3, kTimeoutImmediate));
+		EATEST_VERIFY((ring.Peek(nSize, kTimeoutImmediate) != NULL) && (nSize == 3));
+		ring.Release();
+	}
+
+	{   // Test many producer processes writing to one consumer.
+		TestRingBuffer ring(ringName);
+		pid_t          pidArray[kRingProducerCount];
+		uint32_t       nextSequence[kRingProducerCount] = {};
+		uint64_t       nByteCount = 0;
+
+		EA::StdC::Stopwatch stopwatch(EA::StdC::Stopwatch::kUnitsMicroseconds, true);
+
+		fflush(stdout);
+		for(int i = 0; i < kRingProducerCount; i++)
+		{
+			pidArray[i] = fork();
+
+			if(pidArray[i] == 0)
+				_exit(RingProducerProcess(ringName, (uint32_t)i) ? 1 : 0); // _exit, so that we don't run the parent's destructors.
+		}
+
+		for(uint32_t n = 0; n < (kRingProducerCount * kRingMessageCount); n++)
+		{
+			uint32_t                       nSize;
+			const RingMessageHeader* const pMessage = static_cast<const RingMessageHeader*>(ring.Peek(nSize, GetThreadTime() + 10000));
+
+			EATEST_VERIFY_MSG(pMessage != NULL, "RingBufferIP failure: consumer peek timed out.");
+			if(!pMessage)
+				break;
+
+			const uint32_t nProducer = pMessage->mnProducer;
+			EATEST_VERIFY(nProducer < kRingProducerCount);
+
+			if(nProducer < kRingProducerCount)
+			{
+				const uint32_t       nSequence = pMessage->mnSequence;
+				const uint8_t* const pPayload  = reinterpret_cast<const uint8_t*>(pMessage + 1);
+
+				// Each producer's records must arrive whole and in order.
+				EATEST_VERIFY(nSequence == nextSequence[nProducer]);
+				EATEST_VERIFY(nSize == (sizeof(RingMessageHeader) + RingPayloadSize(nSequence)));
+				for(uint32_t i = 0; i < RingPayloadSize(nSequence); i++)
+				{
+					if(pPayload[i] != RingPayloadByte(nProducer, nSequence, i))
+					{
+						EATEST_VERIFY_MSG(false, "RingBufferIP failure: corrupt record.");
+						break;
+					}
+				}
+				nextSequence[nProducer] = nSequence + 1;
+			}
+
+			nByteCount += nSize;
+			ring.Release();
+		}
+
+		EATEST_VERIFY_MSG(WaitForRingProcesses(pidArray, kRingProducerCount) == 0, "RingBufferIP failure: producer process failed.");
+		EATEST_VERIFY(ring.GetUsedSize() == 0);
+
+		const uint64_t nElapsedMicroseconds = stopwatch.GetElapsedTime() + 1;
+
+		EA::UnitTest::ReportVerbosity(1, "RingBufferIP throughput: %d producer processes, %" PRIu64 " records/s, %" PRIu64 " MB/s\n",
+									  kRingProducerCount, ((uint64_t)kRingProducerCount * kRingMessageCount * 1000000) / nElapsedMicroseconds, nByteCount / nElapsedMicroseconds);
+	}
+
+	{   // Measure round trip latency between two processes.
+		TestRingBuffer requestRing(ringName);
+		TestRingBuffer responseRing(responseName);
+
+		fflush(stdout);
+		const pid_t pid = fork();
+
+		if(pid == 0)
+			_exit(RingEchoProcess(ringName, responseName) ? 1 : 0);
+
+		EA::StdC::Stopwatch stopwatch(EA::StdC::Stopwatch::kUnitsNanoseconds, true);
+
+		for(int i = 0; i < kRingRoundTripCount; i++)
+		{
+			uint32_t nSize;
+
+			EATEST_VERIFY(requestRing.Write(&i, sizeof(i)));
+
+			const int* const pResponse = static_cast<const int*>(responseRing.Peek(nSize, GetThreadTime() + 10000));
+
+			EATEST_VERIFY_MSG(pResponse != NULL, "RingBufferIP failure: response peek timed out.");
+			if(!pResponse)
+				break;
+
+			EATEST_VERIFY((nSize == sizeof(i)) && (*pResponse == i));
+			responseRing.Release();
+		}
+
+		const uint64_t nElapsedNanoseconds = stopwatch.GetElapsedTime();
+
+		EATEST_VERIFY_MSG(WaitForRingProcesses(&pid, 1) == 0, "RingBufferIP failure: echo process failed.");
+
+		EA::UnitTest::ReportVerbosity(1, "RingBufferIP round trip latency: %" PRIu64 " ns (%d processors)\n",
+									  nElapsedNanoseconds / kRingRoundTripCount, GetProcessorCount());
+	}
+
+	return nErrorCount;
+}
+
+#endif // EATHREAD_POSIX_SHARED_MEMORY_AVAILABLE
@@ -203,16 +203,21 @@ int EAMain(int argc, char** argv)
 	testSuite.AddTest("Atomic",            TestThreadAtomic);
 	testSuite.AddTest("Barrier",           TestThreadBarrier);
 	testSuite.AddTest("Callstack",         TestThreadCallstack);
+	testSuite.AddTest("CallstackTable",    TestThreadCallstackTable);
 	testSuite.AddTest("Condition",         TestThreadCondition);
 	testSuite.AddTest("EnumerateThreads",  TestEnumerateThreads);
 	testSuite.AddTest("Futex",             TestThreadFutex);
+	testSuite.AddTest("MCSSpinLock",       TestThreadMCSSpinLock);
 	testSuite.AddTest("Misc",              TestThreadMisc);
 	testSuite.AddTest("Mutex",             TestThreadMutex);
+	testSuite.AddTest("Profiler",          TestThreadProfiler);
 	testSuite.AddTest("RWMutex",           TestThreadRWMutex);
 	testSuite.AddTest("RWSemaphore",       TestThreadRWSemaLock);
 	testSuite.AddTest("RWSpinLock",        TestThreadRWSpinLock);
 	testSuite.AddTest("Semaphore",         TestThreadSemaphore);
+	testSuite.AddTest("ShardedCounter",    TestThreadShardedCounter);
 	testSuite.AddTest("SmartPtr",          TestThreadSmartPtr);
+	testSuite.AddTest("SpinBarrier",       TestThreadSpinBarrier);
 	testSuite.AddTest("SpinLock",          TestThreadSpinLock);
 	testSuite.AddTest("Storage",           TestThreadStorage);
 	testSuite.AddTest("Sync",              TestThreadSync);
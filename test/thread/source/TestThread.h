@@ -25,16 +25,21 @@ extern bool IsSuperUser();
 int TestThreadSync();
 int TestThreadAtomic();
 int TestThreadCallstack();
+int TestThreadCallstackTable();
 int TestThreadStorage();
 int TestThreadSpinLock();
+int TestThreadMCSSpinLock();
 int TestThreadRWSpinLock();
 int TestThreadFutex();
 int TestThreadMutex();
 int TestThreadRWMutex();
 int TestThreadSemaphore();
+int TestThreadShardedCounter();
+int TestThreadProfiler();
 int TestThreadRWSemaLock();
 int TestThreadCondition();
 int TestThreadBarrier();
+int TestThreadSpinBarrier();
 int TestThreadThread();
 int TestThreadThreadPool();
 int TestThreadSmartPtr();
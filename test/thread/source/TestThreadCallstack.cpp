@@ -16,6 +16,8 @@
 #include <eathread/eathread_thread.h>
 #include <eathread/eathread_sync.h>
 #include <eathread/eathread_semaphore.h>
+#include <string.h>
+#include <inttypes.h>
 
 
 #ifdef EA_PLATFORM_MICROSOFT
@@ -24,6 +26,16 @@ EA_DISABLE_ALL_VC_WARNINGS()
 EA_RESTORE_ALL_VC_WARNINGS()
 #endif
 
+#if EATHREAD_THREAD_CALLSTACK_AVAILABLE
+#include <signal.h>
+#endif
+
+#if EATHREAD_MODULE_MAP_AVAILABLE
+#include <dlfcn.h>
+#include <link.h>
+#include <unistd.h>
+#endif
+
 
 struct CallstackTestInfo
 {
@@ -293,6 +305,442 @@ EA_NO_INLINE EACALLSTACK_TEST_FUNCTION_LINKAGE  int TestRemoteThreadContextVsCal
 	return nErrorCount;
 }
 
+#if EATHREAD_THREAD_CALLSTACK_AVAILABLE
+	struct SignalCallstackTestThread : public EA::Thread::IRunnable
+	{
+		EA::Thread::Thread    mThread;
+		EA::Thread::Semaphore mStartSemaphore;
+		EA::Thread::Semaphore mEndSemaphore;
+		void*                 mpAddress;        // An address within the function which the thread is blocked in.
+		bool                  mbBusy;           // If true then the thread spins instead of blocking.
+		bool                  mbBlockSignal;    // If true then the thread blocks EATHREAD_CALLSTACK_SIGNAL until told to end.
+		volatile bool         mbShouldEnd;
+
+		SignalCallstackTestThread() : mThread(), mStartSemaphore(0), mEndSemaphore(0), mpAddress(NULL), mbBusy(false), mbBlockSignal(false), mbShouldEnd(false) {}
+
+		EA_NO_INLINE void Spin()
+		{
+			EAGetInstructionPointer(mpAddress);
+			mStartSemaphore.Post();
+			while(!mbShouldEnd)
+				{ }
+		}
+
+		EA_NO_INLINE void Wait()
+		{
+			EAGetInstructionPointer(mpAddress);
+			mStartSemaphore.Post();
+			mEndSemaphore.Wait();
+		}
+
+		intptr_t Run(void*)
+		{
+			sigset_t signalSet;
+			sigemptyset(&signalSet);
+			sigaddset(&signalSet, EATHREAD_CALLSTACK_SIGNAL);
+
+			if(mbBlockSignal)
+				pthread_sigmask(SIG_BLOCK, &signalSet, NULL);
+
+			if(mbBusy)
+				Spin();
+			else
+				Wait();
+
+			if(mbBlockSignal)
+				pthread_sigmask(SIG_UNBLOCK, &signalSet, NULL); // The signal that timed out is delivered now, and must be ignored.
+			return 0;
+		}
+
+		void Begin(const char* pName)
+		{
+			EA::Thread::ThreadParameters parameters;
+			parameters.mpName = pName;
+			mThread.Begin(this, NULL, &parameters);
+			mStartSemaphore.Wait();
+		}
+
+		void End()
+		{
+			mbShouldEnd = true;
+			mEndSemaphore.Post();
+			mThread.WaitForEnd();
+		}
+	};
+
+
+	static bool CallstackContainsAddress(void* const* callstack, size_t depth, void* pAddress)
+	{
+		for(size_t i = 0; i < depth; i++)
+		{
+			if(IsRoughlyEqualAddress(callstack[i], pAddress))
+				return true;
+		}
+
+		return false;
+	}
+
+
+	static intptr_t SignalCallstackRequestThreadFunc(void* pContext)
+	{
+		SignalCallstackTestThread* const pTargets = static_cast<SignalCallstackTestThread*>(pContext);
+		intptr_t                         nFailureCount = 0;
+
+		for(int i = 0; i < 200; i++)
+		{
+			SignalCallstackTestThread& target = pTargets[i % 2];
+			void*                      callstack[32];
+			const size_t               depth = EA::Thread::GetCallstack(callstack, EAArrayCount(callstack), target.mThread.GetId(), EA::Thread::GetThreadTime() + 5000);
+
+			if(!CallstackContainsAddress(callstack, depth, target.mpAddress))
+				nFailureCount++;
+		}
+
+		return nFailureCount;
+	}
+
+
+	static int TestSignalCallstack()
+	{
+		using namespace EA::Thread;
+
+		int nErrorCount(0);
+
+		SignalCallstackTestThread targets[3];
+		targets[1].mbBusy = true;
+		targets[0].Begin("CallstackBlocked");
+		targets[1].Begin("CallstackBusy");
+
+		{   // Test reading one thread's callstack at a time, blocked and running.
+			for(int t = 0; t < 2; t++)
+			{
+				void*        callstack[ThreadCallstack::kMaxDepth];
+				const size_t depth = GetCallstack(callstack, EAArrayCount(callstack), targets[t].mThread.GetId(), GetThreadTime() + 5000);
+
+				EATEST_VERIFY(depth > 0);
+				EATEST_VERIFY(CallstackContainsAddress(callstack, depth, targets[t].mpAddress));
+			}
+
+			// Test that the calling thread reads its own callstack directly.
+			void* callstack[8];
+			EATEST_VERIFY(GetCallstack(callstack, EAArrayCount(callstack), GetThreadId(), GetThreadTime() + 5000) > 0);
+		}
+
+		{   // Test many threads requesting callstacks at once, including of the same thread.
+			Thread requesters[4];
+
+			for(int i = 0; i < 4; i++)
+				requesters[i].Begin(SignalCallstackRequestThreadFunc, targets);
+
+			for(int i = 0; i < 4; i++)
+			{
+				intptr_t nFailureCount = -1;
+				requesters[i].WaitForEnd(kTimeoutNone, &nFailureCount);
+				EATEST_VERIFY_F(nFailureCount == 0, "GetCallstack failure: %d concurrent requests failed.", (int)nFailureCount);
+			}
+		}
+
+		{   // Test that a thread which doesn't respond times out, and that its late response is ignored.
+			targets[2].mbBlockSignal = true;
+			targets[2].Begin("CallstackDeaf");
+
+			void*            callstack[16];
+			const ThreadTime timeStart = GetThreadTime();
+
+			EATEST_VERIFY(GetCallstack(callstack, EAArrayCount(callstack), targets[2].mThread.GetId(), timeStart + 50) == 0);
+			EATEST_VERIFY((GetThreadTime() - timeStart) < 5000);
+
+			targets[2].End();
+		}
+
+		{   // Test reading every thread's callstack in one call.
+			ThreadCallstack callstacks[16];
+			const size_t    count = GetThreadCallstacks(callstacks, EAArrayCount(callstacks), GetThreadTime() + 5000);
+			int             nFoundCount = 0;
+
+			EATEST_VERIFY(count >= 2);
+
+			for(size_t i = 0; (i < count) && (i < EAArrayCount(callstacks)); i++)
+			{
+				for(int t = 0; t < 2; t++)
+				{
+					if(callstacks[i].mThreadId == targets[t].mThread.GetId())
+					{
+						nFoundCount++;
+						EATEST_VERIFY(strcmp(callstacks[i].mName, t ? "CallstackBusy" : "CallstackBlocked") == 0);
+						EATEST_VERIFY(CallstackContainsAddress(callstacks[i].mCallstack, callstacks[i].mnDepth, targets[t].mpAddress));
+					}
+				}
+			}
+
+			EATEST_VERIFY(nFoundCount == 2);
+		}
+
+		targets[0].End();
+		targets[1].End();
+
+		return nErrorCount;
+	}
+#endif
+
+
+#if EATHREAD_FRAME_POINTER_CALLSTACK_AVAILABLE
+	struct FramePointerTestInfo
+	{
+		void*         mAddress[3];      // An address within each of the FramePointerCallstack functions, innermost first.
+		void*         mCallstack[32];
+		size_t        mnDepth;
+		bool          mbUseGetCallstack;
+		volatile bool mbReturned;       // Written after each call, so that the calls aren't made as tail calls, which leave no frame.
+	};
+
+	// These use __builtin_frame_address, which makes the compiler give them frame
+	// pointers even when the rest of the test is compiled without them.
+	EA_NO_INLINE static void FramePointerCallstack03(FramePointerTestInfo& info)
+	{
+		void* volatile pFrame = __builtin_frame_address(0);
+		EA_UNUSED(pFrame);
+
+		if(info.mbUseGetCallstack)
+			info.mnDepth = EA::Thread::GetCallstack(info.mCallstack, EAArrayCount(info.mCallstack));
+		else
+			info.mnDepth = EA::Thread::GetCallstackFromFramePointers(info.mCallstack, EAArrayCount(info.mCallstack));
+
+		EAGetInstructionPointer(info.mAddress[0]); // Right after the call, so it's close to the return address even in instrumented builds.
+	}
+
+	EA_NO_INLINE static void FramePointerCallstack02(FramePointerTestInfo& info)
+	{
+		void* volatile pFrame = __builtin_frame_address(0);
+		EA_UNUSED(pFrame);
+		EAGetInstructionPointer(info.mAddress[1]);
+		FramePointerCallstack03(info);
+		info.mbReturned = true;
+	}
+
+	EA_NO_INLINE static void FramePointerCallstack01(FramePointerTestInfo& info)
+	{
+		void* volatile pFrame = __builtin_frame_address(0);
+		EA_UNUSED(pFrame);
+		EAGetInstructionPointer(info.mAddress[2]);
+		FramePointerCallstack02(info);
+		info.mbReturned = true;
+	}
+
+
+	static void SetFramePointerTestContext(EA::Thread::CallstackContext& context, void* pInstruction, void* pFrame)
+	{
+		#if defined(EA_PROCESSOR_X86_64)
+			context.mRIP = (uint64_t)(uintptr_t)pInstruction;
+			context.mRBP = (uint64_t)(uintptr_t)pFrame;
+		#elif defined(EA_PROCESSOR_X86)
+			context.mEIP = (uint32_t)(uintptr_t)pInstruction;
+			context.mEBP = (uint32_t)(uintptr_t)pFrame;
+		#else
+			context.mPC = (uint64_t)(uintptr_t)pInstruction;
+			context.mFP = (uint64_t)(uintptr_t)pFrame;
+		#endif
+	}
+
+
+	static int TestFramePointerCallstack()
+	{
+		using namespace EA::Thread;
+
+		int nErrorCount(0);
+
+		EATEST_VERIFY(GetCallstackUnwinder() == kCallstackUnwinderDefault);
+
+		{   // Test that both GetCallstackFromFramePointers and GetCallstack with the frame pointer unwinder report the calling functions.
+			for(int i = 0; i < 2; i++)
+			{
+				FramePointerTestInfo info = {};
+				info.mbUseGetCallstack = (i == 1);
+
+				SetCallstackUnwinder(info.mbUseGetCallstack ? kCallstackUnwinderFramePointer : kCallstackUnwinderDefault);
+				FramePointerCallstack01(info);
+				SetCallstackUnwinder(kCallstackUnwinderDefault);
+
+				EATEST_VERIFY(info.mnDepth >= 3);
+				for(size_t j = 0; (j < 3) && (j < info.mnDepth); j++)
+					EATEST_VERIFY_F(IsRoughlyEqualAddress(info.mCallstack[j], info.mAddress[j]), "Frame pointer callstack failure: frame %u.", (unsigned)j);
+			}
+		}
+
+		{   // Test that the walk doesn't leave the stack bounds.
+			void*            callstack[8];
+			void*            pInstruction;
+			void* const      pFrame = __builtin_frame_address(0);
+			CallstackContext context;
+
+			EAGetInstructionPointer(pInstruction);
+
+			// A frame pointer outside the stack gives just the instruction.
+			SetFramePointerTestContext(context, pInstruction, (void*)(uintptr_t)0x1000);
+			EATEST_VERIFY(GetCallstackFromFramePointers(callstack, EAArrayCount(callstack), &context) == 1);
+			EATEST_VERIFY(callstack[0] == pInstruction);
+
+			// A stack which ends right after our frame gives the instruction and our return address.
+			SetFramePointerTestContext(context, pInstruction, pFrame);
+			context.mStackLimit = (uintptr_t)pFrame;
+			context.mStackBase  = (uintptr_t)pFrame + (2 * sizeof(void*));
+			EATEST_VERIFY(GetCallstackFromFramePointers(callstack, EAArrayCount(callstack), &context) == 2);
+			EATEST_VERIFY(callstack[1] == __builtin_return_address(0));
+
+			// With our own stack's bounds, GetCallstack with a context walks the frame pointers too.
+			context.mStackLimit = context.mStackBase = 0;
+			EATEST_VERIFY(GetCallstack(callstack, EAArrayCount(callstack), &context) >= 2);
+			EATEST_VERIFY(callstack[1] == __builtin_return_address(0));
+
+			// A depth of 1 gives just the instruction.
+			EATEST_VERIFY(GetCallstackFromFramePointers(callstack, 1, &context) == 1);
+		}
+
+		{   // Compare the frame pointer unwinder with the unwind table reader.
+			// The frame pointer walk ends at the first caller without a frame pointer, such as the
+			// C library's startup code, so both unwinders are limited to the frames it can read.
+			// The capacity is one more than that, as backtrace counts GetCallstack itself against it.
+			// The comparison is reported only if both then read the same frames.
+			const int    kCaptureCount = 20000;
+			void*        callstack[2][32];
+			uint64_t     nElapsed[2];
+			size_t       nDepth[2];
+
+			SetCallstackUnwinder(kCallstackUnwinderFramePointer);
+			const size_t nCapacity = GetCallstack(callstack[1], EAArrayCount(callstack[1]) - 1) + 1;
+
+			for(int i = 0; i < 2; i++)
+			{
+				SetCallstackUnwinder(i ? kCallstackUnwinderFramePointer : kCallstackUnwinderDefault);
+				EA::StdC::Stopwatch stopwatch(EA::StdC::Stopwatch::kUnitsNanoseconds, true);
+
+				for(int j = 0; j < kCaptureCount; j++)
+					nDepth[i] = GetCallstack(callstack[i], nCapacity);
+
+				nElapsed[i] = stopwatch.GetElapsedTime();
+			}
+
+			SetCallstackUnwinder(kCallstackUnwinderDefault);
+
+			if((nDepth[0] == nDepth[1]) && (memcmp(callstack[0], callstack[1], nDepth[0] * sizeof(void*)) == 0))
+				EA::UnitTest::ReportVerbosity(1, "GetCallstack of %u frames: %" PRIu64 " ns with unwind tables, %" PRIu64 " ns with frame pointers\n",
+											  (unsigned)nDepth[0], nElapsed[0] / kCaptureCount, nElapsed[1] / kCaptureCount);
+			else
+				EA::UnitTest::ReportVerbosity(1, "GetCallstack: unwinders read different frames (depth %u with unwind tables, %u with frame pointers), so their times aren't compared. Build with -fno-omit-frame-pointer.\n",
+											  (unsigned)nDepth[0], (unsigned)nDepth[1]);
+		}
+
+		return nErrorCount;
+	}
+#endif
+
+
+#if EATHREAD_MODULE_MAP_AVAILABLE
+	static int TestModuleMap()
+	{
+		using namespace EA::Thread;
+
+		int     nErrorCount = 0;
+		char    executablePath[512];
+		char    moduleName[512];
+		ssize_t nPathLength = readlink("/proc/self/exe", executablePath, sizeof(executablePath) - 1);
+
+		executablePath[(nPathLength > 0) ? nPathLength : 0] = 0;
+
+		EATEST_VERIFY(UpdateModuleMap());
+
+		{   // Test an address in the executable.
+			const size_t nLength = GetModuleFromAddress((void*)&TestModuleMap, moduleName, sizeof(moduleName));
+			EATEST_VERIFY(nLength == strlen(moduleName));
+			EATEST_VERIFY_F(strcmp(moduleName, executablePath) == 0, "GetModuleFromAddress: \"%s\" instead of \"%s\"\n", moduleName, executablePath);
+
+			void* const pExecutable = dlopen(NULL, RTLD_LAZY);
+			EATEST_VERIFY(GetModuleHandleFromAddress((void*)&TestModuleMap) == pExecutable);
+			dlclose(pExecutable);
+
+			// A name which doesn't fit is truncated, and the required length is returned.
+			char shortName[8];
+			EATEST_VERIFY(GetModuleFromAddress((void*)&TestModuleMap, shortName, sizeof(shortName)) == strlen(executablePath));
+			EATEST_VERIFY((strlen(shortName) == (sizeof(shortName) - 1)) && (strncmp(shortName, executablePath, sizeof(shortName) - 1) == 0));
+		}
+
+		{   // Test an address in the C library.
+			void* const pLibC     = dlopen("libc.so.6", RTLD_LAZY | RTLD_NOLOAD);
+			void* const pFunction = pLibC ? dlsym(pLibC, "fopen") : NULL;
+
+			EATEST_VERIFY(pFunction != NULL);
+			if(pFunction)
+			{
+				EATEST_VERIFY(GetModuleFromAddress(pFunction, moduleName, sizeof(moduleName)) > 0);
+				EATEST_VERIFY(strstr(moduleName, "libc") != NULL);
+				EATEST_VERIFY(GetModuleHandleFromAddress(pFunction) == pLibC);
+			}
+
+			if(pLibC)
+				dlclose(pLibC);
+		}
+
+		{   // Test addresses which aren't in any module.
+			int nLocal = 0;
+			EATEST_VERIFY(GetModuleFromAddress(&nLocal, moduleName, sizeof(moduleName)) == 0);
+			EATEST_VERIFY(moduleName[0] == 0);
+			EATEST_VERIFY(GetModuleHandleFromAddress((void*)(uintptr_t)16) == NULL);
+		}
+
+		{   // Test that modules which are loaded and unloaded later are noticed.
+			const char* const libraryNames[] = { "libz.so.1", "libresolv.so.2", "libanl.so.1" };
+
+			for(size_t i = 0; i < EAArrayCount(libraryNames); i++)
+			{
+				if(dlopen(libraryNames[i], RTLD_LAZY | RTLD_NOLOAD)) // If it's already loaded then we can't test with it (and we've added a reference).
+					continue;
+
+				void* const pLibrary = dlopen(libraryNames[i], RTLD_LAZY | RTLD_LOCAL);
+				if(!pLibrary)
+					continue;
+
+				// The module's dynamic section is in one of its loaded segments.
+				void* const pAddress = static_cast<link_map*>(pLibrary)->l_ld;
+
+				EATEST_VERIFY(GetModuleHandleFromAddress(pAddress) == pLibrary);
+				EATEST_VERIFY(GetModuleFromAddress(pAddress, moduleName, sizeof(moduleName)) > 0);
+				EATEST_VERIFY(strstr(moduleName, libraryNames[i]) != NULL);
+
+				dlclose(pLibrary);
+
+				if(!dlopen(libraryNames[i], RTLD_LAZY | RTLD_NOLOAD)) // If it was really unloaded...
+					EATEST_VERIFY(GetModuleHandleFromAddress(pAddress) == NULL);
+				break;
+			}
+		}
+
+		{   // Measure the lookup time, with addresses from a few modules.
+			const int kLookupCount = 1000000;
+			void*     addressArray[16];
+			size_t    nAddressCount = GetCallstack(addressArray, EAArrayCount(addressArray));
+			size_t    nFoundCount   = 0;
+
+			addressArray[nAddressCount++] = (void*)&TestModuleMap;
+
+			EA::StdC::Stopwatch stopwatch(EA::StdC::Stopwatch::kUnitsNanoseconds, true);
+
+			for(int i = 0; i < kLookupCount; i++)
+			{
+				if(GetModuleHandleFromAddress(addressArray[(size_t)i % nAddressCount]))
+					nFoundCount++;
+			}
+
+			const uint64_t nElapsed = stopwatch.GetElapsedTime();
+
+			EATEST_VERIFY(nFoundCount == (size_t)kLookupCount);
+			EA::UnitTest::ReportVerbosity(1, "GetModuleHandleFromAddress: %" PRIu64 " ms for %d lookups\n", nElapsed / 1000000, kLookupCount);
+		}
+
+		return nErrorCount;
+	}
+#endif
+
+
 int TestThreadCallstack()
 {
 	int nErrorCount(0);
@@ -354,6 +802,18 @@ int TestThreadCallstack()
 			EA::Thread::ShutdownCallstack();
 		}
 		#endif
+
+		#if EATHREAD_THREAD_CALLSTACK_AVAILABLE
+			nErrorCount += TestSignalCallstack();
+		#endif
+
+		#if EATHREAD_FRAME_POINTER_CALLSTACK_AVAILABLE
+			nErrorCount += TestFramePointerCallstack();
+		#endif
+	#endif
+
+	#if EATHREAD_MODULE_MAP_AVAILABLE
+		nErrorCount += TestModuleMap();
 	#endif
 
 
@@ -366,8 +826,6 @@ int TestThreadCallstack()
 	// bool GetCallstackContext(CallstackContext& context, intptr_t threadId = 0);
 	// bool GetCallstackContextSysThreadId(CallstackContext& context, intptr_t sysThreadId = 0);
 	// void GetCallstackContext(CallstackContext& context, const Context* pContext = NULL);
-	// size_t GetModuleFromAddress(const void* pAddress, char* pModuleFileName, size_t moduleNameCapacity);
-	// ModuleHandle GetModuleHandleFromAddress(const void* pAddress);
 
 	// EA::Thread::CallstackContext context;
 	// EA::Thread::GetCallstackContext(context, EA::Thread::GetThreadId());
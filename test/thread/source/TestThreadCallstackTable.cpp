@@ -0,0 +1,261 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TestThread.h"
+#include <EATest/EATest.h>
+#include <EAStdC/EAStopwatch.h>
+#include <eathread/eathread.h>
+#include <eathread/eathread_thread.h>
+#include <eathread/eathread_atomic.h>
+#include <eathread/eathread_callstack.h>
+#include <eathread/eathread_callstack_table.h>
+#include <string.h>
+
+
+using namespace EA::Thread;
+
+
+const int kCallstackTableThreadCount    = 8;
+const int kCallstackTableStackCount     = 2000;
+const int kCallstackTableIterationCount = 10;
+
+
+// Makes a distinct, made-up callstack for each n.
+static size_t MakeTestCallstack(void** pCallstack, int n)
+{
+	const size_t nDepth = 1 + (size_t)(n % 12);
+
+	for(size_t i = 0; i < nDepth; i++)
+		pCallstack[i] = (void*)(uintptr_t)(0x10000 + (n * 0x100) + (i * 8));
+
+	return nDepth;
+}
+
+
+struct CallstackTableWorkData
+{
+	CallstackTable mTable;
+	CallstackId    mIdArray[kCallstackTableThreadCount][kCallstackTableStackCount];
+	AtomicInt32    mnReadyCount;
+	AtomicInt32    mShouldBegin;
+
+	CallstackTableWorkData() : mTable(kCallstackTableStackCount * 2), mnReadyCount(0), mShouldBegin(0) {}
+};
+
+
+static CallstackTableWorkData* gpCallstackTableWorkData = NULL;
+
+
+static intptr_t CallstackTableThreadFunction(void* pvThreadIndex)
+{
+	CallstackTableWorkData* const pWorkData    = gpCallstackTableWorkData;
+	const int                     nThreadIndex = (int)(intptr_t)pvThreadIndex;
+	void*                         callstack[16];
+
+	pWorkData->mnReadyCount.Increment();
+	while(!pWorkData->mShouldBegin.GetValue())
+		EA_THREAD_DO_SPIN();
+
+	// Each thread goes through the same callstacks, starting at a different place,
+	// so that some of them race to insert the same new callstack.
+	for(int j = 0; j < kCallstackTableIterationCount; j++)
+	{
+		for(int i = 0; i < kCallstackTableStackCount; i++)
+		{
+			const int n = (i + (nThreadIndex * (kCallstackTableStackCount / kCallstackTableThreadCount))) % kCallstackTableStackCount;
+			const CallstackId id = pWorkData->mTable.Insert(callstack, MakeTestCallstack(callstack, n));
+
+			if(j == 0)
+				pWorkData->mIdArray[nThreadIndex][n] = id;
+			else if(pWorkData->mIdArray[nThreadIndex][n] != id)
+				pWorkData->mIdArray[nThreadIndex][n] = kCallstackIdInvalid;
+		}
+	}
+
+	return 0;
+}
+
+
+static volatile int gnCaptureCount = 0;
+
+// Each call site gets its own callstack. The increment keeps Capture from being a tail call,
+// which would leave these functions out of the callstack.
+EA_NO_INLINE static CallstackId CaptureA(CallstackTable& table) { const CallstackId id = table.Capture(); gnCaptureCount++; return id; }
+EA_NO_INLINE static CallstackId CaptureB(CallstackTable& table) { const CallstackId id = table.Capture(); gnCaptureCount++; return id; }
+
+
+int TestThreadCallstackTable()
+{
+	int nErrorCount(0);
+
+	{ // Insert, Find and GetCallstack.
+		CallstackTable table(1000);
+		void*          callstack[16];
+		void*          callstack2[16];
+
+		EATEST_VERIFY(table.GetMemorySize() > 0);
+		EATEST_VERIFY(table.GetCallstackCount() == 0);
+
+		for(int n = 0; n < 1000; n++)
+		{
+			const size_t      nDepth = MakeTestCallstack(callstack, n);
+			const CallstackId id     = table.Insert(callstack, nDepth);
+
+			EATEST_VERIFY(id == (CallstackId)n);
+			EATEST_VERIFY(table.Insert(callstack, nDepth) == id);
+			EATEST_VERIFY(table.Find(callstack, nDepth) == id);
+		}
+
+		EATEST_VERIFY(table.GetCallstackCount() == 1000);
+
+		for(int n = 0; n < 1000; n++)
+		{
+			const size_t nDepth = MakeTestCallstack(callstack, n);
+			size_t       nResultDepth;
+			void* const* pResult = table.GetCallstack((CallstackId)n, &nResultDepth);
+
+			EATEST_VERIFY((pResult != NULL) && (nResultDepth == nDepth) && (memcmp(pResult, callstack, nDepth * sizeof(void*)) == 0));
+		}
+
+		// A prefix of a callstack, or one which differs only in its last entry, is a different callstack.
+		const size_t nDepth = MakeTestCallstack(callstack, 11);
+		memcpy(callstack2, callstack, sizeof(callstack));
+		callstack2[nDepth - 1] = (void*)1;
+
+		EATEST_VERIFY(table.Find(callstack, nDepth - 1) == kCallstackIdInvalid);
+		EATEST_VERIFY(table.Find(callstack2, nDepth) == kCallstackIdInvalid);
+		EATEST_VERIFY(table.Find(callstack, nDepth) == 11);
+
+		// The table is full.
+		EATEST_VERIFY(table.Insert(callstack2, nDepth) == kCallstackIdInvalid);
+		EATEST_VERIFY(table.Insert(callstack, nDepth) == 11);
+		EATEST_VERIFY(table.GetCallstackCount() == 1000);
+
+		size_t nResultDepth = 1;
+		EATEST_VERIFY(table.GetCallstack(1000, &nResultDepth) == NULL && (nResultDepth == 0));
+		EATEST_VERIFY(table.GetCallstack(kCallstackIdInvalid, NULL) == NULL);
+	}
+
+	{ // The frame arena can run out before the ids do.
+		CallstackTable table(100, 20);
+		void*          callstack[16];
+
+		EATEST_VERIFY(table.Insert(callstack, MakeTestCallstack(callstack, 11)) == 0);  // 12 entries
+		EATEST_VERIFY(table.Insert(callstack, MakeTestCallstack(callstack, 7)) == 1);   // 8 entries
+		EATEST_VERIFY(table.Insert(callstack, MakeTestCallstack(callstack, 0)) == kCallstackIdInvalid);
+		EATEST_VERIFY(table.GetFrameCount() == 20);
+
+		// The failed insert used up id 2, but never published it.
+		size_t nResultDepth = 1;
+		EATEST_VERIFY(table.GetCallstack(2, &nResultDepth) == NULL && (nResultDepth == 0));
+
+		// An empty callstack takes no frames.
+		EATEST_VERIFY(table.Insert(callstack, 0) == 3);
+		EATEST_VERIFY(table.Find(callstack, 0) == 3);
+		EATEST_VERIFY(table.GetCallstack(3, &nResultDepth) != NULL && (nResultDepth == 0));
+	}
+
+	{ // A table of size zero.
+		CallstackTable table(0);
+		void*          callstack[16];
+
+		EATEST_VERIFY(table.Insert(callstack, MakeTestCallstack(callstack, 1)) == kCallstackIdInvalid);
+		EATEST_VERIFY(table.Find(callstack, 2) == kCallstackIdInvalid);
+		EATEST_VERIFY(table.GetCallstack(0, NULL) == NULL);
+	}
+
+	#if EA_THREADS_AVAILABLE
+	{
+		// Threads which insert the same callstacks at the same time all get the same ids.
+		CallstackTableWorkData* const pWorkData = new CallstackTableWorkData;
+		Thread                        threadArray[kCallstackTableThreadCount];
+
+		gpCallstackTableWorkData = pWorkData;
+
+		for(int i = 0; i < kCallstackTableThreadCount; i++)
+			threadArray[i].Begin(CallstackTableThreadFunction, (void*)(intptr_t)i);
+
+		while(pWorkData->mnReadyCount.GetValue() < kCallstackTableThreadCount)
+			ThreadSleep(1);
+		pWorkData->mShouldBegin.SetValue(1);
+
+		for(int i = 0; i < kCallstackTableThreadCount; i++)
+			EATEST_VERIFY_MSG(threadArray[i].WaitForEnd(GetThreadTime() + 60000) == Thread::kStatusEnded, "Thread failure: Thread(s) didn't end.");
+
+		EATEST_VERIFY(pWorkData->mTable.GetCallstackCount() == kCallstackTableStackCount);
+
+		for(int n = 0; n < kCallstackTableStackCount; n++)
+		{
+			void*             callstack[16];
+			const size_t      nDepth = MakeTestCallstack(callstack, n);
+			const CallstackId id     = pWorkData->mIdArray[0][n];
+			size_t            nResultDepth;
+			void* const*      pResult = pWorkData->mTable.GetCallstack(id, &nResultDepth);
+
+			EATEST_VERIFY(id != kCallstackIdInvalid);
+			EATEST_VERIFY((pResult != NULL) && (nResultDepth == nDepth) && (memcmp(pResult, callstack, nDepth * sizeof(void*)) == 0));
+
+			for(int i = 1; i < kCallstackTableThreadCount; i++)
+				EATEST_VERIFY(pWorkData->mIdArray[i][n] == id);
+		}
+
+		gpCallstackTableWorkData = NULL;
+		delete pWorkData;
+	}
+	#endif
+
+	#if EATHREAD_THREAD_CALLSTACK_AVAILABLE
+	{ // Capture
+		CallstackTable table(100);
+		CallstackId    idA[3], idB[3];
+
+		for(int i = 0; i < 3; i++)
+		{
+			idA[i] = CaptureA(table);
+			idB[i] = CaptureB(table);
+		}
+
+		EATEST_VERIFY((idA[0] != kCallstackIdInvalid) && (idB[0] != kCallstackIdInvalid) && (idA[0] != idB[0]));
+		EATEST_VERIFY((idA[1] == idA[0]) && (idA[2] == idA[0]));
+		EATEST_VERIFY((idB[1] == idB[0]) && (idB[2] == idB[0]));
+		EATEST_VERIFY(table.GetCallstackCount() == 2);
+
+		// The callstack starts in the calling function.
+		size_t       nDepth;
+		void* const* pCallstack = table.GetCallstack(idA[0], &nDepth);
+		const uintptr_t nBegin  = (uintptr_t)&CaptureA;
+
+		EATEST_VERIFY((nDepth > 0) && ((uintptr_t)pCallstack[0] >= nBegin) && ((uintptr_t)pCallstack[0] < (nBegin + 1024)));
+	}
+	#endif
+
+	{
+		// Lookups, of which nearly all of a tool's calls will be, with many distinct callstacks in the table.
+		const int      kLookupCount = 1000000;
+		CallstackTable table(65536);
+		void*          callstack[16];
+		size_t         nFoundCount = 0;
+
+		for(int n = 0; n < 50000; n++)
+			table.Insert(callstack, MakeTestCallstack(callstack, n));
+
+		EA::StdC::Stopwatch stopwatch(EA::StdC::Stopwatch::kUnitsNanoseconds, true);
+
+		for(int i = 0; i < kLookupCount; i++)
+		{
+			const size_t nDepth = MakeTestCallstack(callstack, (int)(((unsigned)i * 7919u) % 50000u));
+			nFoundCount += (table.Insert(callstack, nDepth) != kCallstackIdInvalid);
+		}
+
+		stopwatch.Stop();
+
+		EATEST_VERIFY(nFoundCount == (size_t)kLookupCount);
+		EATEST_VERIFY(table.GetCallstackCount() == 50000);
+
+		EA::UnitTest::ReportVerbosity(1, "CallstackTable: %.1f ns per Insert of an existing callstack, %u KB for %u callstacks.\n",
+									  (double)stopwatch.GetElapsedTime() / kLookupCount, (unsigned)(table.GetMemorySize() / 1024), (unsigned)table.GetCallstackCount());
+	}
+
+	return nErrorCount;
+}
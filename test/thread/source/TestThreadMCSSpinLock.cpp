@@ -0,0 +1,225 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TestThread.h"
+#include <EATest/EATest.h>
+#include <EAStdC/EAStopwatch.h>
+#include <eathread/eathread_thread.h>
+#include <eathread/eathread_mcsspinlock.h>
+#include <eathread/eathread_spinlock.h>
+#include <eathread/eathread_futex.h>
+
+
+using namespace EA::Thread;
+
+
+// The contention benchmark goes up to 64 threads, but only on systems with
+// enough processors. Spinlocks of either kind are meaningless when threads
+// outnumber processors, and FIFO hand-off makes MCSSpinLock degrade to one
+// scheduler time slice per hand-off in that case.
+const int kMaxContentionThreadCount = 64;
+const int kContentionLoopCount      = 20000;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ContentionWorkData
+//
+template <typename Lock>
+struct ContentionWorkData
+{
+	Lock          mLock;
+	AtomicInt32   mnStartCount;  // Threads spin until all have started, so that they contend from the beginning.
+	int           mnThreadCount;
+	int           mnLoopCount;
+	volatile int  mnCounter;     // Intentionally not atomic; modified only under mLock.
+
+	ContentionWorkData(int nThreadCount, int nLoopCount) : mLock(), mnStartCount(0), mnThreadCount(nThreadCount), mnLoopCount(nLoopCount), mnCounter(0) {}
+
+private:
+	ContentionWorkData(const ContentionWorkData&);
+	ContentionWorkData& operator=(const ContentionWorkData&);
+};
+
+
+template <typename Lock>
+static intptr_t ContentionThreadFunction(void* pvWorkData)
+{
+	ContentionWorkData<Lock>* const pWorkData = (ContentionWorkData<Lock>*)pvWorkData;
+
+	pWorkData->mnStartCount.Increment();
+	while(pWorkData->mnStartCount.GetValue() < pWorkData->mnThreadCount)
+		EA_THREAD_DO_SPIN();
+
+	for(int i = 0; i < pWorkData->mnLoopCount; i++)
+	{
+		pWorkData->mLock.Lock();
+		pWorkData->mnCounter = pWorkData->mnCounter + 1;
+		pWorkData->mLock.Unlock();
+	}
+
+	return 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RunContention
+//
+// Returns the elapsed time in microseconds.
+//
+template <typename Lock>
+static uint64_t RunContention(int nThreadCount, int nLoopCount, int& nErrorCount)
+{
+	ContentionWorkData<Lock>* const pWorkData = new ContentionWorkData<Lock>(nThreadCount, nLoopCount);
+	Thread                          thread[kMaxContentionThreadCount];
+	EA::StdC::Stopwatch             stopwatch(EA::StdC::Stopwatch::kUnitsMicroseconds);
+
+	stopwatch.Start();
+
+	for(int i = 0; i < nThreadCount; i++)
+		thread[i].Begin(ContentionThreadFunction<Lock>, pWorkData);
+
+	for(int i = 0; i < nThreadCount; i++)
+	{
+		const Thread::Status status = thread[i].WaitForEnd(GetThreadTime() + 60000);
+		EATEST_VERIFY_MSG(status == Thread::kStatusEnded, "Contention test failure: Thread(s) didn't end.");
+	}
+
+	stopwatch.Stop();
+
+	EATEST_VERIFY_MSG(pWorkData->mnCounter == (nThreadCount * nLoopCount), "Contention test failure: lock didn't provide mutual exclusion.");
+
+	delete pWorkData;
+
+	return stopwatch.GetElapsedTime();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TestThreadMCSSpinLockContention
+//
+static int TestThreadMCSSpinLockContention()
+{
+	int       nErrorCount     = 0;
+	const int nProcessorCount = GetProcessorCount();
+
+	EA::UnitTest::ReportVerbosity(1, "\nMCSSpinLock contention test (%d lock/unlock pairs per thread, time in us)...\n", kContentionLoopCount);
+
+	for(int nThreadCount = 2; nThreadCount <= kMaxContentionThreadCount; nThreadCount *= 2)
+	{
+		if(nThreadCount > nProcessorCount)
+		{
+			EA::UnitTest::ReportVerbosity(1, "    %2d threads: skipped, only %d processors.\n", nThreadCount, nProcessorCount);
+			continue;
+		}
+
+		const uint64_t tMCSSpinLock = RunContention<MCSSpinLock>(nThreadCount, kContentionLoopCount, nErrorCount);
+		const uint64_t tSpinLock    = RunContention<SpinLock>(nThreadCount, kContentionLoopCount, nErrorCount);
+		const uint64_t tFutex       = RunContention<Futex>(nThreadCount, kContentionLoopCount, nErrorCount);
+
+		EA::UnitTest::ReportVerbosity(1, "    %2d threads: MCSSpinLock %8" PRIu64 ", SpinLock %8" PRIu64 ", Futex %8" PRIu64 "\n",
+									  nThreadCount, tMCSSpinLock, tSpinLock, tFutex);
+	}
+
+	return nErrorCount;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TestThreadMCSSpinLock
+//
+int TestThreadMCSSpinLock()
+{
+	int nErrorCount(0);
+
+	{ // MCSSpinLock -- Basic single-threaded test.
+
+		MCSSpinLock spinLock;
+
+		EATEST_VERIFY_MSG(!spinLock.IsLocked(), "MCSSpinLock failure");
+
+		spinLock.Lock();
+		EATEST_VERIFY_MSG(spinLock.IsLocked(), "MCSSpinLock failure");
+
+		EATEST_VERIFY_MSG(!spinLock.TryLock(), "MCSSpinLock failure");
+
+		spinLock.Unlock();
+		EATEST_VERIFY_MSG(!spinLock.IsLocked(), "MCSSpinLock failure");
+
+		EATEST_VERIFY_MSG(spinLock.TryLock(), "MCSSpinLock failure");
+		EATEST_VERIFY_MSG(spinLock.IsLocked(), "MCSSpinLock failure");
+
+		spinLock.Unlock();
+		EATEST_VERIFY_MSG(!spinLock.IsLocked(), "MCSSpinLock failure");
+	}
+
+
+	{ // MCSSpinLock -- Caller-supplied nodes.
+
+		MCSSpinLock     spinLock;
+		MCSSpinLockNode node1, node2;
+
+		spinLock.Lock(node1);
+		EATEST_VERIFY_MSG(spinLock.IsLocked(), "MCSSpinLock failure");
+		EATEST_VERIFY_MSG(!spinLock.TryLock(node2), "MCSSpinLock failure");
+
+		spinLock.Unlock(node1);
+		EATEST_VERIFY_MSG(!spinLock.IsLocked(), "MCSSpinLock failure");
+
+		EATEST_VERIFY_MSG(spinLock.TryLock(node2), "MCSSpinLock failure");
+		spinLock.Unlock(node2);
+		EATEST_VERIFY_MSG(!spinLock.IsLocked(), "MCSSpinLock failure");
+	}
+
+
+	{ // MCSSpinLock -- More simultaneously held locks than there are thread-local nodes, released out of order.
+
+		const int   kLockCount = EATHREAD_MCS_SPINLOCK_NODE_COUNT + 2;
+		MCSSpinLock spinLocks[kLockCount];
+
+		for(int i = 0; i < kLockCount; i++)
+			spinLocks[i].Lock();
+
+		for(int i = 0; i < kLockCount; i += 2)
+			spinLocks[i].Unlock();
+
+		for(int i = 1; i < kLockCount; i += 2)
+		{
+			EATEST_VERIFY_MSG(spinLocks[i].IsLocked(), "MCSSpinLock failure");
+			spinLocks[i].Unlock();
+		}
+
+		for(int i = 0; i < kLockCount; i++)
+			EATEST_VERIFY_MSG(!spinLocks[i].IsLocked(), "MCSSpinLock failure");
+	}
+
+
+	{ // AutoMCSSpinLock -- Basic single-threaded test.
+
+		MCSSpinLock spinLock;
+
+		EATEST_VERIFY_MSG(!spinLock.IsLocked(), "AutoMCSSpinLock failure");
+
+		{  //Special scope just for the AutoMCSSpinLock
+			AutoMCSSpinLock autoMCSSpinLock(spinLock);
+
+			EATEST_VERIFY_MSG(spinLock.IsLocked(), "AutoMCSSpinLock failure");
+		}
+
+		EATEST_VERIFY_MSG(!spinLock.IsLocked(), "AutoMCSSpinLock failure");
+	}
+
+
+	#if EA_THREADS_AVAILABLE
+		{  // Multithreaded test
+			// With a single processor every hand-off waits for the next owner to be scheduled, so keep it short.
+			const bool bSingleProcessor = (GetProcessorCount() == 1);
+
+			RunContention<MCSSpinLock>(bSingleProcessor ? 2 : EATHREAD_MAX_CONCURRENT_THREAD_COUNT, bSingleProcessor ? 100 : 1000, nErrorCount);
+		}
+
+		nErrorCount += TestThreadMCSSpinLockContention();
+	#endif
+
+	return nErrorCount;
+}
@@ -4,6 +4,7 @@
 
 #include "TestThread.h"
 #include <EATest/EATest.h>
+#include <EAStdC/EAStopwatch.h>
 #include <eathread/eathread_mutex.h>
 #include <eathread/eathread_thread.h>
 #include <eathread/eathread_atomic.h>
@@ -19,12 +20,13 @@ const int kMaxConcurrentThreadCount = EATHREAD_MAX_CONCURRENT_THREAD_COUNT;
 struct MWorkData
 {
 	volatile bool mbShouldQuit;
+	bool          mbRecursive;
 	Mutex         mMutex;
 	volatile int  mnExpectedValue;
 	volatile int  mnCalculatedValue;
 	AtomicInt32   mnErrorCount;
 
-	MWorkData() : mbShouldQuit(false), mMutex(NULL, true), 
+	MWorkData(const MutexParameters* pMutexParameters = NULL) : mbShouldQuit(false), mbRecursive(!pMutexParameters || pMutexParameters->mbRecursive), mMutex(pMutexParameters, true), 
 				  mnExpectedValue(0), mnCalculatedValue(0), 
 				  mnErrorCount(0) {}
 
@@ -46,7 +48,7 @@ static intptr_t MutexTestThreadFunction(void* pvWorkData)
 
 	while(!pWorkData->mbShouldQuit)
 	{
-		const int nRecursiveLockCount(rand() % 3);
+		const int nRecursiveLockCount(pWorkData->mbRecursive ? (rand() % 3) : (rand() % 2));
 		int i, nLockResult, nLocks = 0;
 
 		for(i = 0; i < nRecursiveLockCount; i++)
@@ -122,6 +124,51 @@ static intptr_t MutexTestThreadFunction(void* pvWorkData)
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+// TestMutexRecursiveSpeed
+//
+// Times uncontended lock/unlock pairs on recursive and non-recursive mutexes.
+//
+static int TestMutexRecursiveSpeed()
+{
+	int nErrorCount(0);
+
+	const int kLoopCount = 1000000;
+
+	MutexParameters mpRecursive;
+	MutexParameters mpNonRecursive;
+	mpNonRecursive.mbRecursive = false;
+
+	Mutex mutexRecursive(&mpRecursive);
+	Mutex mutexNonRecursive(&mpNonRecursive);
+
+	EA::StdC::Stopwatch stopwatch(EA::StdC::Stopwatch::kUnitsMicroseconds);
+
+	stopwatch.Restart();
+	for(int i = 0; i < kLoopCount; i++)
+	{
+		mutexRecursive.Lock();
+		mutexRecursive.Unlock();
+	}
+	const uint64_t tRecursive = stopwatch.GetElapsedTime();
+
+	stopwatch.Restart();
+	for(int i = 0; i < kLoopCount; i++)
+	{
+		mutexNonRecursive.Lock();
+		mutexNonRecursive.Unlock();
+	}
+	const uint64_t tNonRecursive = stopwatch.GetElapsedTime();
+
+	EATEST_VERIFY_MSG(mutexNonRecursive.GetLockCount() == 0, "Mutex failure.");
+
+	EA::UnitTest::ReportVerbosity(1, "\nMutex uncontended speed test (%d lock/unlock pairs): recursive %" PRIu64 " us, non-recursive %" PRIu64 " us\n",
+								  kLoopCount, tRecursive, tNonRecursive);
+
+	return nErrorCount;
+}
+
+
 int TestThreadMutex()
 {
 	int nErrorCount(0);
@@ -182,6 +229,35 @@ int TestThreadMutex()
 		EATEST_VERIFY_MSG(nLockCount ==  0, "Mutex failure.");
 	}
 
+	{ // Non-recursive mutex -- single-threaded tests
+		MutexParameters mp;
+		mp.mbRecursive = false;
+
+		Mutex mutex(&mp);
+
+		EATEST_VERIFY_MSG(mutex.GetLockCount() == 0, "Mutex failure.");
+		EATEST_VERIFY_MSG(mutex.Lock() == 1, "Mutex failure.");
+		EATEST_VERIFY_MSG(mutex.GetLockCount() == 1, "Mutex failure.");
+
+		#if EAT_ASSERT_ENABLED
+			EATEST_VERIFY_MSG(mutex.HasLock(), "Mutex failure.");
+		#endif
+
+		EATEST_VERIFY_MSG(mutex.Unlock() == 0, "Mutex failure.");
+		EATEST_VERIFY_MSG(mutex.Lock(kTimeoutImmediate) == 1, "Mutex failure.");
+		EATEST_VERIFY_MSG(mutex.Unlock() == 0, "Mutex failure.");
+		EATEST_VERIFY_MSG(!mutex.HasLock(), "Mutex failure.");
+
+		{
+			AutoMutex autoMutex(mutex);
+			EATEST_VERIFY_MSG(mutex.GetLockCount() == 1, "Mutex failure.");
+		}
+
+		EATEST_VERIFY_MSG(mutex.GetLockCount() == 0, "Mutex failure.");
+	}
+
+	nErrorCount += TestMutexRecursiveSpeed();
+
 	#ifdef EA_PLATFORM_PS4
 	{
 		// Validate the amount of system resources being consumed by a Sony Mutex without a mutex name.  It appears the
@@ -197,8 +273,12 @@ int TestThreadMutex()
 
 	#if EA_THREADS_AVAILABLE
 
-		{  // Multithreaded test
-			MWorkData workData; 
+		for(int r = 0; r < 2; r++)  // Multithreaded test, with a recursive and then a non-recursive mutex.
+		{
+			MutexParameters mp;
+			mp.mbRecursive = (r == 0);
+
+			MWorkData workData(&mp); 
 
 			const int kThreadCount(kMaxConcurrentThreadCount);
 			Thread thread[kThreadCount];
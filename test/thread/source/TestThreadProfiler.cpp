@@ -0,0 +1,197 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TestThread.h"
+#include <EATest/EATest.h>
+#include <eathread/eathread.h>
+#include <eathread/eathread_thread.h>
+#include <eathread/eathread_atomic.h>
+#include <eathread/eathread_callstack.h>
+#include <eathread/eathread_profiler.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#if EATHREAD_PROFILER_AVAILABLE
+
+using namespace EA::Thread;
+
+
+static AtomicInt32       gnProfilerTestStop(0);
+static volatile uint64_t gnProfilerTestResult = 0;
+
+
+// Uses CPU until told to stop. It isn't inlined, so that we can tell its samples apart.
+EA_NO_INLINE static uint64_t ProfilerBusyLoop()
+{
+	uint64_t n = 1;
+
+	while(gnProfilerTestStop.GetValueRaw() == 0)
+	{
+		for(int i = 0; i < 1000; i++)
+			n = (n * UINT64_C(6364136223846793005)) + 1;
+	}
+
+	return n;
+}
+
+
+static intptr_t ProfilerBusyThreadFunction(void*)
+{
+	gnProfilerTestResult = ProfilerBusyLoop();
+	return 0;
+}
+
+
+struct ProfilerTestCounts
+{
+	uint64_t mnTotal;
+	uint64_t mnInBusyLoop;
+};
+
+
+static void CountProfilerStack(void* const* pCallstack, size_t nDepth, uint64_t nCount, void* pContext)
+{
+	ProfilerTestCounts& counts = *static_cast<ProfilerTestCounts*>(pContext);
+	const uintptr_t     nBegin = (uintptr_t)&ProfilerBusyLoop;
+
+	counts.mnTotal += nCount;
+
+	if(nDepth && ((uintptr_t)pCallstack[0] >= nBegin) && ((uintptr_t)pCallstack[0] < (nBegin + 1024)))
+		counts.mnInBusyLoop += nCount;
+}
+
+
+struct ProfilerTestOutput
+{
+	char   mBuffer[65536];
+	size_t mnLength;
+	bool   mbOverflow;
+};
+
+
+static void WriteProfilerTestOutput(const char* pText, size_t nLength, void* pContext)
+{
+	ProfilerTestOutput& output = *static_cast<ProfilerTestOutput*>(pContext);
+
+	if((output.mnLength + nLength) < sizeof(output.mBuffer))
+	{
+		memcpy(output.mBuffer + output.mnLength, pText, nLength);
+		output.mnLength += nLength;
+		output.mBuffer[output.mnLength] = 0;
+	}
+	else
+		output.mbOverflow = true;
+}
+
+
+static int TestProfilerSampling(const char* pUnwinderName)
+{
+	int nErrorCount = 0;
+
+	gnProfilerTestStop.SetValue(0);
+
+	Thread busyThread;
+	busyThread.Begin(ProfilerBusyThreadFunction);
+
+	ProfilerParameters parameters;
+	parameters.mnSampleIntervalUs = 1000;
+
+	Profiler profiler;
+	EATEST_VERIFY(profiler.Start(&parameters));
+	EATEST_VERIFY(profiler.IsStarted());
+
+	{   // Only one Profiler can sample at a time.
+		Profiler otherProfiler;
+		EATEST_VERIFY(!otherProfiler.Start());
+		EATEST_VERIFY(!profiler.Start());
+	}
+
+	// We stop once the busy thread has been sampled for a while, and don't wait forever if it
+	// doesn't get any CPU time. The busy thread may start after the Profiler, which Collect handles.
+	const ThreadTime timeoutAbsolute = GetThreadTime() + 10000;
+
+	while((profiler.GetStats().mnSampleCount < 200) && (GetThreadTime() < timeoutAbsolute))
+	{
+		ThreadSleep(20);
+		profiler.Collect();
+	}
+
+	gnProfilerTestStop.SetValue(1);
+	busyThread.WaitForEnd();
+	profiler.Stop();
+	EATEST_VERIFY(!profiler.IsStarted());
+
+	const ProfilerStats stats = profiler.GetStats();
+	EATEST_VERIFY(stats.mnSampleCount >= 200);
+	EATEST_VERIFY(stats.mnThreadCount >= 1);
+	EATEST_VERIFY(stats.mnStackCount >= 1);
+
+	ProfilerTestCounts counts = { 0, 0 };
+	profiler.EnumerateStacks(CountProfilerStack, &counts);
+	EATEST_VERIFY(counts.mnTotal == stats.mnSampleCount);
+	EATEST_VERIFY_F(counts.mnInBusyLoop * 2 > counts.mnTotal, "Profiler: %" PRIu64 " of %" PRIu64 " samples are in the busy loop.\n", counts.mnInBusyLoop, counts.mnTotal);
+
+	{   // Each folded stack line ends with its count, and the counts add up to the samples.
+		ProfilerTestOutput* pOutput = new ProfilerTestOutput;
+		pOutput->mnLength   = 0;
+		pOutput->mbOverflow = false;
+		pOutput->mBuffer[0] = 0;
+
+		profiler.WriteFoldedStacks(WriteProfilerTestOutput, pOutput);
+		EATEST_VERIFY(!pOutput->mbOverflow);
+
+		uint64_t nTotal     = 0;
+		size_t   nLineCount = 0;
+
+		for(char* pLine = pOutput->mBuffer; *pLine; nLineCount++)
+		{
+			char* const pLineEnd = strchr(pLine, '\n');
+			EATEST_VERIFY(pLineEnd != NULL);
+			if(!pLineEnd)
+				break;
+
+			*pLineEnd = 0;
+			const char* const pCount = strrchr(pLine, ' ');
+			EATEST_VERIFY((pCount != NULL) && (pCount > pLine));
+			if(pCount)
+				nTotal += strtoull(pCount + 1, NULL, 10);
+
+			pLine = pLineEnd + 1;
+		}
+
+		EATEST_VERIFY(nLineCount == stats.mnStackCount);
+		EATEST_VERIFY(nTotal == stats.mnSampleCount);
+
+		delete pOutput;
+	}
+
+	EA::UnitTest::ReportVerbosity(1, "Profiler (%s): %" PRIu64 " samples, %" PRIu64 " dropped, %" PRIu64 " ns per sample, %.3f%% overhead at %d us\n",
+								  pUnwinderName, stats.mnSampleCount, stats.mnDroppedSampleCount, stats.mnSampleNanoseconds / (stats.mnSampleCount ? stats.mnSampleCount : 1),
+								  (100.0 * (double)stats.mnSampleNanoseconds) / ((double)(stats.mnSampleCount ? stats.mnSampleCount : 1) * parameters.mnSampleIntervalUs * 1000.0),
+								  parameters.mnSampleIntervalUs);
+
+	return nErrorCount;
+}
+
+#endif // EATHREAD_PROFILER_AVAILABLE
+
+
+int TestThreadProfiler()
+{
+	int nErrorCount = 0;
+
+	#if EATHREAD_PROFILER_AVAILABLE
+		nErrorCount += TestProfilerSampling("unwind tables");
+
+		#if EATHREAD_FRAME_POINTER_CALLSTACK_AVAILABLE
+			SetCallstackUnwinder(kCallstackUnwinderFramePointer);
+			nErrorCount += TestProfilerSampling("frame pointers");
+			SetCallstackUnwinder(kCallstackUnwinderDefault);
+		#endif
+	#endif
+
+	return nErrorCount;
+}
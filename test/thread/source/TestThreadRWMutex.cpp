@@ -4,7 +4,9 @@
 
 #include "TestThread.h"
 #include <EATest/EATest.h>
+#include <EAStdC/EAStopwatch.h>
 #include <eathread/eathread_rwmutex.h>
+#include <eathread/eathread_rwspinlock.h>
 #include <eathread/eathread_thread.h>
 #include <stdlib.h>
 
@@ -149,6 +151,189 @@ static intptr_t WriterFunction(void* pvWorkData)
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+// Cache fill benchmark
+//
+// Threads look up keys in a small direct-mapped cache which has fewer slots
+// than there are keys, so misses happen continuously. Without upgrades a miss
+// drops the read lock, takes the write lock and checks the slot again before
+// filling it. With upgrades every lookup takes the upgradeable read lock and
+// upgrades it on a miss. The adapters below give RWMutex and RWSpinLock a
+// common interface for this.
+//
+const int kCacheSlotCount       = 64;
+const int kCacheKeyCount        = 256;
+const int kCacheThreadCount     = 4;
+const int kCacheLookupCount     = 20000;
+
+struct CacheSlot
+{
+	int mnKey;
+	int mnValue;
+};
+
+static int CacheValue(int nKey)
+{
+	return (nKey * 7) + 1;
+}
+
+struct RWMutexCacheLock
+{
+	RWMutex mMutex;
+
+	void ReadLock()            { mMutex.Lock(RWMutex::kLockTypeRead); }
+	void ReadUnlock()          { mMutex.Unlock(); }
+	void WriteLock()           { mMutex.Lock(RWMutex::kLockTypeWrite); }
+	void WriteUnlock()         { mMutex.Unlock(); }
+	void UpgradeableLock()     { mMutex.Lock(RWMutex::kLockTypeUpgradeableRead); }
+	void UpgradeableUnlock()   { mMutex.Unlock(); }
+	void Upgrade()             { mMutex.Upgrade(); }
+};
+
+struct RWSpinLockCacheLock
+{
+	RWSpinLock mSpinLock;
+
+	void ReadLock()            { mSpinLock.ReadLock(); }
+	void ReadUnlock()          { mSpinLock.ReadUnlock(); }
+	void WriteLock()           { mSpinLock.WriteLock(); }
+	void WriteUnlock()         { mSpinLock.WriteUnlock(); }
+	void UpgradeableLock()     { mSpinLock.UpgradeableReadLock(); }
+	void UpgradeableUnlock()   { mSpinLock.UpgradeableReadUnlock(); }
+	void Upgrade()             { mSpinLock.Upgrade(); }
+};
+
+template <typename CacheLock>
+struct CacheWorkData
+{
+	CacheLock    mLock;
+	CacheSlot    mSlots[kCacheSlotCount];
+	bool         mbUseUpgrade;
+	AtomicInt32  mnFillCount;
+	AtomicInt32  mnErrorCount;
+
+	CacheWorkData(bool bUseUpgrade) : mLock(), mbUseUpgrade(bUseUpgrade), mnFillCount(0), mnErrorCount(0)
+	{
+		for(int i = 0; i < kCacheSlotCount; i++)
+		{
+			mSlots[i].mnKey   = -1;
+			mSlots[i].mnValue = 0;
+		}
+	}
+
+private:
+	CacheWorkData(const CacheWorkData&);
+	CacheWorkData& operator=(const CacheWorkData&);
+};
+
+template <typename CacheLock>
+static intptr_t CacheThreadFunction(void* pvWorkData)
+{
+	CacheWorkData<CacheLock>* const pWorkData = (CacheWorkData<CacheLock>*)pvWorkData;
+	uint32_t                        nRandom   = (uint32_t)(uintptr_t)&nRandom; // Differs per thread.
+	int                             nErrorCount = 0;
+
+	for(int i = 0; i < kCacheLookupCount; i++)
+	{
+		nRandom = (nRandom * 1103515245) + 12345;
+
+		const int  nKey  = (int)((nRandom >> 16) % kCacheKeyCount);
+		CacheSlot& slot  = pWorkData->mSlots[nKey % kCacheSlotCount];
+		int        nValue;
+
+		if(pWorkData->mbUseUpgrade)
+		{
+			pWorkData->mLock.UpgradeableLock();
+
+			if(slot.mnKey == nKey)
+			{
+				nValue = slot.mnValue;
+				pWorkData->mLock.UpgradeableUnlock();
+			}
+			else
+			{
+				pWorkData->mLock.Upgrade(); // Nobody can have changed the slot since we looked at it.
+				slot.mnKey   = nKey;
+				slot.mnValue = nValue = CacheValue(nKey);
+				pWorkData->mnFillCount.Increment();
+				pWorkData->mLock.WriteUnlock();
+			}
+		}
+		else
+		{
+			pWorkData->mLock.ReadLock();
+			const bool bHit = (slot.mnKey == nKey);
+			nValue = slot.mnValue;
+			pWorkData->mLock.ReadUnlock();
+
+			if(!bHit)
+			{
+				pWorkData->mLock.WriteLock();
+
+				if(slot.mnKey != nKey) // Another thread may have filled it since we dropped the read lock.
+				{
+					slot.mnKey   = nKey;
+					slot.mnValue = CacheValue(nKey);
+					pWorkData->mnFillCount.Increment();
+				}
+
+				nValue = slot.mnValue;
+				pWorkData->mLock.WriteUnlock();
+			}
+		}
+
+		EATEST_VERIFY_MSG(nValue == CacheValue(nKey), "Cache fill test failure: wrong value read.");
+	}
+
+	pWorkData->mnErrorCount.Add(nErrorCount);
+
+	return 0;
+}
+
+template <typename CacheLock>
+static uint64_t RunCacheFill(bool bUseUpgrade, int nThreadCount, int& nErrorCount)
+{
+	CacheWorkData<CacheLock>* const pWorkData = new CacheWorkData<CacheLock>(bUseUpgrade);
+	Thread                          thread[kCacheThreadCount];
+	EA::StdC::Stopwatch             stopwatch(EA::StdC::Stopwatch::kUnitsMicroseconds);
+
+	stopwatch.Start();
+
+	for(int i = 0; i < nThreadCount; i++)
+		thread[i].Begin(CacheThreadFunction<CacheLock>, pWorkData);
+
+	for(int i = 0; i < nThreadCount; i++)
+		EATEST_VERIFY_MSG(thread[i].WaitForEnd(GetThreadTime() + 60000) == Thread::kStatusEnded, "Cache fill test failure: Thread(s) didn't end.");
+
+	stopwatch.Stop();
+
+	nErrorCount += (int)pWorkData->mnErrorCount.GetValue();
+	delete pWorkData;
+
+	return stopwatch.GetElapsedTime();
+}
+
+static int TestRWMutexCacheFill()
+{
+	int nErrorCount = 0;
+
+	// RWSpinLock waiters spin, so don't use more threads than processors with it.
+	const int nProcessorCount = GetProcessorCount();
+	const int nSpinThreadCount = (nProcessorCount < kCacheThreadCount) ? ((nProcessorCount < 2) ? 2 : nProcessorCount) : kCacheThreadCount;
+
+	const uint64_t tMutexNoUpgrade    = RunCacheFill<RWMutexCacheLock>   (false, kCacheThreadCount, nErrorCount);
+	const uint64_t tMutexUpgrade      = RunCacheFill<RWMutexCacheLock>   (true,  kCacheThreadCount, nErrorCount);
+	const uint64_t tSpinLockNoUpgrade = RunCacheFill<RWSpinLockCacheLock>(false, nSpinThreadCount,  nErrorCount);
+	const uint64_t tSpinLockUpgrade   = RunCacheFill<RWSpinLockCacheLock>(true,  nSpinThreadCount,  nErrorCount);
+
+	EA::UnitTest::ReportVerbosity(1, "\nCache fill test (%d lookups per thread, %d keys, %d slots, time in us):\n", kCacheLookupCount, kCacheKeyCount, kCacheSlotCount);
+	EA::UnitTest::ReportVerbosity(1, "    RWMutex    (%d threads): re-lock and re-check %8" PRIu64 ", upgrade %8" PRIu64 "\n", kCacheThreadCount, tMutexNoUpgrade, tMutexUpgrade);
+	EA::UnitTest::ReportVerbosity(1, "    RWSpinLock (%d threads): re-lock and re-check %8" PRIu64 ", upgrade %8" PRIu64 "\n", nSpinThreadCount, tSpinLockNoUpgrade, tSpinLockUpgrade);
+
+	return nErrorCount;
+}
+
+
 int TestThreadRWMutex()
 {
 	int nErrorCount(0);
@@ -176,6 +361,33 @@ int TestThreadRWMutex()
 		}
 	}
 
+	{ // Upgradeable read locks, Upgrade and Downgrade -- single-threaded test.
+		RWMutex mutex;
+
+		EATEST_VERIFY(mutex.Lock(RWMutex::kLockTypeUpgradeableRead) == 1);
+		EATEST_VERIFY(mutex.GetLockCount(RWMutex::kLockTypeUpgradeableRead) == 1);
+		EATEST_VERIFY(mutex.GetLockCount(RWMutex::kLockTypeRead) == 1);
+
+		EATEST_VERIFY(mutex.Upgrade() == 1);
+		EATEST_VERIFY(mutex.GetLockCount(RWMutex::kLockTypeWrite) == 1);
+		EATEST_VERIFY(mutex.GetLockCount(RWMutex::kLockTypeRead) == 0);
+		EATEST_VERIFY(mutex.GetLockCount(RWMutex::kLockTypeUpgradeableRead) == 0);
+
+		EATEST_VERIFY(mutex.Downgrade() == 1);
+		EATEST_VERIFY(mutex.GetLockCount(RWMutex::kLockTypeWrite) == 0);
+		EATEST_VERIFY(mutex.GetLockCount(RWMutex::kLockTypeRead) == 1);
+		EATEST_VERIFY(mutex.Unlock() == 0);
+
+		{
+			AutoRWMutex autoMutex(mutex, RWMutex::kLockTypeUpgradeableRead);
+			EATEST_VERIFY(autoMutex.Upgrade() == 1);
+			EATEST_VERIFY(mutex.GetLockCount(RWMutex::kLockTypeWrite) == 1);
+		}
+
+		EATEST_VERIFY(mutex.GetLockCount(RWMutex::kLockTypeWrite) == 0);
+		EATEST_VERIFY(mutex.GetLockCount(RWMutex::kLockTypeUpgradeableRead) == 0);
+	}
+
 	#if EA_THREADS_AVAILABLE
 
 		{
@@ -210,6 +422,8 @@ int TestThreadRWMutex()
 			nErrorCount += (int)workData.mnErrorCount;
 		}
 
+		nErrorCount += TestRWMutexCacheFill();
+
 	#endif
 
 	return nErrorCount;
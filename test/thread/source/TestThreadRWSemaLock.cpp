@@ -5,6 +5,7 @@
 
 #include "TestThread.h"
 #include <EATest/EATest.h>
+#include <EAStdC/EAStopwatch.h>
 #include <eathread/eathread_thread.h>
 #include <eathread/eathread_rwsemalock.h>
 #include <stdlib.h>
@@ -32,10 +33,11 @@ enum RWSTestType
 ///////////////////////////////////////////////////////////////////////////////
 // RWSemaWorkData
 //
+template <typename Lock>
 struct RWSemaWorkData
 {
 	volatile bool               mbShouldQuit;
-	EA::Thread::RWSemaLock      mRWSemaLock;
+	Lock                        mRWSemaLock;
 	volatile int                mnWriterCount;
 	EA::Thread::AtomicInt32     mnErrorCount;
 	EA::Thread::AtomicInt32     mnCurrentTestType;
@@ -55,11 +57,12 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 // RWSThreadFunction
 //
+template <typename Lock, typename ReadLockGuard, typename WriteLockGuard>
 static intptr_t RWSThreadFunction(void* pvWorkData)
 {
 	using namespace EA::Thread;
 
-	RWSemaWorkData* const pWorkData = (RWSemaWorkData*)pvWorkData;
+	RWSemaWorkData<Lock>* const pWorkData = (RWSemaWorkData<Lock>*)pvWorkData;
 
 	ThreadId threadId = GetThreadId();
 	EA::UnitTest::ReportVerbosity(1, "RWSemaLock test function created: %s\n", EAThreadThreadIdToString(threadId));
@@ -99,14 +102,14 @@ static intptr_t RWSThreadFunction(void* pvWorkData)
 
 		if(bShouldWrite)
 		{
-			AutoSemaWriteLock _(pWorkData->mRWSemaLock);
+			WriteLockGuard _(pWorkData->mRWSemaLock);
 			pWorkData->mnWriterCount++;
 			EA::UnitTest::ThreadSleepRandom(2, 10);
 			pWorkData->mnWriterCount--;
 		}
 		else
 		{
-			AutoSemaReadLock _(pWorkData->mRWSemaLock);
+			ReadLockGuard _(pWorkData->mRWSemaLock);
 			EATEST_VERIFY_MSG(pWorkData->mnWriterCount == 0, "ReadLock is held, there should be no active WriteLocks.");
 		}
 	}
@@ -144,6 +147,194 @@ struct TestRWSemaLock : public EA::Thread::RWSemaLock
 };
 
 
+struct TestRWSemaLock64 : public EA::Thread::RWSemaLock64
+{
+	TestRWSemaLock64() = default;
+	TestRWSemaLock64(const TestRWSemaLock64&) = delete;
+	TestRWSemaLock64(TestRWSemaLock64&&) = delete;
+	TestRWSemaLock64& operator=(const TestRWSemaLock64&) = delete;
+	TestRWSemaLock64& operator=(TestRWSemaLock64&&) = delete;
+
+	bool IsReadLocked()  { return Readers(mStatus.GetValue()) > 0; }
+	bool IsWriteLocked() { return Writers(mStatus.GetValue()) > 0; }
+
+	#if EATHREAD_FUTEX_WORD_AVAILABLE
+		int32_t GetParkedCount() { return mnReadParkedCount.GetValue() + mnWriteParkedCount.GetValue(); }
+	#endif
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TestRWSemaLockMultithreaded
+//
+template <typename Lock, typename ReadLockGuard, typename WriteLockGuard>
+static int TestRWSemaLockMultithreaded()
+{
+	using namespace EA::Thread;
+
+	int nErrorCount = 0;
+
+	RWSemaWorkData<Lock> workData; 
+
+	Thread         thread[kThreadCount];
+	ThreadId       threadId[kThreadCount];
+	Thread::Status status;
+
+	for(int i(0); i < kThreadCount; i++)
+		threadId[i] = thread[i].Begin(RWSThreadFunction<Lock, ReadLockGuard, WriteLockGuard>, &workData);
+
+	for(int e = 0; e < kRWSTestTypeCount; e++)
+	{
+		workData.mnCurrentTestType.SetValue(e);
+		EA::UnitTest::ThreadSleepRandom(gTestLengthSeconds * 500, gTestLengthSeconds * 500);
+	}
+
+	workData.mbShouldQuit = true;
+	for(int t(0); t < kThreadCount; t++)
+	{
+		if(threadId[t] != kThreadIdInvalid)
+		{
+			status = thread[t].WaitForEnd(GetThreadTime() + 30000);
+			EATEST_VERIFY_MSG(status != Thread::kStatusRunning, "RWSemalock/Thread failure: status == kStatusRunning.\n");
+		}
+	}
+
+	nErrorCount += (int)workData.mnErrorCount;
+
+	return nErrorCount;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TestRWSemaLock64ManyReaders
+//
+// Holds more read locks than RWSemaLock's 10 bit field allows and verifies
+// that a writer blocks until the last of them is released.
+//
+static intptr_t RWSemaLock64WriterFunction(void* pvLock)
+{
+	EA::Thread::RWSemaLock64* const pLock = (EA::Thread::RWSemaLock64*)pvLock;
+
+	pLock->WriteLock();
+	pLock->WriteUnlock();
+
+	return 0;
+}
+
+static int TestRWSemaLock64ManyReaders()
+{
+	using namespace EA::Thread;
+
+	int nErrorCount = 0;
+
+	const int        kReadLockCount = 5000;
+	TestRWSemaLock64 rwSemaLock;
+	Thread           thread;
+
+	for(int i = 0; i < kReadLockCount; i++)
+		rwSemaLock.ReadLock();
+
+	thread.Begin(RWSemaLock64WriterFunction, static_cast<RWSemaLock64*>(&rwSemaLock));
+
+	while(!rwSemaLock.IsWriteLocked()) // Wait for the writer to queue up.
+		ThreadSleep(1);
+	ThreadSleep(20);
+
+	EATEST_VERIFY_MSG(thread.GetStatus() == Thread::kStatusRunning, "RWSemaLock64 failure: writer didn't wait for readers.");
+	EATEST_VERIFY_MSG(!rwSemaLock.ReadTryLock(), "RWSemaLock64 failure: reader got ahead of a waiting writer.");
+
+	for(int i = 0; i < kReadLockCount; i++)
+		rwSemaLock.ReadUnlock();
+
+	EATEST_VERIFY_MSG(thread.WaitForEnd(GetThreadTime() + 30000) == Thread::kStatusEnded, "RWSemaLock64 failure: writer didn't get the lock.");
+
+	#if EATHREAD_FUTEX_WORD_AVAILABLE
+		// The writer parked, and left, so later hand-offs make no wake syscalls.
+		EATEST_VERIFY_MSG(rwSemaLock.GetParkedCount() == 0, "RWSemaLock64 failure: parked count wasn't restored.");
+	#endif
+
+	EATEST_VERIFY_MSG(rwSemaLock.WriteTryLock(), "RWSemaLock64 failure");
+	rwSemaLock.WriteUnlock();
+
+	return nErrorCount;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TestRWSemaLockWriterChurn
+//
+// Measures lock hand-off cost with several threads doing nothing but taking
+// and releasing the write lock, so that nearly every unlock wakes a waiter.
+//
+const int kWriterChurnThreadCount = 4;
+const int kWriterChurnLoopCount   = 20000;
+
+template <typename Lock>
+struct WriterChurnWorkData
+{
+	Lock         mLock;
+	volatile int mnCounter; // Modified only under the write lock.
+
+	WriterChurnWorkData() : mLock(), mnCounter(0) {}
+};
+
+template <typename Lock>
+static intptr_t WriterChurnThreadFunction(void* pvWorkData)
+{
+	WriterChurnWorkData<Lock>* const pWorkData = (WriterChurnWorkData<Lock>*)pvWorkData;
+
+	for(int i = 0; i < kWriterChurnLoopCount; i++)
+	{
+		pWorkData->mLock.WriteLock();
+		pWorkData->mnCounter = pWorkData->mnCounter + 1;
+		pWorkData->mLock.WriteUnlock();
+	}
+
+	return 0;
+}
+
+template <typename Lock>
+static uint64_t RunWriterChurn(int& nErrorCount)
+{
+	using namespace EA::Thread;
+
+	WriterChurnWorkData<Lock>* const pWorkData = new WriterChurnWorkData<Lock>;
+	Thread                           thread[kWriterChurnThreadCount];
+	EA::StdC::Stopwatch              stopwatch(EA::StdC::Stopwatch::kUnitsMicroseconds);
+
+	stopwatch.Start();
+
+	for(int i = 0; i < kWriterChurnThreadCount; i++)
+		thread[i].Begin(WriterChurnThreadFunction<Lock>, pWorkData);
+
+	for(int i = 0; i < kWriterChurnThreadCount; i++)
+		EATEST_VERIFY_MSG(thread[i].WaitForEnd(GetThreadTime() + 60000) == Thread::kStatusEnded, "Writer churn test failure: Thread(s) didn't end.");
+
+	stopwatch.Stop();
+
+	EATEST_VERIFY_MSG(pWorkData->mnCounter == (kWriterChurnThreadCount * kWriterChurnLoopCount), "Writer churn test failure: lock didn't provide mutual exclusion.");
+
+	delete pWorkData;
+
+	return stopwatch.GetElapsedTime();
+}
+
+static int TestRWSemaLockWriterChurn()
+{
+	using namespace EA::Thread;
+
+	int nErrorCount = 0;
+
+	const uint64_t tRWSemaLock   = RunWriterChurn<RWSemaLock>(nErrorCount);
+	const uint64_t tRWSemaLock64 = RunWriterChurn<RWSemaLock64>(nErrorCount);
+
+	EA::UnitTest::ReportVerbosity(1, "\nRWSemaLock writer churn (%d threads, %d write locks each): RWSemaLock %" PRIu64 " us (%u bytes), RWSemaLock64 %" PRIu64 " us (%u bytes)\n",
+								  kWriterChurnThreadCount, kWriterChurnLoopCount, tRWSemaLock, (unsigned)sizeof(RWSemaLock), tRWSemaLock64, (unsigned)sizeof(RWSemaLock64));
+
+	return nErrorCount;
+}
+
+
 int TestThreadRWSemaLock()
 {
 	using namespace EA::Thread;
@@ -211,38 +402,55 @@ int TestThreadRWSemaLock()
 	}
 
 
-	#if EA_THREADS_AVAILABLE
+	{ // RWSemaLock64 -- Basic single-threaded test.
+
+		TestRWSemaLock64 rwSemaLock;
+
+		EATEST_VERIFY_MSG(!rwSemaLock.IsReadLocked(),  "RWSemaLock64 failure");
+		EATEST_VERIFY_MSG(!rwSemaLock.IsWriteLocked(), "RWSemaLock64 failure");
+
+		{
+			AutoSemaReadLock64 autoRWSemaLock1(rwSemaLock);
+			AutoSemaReadLock64 autoRWSemaLock2(rwSemaLock);
 
-		{  // Multithreaded test
-			  
-			RWSemaWorkData workData; 
-
-			Thread         thread[kThreadCount];
-			ThreadId       threadId[kThreadCount];
-			Thread::Status status;
-
-			for(int i(0); i < kThreadCount; i++)
-				threadId[i] = thread[i].Begin(RWSThreadFunction, &workData);
-
-			for(int e = 0; e < kRWSTestTypeCount; e++)
-			{
-				workData.mnCurrentTestType.SetValue(e);
-				EA::UnitTest::ThreadSleepRandom(gTestLengthSeconds * 500, gTestLengthSeconds * 500);
-			}
-
-			workData.mbShouldQuit = true;
-			for(int t(0); t < kThreadCount; t++)
-			{
-				if(threadId[t] != kThreadIdInvalid)
-				{
-					status = thread[t].WaitForEnd(GetThreadTime() + 30000);
-					EATEST_VERIFY_MSG(status != Thread::kStatusRunning, "RWSemalock/Thread failure: status == kStatusRunning.\n");
-				}
-			}
-
-			nErrorCount += (int)workData.mnErrorCount;
+			EATEST_VERIFY_MSG(rwSemaLock.IsReadLocked(),   "RWSemaLock64 failure");
+			EATEST_VERIFY_MSG(!rwSemaLock.WriteTryLock(),  "RWSemaLock64 failure");
+			EATEST_VERIFY_MSG(!rwSemaLock.IsWriteLocked(), "RWSemaLock64 failure");
 		}
 
+		EATEST_VERIFY_MSG(!rwSemaLock.IsReadLocked(), "RWSemaLock64 failure");
+
+		{
+			AutoSemaWriteLock64 autoRWSemaLock(rwSemaLock);
+
+			EATEST_VERIFY_MSG(rwSemaLock.IsWriteLocked(), "RWSemaLock64 failure");
+			EATEST_VERIFY_MSG(!rwSemaLock.ReadTryLock(),  "RWSemaLock64 failure");
+			EATEST_VERIFY_MSG(!rwSemaLock.WriteTryLock(), "RWSemaLock64 failure");
+		}
+
+		EATEST_VERIFY_MSG(!rwSemaLock.IsReadLocked(),  "RWSemaLock64 failure");
+		EATEST_VERIFY_MSG(!rwSemaLock.IsWriteLocked(), "RWSemaLock64 failure");
+
+		// Beyond RWSemaLock's 1023 reader limit.
+		for(int i = 0; i < 4000; i++)
+			EATEST_VERIFY_MSG(rwSemaLock.ReadTryLock(), "RWSemaLock64 failure");
+		EATEST_VERIFY_MSG(rwSemaLock.IsReadLocked(),  "RWSemaLock64 failure");
+		EATEST_VERIFY_MSG(!rwSemaLock.WriteTryLock(), "RWSemaLock64 failure");
+		for(int i = 0; i < 4000; i++)
+			rwSemaLock.ReadUnlock();
+		EATEST_VERIFY_MSG(!rwSemaLock.IsReadLocked(), "RWSemaLock64 failure");
+	}
+
+
+	#if EA_THREADS_AVAILABLE
+
+		nErrorCount += TestRWSemaLockMultithreaded<RWSemaLock, AutoSemaReadLock, AutoSemaWriteLock>();
+		nErrorCount += TestRWSemaLockMultithreaded<RWSemaLock64, AutoSemaReadLock64, AutoSemaWriteLock64>();
+
+		nErrorCount += TestRWSemaLock64ManyReaders();
+
+		nErrorCount += TestRWSemaLockWriterChurn();
+
 	#endif
 
 	return nErrorCount;
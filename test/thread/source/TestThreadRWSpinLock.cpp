@@ -357,70 +357,131 @@ static intptr_t RWSThreadFunction(void* pvWorkData)
 
 
 
-int TestThreadRWSpinLock()
+///////////////////////////////////////////////////////////////////////////////
+// TestRWSpinLockBasic
+//
+// Basic single-threaded tests, for RWSpinLock and for RWSpinLockT with other
+// backoff policies.
+//
+template <typename RWSpinLockType, typename AutoRWSpinLockType>
+static int TestRWSpinLockBasic(const char* pName)
 {
-	using namespace EA::Thread;
-
 	int nErrorCount = 0;
 
-	{ // RWSpinLock -- Basic single-threaded test.
+	{ // Basic single-threaded test.
 
-		RWSpinLock rwSpinLock; // There are no construction parameters.
+		RWSpinLockType rwSpinLock; // There are no construction parameters.
 
-		EATEST_VERIFY_MSG(!rwSpinLock.IsReadLocked(),  "RWSpinLock failure");
-		EATEST_VERIFY_MSG(!rwSpinLock.IsWriteLocked(), "RWSpinLock failure");
+		EATEST_VERIFY_F(!rwSpinLock.IsReadLocked(),  "%s failure", pName);
+		EATEST_VERIFY_F(!rwSpinLock.IsWriteLocked(), "%s failure", pName);
 
 		rwSpinLock.ReadTryLock();
-		EATEST_VERIFY_MSG(rwSpinLock.IsReadLocked(),   "RWSpinLock failure");
-		EATEST_VERIFY_MSG(!rwSpinLock.IsWriteLocked(), "RWSpinLock failure");
-		EATEST_VERIFY_MSG(!rwSpinLock.WriteTryLock(),  "RWSpinLock failure");
-		EATEST_VERIFY_MSG(!rwSpinLock.IsWriteLocked(), "RWSpinLock failure");
+		EATEST_VERIFY_F(rwSpinLock.IsReadLocked(),   "%s failure", pName);
+		EATEST_VERIFY_F(!rwSpinLock.IsWriteLocked(), "%s failure", pName);
+		EATEST_VERIFY_F(!rwSpinLock.WriteTryLock(),  "%s failure", pName);
+		EATEST_VERIFY_F(!rwSpinLock.IsWriteLocked(), "%s failure", pName);
 
 		rwSpinLock.ReadLock();
-		EATEST_VERIFY_MSG(rwSpinLock.IsReadLocked(), "RWSpinLock failure");
+		EATEST_VERIFY_F(rwSpinLock.IsReadLocked(), "%s failure", pName);
 
 		rwSpinLock.ReadUnlock();
-		EATEST_VERIFY_MSG(rwSpinLock.IsReadLocked(), "RWSpinLock failure");
+		EATEST_VERIFY_F(rwSpinLock.IsReadLocked(), "%s failure", pName);
 
 		rwSpinLock.ReadUnlock();
-		EATEST_VERIFY_MSG(!rwSpinLock.IsReadLocked(), "RWSpinLock failure");
+		EATEST_VERIFY_F(!rwSpinLock.IsReadLocked(), "%s failure", pName);
 
 		rwSpinLock.WriteTryLock();
-		EATEST_VERIFY_MSG(rwSpinLock.IsWriteLocked(), "RWSpinLock failure");
-		EATEST_VERIFY_MSG(!rwSpinLock.IsReadLocked(), "RWSpinLock failure");
-		EATEST_VERIFY_MSG(!rwSpinLock.ReadTryLock(),  "RWSpinLock failure");
-		EATEST_VERIFY_MSG(!rwSpinLock.IsReadLocked(), "RWSpinLock failure");
-		EATEST_VERIFY_MSG(!rwSpinLock.WriteTryLock(), "RWSpinLock failure");
+		EATEST_VERIFY_F(rwSpinLock.IsWriteLocked(), "%s failure", pName);
+		EATEST_VERIFY_F(!rwSpinLock.IsReadLocked(), "%s failure", pName);
+		EATEST_VERIFY_F(!rwSpinLock.ReadTryLock(),  "%s failure", pName);
+		EATEST_VERIFY_F(!rwSpinLock.IsReadLocked(), "%s failure", pName);
+		EATEST_VERIFY_F(!rwSpinLock.WriteTryLock(), "%s failure", pName);
 	}
 
 
-	{ // AutoRWSpinLock -- Basic single-threaded test.
-		RWSpinLock rwSpinLock; // There are no construction parameters.
+	{ // Auto lock -- Basic single-threaded test.
+		RWSpinLockType rwSpinLock; // There are no construction parameters.
 
 		{  //Special scope just for the AutoRWSpinLock
-			AutoRWSpinLock autoRWSpinLock1(rwSpinLock, AutoRWSpinLock::kLockTypeRead);
-			AutoRWSpinLock autoRWSpinLock2(rwSpinLock, AutoRWSpinLock::kLockTypeRead);
+			AutoRWSpinLockType autoRWSpinLock1(rwSpinLock, EA::Thread::AutoRWSpinLock::kLockTypeRead);
+			AutoRWSpinLockType autoRWSpinLock2(rwSpinLock, EA::Thread::AutoRWSpinLock::kLockTypeRead);
 
-			EATEST_VERIFY_MSG(rwSpinLock.IsReadLocked(),   "RWSpinLock failure");
-			EATEST_VERIFY_MSG(!rwSpinLock.IsWriteLocked(), "RWSpinLock failure");
-			EATEST_VERIFY_MSG(!rwSpinLock.WriteTryLock(),  "RWSpinLock failure");
-			EATEST_VERIFY_MSG(!rwSpinLock.IsWriteLocked(), "RWSpinLock failure");
+			EATEST_VERIFY_F(rwSpinLock.IsReadLocked(),   "%s failure", pName);
+			EATEST_VERIFY_F(!rwSpinLock.IsWriteLocked(), "%s failure", pName);
+			EATEST_VERIFY_F(!rwSpinLock.WriteTryLock(),  "%s failure", pName);
+			EATEST_VERIFY_F(!rwSpinLock.IsWriteLocked(), "%s failure", pName);
 		}
 
-		EATEST_VERIFY_MSG(!rwSpinLock.IsReadLocked(),  "RWSpinLock failure");
-		EATEST_VERIFY_MSG(!rwSpinLock.IsWriteLocked(), "RWSpinLock failure");
+		EATEST_VERIFY_F(!rwSpinLock.IsReadLocked(),  "%s failure", pName);
+		EATEST_VERIFY_F(!rwSpinLock.IsWriteLocked(), "%s failure", pName);
 
 		{  //Special scope just for the AutoRWSpinLock
-			AutoRWSpinLock autoRWSpinLock(rwSpinLock, AutoRWSpinLock::kLockTypeWrite);
+			AutoRWSpinLockType autoRWSpinLock(rwSpinLock, EA::Thread::AutoRWSpinLock::kLockTypeWrite);
 
-			EATEST_VERIFY_MSG(rwSpinLock.IsWriteLocked(), "RWSpinLock failure");
-			EATEST_VERIFY_MSG(!rwSpinLock.IsReadLocked(), "RWSpinLock failure");
-			EATEST_VERIFY_MSG(!rwSpinLock.ReadTryLock(),  "RWSpinLock failure");
-			EATEST_VERIFY_MSG(!rwSpinLock.IsReadLocked(), "RWSpinLock failure");
+			EATEST_VERIFY_F(rwSpinLock.IsWriteLocked(), "%s failure", pName);
+			EATEST_VERIFY_F(!rwSpinLock.IsReadLocked(), "%s failure", pName);
+			EATEST_VERIFY_F(!rwSpinLock.ReadTryLock(),  "%s failure", pName);
+			EATEST_VERIFY_F(!rwSpinLock.IsReadLocked(), "%s failure", pName);
 		}
 
-		EATEST_VERIFY_MSG(!rwSpinLock.IsReadLocked(),  "RWSpinLock failure");
+		EATEST_VERIFY_F(!rwSpinLock.IsReadLocked(),  "%s failure", pName);
+		EATEST_VERIFY_F(!rwSpinLock.IsWriteLocked(), "%s failure", pName);
+	}
+
+	return nErrorCount;
+}
+
+
+
+int TestThreadRWSpinLock()
+{
+	using namespace EA::Thread;
+
+	int nErrorCount = 0;
+
+	nErrorCount += TestRWSpinLockBasic<RWSpinLock, AutoRWSpinLock>("RWSpinLock");
+	nErrorCount += TestRWSpinLockBasic<RWSpinLockT< BackoffExponential<> >, AutoRWSpinLockT< BackoffExponential<> > >("RWSpinLockT<BackoffExponential>");
+
+
+	{ // Upgradeable read locks, Upgrade and Downgrade -- single-threaded test.
+		RWSpinLock rwSpinLock;
+
+		EATEST_VERIFY_MSG(rwSpinLock.UpgradeableReadTryLock(),  "RWSpinLock failure");
+		EATEST_VERIFY_MSG(rwSpinLock.IsUpgradeableReadLocked(), "RWSpinLock failure");
+		EATEST_VERIFY_MSG(rwSpinLock.IsReadLocked(),            "RWSpinLock failure");
+		EATEST_VERIFY_MSG(!rwSpinLock.UpgradeableReadTryLock(), "RWSpinLock failure"); // Only one upgradeable reader at a time.
+		EATEST_VERIFY_MSG(rwSpinLock.ReadTryLock(),             "RWSpinLock failure"); // But plain readers can coexist with it.
+		EATEST_VERIFY_MSG(!rwSpinLock.WriteTryLock(),           "RWSpinLock failure");
+		rwSpinLock.ReadUnlock();
+
+		rwSpinLock.Upgrade();
+		EATEST_VERIFY_MSG(rwSpinLock.IsWriteLocked(),            "RWSpinLock failure");
+		EATEST_VERIFY_MSG(!rwSpinLock.IsReadLocked(),            "RWSpinLock failure");
+		EATEST_VERIFY_MSG(!rwSpinLock.IsUpgradeableReadLocked(), "RWSpinLock failure");
+		EATEST_VERIFY_MSG(!rwSpinLock.ReadTryLock(),             "RWSpinLock failure");
+
+		rwSpinLock.Downgrade();
 		EATEST_VERIFY_MSG(!rwSpinLock.IsWriteLocked(), "RWSpinLock failure");
+		EATEST_VERIFY_MSG(rwSpinLock.IsReadLocked(),   "RWSpinLock failure");
+		EATEST_VERIFY_MSG(rwSpinLock.ReadTryLock(),    "RWSpinLock failure");
+		rwSpinLock.ReadUnlock();
+		rwSpinLock.ReadUnlock();
+
+		EATEST_VERIFY_MSG(rwSpinLock.mValue.GetValue() == RWSpinLock::kValueUnlocked, "RWSpinLock failure");
+
+		{
+			AutoRWSpinLock autoRWSpinLock(rwSpinLock, AutoRWSpinLock::kLockTypeUpgradeableRead);
+			EATEST_VERIFY_MSG(rwSpinLock.IsUpgradeableReadLocked(), "RWSpinLock failure");
+
+			autoRWSpinLock.Upgrade();
+			EATEST_VERIFY_MSG(rwSpinLock.IsWriteLocked(), "RWSpinLock failure");
+
+			autoRWSpinLock.Downgrade();
+			EATEST_VERIFY_MSG(rwSpinLock.IsReadLocked(), "RWSpinLock failure");
+		}
+
+		EATEST_VERIFY_MSG(rwSpinLock.mValue.GetValue() == RWSpinLock::kValueUnlocked, "RWSpinLock failure");
+		EATEST_VERIFY_MSG(!rwSpinLock.IsUpgradeableReadLocked(), "RWSpinLock failure");
 	}
 
 
@@ -177,6 +177,117 @@ static intptr_t BadSignalTestPostFunction(void *data)
 
 
 
+///////////////////////////////////////////////////////////////////////////////
+// Batch release benchmark
+//
+// A set of worker threads block on a semaphore, and a single Post(n) releases
+// all of them at once, as when a job system hands a batch of jobs to idle workers.
+//
+const int kBatchMaxWaiterCount = 64;
+const int kBatchRoundCount     = 20;
+
+struct BatchReleaseData
+{
+	Semaphore           mSemaphore;
+	AtomicInt32         mnReleasedCount;
+	volatile bool       mbShouldQuit;
+
+	BatchReleaseData(const SemaphoreParameters& sp)
+	  : mSemaphore(&sp, false), mnReleasedCount(0), mbShouldQuit(false) {}
+
+	BatchReleaseData(const BatchReleaseData& rhs);
+	BatchReleaseData& operator=(const BatchReleaseData& rhs);
+};
+
+
+static intptr_t BatchReleaseWaitFunction(void* pvData)
+{
+	BatchReleaseData* const pData = (BatchReleaseData*)pvData;
+
+	for(;;)
+	{
+		if(pData->mSemaphore.Wait(GetThreadTime() + 30000) < 0)
+			break;
+		if(pData->mbShouldQuit)
+			break;
+		pData->mnReleasedCount.Increment();
+	}
+
+	return 0;
+}
+
+
+// Returns the average time in microseconds from the start of Post(nWaiterCount)
+// until all waiters have been released. nPostTime receives the average duration
+// of the Post call itself.
+static uint64_t RunBatchRelease(bool bIntraProcess, int nWaiterCount, uint64_t& nPostTime, int& nErrorCount)
+{
+	SemaphoreParameters       sp(0, bIntraProcess, NULL);
+	BatchReleaseData* const   pData = new BatchReleaseData(sp);
+	Thread                    thread[kBatchMaxWaiterCount];
+	EA::StdC::Stopwatch       stopwatchRelease(EA::StdC::Stopwatch::kUnitsMicroseconds);
+	EA::StdC::Stopwatch       stopwatchPost(EA::StdC::Stopwatch::kUnitsNanoseconds);
+
+	for(int i = 0; i < nWaiterCount; i++)
+		thread[i].Begin(BatchReleaseWaitFunction, pData);
+
+	for(int r = 0; r < kBatchRoundCount; r++)
+	{
+		// Give the waiters time to block again after the previous round.
+		ThreadSleep(20);
+
+		stopwatchRelease.Start();
+		stopwatchPost.Start();
+		pData->mSemaphore.Post(nWaiterCount);
+		stopwatchPost.Stop();
+
+		const ThreadTime timeout = GetThreadTime() + 30000;
+
+		while((pData->mnReleasedCount.GetValue() < (nWaiterCount * (r + 1))) && (GetThreadTime() < timeout))
+			ThreadSleep(kTimeoutYield);
+
+		stopwatchRelease.Stop();
+
+		EATEST_VERIFY_MSG(pData->mnReleasedCount.GetValue() == (nWaiterCount * (r + 1)), "Semaphore failure: batch release didn't release all waiters.\n");
+	}
+
+	pData->mbShouldQuit = true;
+	pData->mSemaphore.Post(nWaiterCount);
+
+	for(int i = 0; i < nWaiterCount; i++)
+	{
+		const Thread::Status status = thread[i].WaitForEnd(GetThreadTime() + 30000);
+		EATEST_VERIFY_MSG(status == Thread::kStatusEnded, "Semaphore failure: Thread(s) didn't end.\n");
+	}
+
+	delete pData;
+
+	nPostTime = stopwatchPost.GetElapsedTime() / kBatchRoundCount;
+	return stopwatchRelease.GetElapsedTime() / kBatchRoundCount;
+}
+
+
+static int TestThreadSemaphoreBatchRelease()
+{
+	int nErrorCount = 0;
+
+	EA::UnitTest::ReportVerbosity(1, "\nSemaphore batch release (Post(n) with n blocked waiters; Post call in ns, release of all waiters in us)...\n");
+
+	for(int nWaiterCount = 4; nWaiterCount <= kBatchMaxWaiterCount; nWaiterCount *= 4)
+	{
+		uint64_t tPostIntra, tPostInter;
+
+		const uint64_t tReleaseIntra = RunBatchRelease(true,  nWaiterCount, tPostIntra, nErrorCount);
+		const uint64_t tReleaseInter = RunBatchRelease(false, nWaiterCount, tPostInter, nErrorCount);
+
+		EA::UnitTest::ReportVerbosity(1, "    %2d waiters: intra-process Post %8" PRIu64 " release %6" PRIu64 ", inter-process Post %8" PRIu64 " release %6" PRIu64 "\n",
+									  nWaiterCount, tPostIntra, tReleaseIntra, tPostInter, tReleaseInter);
+	}
+
+	return nErrorCount;
+}
+
+
 
 int TestThreadSemaphore()
 {
@@ -336,6 +447,8 @@ int TestThreadSemaphore()
 
 		}
 
+		nErrorCount += TestThreadSemaphoreBatchRelease();
+
 	#endif // EA_THREADS_AVAILABLE
 
 	return nErrorCount;
@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TestThread.h"
+#include <EATest/EATest.h>
+#include <EAStdC/EAStopwatch.h>
+#include <eathread/eathread_thread.h>
+#include <eathread/eathread_atomic.h>
+#include <eathread/eathread_shardedcounter.h>
+
+
+using namespace EA::Thread;
+
+
+const int kMaxCounterThreadCount = 32;
+const int kCounterIncrementCount = 200000; // Per thread.
+
+
+struct AtomicCounterAdapter
+{
+	AtomicInt64 mCounter;
+
+	AtomicCounterAdapter() : mCounter(0) {}
+	void    Increment()      { mCounter.Increment(); }
+	int64_t GetValue() const { return mCounter.GetValue(); }
+};
+
+struct ShardedCounterAdapter
+{
+	ShardedCounter mCounter;
+
+	void    Increment()      { mCounter.Increment(); }
+	int64_t GetValue() const { return mCounter.GetValue(); }
+};
+
+
+template <typename Counter>
+struct CounterWorkData
+{
+	Counter     mCounter;
+	AtomicInt32 mnReadyCount;
+	AtomicInt32 mShouldBegin;
+
+	CounterWorkData() : mCounter(), mnReadyCount(0), mShouldBegin(0) {}
+};
+
+
+template <typename Counter>
+static intptr_t CounterThreadFunction(void* pvWorkData)
+{
+	CounterWorkData<Counter>* const pWorkData = (CounterWorkData<Counter>*)pvWorkData;
+
+	pWorkData->mnReadyCount.Increment();
+	while(!pWorkData->mShouldBegin.GetValue())
+		EA_THREAD_DO_SPIN();
+
+	for(int i = 0; i < kCounterIncrementCount; i++)
+		pWorkData->mCounter.Increment();
+
+	return 0;
+}
+
+
+// Returns the time per increment in nanoseconds, over all threads. 
+template <typename Counter>
+static double RunIncrements(int nThreadCount, int& nErrorCount)
+{
+	CounterWorkData<Counter> workData;
+	Thread                   threadArray[kMaxCounterThreadCount];
+	EA::StdC::Stopwatch      stopwatch(EA::StdC::Stopwatch::kUnitsNanoseconds);
+
+	for(int i = 0; i < nThreadCount; i++)
+		threadArray[i].Begin(CounterThreadFunction<Counter>, &workData);
+
+	while(workData.mnReadyCount.GetValue() < nThreadCount)
+		ThreadSleep(1);
+
+	stopwatch.Start();
+	workData.mShouldBegin.SetValue(1);
+
+	for(int i = 0; i < nThreadCount; i++)
+		EATEST_VERIFY_MSG(threadArray[i].WaitForEnd(GetThreadTime() + 60000) == Thread::kStatusEnded, "Thread failure: Thread(s) didn't end.");
+	stopwatch.Stop();
+
+	EATEST_VERIFY_MSG(workData.mCounter.GetValue() == ((int64_t)nThreadCount * kCounterIncrementCount), "ShardedCounter failure: counts were lost.");
+
+	return (double)stopwatch.GetElapsedTime() / ((double)nThreadCount * kCounterIncrementCount);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TestThreadShardedCounter
+//
+int TestThreadShardedCounter()
+{
+	int nErrorCount(0);
+
+	{ // Single-threaded test.
+		ShardedCounter counter(4, 10);
+
+		EATEST_VERIFY_MSG(counter.GetShardCount() == 4, "ShardedCounter failure");
+		EATEST_VERIFY_MSG(counter.GetValue() == 0, "ShardedCounter failure");
+
+		for(int i = 0; i < 25; i++)
+			counter.Increment();
+
+		EATEST_VERIFY_MSG(counter.GetValue() == 25, "ShardedCounter failure");
+		EATEST_VERIFY_MSG((counter.GetApproximateValue() <= 25) && (counter.GetApproximateValue() >= (25 - (counter.GetShardCount() * 10))), "ShardedCounter failure");
+
+		counter.Add(-30);
+		counter.Decrement();
+		EATEST_VERIFY_MSG(counter.GetValue() == -6, "ShardedCounter failure");
+
+		EATEST_VERIFY_MSG(counter.Reset() == -6, "ShardedCounter failure");
+		EATEST_VERIFY_MSG(counter.GetValue() == 0, "ShardedCounter failure");
+		EATEST_VERIFY_MSG(counter.GetApproximateValue() == 0, "ShardedCounter failure");
+	}
+
+	{ // Shard counts are powers of two within [1, kMaxShardCount], and a single shard is exact.
+		ShardedCounter counter3(3), counterBig(1000), counter1(1);
+
+		EATEST_VERIFY_MSG(counter3.GetShardCount() == 4, "ShardedCounter failure");
+		EATEST_VERIFY_MSG(counterBig.GetShardCount() == ShardedCounter::kMaxShardCount, "ShardedCounter failure");
+		EATEST_VERIFY_MSG(counter1.GetShardCount() == 1, "ShardedCounter failure");
+
+		counter1.Add(7);
+		EATEST_VERIFY_MSG(counter1.GetApproximateValue() == 7, "ShardedCounter failure");
+	}
+
+	#if EA_THREADS_AVAILABLE
+	{
+		// Increment throughput from 1 up to as many threads as there are processors,
+		// compared to a single AtomicInt64. The counts are verified along the way.
+		// Thread counts above the processor count are skipped, as in the other
+		// benchmarks, so that the times are comparable between them.
+		const int nProcessorCount = GetProcessorCount();
+		const int kThreadCounts[] = { 1, 2, 4, 8, 16, 32 };
+
+		// The counts are verified with several threads even on small systems.
+		RunIncrements<ShardedCounterAdapter>(4, nErrorCount);
+
+		EA::UnitTest::ReportVerbosity(1, "\nCounter increment cost (%d increments per thread, time in ns per increment over all threads)...\n", kCounterIncrementCount);
+
+		for(size_t t = 0; t < EAArrayCount(kThreadCounts); t++)
+		{
+			const int nThreadCount = kThreadCounts[t];
+
+			if(nThreadCount > nProcessorCount)
+			{
+				EA::UnitTest::ReportVerbosity(1, "    %2d threads: skipped, only %d processors.\n", nThreadCount, nProcessorCount);
+				continue;
+			}
+
+			const double tAtomic  = RunIncrements<AtomicCounterAdapter> (nThreadCount, nErrorCount);
+			const double tSharded = RunIncrements<ShardedCounterAdapter>(nThreadCount, nErrorCount);
+
+			EA::UnitTest::ReportVerbosity(1, "    %2d threads: AtomicInt64 %6.2f, ShardedCounter %6.2f\n", nThreadCount, tAtomic, tSharded);
+		}
+	}
+	#endif
+
+	return nErrorCount;
+}
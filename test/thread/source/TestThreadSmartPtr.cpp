@@ -4,8 +4,11 @@
 
 #include "TestThread.h"
 #include <EATest/EATest.h>
+#include <EAStdC/EAStopwatch.h>
 #include <eathread/eathread_thread.h>
 #include <eathread/shared_ptr_mt.h>
+#include <eathread/atomic_shared_ptr_mt.h>
+#include <eathread/intrusive_ptr_mt.h>
 #include <eathread/shared_array_mt.h>
 #include <eathread/eathread_atomic.h>  // required to test the c11 atomics macros
 
@@ -52,145 +55,526 @@ namespace not_eastl
 }
 
 
-int TestThreadSmartPtr()
+// Tests the interface shared by shared_ptr_mt and atomic_shared_ptr_mt.
+template <typename TestClassSharedPtr>
+static int TestSharedPtrInterface(const char* pName)
 {
 	int nErrorCount(0);
 
-	// C11 atomics & eastl::shared_ptr name collision tests.
+	// typedef T element_type;
+	EATEST_VERIFY_F(sizeof(typename TestClassSharedPtr::element_type) > 0, "%s failure.", pName);
+
+	// typedef T value_type;
+	EATEST_VERIFY_F(sizeof(typename TestClassSharedPtr::value_type) > 0, "%s failure.", pName);
+
+	// explicit SharedPtr(T* pValue = 0)
+	TestClassSharedPtr pSharedPtr0;
+	TestClassSharedPtr pSharedPtr1(new TestClass);
+	TestClassSharedPtr pSharedPtr2(new TestClass);
+
+	// SharedPtr(SharedPtr const& sharedPtr)
+	TestClassSharedPtr pSharedPtr3(pSharedPtr1);
+
+	// void lock() const
+	// void unlock() const
+	pSharedPtr0.lock();
+	pSharedPtr0.unlock();
+
+	// operator bool_() const
+	EATEST_VERIFY_F(IsFalse(pSharedPtr0), "%s failure.", pName);
+	EATEST_VERIFY_F( IsTrue(pSharedPtr1), "%s failure.", pName);
+
+	// bool operator!() const
+	EATEST_VERIFY_F( IsTrue(!pSharedPtr0), "%s failure.", pName);
+	EATEST_VERIFY_F(IsFalse(!pSharedPtr1), "%s failure.", pName);
+
+	// int use_count() const
+	EATEST_VERIFY_F(pSharedPtr0.use_count() == 1, "%s failure.", pName);
+	EATEST_VERIFY_F(pSharedPtr1.use_count() == 2, "%s failure.", pName);
+	EATEST_VERIFY_F(pSharedPtr2.use_count() == 1, "%s failure.", pName);
+	EATEST_VERIFY_F(pSharedPtr3.use_count() == 2, "%s failure.", pName);
+
+	// bool unique() const
+	EATEST_VERIFY_F( pSharedPtr0.unique(), "%s failure.", pName);
+	EATEST_VERIFY_F(!pSharedPtr1.unique(), "%s failure.", pName);
+	EATEST_VERIFY_F( pSharedPtr2.unique(), "%s failure.", pName);
+	EATEST_VERIFY_F(!pSharedPtr3.unique(), "%s failure.", pName);
+
+	// SharedPtr& operator=(SharedPtr const& sharedPtr)
+	pSharedPtr3 = pSharedPtr2;
+
+	EATEST_VERIFY_F(pSharedPtr1.use_count() == 1, "%s failure.", pName);
+	EATEST_VERIFY_F(pSharedPtr2.use_count() == 2, "%s failure.", pName);
+	EATEST_VERIFY_F(pSharedPtr3.use_count() == 2, "%s failure.", pName);
+
+	// void reset(T* pValue = 0)
+	pSharedPtr2.reset();
+
+	EATEST_VERIFY_F(IsFalse(pSharedPtr2), "%s failure.", pName);
+	EATEST_VERIFY_F(pSharedPtr1.use_count() == 1, "%s failure.", pName);
+	EATEST_VERIFY_F(pSharedPtr2.use_count() == 1, "%s failure.", pName);
+	EATEST_VERIFY_F(pSharedPtr3.use_count() == 1, "%s failure.", pName);
+
+	pSharedPtr3.reset(new TestClass);
+
+	EATEST_VERIFY_F(IsTrue(pSharedPtr3), "%s failure.", pName);
+	EATEST_VERIFY_F(pSharedPtr3.use_count() == 1, "%s failure.", pName);
+
+	// T* get() const
+	TestClass* pA = pSharedPtr1.get();
+	TestClass* pB = pSharedPtr3.get();
+
+	// template<class T>
+	// inline T* get_pointer(const SharedPtr& sharedPtr)
+	EATEST_VERIFY_F(get_pointer(pSharedPtr1) == pA, "%s failure.", pName);
+	EATEST_VERIFY_F(get_pointer(pSharedPtr3) == pB, "%s failure.", pName);
+
+	// void swap(SharedPtr& sharedPtr)
+	pSharedPtr1.swap(pSharedPtr3);
+
+	EATEST_VERIFY_F(pSharedPtr1.get() == pB, "%s failure.", pName);
+	EATEST_VERIFY_F(pSharedPtr3.get() == pA, "%s failure.", pName);
+
+	// T& operator*() const
+	(*pSharedPtr1).x = 37;
+
+	EATEST_VERIFY_F(pSharedPtr1.get()->x == 37, "%s failure.", pName);
+
+	// T* operator->() const
+	pSharedPtr1->x = 73;
+
+	EATEST_VERIFY_F(pSharedPtr1.get()->x == 73, "%s failure.", pName);
+
+	// template<class T>
+	// inline void swap(SharedPtr& sharedPtr1, SharedPtr& sharedPtr2)
+	swap(pSharedPtr1, pSharedPtr2);
+
+	EATEST_VERIFY_F(pSharedPtr2.get()->x == 73, "%s failure.", pName);
+
+	// template<class T, class U>
+	// inline bool operator==(const SharedPtr& sharedPtr1, const SharedPtr& sharedPtr2)
+	bool bEqual = pSharedPtr1 == pSharedPtr2;
+
+	EATEST_VERIFY_F(!bEqual, "%s failure.", pName);
+
+	// template<class T, class U>
+	// inline bool operator!=(const SharedPtr& sharedPtr1, const SharedPtr& sharedPtr2)
+	bool bNotEqual = pSharedPtr1 != pSharedPtr2;
+
+	EATEST_VERIFY_F(bNotEqual, "%s failure.", pName);
+
+	// template<class T, class U>
+	// inline bool operator<(const SharedPtr& sharedPtr1, const SharedPtr& sharedPtr2)
+	bool bLessA = pSharedPtr1 < pSharedPtr2;
+	bool bLessB = pSharedPtr2 < pSharedPtr1;
+
+	EATEST_VERIFY_F(bLessA || bLessB, "%s failure.", pName);
+
+	return nErrorCount;
+}
+
+
+struct SharedPtrTestObject
+{
+	static AtomicInt32 sLiveCount;
+
+	int mnMagic;
+
+	SharedPtrTestObject() : mnMagic(0x600dc0de) { sLiveCount.Increment(); }
+   ~SharedPtrTestObject() { mnMagic = 0; sLiveCount.Decrement(); }
+};
+
+AtomicInt32 SharedPtrTestObject::sLiveCount(0);
+
+
+template <typename SharedPtr>
+struct SharedPtrWorkData
+{
+	SharedPtr   mSharedPtr;
+	AtomicInt32 mnReadyCount;
+	AtomicInt32 mShouldBegin;
+	AtomicInt32 mnErrorCount;
+	int         mnCopyCount;  // Per thread.
+	int         mnReplacerCount; // The number of threads which replace the pointer while the others copy it.
+	bool        mbWeak;       // If true then copies are made through a weak_ptr_mt.
+
+	SharedPtrWorkData() : mSharedPtr(new SharedPtrTestObject), mnReadyCount(0), mShouldBegin(0), mnErrorCount(0), mnCopyCount(0), mnReplacerCount(0), mbWeak(false) {}
+};
+
+
+// Copies the pointer and reads the object through the copy, which keeps it alive. 
+template <typename SharedPtr>
+static int CheckSharedPtrCopy(SharedPtr& sharedPtr, bool /*bWeak*/)
+{
+	SharedPtr pCopy(sharedPtr);
+	return (pCopy->mnMagic != 0x600dc0de) ? 1 : 0;
+}
+
+static int CheckSharedPtrCopy(atomic_shared_ptr_mt<SharedPtrTestObject>& sharedPtr, bool bWeak)
+{
+	if(bWeak)
 	{
-		// If you are seeing compiler errors regarding C11 atomic macro
-		// expansions here look at header file eathread_atomic_android_c11.h.
-		// Ensure C11 atomic macros are being undefined properly.  We hit this
-		// problem on android-gcc config.
-		using namespace not_eastl;
-		shared_ptr<int> ptr1, ptr2, ptr3;
+		weak_ptr_mt<SharedPtrTestObject>          weakPtr(sharedPtr);
+		atomic_shared_ptr_mt<SharedPtrTestObject> pLocked = weakPtr.lock(); // May legitimately find the object already replaced.
+		return (pLocked && (pLocked->mnMagic != 0x600dc0de)) ? 1 : 0;
+	}
 
-		atomic_is_lock_free(&ptr1);
-		atomic_load(&ptr1);
-		atomic_load_explicit(&ptr1);
-		atomic_store(&ptr1, ptr2);
-		atomic_store_explicit(&ptr1, ptr2);
-		atomic_exchange(&ptr1, ptr2);
-		atomic_exchange_explicit(&ptr1, ptr2);
-		atomic_compare_exchange_strong(&ptr1, &ptr2, ptr3);
-		atomic_compare_exchange_weak(&ptr1, &ptr2, ptr3);
-		atomic_compare_exchange_strong_explicit(&ptr1, &ptr2, ptr3);
-		atomic_compare_exchange_strong_explicit(&ptr1, &ptr2, ptr3);
+	atomic_shared_ptr_mt<SharedPtrTestObject> pCopy(sharedPtr);
+	return (pCopy->mnMagic != 0x600dc0de) ? 1 : 0;
+}
+
+
+template <typename SharedPtr>
+static intptr_t SharedPtrCopyThreadFunction(void* pvWorkData)
+{
+	SharedPtrWorkData<SharedPtr>* const pWorkData   = (SharedPtrWorkData<SharedPtr>*)pvWorkData;
+	const bool                          bReplace    = (pWorkData->mnReadyCount.Increment() <= pWorkData->mnReplacerCount);
+	int                                 nErrorCount = 0;
+
+	while(!pWorkData->mShouldBegin.GetValue())
+		EA_THREAD_DO_SPIN();
+
+	for(int i = 0; i < pWorkData->mnCopyCount; i++)
+	{
+		if(bReplace)
+			pWorkData->mSharedPtr.reset(new SharedPtrTestObject);
+		else
+			nErrorCount += CheckSharedPtrCopy(pWorkData->mSharedPtr, pWorkData->mbWeak);
 	}
 
-	{  // Basic single-threaded test.
-		typedef shared_ptr_mt<TestClass> TestClassSharedPtr;
+	pWorkData->mnErrorCount += nErrorCount;
+	return 0;
+}
+
+
+// Returns the time per copy in nanoseconds, over all threads.
+template <typename SharedPtr>
+static double RunSharedPtrCopies(int nThreadCount, int nCopyCount, int nReplacerCount, int& nErrorCount, bool bWeak = false)
+{
+	SharedPtrWorkData<SharedPtr> workData;
+	Thread                       threadArray[16];
+	EA::StdC::Stopwatch          stopwatch(EA::StdC::Stopwatch::kUnitsNanoseconds);
+
+	workData.mnCopyCount     = nCopyCount;
+	workData.mnReplacerCount = nReplacerCount;
+	workData.mbWeak          = bWeak;
+
+	for(int i = 0; i < nThreadCount; i++)
+		threadArray[i].Begin(SharedPtrCopyThreadFunction<SharedPtr>, &workData);
+
+	while(workData.mnReadyCount.GetValue() < nThreadCount)
+		ThreadSleep(1);
+
+	stopwatch.Start();
+	workData.mShouldBegin.SetValue(1);
 
-		// typedef T element_type;
-		EATEST_VERIFY_MSG(sizeof(TestClassSharedPtr::element_type) > 0, "shared_ptr_mt failure.");
+	for(int i = 0; i < nThreadCount; i++)
+		EATEST_VERIFY_MSG(threadArray[i].WaitForEnd(GetThreadTime() + 60000) == Thread::kStatusEnded, "Thread failure: Thread(s) didn't end.");
+	stopwatch.Stop();
 
-		// typedef T value_type;
-		EATEST_VERIFY_MSG(sizeof(TestClassSharedPtr::value_type) > 0, "shared_ptr_mt failure");
+	EATEST_VERIFY_MSG(workData.mnErrorCount.GetValue() == 0, "shared pointer failure: copy saw a destroyed object.");
+	EATEST_VERIFY_MSG(workData.mSharedPtr.unique(), "shared pointer failure: reference count leaked.");
 
-		// explicit shared_ptr_mt(T* pValue = 0)
-		TestClassSharedPtr pSharedPtr0;
-		TestClassSharedPtr pSharedPtr1(new TestClass);
-		TestClassSharedPtr pSharedPtr2(new TestClass);
+	return (double)stopwatch.GetElapsedTime() / ((double)nThreadCount * nCopyCount);
+}
+
+
+static int TestAtomicSharedPtrThreads()
+{
+	int nErrorCount(0);
+
+	EA::UnitTest::ReportVerbosity(1, "\nsizeof(shared_ptr_mt) = %u, sizeof(atomic_shared_ptr_mt) = %u\n",
+								  (unsigned)sizeof(shared_ptr_mt<TestClass>), (unsigned)sizeof(atomic_shared_ptr_mt<TestClass>));
+
+	#if EA_THREADS_AVAILABLE
+		// Copies racing with replacement of the pointer must always see a live object.
+		RunSharedPtrCopies<atomic_shared_ptr_mt<SharedPtrTestObject> >(4, 100000, 1, nErrorCount);
+		EATEST_VERIFY_MSG(SharedPtrTestObject::sLiveCount.GetValue() == 0, "atomic_shared_ptr_mt failure: objects leaked.");
+
+		// Several threads replacing the pointer at once, each of which compares with the pointer it replaces.
+		RunSharedPtrCopies<atomic_shared_ptr_mt<SharedPtrTestObject> >(4, 100000, 3, nErrorCount);
+		RunSharedPtrCopies<atomic_shared_ptr_mt<SharedPtrTestObject> >(4, 100000, 4, nErrorCount);
+		EATEST_VERIFY_MSG(SharedPtrTestObject::sLiveCount.GetValue() == 0, "atomic_shared_ptr_mt failure: objects leaked.");
+
+		{ // Copy throughput from one shared pointer object, with 1 to N threads.
+			const int nProcessorCount = GetProcessorCount();
+			const int kThreadCounts[] = { 1, 2, 4, 8, 16 };
+			const int kCopyCount      = 200000; // Per thread.
+
+			EA::UnitTest::ReportVerbosity(1, "Shared pointer copy cost (%d copies per thread, time in ns per copy over all threads)...\n", kCopyCount);
+
+			for(size_t t = 0; t < EAArrayCount(kThreadCounts); t++)
+			{
+				const int nThreadCount = kThreadCounts[t];
 
-		// shared_ptr_mt(shared_ptr_mt const& sharedPtr)
-		TestClassSharedPtr pSharedPtr3(pSharedPtr1);
+				if(nThreadCount > nProcessorCount) // As in the other benchmarks, so that the times are comparable.
+				{
+					EA::UnitTest::ReportVerbosity(1, "    %2d threads: skipped, only %d processors.\n", nThreadCount, nProcessorCount);
+					continue;
+				}
 
-		// void lock() const
-		// void unlock() const
-		pSharedPtr0.lock();
-		pSharedPtr0.unlock();
+				const double tLocked   = RunSharedPtrCopies<shared_ptr_mt<SharedPtrTestObject> >       (nThreadCount, kCopyCount, 0, nErrorCount);
+				const double tLockFree = RunSharedPtrCopies<atomic_shared_ptr_mt<SharedPtrTestObject> >(nThreadCount, kCopyCount, 0, nErrorCount);
 
-		// operator bool_() const
-		EATEST_VERIFY_MSG(IsFalse(pSharedPtr0), "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG( IsTrue(pSharedPtr1), "shared_ptr_mt failure");
+				EA::UnitTest::ReportVerbosity(1, "    %2d threads: shared_ptr_mt %6.2f, atomic_shared_ptr_mt %6.2f\n", nThreadCount, tLocked, tLockFree);
+			}
+		}
+	#endif
 
-		// bool operator!() const
-		EATEST_VERIFY_MSG( IsTrue(!pSharedPtr0), "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(IsFalse(!pSharedPtr1), "shared_ptr_mt failure");
+	return nErrorCount;
+}
 
-		// int use_count() const
-		EATEST_VERIFY_MSG(pSharedPtr0.use_count() == 1, "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(pSharedPtr1.use_count() == 2, "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(pSharedPtr2.use_count() == 1, "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(pSharedPtr3.use_count() == 2, "shared_ptr_mt failure");
 
-		// bool unique() const
-		EATEST_VERIFY_MSG( pSharedPtr0.unique(), "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(!pSharedPtr1.unique(), "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG( pSharedPtr2.unique(), "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(!pSharedPtr3.unique(), "shared_ptr_mt failure");
+struct MessageTestObject
+{
+	static AtomicInt32 sLiveCount;
 
-		// shared_ptr_mt& operator=(shared_ptr_mt const& sharedPtr)
-		pSharedPtr3 = pSharedPtr2;
+	int mnType;
+	int mnSize;
 
-		EATEST_VERIFY_MSG(pSharedPtr1.use_count() == 1, "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(pSharedPtr2.use_count() == 2, "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(pSharedPtr3.use_count() == 2, "shared_ptr_mt failure");
+	MessageTestObject(int nType, int nSize) : mnType(nType), mnSize(nSize) { sLiveCount.Increment(); }
+   ~MessageTestObject() { sLiveCount.Decrement(); }
+};
 
-		// void reset(T* pValue = 0)
-		pSharedPtr2.reset();
+AtomicInt32 MessageTestObject::sLiveCount(0);
 
-		EATEST_VERIFY_MSG(IsFalse(pSharedPtr2), "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(pSharedPtr1.use_count() == 1, "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(pSharedPtr2.use_count() == 1, "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(pSharedPtr3.use_count() == 1, "shared_ptr_mt failure");
 
-		pSharedPtr3.reset(new TestClass);
+struct IntrusiveTestObject : public intrusive_ref_counted_mt<IntrusiveTestObject>
+{
+	static AtomicInt32 sLiveCount;
 
-		EATEST_VERIFY_MSG(IsTrue(pSharedPtr3), "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(pSharedPtr3.use_count() == 1, "shared_ptr_mt failure");
+	IntrusiveTestObject()  { sLiveCount.Increment(); }
+   ~IntrusiveTestObject() { sLiveCount.Decrement(); }
+};
 
-		// T* get() const
-		TestClass* pA = pSharedPtr1.get();
-		TestClass* pB = pSharedPtr3.get();
+AtomicInt32 IntrusiveTestObject::sLiveCount(0);
 
-		// template<class T>
-		// inline T* get_pointer(const shared_ptr_mt<T>& sharedPtr)
-		EATEST_VERIFY_MSG(get_pointer(pSharedPtr1) == pA, "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(get_pointer(pSharedPtr3) == pB, "shared_ptr_mt failure");
 
-		// void swap(shared_ptr_mt<T>& sharedPtr)
-		pSharedPtr1.swap(pSharedPtr3);
+// Counts allocations, to verify that make_shared_mt allocates once and goes through the EAThread allocator.
+class CountingAllocator : public EA::Thread::Allocator
+{
+public:
+	int mnAllocCount;
+	int mnFreeCount;
+
+	CountingAllocator() : mnAllocCount(0), mnFreeCount(0) {}
 
-		EATEST_VERIFY_MSG(pSharedPtr1.get() == pB, "shared_ptr_mt failure");
-		EATEST_VERIFY_MSG(pSharedPtr3.get() == pA, "shared_ptr_mt failure");
+	void* Alloc(size_t size, const char* /*name*/, unsigned int /*flags*/)
+		{ mnAllocCount++; return new char[size]; }
 
-		// T& operator*() const
-		(*pSharedPtr1).x = 37;
+	void* Alloc(size_t size, const char* /*name*/, unsigned int /*flags*/, unsigned int /*align*/, unsigned int /*alignOffset*/)
+		{ mnAllocCount++; return new char[size]; }
 
-		EATEST_VERIFY_MSG(pSharedPtr1.get()->x == 37, "shared_ptr_mt failure");
+	void Free(void* block, size_t /*size*/)
+		{ mnFreeCount++; delete[] static_cast<char*>(block); }
+};
 
-		// T* operator->() const
-		pSharedPtr1->x = 73;
 
-		EATEST_VERIFY_MSG(pSharedPtr1.get()->x == 73, "shared_ptr_mt failure");
+// Fails every allocation.
+class FailingAllocator : public EA::Thread::Allocator
+{
+public:
+	void* Alloc(size_t, const char*, unsigned int)                             { return NULL; }
+	void* Alloc(size_t, const char*, unsigned int, unsigned int, unsigned int) { return NULL; }
+	void  Free(void*, size_t)                                                  {}
+};
 
-		// template<class T>
-		// inline void swap(shared_ptr_mt<T>& sharedPtr1, shared_ptr_mt<T>& sharedPtr2)
-		swap(pSharedPtr1, pSharedPtr2);
 
-		EATEST_VERIFY_MSG(pSharedPtr2.get()->x == 73, "shared_ptr_mt failure");
+struct alignas(128) AlignedTestObject
+{
+	int mnValue;
+
+	explicit AlignedTestObject(int nValue) : mnValue(nValue) {}
+};
+
+
+static int TestMakeSharedWeakIntrusive()
+{
+	int nErrorCount(0);
+
+	{ // make_shared_mt allocates once, from the EAThread allocator.
+		CountingAllocator  allocator;
+		Allocator* const   pSavedAllocator = GetAllocator();
+
+		SetAllocator(&allocator);
+		{
+			atomic_shared_ptr_mt<MessageTestObject> pMessage = make_shared_mt<MessageTestObject>(3, 42);
+
+			EATEST_VERIFY_MSG(allocator.mnAllocCount == 1, "make_shared_mt failure: more than one allocation.");
+			EATEST_VERIFY_MSG((pMessage->mnType == 3) && (pMessage->mnSize == 42), "make_shared_mt failure.");
+			EATEST_VERIFY_MSG(pMessage.unique(), "make_shared_mt failure.");
+
+			atomic_shared_ptr_mt<MessageTestObject> pCopy(pMessage);
+			EATEST_VERIFY_MSG(pMessage.use_count() == 2, "make_shared_mt failure.");
+		}
+		SetAllocator(pSavedAllocator);
+
+		EATEST_VERIFY_MSG(MessageTestObject::sLiveCount.GetValue() == 0, "make_shared_mt failure: object not destroyed.");
+		EATEST_VERIFY_MSG(allocator.mnFreeCount == 1, "make_shared_mt failure: memory not freed.");
+	}
+
+	{ // make_shared_mt aligns the object as its type requires, with or without an allocator.
+		atomic_shared_ptr_mt<AlignedTestObject> pAligned = make_shared_mt<AlignedTestObject>(7);
+		EATEST_VERIFY_MSG((((uintptr_t)pAligned.get() % EA_ALIGN_OF(AlignedTestObject)) == 0) && (pAligned->mnValue == 7), "make_shared_mt failure: misaligned object.");
+
+		CountingAllocator allocator;
+		Allocator* const  pSavedAllocator = GetAllocator();
+
+		SetAllocator(&allocator);
+		atomic_shared_ptr_mt<AlignedTestObject> pAllocatorAligned = make_shared_mt<AlignedTestObject>(8);
+		SetAllocator(pSavedAllocator);
+
+		EATEST_VERIFY_MSG(((uintptr_t)pAllocatorAligned.get() % EA_ALIGN_OF(AlignedTestObject)) == 0, "make_shared_mt failure: misaligned object.");
+		pAllocatorAligned.reset(); // Freed by the allocator it came from, which is no longer the current one.
+		EATEST_VERIFY_MSG(allocator.mnFreeCount == 1, "make_shared_mt failure: memory not freed by its allocator.");
+	}
+
+	{ // make_shared_mt doesn't construct into memory it failed to allocate.
+		FailingAllocator allocator;
+		Allocator* const pSavedAllocator = GetAllocator();
+		bool             bFailed         = false;
+
+		SetAllocator(&allocator);
+		#if defined(EA_COMPILER_NO_EXCEPTIONS) || defined(EA_COMPILER_NO_UNWIND)
+			bFailed = !make_shared_mt<MessageTestObject>(1, 1);
+		#else
+			try
+			{
+				make_shared_mt<MessageTestObject>(1, 1);
+			}
+			catch(std::bad_alloc&)
+			{
+				bFailed = true;
+			}
+		#endif
+		SetAllocator(pSavedAllocator);
+
+		EATEST_VERIFY_MSG(bFailed && (MessageTestObject::sLiveCount.GetValue() == 0), "make_shared_mt failure: allocation failure not reported.");
+	}
+
+	{ // weak_ptr_mt
+		weak_ptr_mt<MessageTestObject> weakEmpty;
 
-		// template<class T, class U>
-		// inline bool operator==(const shared_ptr_mt<T>& sharedPtr1, const shared_ptr_mt<U>& sharedPtr2)
-		bool bEqual = pSharedPtr1 == pSharedPtr2;
+		EATEST_VERIFY_MSG(weakEmpty.expired() && !weakEmpty.lock(), "weak_ptr_mt failure.");
 
-		EATEST_VERIFY_MSG(!bEqual, "shared_ptr_mt failure");
+		atomic_shared_ptr_mt<MessageTestObject> pMessage = make_shared_mt<MessageTestObject>(1, 2);
+		weak_ptr_mt<MessageTestObject>          weakMessage(pMessage);
+		weak_ptr_mt<MessageTestObject>          weakCopy(weakMessage);
 
-		// template<class T, class U>
-		// inline bool operator!=(const shared_ptr_mt<T>& sharedPtr1, const shared_ptr_mt<U>& sharedPtr2)
-		bool bNotEqual = pSharedPtr1 != pSharedPtr2;
+		EATEST_VERIFY_MSG(!weakMessage.expired() && (weakMessage.use_count() == 1), "weak_ptr_mt failure.");
 
-		EATEST_VERIFY_MSG(bNotEqual, "shared_ptr_mt failure");
+		{
+			atomic_shared_ptr_mt<MessageTestObject> pLocked = weakCopy.lock();
+			EATEST_VERIFY_MSG((pLocked == pMessage) && (pMessage.use_count() == 2), "weak_ptr_mt failure.");
+		}
 
-		// template<class T, class U>
-		// inline bool operator<(const shared_ptr_mt<T>& sharedPtr1, const shared_ptr_mt<U>& sharedPtr2)
-		bool bLessA = pSharedPtr1 < pSharedPtr2;
-		bool bLessB = pSharedPtr2 < pSharedPtr1;
+		// The object goes away with its last owner, even though weak references remain.
+		pMessage.reset();
+		EATEST_VERIFY_MSG(MessageTestObject::sLiveCount.GetValue() == 0, "weak_ptr_mt failure: weak reference kept the object alive.");
+		EATEST_VERIFY_MSG(weakMessage.expired() && weakCopy.expired(), "weak_ptr_mt failure.");
+		EATEST_VERIFY_MSG(!weakMessage.lock(), "weak_ptr_mt failure.");
 
-		EATEST_VERIFY_MSG(bLessA || bLessB, "shared_ptr_mt failure");
+		// Weak references work with separately allocated objects as well.
+		atomic_shared_ptr_mt<MessageTestObject> pSeparate(new MessageTestObject(5, 6));
+		weakCopy = pSeparate;
+		EATEST_VERIFY_MSG(weakCopy.lock()->mnType == 5, "weak_ptr_mt failure.");
+		pSeparate.reset();
+		EATEST_VERIFY_MSG(weakCopy.expired() && (MessageTestObject::sLiveCount.GetValue() == 0), "weak_ptr_mt failure.");
 	}
 
+	{ // intrusive_ptr_mt
+		IntrusiveTestObject* const pObject = new IntrusiveTestObject;
+
+		{
+			intrusive_ptr_mt<IntrusiveTestObject> p1(pObject);
+			intrusive_ptr_mt<IntrusiveTestObject> p2(p1);
+			intrusive_ptr_mt<IntrusiveTestObject> p3;
+
+			EATEST_VERIFY_MSG(pObject->GetRefCount() == 2, "intrusive_ptr_mt failure.");
+			EATEST_VERIFY_MSG(!p3 && p1 && (p1 == p2), "intrusive_ptr_mt failure.");
+
+			p3 = pObject; // From a raw pointer, as if passed through a queue.
+			EATEST_VERIFY_MSG(pObject->GetRefCount() == 3, "intrusive_ptr_mt failure.");
+
+			IntrusiveTestObject* const pDetached = p2.detach();
+			EATEST_VERIFY_MSG(!p2 && (pObject->GetRefCount() == 3), "intrusive_ptr_mt failure.");
+
+			intrusive_ptr_mt<IntrusiveTestObject> p4(pDetached, false); // Adopts the detached reference.
+			EATEST_VERIFY_MSG(pObject->GetRefCount() == 3, "intrusive_ptr_mt failure.");
+
+			p1.reset();
+			EATEST_VERIFY_MSG((pObject->GetRefCount() == 2) && (IntrusiveTestObject::sLiveCount.GetValue() == 1), "intrusive_ptr_mt failure.");
+		}
+
+		EATEST_VERIFY_MSG(IntrusiveTestObject::sLiveCount.GetValue() == 0, "intrusive_ptr_mt failure: object not destroyed.");
+	}
+
+	#if EA_THREADS_AVAILABLE
+		// Weak references locking concurrently with replacement of the owner.
+		RunSharedPtrCopies<atomic_shared_ptr_mt<SharedPtrTestObject> >(4, 50000, 1, nErrorCount, true);
+		EATEST_VERIFY_MSG(SharedPtrTestObject::sLiveCount.GetValue() == 0, "weak_ptr_mt failure: objects leaked.");
+	#endif
+
+	{ // Creation speed test.
+		const int kLoopCount = 200000;
+		EA::StdC::Stopwatch stopwatch(EA::StdC::Stopwatch::kUnitsNanoseconds);
+
+		stopwatch.Start();
+		for(int i = 0; i < kLoopCount; i++)
+			shared_ptr_mt<MessageTestObject> p(new MessageTestObject(i, i));
+		stopwatch.Stop();
+		const double tShared = (double)stopwatch.GetElapsedTime() / kLoopCount;
+
+		stopwatch.Restart();
+		for(int i = 0; i < kLoopCount; i++)
+			atomic_shared_ptr_mt<MessageTestObject> p(new MessageTestObject(i, i));
+		stopwatch.Stop();
+		const double tAtomicShared = (double)stopwatch.GetElapsedTime() / kLoopCount;
+
+		stopwatch.Restart();
+		for(int i = 0; i < kLoopCount; i++)
+			atomic_shared_ptr_mt<MessageTestObject> p(make_shared_mt<MessageTestObject>(i, i));
+		stopwatch.Stop();
+		const double tMakeShared = (double)stopwatch.GetElapsedTime() / kLoopCount;
+
+		EA::UnitTest::ReportVerbosity(1, "Create and destroy cost: shared_ptr_mt %.2f ns, atomic_shared_ptr_mt %.2f ns, make_shared_mt %.2f ns\n", tShared, tAtomicShared, tMakeShared);
+	}
+
+	return nErrorCount;
+}
+
+
+int TestThreadSmartPtr()
+{
+	int nErrorCount(0);
+
+	// C11 atomics & eastl::shared_ptr name collision tests.
+	{
+		// If you are seeing compiler errors regarding C11 atomic macro
+		// expansions here look at header file eathread_atomic_android_c11.h.
+		// Ensure C11 atomic macros are being undefined properly.  We hit this
+		// problem on android-gcc config.
+		using namespace not_eastl;
+		shared_ptr<int> ptr1, ptr2, ptr3;
+
+		atomic_is_lock_free(&ptr1);
+		atomic_load(&ptr1);
+		atomic_load_explicit(&ptr1);
+		atomic_store(&ptr1, ptr2);
+		atomic_store_explicit(&ptr1, ptr2);
+		atomic_exchange(&ptr1, ptr2);
+		atomic_exchange_explicit(&ptr1, ptr2);
+		atomic_compare_exchange_strong(&ptr1, &ptr2, ptr3);
+		atomic_compare_exchange_weak(&ptr1, &ptr2, ptr3);
+		atomic_compare_exchange_strong_explicit(&ptr1, &ptr2, ptr3);
+		atomic_compare_exchange_strong_explicit(&ptr1, &ptr2, ptr3);
+	}
+
+	nErrorCount += TestSharedPtrInterface<shared_ptr_mt<TestClass> >("shared_ptr_mt");
+	nErrorCount += TestSharedPtrInterface<atomic_shared_ptr_mt<TestClass> >("atomic_shared_ptr_mt");
+	nErrorCount += TestAtomicSharedPtrThreads();
+	nErrorCount += TestMakeSharedWeakIntrusive();
+
 
 	{
 		typedef shared_array_mt<TestClass> TestClassSharedArray;
@@ -0,0 +1,329 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Electronic Arts Inc. All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TestThread.h"
+#include <EATest/EATest.h>
+#include <EAStdC/EAStopwatch.h>
+#include <eathread/eathread_thread.h>
+#include <eathread/eathread_barrier.h>
+#include <eathread/eathread_spinbarrier.h>
+
+
+using namespace EA::Thread;
+
+
+// The latency benchmark goes up to 48 threads, as in a frame step spread over
+// 48 workers, but only on systems with enough processors. Otherwise we would
+// be measuring the scheduler rather than the barrier.
+const int kMaxPhaseThreadCount   = 48;
+const int kPhaseCheckCount       = 200;   // Phases run by the multithreaded correctness test.
+const int kPhaseBenchmarkCount   = 20000; // Phases timed by the latency benchmark.
+
+
+// All three barriers return the same values, which the tests rely on.
+EAT_COMPILETIME_ASSERT(((int)SpinBarrier::kResultPrimary == (int)Barrier::kResultPrimary) && ((int)TreeBarrier::kResultPrimary == (int)Barrier::kResultPrimary));
+EAT_COMPILETIME_ASSERT(((int)SpinBarrier::kResultSecondary == (int)Barrier::kResultSecondary) && ((int)TreeBarrier::kResultSecondary == (int)Barrier::kResultSecondary));
+EAT_COMPILETIME_ASSERT(((int)SpinBarrier::kResultTimeout == (int)Barrier::kResultTimeout) && ((int)TreeBarrier::kResultTimeout == (int)Barrier::kResultTimeout));
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Adapters which give the barriers a common Wait(nParticipant, timeout) interface.
+//
+struct BarrierAdapter
+{
+	Barrier mBarrier;
+	explicit BarrierAdapter(int height) : mBarrier(height) {}
+	int Wait(int /*nParticipant*/, const ThreadTime& timeoutAbsolute) { return mBarrier.Wait(timeoutAbsolute); }
+};
+
+struct SpinBarrierAdapter
+{
+	SpinBarrier mBarrier;
+	explicit SpinBarrierAdapter(int height) : mBarrier(height) {}
+	int Wait(int /*nParticipant*/, const ThreadTime& timeoutAbsolute) { return mBarrier.Wait(timeoutAbsolute); }
+};
+
+struct TreeBarrierAdapter
+{
+	TreeBarrier mBarrier;
+	explicit TreeBarrierAdapter(int height) : mBarrier(height) {}
+	int Wait(int nParticipant, const ThreadTime& timeoutAbsolute) { return mBarrier.Wait(nParticipant, timeoutAbsolute); }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+// PhaseWorkData
+//
+template <typename BarrierType>
+struct PhaseWorkData
+{
+	BarrierType         mBarrier;
+	int                 mnThreadCount;
+	int                 mnPhaseCount;
+	bool                mbCheck;          // If true, verify each phase. The benchmark leaves this off, as it adds shared writes.
+	AtomicInt32         mnNextParticipant;
+	AtomicInt32         mnErrorCount;
+	AtomicInt32         mnArrivalCount[kPhaseCheckCount];
+	AtomicInt32         mnPrimaryCount[kPhaseCheckCount];
+	EA::StdC::Stopwatch mStopwatch;
+
+	PhaseWorkData(int nThreadCount, int nPhaseCount, bool bCheck)
+	  : mBarrier(nThreadCount), mnThreadCount(nThreadCount), mnPhaseCount(nPhaseCount), mbCheck(bCheck),
+		mnNextParticipant(0), mnErrorCount(0), mStopwatch(EA::StdC::Stopwatch::kUnitsNanoseconds)
+	{
+		for(int i = 0; i < kPhaseCheckCount; i++)
+		{
+			mnArrivalCount[i].SetValue(0);
+			mnPrimaryCount[i].SetValue(0);
+		}
+	}
+
+private:
+	PhaseWorkData(const PhaseWorkData&);
+	PhaseWorkData& operator=(const PhaseWorkData&);
+};
+
+
+template <typename BarrierType>
+static intptr_t PhaseThreadFunction(void* pvWorkData)
+{
+	PhaseWorkData<BarrierType>* const pWorkData    = (PhaseWorkData<BarrierType>*)pvWorkData;
+	const int                         nParticipant = pWorkData->mnNextParticipant.Increment() - 1;
+
+	// The first phase waits for all threads to start. Its primary thread starts the clock.
+	if(pWorkData->mBarrier.Wait(nParticipant, GetThreadTime() + 30000) == Barrier::kResultPrimary)
+		pWorkData->mStopwatch.Start();
+
+	for(int i = 0; i < pWorkData->mnPhaseCount; i++)
+	{
+		if(pWorkData->mbCheck)
+			pWorkData->mnArrivalCount[i].Increment();
+
+		const int result = pWorkData->mBarrier.Wait(nParticipant, pWorkData->mbCheck ? (GetThreadTime() + 30000) : kTimeoutNone);
+
+		if(result == Barrier::kResultPrimary)
+		{
+			if(pWorkData->mbCheck)
+				pWorkData->mnPrimaryCount[i].Increment();
+
+			if(i == (pWorkData->mnPhaseCount - 1))
+				pWorkData->mStopwatch.Stop();
+		}
+		else if(result != Barrier::kResultSecondary)
+			pWorkData->mnErrorCount.Increment();
+
+		// Every thread must have arrived for this phase before any thread is released from it.
+		if(pWorkData->mbCheck && (pWorkData->mnArrivalCount[i].GetValue() != pWorkData->mnThreadCount))
+			pWorkData->mnErrorCount.Increment();
+	}
+
+	return 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RunPhases
+//
+// Returns the average time per phase in nanoseconds.
+//
+template <typename BarrierType>
+static uint64_t RunPhases(int nThreadCount, int nPhaseCount, bool bCheck, int& nErrorCount)
+{
+	PhaseWorkData<BarrierType>* const pWorkData = new PhaseWorkData<BarrierType>(nThreadCount, nPhaseCount, bCheck);
+	Thread                            thread[kMaxPhaseThreadCount];
+
+	for(int i = 0; i < nThreadCount; i++)
+		thread[i].Begin(PhaseThreadFunction<BarrierType>, pWorkData);
+
+	for(int i = 0; i < nThreadCount; i++)
+	{
+		const Thread::Status status = thread[i].WaitForEnd(GetThreadTime() + 60000);
+		EATEST_VERIFY_MSG(status == Thread::kStatusEnded, "Barrier phase test failure: Thread(s) didn't end.");
+	}
+
+	EATEST_VERIFY_MSG(pWorkData->mnErrorCount.GetValue() == 0, "Barrier phase test failure: bad Wait result or early release.");
+
+	if(bCheck)
+	{
+		for(int i = 0; i < nPhaseCount; i++)
+			EATEST_VERIFY_MSG(pWorkData->mnPrimaryCount[i].GetValue() == 1, "Barrier phase test failure: phase didn't have exactly one primary thread.");
+	}
+
+	const uint64_t nPhaseTime = pWorkData->mStopwatch.GetElapsedTime() / (uint64_t)nPhaseCount;
+
+	delete pWorkData;
+
+	return nPhaseTime;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TreeWithdrawalWorkData
+//
+struct TreeWithdrawalWorkData
+{
+	TreeBarrier* mpBarrier;
+	int          mnParticipant;
+	int          mnResult;
+};
+
+
+static intptr_t TreeWithdrawalThreadFunction(void* pvWorkData)
+{
+	TreeWithdrawalWorkData* const pWorkData = (TreeWithdrawalWorkData*)pvWorkData;
+
+	pWorkData->mnResult = pWorkData->mpBarrier->Wait(pWorkData->mnParticipant, GetThreadTime() + 30000);
+	return 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TestThreadSpinBarrierLatency
+//
+static int TestThreadSpinBarrierLatency()
+{
+	int       nErrorCount     = 0;
+	const int nProcessorCount = GetProcessorCount();
+	const int kThreadCounts[] = { 2, 4, 8, 16, 32, 48 };
+
+	EA::UnitTest::ReportVerbosity(1, "\nBarrier per-phase latency (%d phases, time in ns per phase)...\n", kPhaseBenchmarkCount);
+
+	for(size_t t = 0; t < EAArrayCount(kThreadCounts); t++)
+	{
+		const int nThreadCount = kThreadCounts[t];
+
+		if(nThreadCount > nProcessorCount)
+		{
+			EA::UnitTest::ReportVerbosity(1, "    %2d threads: skipped, only %d processors.\n", nThreadCount, nProcessorCount);
+			continue;
+		}
+
+		const uint64_t tBarrier     = RunPhases<BarrierAdapter>    (nThreadCount, kPhaseBenchmarkCount, false, nErrorCount);
+		const uint64_t tSpinBarrier = RunPhases<SpinBarrierAdapter>(nThreadCount, kPhaseBenchmarkCount, false, nErrorCount);
+		const uint64_t tTreeBarrier = RunPhases<TreeBarrierAdapter>(nThreadCount, kPhaseBenchmarkCount, false, nErrorCount);
+
+		EA::UnitTest::ReportVerbosity(1, "    %2d threads: Barrier %8" PRIu64 ", SpinBarrier %8" PRIu64 ", TreeBarrier %8" PRIu64 "\n",
+									  nThreadCount, tBarrier, tSpinBarrier, tTreeBarrier);
+	}
+
+	return nErrorCount;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TestThreadSpinBarrier
+//
+int TestThreadSpinBarrier()
+{
+	int nErrorCount(0);
+
+	{ // SpinBarrier -- single-threaded test.
+
+		SpinBarrier barrier(1);
+
+		for(int i = 0; i < 3; i++)
+			EATEST_VERIFY_MSG(barrier.Wait() == SpinBarrier::kResultPrimary, "SpinBarrier failure");
+	}
+
+
+	{ // SpinBarrier -- A timed out thread gives up its contribution to the height.
+
+		SpinBarrier barrier(2);
+
+		EATEST_VERIFY_MSG(barrier.Wait(kTimeoutImmediate) == SpinBarrier::kResultTimeout, "SpinBarrier failure");
+		EATEST_VERIFY_MSG(barrier.Wait(GetThreadTime() + 20) == SpinBarrier::kResultTimeout, "SpinBarrier failure");
+
+		barrier.Init(1);
+		EATEST_VERIFY_MSG(barrier.Wait(kTimeoutImmediate) == SpinBarrier::kResultPrimary, "SpinBarrier failure");
+	}
+
+
+	{ // TreeBarrier -- single-threaded test.
+
+		for(int nFanIn = 2; nFanIn <= 4; nFanIn++)
+		{
+			TreeBarrier barrier(1, nFanIn);
+
+			for(int i = 0; i < 3; i++)
+				EATEST_VERIFY_MSG(barrier.Wait(0) == TreeBarrier::kResultPrimary, "TreeBarrier failure");
+		}
+	}
+
+
+	{ // TreeBarrier -- A timed out thread gives up its contribution to the height.
+
+		TreeBarrier barrier(5, 2);
+
+		EATEST_VERIFY_MSG(barrier.GetHeight() == 5, "TreeBarrier failure");
+		EATEST_VERIFY_MSG(barrier.Wait(4, kTimeoutImmediate) == TreeBarrier::kResultTimeout, "TreeBarrier failure");
+		EATEST_VERIFY_MSG(barrier.Wait(4, GetThreadTime() + 20) == TreeBarrier::kResultTimeout, "TreeBarrier failure");
+	}
+
+
+	#if EA_THREADS_AVAILABLE
+		{ // TreeBarrier -- Timing out after our group has already arrived further up the tree.
+
+			// With a fan-in of 2, participants 0 and 1 share a leaf. Once both have arrived,
+			// the leaf's arrival has been made at the root, and participant 1 timing out must undo that.
+			TreeBarrier            barrier(4, 2);
+			TreeWithdrawalWorkData workData[4];
+			Thread                 thread[4];
+
+			for(int i = 0; i < 4; i++)
+			{
+				workData[i].mpBarrier     = &barrier;
+				workData[i].mnParticipant = i;
+				workData[i].mnResult      = TreeBarrier::kResultError;
+			}
+
+			thread[0].Begin(TreeWithdrawalThreadFunction, &workData[0]);
+			EATEST_VERIFY_MSG(barrier.Wait(1, GetThreadTime() + 200) == TreeBarrier::kResultTimeout, "TreeBarrier failure");
+
+			// Now complete the phase with participant 1 arriving again from another thread.
+			for(int i = 1; i < 4; i++)
+				thread[i].Begin(TreeWithdrawalThreadFunction, &workData[i]);
+
+			int nPrimaryCount = 0;
+
+			for(int i = 0; i < 4; i++)
+			{
+				const Thread::Status status = thread[i].WaitForEnd(GetThreadTime() + 30000);
+				EATEST_VERIFY_MSG(status == Thread::kStatusEnded, "TreeBarrier failure: Thread(s) didn't end.");
+				EATEST_VERIFY_MSG((workData[i].mnResult == TreeBarrier::kResultPrimary) || (workData[i].mnResult == TreeBarrier::kResultSecondary), "TreeBarrier failure");
+
+				if(workData[i].mnResult == TreeBarrier::kResultPrimary)
+					nPrimaryCount++;
+			}
+
+			EATEST_VERIFY_MSG(nPrimaryCount == 1, "TreeBarrier failure");
+
+			// The barrier must be in a consistent state for the next phase.
+			for(int i = 0; i < 4; i++)
+				thread[i].Begin(TreeWithdrawalThreadFunction, &workData[i]);
+
+			for(int i = 0; i < 4; i++)
+			{
+				const Thread::Status status = thread[i].WaitForEnd(GetThreadTime() + 30000);
+				EATEST_VERIFY_MSG(status == Thread::kStatusEnded, "TreeBarrier failure: Thread(s) didn't end.");
+				EATEST_VERIFY_MSG(workData[i].mnResult != TreeBarrier::kResultTimeout, "TreeBarrier failure");
+			}
+		}
+
+
+		{ // Multithreaded test, including tree shapes with partially filled nodes.
+
+			const int kThreadCounts[] = { 2, 3, 7, 9 };
+
+			for(size_t t = 0; t < EAArrayCount(kThreadCounts); t++)
+			{
+				RunPhases<SpinBarrierAdapter>(kThreadCounts[t], kPhaseCheckCount, true, nErrorCount);
+				RunPhases<TreeBarrierAdapter>(kThreadCounts[t], kPhaseCheckCount, true, nErrorCount);
+			}
+		}
+
+		nErrorCount += TestThreadSpinBarrierLatency();
+	#endif
+
+	return nErrorCount;
+}
@@ -4,12 +4,110 @@
 
 #include "TestThread.h"
 #include <EATest/EATest.h>
+#include <EAStdC/EAStopwatch.h>
+#include <eathread/eathread_thread.h>
 #include <eathread/eathread_spinlock.h>
 
 
 using namespace EA::Thread;
 
 
+const int kBackoffThreadCount = 8;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// BackoffWorkData
+//
+template <typename BackoffPolicy>
+struct BackoffWorkData
+{
+	SpinLockT<BackoffPolicy> mSpinLock;
+	int                      mnLoopCount;
+	volatile int             mnCounter;  // Intentionally not atomic; modified only under mSpinLock.
+
+	BackoffWorkData(int nLoopCount) : mSpinLock(), mnLoopCount(nLoopCount), mnCounter(0) {}
+
+private:
+	BackoffWorkData(const BackoffWorkData&);
+	BackoffWorkData& operator=(const BackoffWorkData&);
+};
+
+
+template <typename BackoffPolicy>
+static intptr_t BackoffThreadFunction(void* pvWorkData)
+{
+	BackoffWorkData<BackoffPolicy>* const pWorkData = (BackoffWorkData<BackoffPolicy>*)pvWorkData;
+
+	for(int i = 0; i < pWorkData->mnLoopCount; i++)
+	{
+		AutoSpinLockT<BackoffPolicy> autoSpinLock(pWorkData->mSpinLock);
+		pWorkData->mnCounter = pWorkData->mnCounter + 1;
+	}
+
+	return 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TestSpinLockBackoff
+//
+// Runs the basic tests against SpinLockT<BackoffPolicy> and, if threads are
+// available, has nThreadCount threads increment a shared counter under the lock.
+// Returns the elapsed time of the multithreaded part in microseconds.
+//
+template <typename BackoffPolicy>
+static uint64_t TestSpinLockBackoff(const char* pPolicyName, int nThreadCount, int nLoopCount, int& nErrorCount)
+{
+	{
+		SpinLockT<BackoffPolicy> spinLock;
+
+		spinLock.Lock();
+		EATEST_VERIFY_F(spinLock.IsLocked(), "SpinLockT<%s> failure", pPolicyName);
+		EATEST_VERIFY_F(!spinLock.TryLock(), "SpinLockT<%s> failure", pPolicyName);
+		spinLock.Unlock();
+		EATEST_VERIFY_F(!spinLock.IsLocked(), "SpinLockT<%s> failure", pPolicyName);
+
+		{
+			AutoSpinLockT<BackoffPolicy> autoSpinLock(spinLock);
+			EATEST_VERIFY_F(spinLock.IsLocked(), "AutoSpinLockT<%s> failure", pPolicyName);
+		}
+
+		EATEST_VERIFY_F(!spinLock.IsLocked(), "AutoSpinLockT<%s> failure", pPolicyName);
+	}
+
+	uint64_t nElapsedTime = 0;
+
+	#if EA_THREADS_AVAILABLE
+		BackoffWorkData<BackoffPolicy>* const pWorkData = new BackoffWorkData<BackoffPolicy>(nLoopCount);
+		Thread                                thread[kBackoffThreadCount];
+		EA::StdC::Stopwatch                   stopwatch(EA::StdC::Stopwatch::kUnitsMicroseconds);
+
+		stopwatch.Start();
+
+		for(int i = 0; i < nThreadCount; i++)
+			thread[i].Begin(BackoffThreadFunction<BackoffPolicy>, pWorkData);
+
+		for(int i = 0; i < nThreadCount; i++)
+		{
+			const Thread::Status status = thread[i].WaitForEnd(GetThreadTime() + 60000);
+			EATEST_VERIFY_F(status == Thread::kStatusEnded, "SpinLockT<%s> failure: Thread(s) didn't end.", pPolicyName);
+		}
+
+		stopwatch.Stop();
+
+		EATEST_VERIFY_F(pWorkData->mnCounter == (nThreadCount * nLoopCount), "SpinLockT<%s> failure: lock didn't provide mutual exclusion.", pPolicyName);
+
+		delete pWorkData;
+		nElapsedTime = stopwatch.GetElapsedTime();
+	#else
+		EA_UNUSED(nThreadCount);
+		EA_UNUSED(nLoopCount);
+	#endif
+
+	return nElapsedTime;
+}
+
+
 int TestThreadSpinLock()
 {
 	int nErrorCount(0);
@@ -52,13 +150,35 @@ int TestThreadSpinLock()
 	}
 
 
-	#if EA_THREADS_AVAILABLE
-		{  // Multithreaded test
-	  
-			// Implement this when we get the thread class working.
-			// gTestLengthSeconds;
-		}
-	#endif
+	{ // Backoff policies
+
+		// Spinning threads that outnumber the processors mostly measure the scheduler, so keep the thread count within the processor count.
+		const int nProcessorCount = GetProcessorCount();
+		const int nThreadCount    = (nProcessorCount < 2) ? 2 : ((nProcessorCount < kBackoffThreadCount) ? nProcessorCount : kBackoffThreadCount);
+		const int nLoopCount      = (nProcessorCount < 2) ? 100 : 20000;
+
+		EA::UnitTest::ReportVerbosity(1, "\nProcessor pauses per microsecond: %u\n", (unsigned)GetProcessorPausesPerMicrosecond());
+		EA::UnitTest::ReportVerbosity(1, "SpinLock backoff test (%d threads, %d lock/unlock pairs per thread, time in us)...\n", nThreadCount, nLoopCount);
+
+		const uint64_t tNone         = TestSpinLockBackoff<BackoffNone>                ("BackoffNone",           nThreadCount, nLoopCount, nErrorCount);
+		const uint64_t tExponential  = TestSpinLockBackoff< BackoffExponential<> >     ("BackoffExponential",    nThreadCount, nLoopCount, nErrorCount);
+		const uint64_t tProportional = TestSpinLockBackoff< BackoffProportional<> >    ("BackoffProportional",   nThreadCount, nLoopCount, nErrorCount);
+		const uint64_t tSpinYield    = TestSpinLockBackoff< BackoffSpinYieldSleep<> >  ("BackoffSpinYieldSleep", nThreadCount, nLoopCount, nErrorCount);
+
+		EA::UnitTest::ReportVerbosity(1, "    BackoffNone %8" PRIu64 ", BackoffExponential %8" PRIu64 ", BackoffProportional %8" PRIu64 ", BackoffSpinYieldSleep %8" PRIu64 "\n",
+									  tNone, tExponential, tProportional, tSpinYield);
+
+		// Setting the value overrides the measurement, and setting 0 causes a re-measurement.
+		const uint32_t nPausesPerMicrosecond = GetProcessorPausesPerMicrosecond();
+
+		SetProcessorPausesPerMicrosecond(123);
+		EATEST_VERIFY_MSG(GetProcessorPausesPerMicrosecond() == 123, "SetProcessorPausesPerMicrosecond failure");
+
+		SetProcessorPausesPerMicrosecond(0);
+		EATEST_VERIFY_MSG(GetProcessorPausesPerMicrosecond() >= 1, "SetProcessorPausesPerMicrosecond failure");
+
+		SetProcessorPausesPerMicrosecond(nPausesPerMicrosecond);
+	}
 
 	return nErrorCount;
 }
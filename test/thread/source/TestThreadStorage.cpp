@@ -4,6 +4,7 @@
 
 #include "TestThread.h"
 #include <EATest/EATest.h>
+#include <EAStdC/EAStopwatch.h>
 #include <eathread/eathread.h>
 #include <eathread/eathread_storage.h>
 #include <eathread/eathread_thread.h>
@@ -217,11 +218,272 @@ static int TestThreadStorageMultiple()
 }
 
 
+// Without EATHREAD_TLS_SLOT_VECTOR_ENABLED, each ThreadLocalStorage may consume a
+// limited system resource (e.g. a pthread key), so we use only a few.
+#if EATHREAD_TLS_SLOT_VECTOR_ENABLED
+	const int kManyTLSCount = 5000;
+#else
+	const int kManyTLSCount = 8;
+#endif
+
+
+struct ManyTLSWorkData
+{
+	ThreadLocalStorage* mpTLSArray;
+	AtomicInt32         mnErrorCount;
+
+	ManyTLSWorkData() : mpTLSArray(NULL), mnErrorCount(0) {}
+
+	ManyTLSWorkData(const ManyTLSWorkData& rhs);
+	ManyTLSWorkData& operator=(const ManyTLSWorkData& rhs);
+};
+
+
+static intptr_t ManyTLSThreadFunction(void* pvWorkData)
+{
+	ManyTLSWorkData* const pWorkData   = (ManyTLSWorkData*)pvWorkData;
+	int                    nErrorCount = 0;
+
+	// Values set by the main thread aren't visible here.
+	for(int i = 0; i < kManyTLSCount; i++)
+		EATEST_VERIFY_MSG(pWorkData->mpTLSArray[i].GetValue() == NULL, "ThreadLocalStorage failure.");
+
+	for(int i = 0; i < kManyTLSCount; i++)
+		EATEST_VERIFY_MSG(pWorkData->mpTLSArray[i].SetValue((void*)(uintptr_t)(i + 100000)), "ThreadLocalStorage failure.");
+
+	for(int i = 0; i < kManyTLSCount; i++)
+		EATEST_VERIFY_MSG(pWorkData->mpTLSArray[i].GetValue() == (void*)(uintptr_t)(i + 100000), "ThreadLocalStorage failure.");
+
+	pWorkData->mnErrorCount += nErrorCount;
+
+	return 0;
+}
+
+
+static int TestThreadStorageMany()
+{
+	int nErrorCount(0);
+
+	ManyTLSWorkData workData;
+
+	workData.mpTLSArray = new ThreadLocalStorage[kManyTLSCount];
+
+	for(int i = 0; i < kManyTLSCount; i++)
+		EATEST_VERIFY_MSG(workData.mpTLSArray[i].SetValue((void*)(uintptr_t)(i + 1)), "ThreadLocalStorage failure.");
+
+	#if EA_THREADS_AVAILABLE
+		Thread thread;
+
+		thread.Begin(ManyTLSThreadFunction, &workData);
+		EATEST_VERIFY_MSG(thread.WaitForEnd(GetThreadTime() + 30000) == Thread::kStatusEnded, "Thread failure: Thread(s) didn't end.");
+
+		nErrorCount += (int)workData.mnErrorCount;
+	#endif
+
+	// The other thread's values didn't change ours.
+	for(int i = 0; i < kManyTLSCount; i++)
+		EATEST_VERIFY_MSG(workData.mpTLSArray[i].GetValue() == (void*)(uintptr_t)(i + 1), "ThreadLocalStorage failure.");
+
+	{ // GetValue speed test.
+		EA::StdC::Stopwatch stopwatch(EA::StdC::Stopwatch::kUnitsNanoseconds);
+		const int           kLoopCount = 1000000;
+		uintptr_t           nSum       = 0;
+		ThreadLocalStorage& tls        = workData.mpTLSArray[kManyTLSCount - 1];
+
+		stopwatch.Start();
+		for(int i = 0; i < kLoopCount; i++)
+			nSum += (uintptr_t)tls.GetValue();
+		stopwatch.Stop();
+
+		EATEST_VERIFY_MSG(nSum == ((uintptr_t)kManyTLSCount * kLoopCount), "ThreadLocalStorage failure.");
+		EA::UnitTest::ReportVerbosity(1, "\nThreadLocalStorage::GetValue with %d ThreadLocalStorage objects: %.2f ns per call.\n",
+									  kManyTLSCount, (double)stopwatch.GetElapsedTime() / kLoopCount);
+	}
+
+	delete[] workData.mpTLSArray;
+
+	// The new objects reuse the slots of the destroyed ones, but must not see their values.
+	workData.mpTLSArray = new ThreadLocalStorage[kManyTLSCount];
+
+	for(int i = 0; i < kManyTLSCount; i++)
+		EATEST_VERIFY_MSG(workData.mpTLSArray[i].GetValue() == NULL, "ThreadLocalStorage failure.");
+
+	delete[] workData.mpTLSArray;
+
+	return nErrorCount;
+}
+
+
+struct TLPCounter
+{
+	static AtomicInt32 sLiveCount;
+	static AtomicInt32 sDestroyedTotal; // Sum of mnCount over all destructed instances.
+
+	int mnCount;
+
+	TLPCounter() : mnCount(0) { sLiveCount.Increment(); }
+   ~TLPCounter() { sDestroyedTotal.Add(mnCount); sLiveCount.Decrement(); }
+};
+
+AtomicInt32 TLPCounter::sLiveCount(0);
+AtomicInt32 TLPCounter::sDestroyedTotal(0);
+
+
+struct alignas(128) TLPAligned
+{
+	char mData[8];
+};
+
+
+struct TLPWorkData
+{
+	ThreadLocalPointer<TLPCounter>* mpCounter;
+	AtomicInt32                     mnReadyCount;
+	AtomicInt32                     mShouldEnd;
+	AtomicInt32                     mnErrorCount;
+
+	TLPWorkData() : mpCounter(NULL), mnReadyCount(0), mShouldEnd(0), mnErrorCount(0) {}
+
+	TLPWorkData(const TLPWorkData& rhs);
+	TLPWorkData& operator=(const TLPWorkData& rhs);
+};
+
+
+struct TLPCountSummer
+{
+	int* mpSum;
+	void operator()(TLPCounter& counter) const { *mpSum += counter.mnCount; }
+};
+
+
+static const int kTLPIncrementCount = 1000;
+
+
+static intptr_t TLPThreadFunction(void* pvWorkData)
+{
+	TLPWorkData* const pWorkData   = (TLPWorkData*)pvWorkData;
+	int                nErrorCount = 0;
+
+	EATEST_VERIFY_MSG(pWorkData->mpCounter->peek() == NULL, "ThreadLocalPointer failure.");
+
+	for(int i = 0; i < kTLPIncrementCount; i++)
+		(*pWorkData->mpCounter)->mnCount++;
+
+	EATEST_VERIFY_MSG(pWorkData->mpCounter->get()->mnCount == kTLPIncrementCount, "ThreadLocalPointer failure.");
+
+	pWorkData->mnReadyCount.Increment();
+	while(!pWorkData->mShouldEnd.GetValue())
+		ThreadSleep(1);
+
+	pWorkData->mnErrorCount += nErrorCount;
+
+	return 0; // The thread's instance is destructed as it exits.
+}
+
+
+static int TestThreadLocalPointer()
+{
+	int nErrorCount(0);
+
+	{
+		ThreadLocalPointer<TLPCounter> counter;
+
+		// Lazy construction.
+		EATEST_VERIFY_MSG(counter.peek() == NULL, "ThreadLocalPointer failure.");
+		EATEST_VERIFY_MSG(TLPCounter::sLiveCount.GetValue() == 0, "ThreadLocalPointer failure.");
+
+		counter->mnCount = 5;
+		EATEST_VERIFY_MSG(counter.peek() == counter.get(), "ThreadLocalPointer failure.");
+		EATEST_VERIFY_MSG((*counter).mnCount == 5, "ThreadLocalPointer failure.");
+		EATEST_VERIFY_MSG(TLPCounter::sLiveCount.GetValue() == 1, "ThreadLocalPointer failure.");
+		EATEST_VERIFY_MSG(counter.GetInstanceCount() == 1, "ThreadLocalPointer failure.");
+
+		// reset destructs the calling thread's instance, and the next access constructs a new one.
+		counter.reset();
+		EATEST_VERIFY_MSG(counter.peek() == NULL, "ThreadLocalPointer failure.");
+		EATEST_VERIFY_MSG(TLPCounter::sDestroyedTotal.GetValue() == 5, "ThreadLocalPointer failure.");
+		EATEST_VERIFY_MSG(counter->mnCount == 0, "ThreadLocalPointer failure.");
+		counter->mnCount = 1;
+
+		#if EA_THREADS_AVAILABLE
+		{
+			const int   kThreadCount = 4;
+			TLPWorkData workData;
+			Thread      threadArray[kThreadCount];
+
+			workData.mpCounter = &counter;
+			TLPCounter::sDestroyedTotal.SetValue(0);
+
+			for(int i = 0; i < kThreadCount; i++)
+				threadArray[i].Begin(TLPThreadFunction, &workData);
+
+			while(workData.mnReadyCount.GetValue() < kThreadCount)
+				ThreadSleep(1);
+
+			// Enumeration sees the instances of all live threads, including our own.
+			int nSum = 0;
+			TLPCountSummer summer = { &nSum };
+			counter.enumerate(summer);
+
+			EATEST_VERIFY_MSG(nSum == ((kThreadCount * kTLPIncrementCount) + 1), "ThreadLocalPointer failure.");
+			EATEST_VERIFY_MSG(counter.GetInstanceCount() == (size_t)(kThreadCount + 1), "ThreadLocalPointer failure.");
+
+			workData.mShouldEnd.SetValue(1);
+
+			for(int i = 0; i < kThreadCount; i++)
+				EATEST_VERIFY_MSG(threadArray[i].WaitForEnd(GetThreadTime() + 30000) == Thread::kStatusEnded, "Thread failure: Thread(s) didn't end.");
+
+			nErrorCount += (int)workData.mnErrorCount;
+
+			// The exited threads' instances were destructed, and ours is intact.
+			#if defined(EA_PLATFORM_UNIX) || defined(EA_PLATFORM_WINDOWS)
+				// WaitForEnd may return just before the thread's exit callbacks complete.
+				for(int i = 0; (i < 1000) && (TLPCounter::sLiveCount.GetValue() != 1); i++)
+					ThreadSleep(1);
+
+				EATEST_VERIFY_MSG(TLPCounter::sLiveCount.GetValue() == 1, "ThreadLocalPointer failure: instances not destructed at thread exit.");
+				EATEST_VERIFY_MSG(TLPCounter::sDestroyedTotal.GetValue() == (kThreadCount * kTLPIncrementCount), "ThreadLocalPointer failure.");
+				EATEST_VERIFY_MSG(counter.GetInstanceCount() == 1, "ThreadLocalPointer failure.");
+			#endif
+			EATEST_VERIFY_MSG(counter->mnCount == 1, "ThreadLocalPointer failure.");
+		}
+		#endif
+
+		{ // get speed test.
+			EA::StdC::Stopwatch stopwatch(EA::StdC::Stopwatch::kUnitsNanoseconds);
+			const int           kLoopCount = 1000000;
+
+			stopwatch.Start();
+			for(int i = 0; i < kLoopCount; i++)
+				counter->mnCount++;
+			stopwatch.Stop();
+
+			EATEST_VERIFY_MSG(counter->mnCount == (kLoopCount + 1), "ThreadLocalPointer failure.");
+			EA::UnitTest::ReportVerbosity(1, "\nThreadLocalPointer::get: %.2f ns per call.\n", (double)stopwatch.GetElapsedTime() / kLoopCount);
+		}
+	}
+
+	// Destructing the ThreadLocalPointer destructed the remaining instance.
+	EATEST_VERIFY_MSG(TLPCounter::sLiveCount.GetValue() == 0, "ThreadLocalPointer failure.");
+
+	{ // Instances are aligned as their type requires, beyond what operator new guarantees.
+		ThreadLocalPointer<TLPAligned> aligned;
+
+		EATEST_VERIFY_MSG(((uintptr_t)aligned.get() % EA_ALIGN_OF(TLPAligned)) == 0, "ThreadLocalPointer failure: misaligned instance.");
+		aligned->mData[0] = 1;
+	}
+
+	return nErrorCount;
+}
+
+
 int TestThreadStorage()
 {
 	int nErrorCount(0);
 
 	nErrorCount += TestThreadStorageSingle();
+	nErrorCount += TestThreadStorageMany();
+	nErrorCount += TestThreadLocalPointer();
 
 	#if EA_THREADS_AVAILABLE
 		// Call this twice, to make sure recyling of TLS works properly.
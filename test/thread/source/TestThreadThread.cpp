@@ -522,6 +522,367 @@ int TestLambdaThreads()
 				.WaitForEnd();
 	}
 
+	{ // test Thread::Begin with a callable, whose return value is the thread's return value
+		int      foo = 0;
+		Thread   thread;
+		intptr_t nThreadReturnValue = 0;
+
+		const ThreadId threadId = thread.Begin([&foo]{ foo = 42; return 37; });
+		EATEST_VERIFY(threadId != kThreadIdInvalid);
+
+		thread.WaitForEnd(kTimeoutNone, &nThreadReturnValue);
+		EATEST_VERIFY((foo == 42) && (nThreadReturnValue == 37));
+	}
+
+	{ // test Thread::Begin with a callable whose return value doesn't convert to intptr_t, which gives a return value of 0
+		struct Result { int mnValue; };
+		int      foo = 0;
+		Thread   thread;
+		intptr_t nThreadReturnValue = 1;
+
+		thread.Begin([&foo]{ foo = 42; return Result{ 37 }; });
+		thread.WaitForEnd(kTimeoutNone, &nThreadReturnValue);
+		EATEST_VERIFY((foo == 42) && (nThreadReturnValue == 0));
+
+		MakeThread([&foo]{ foo = 43; return Result{ 38 }; }).WaitForEnd();
+		EATEST_VERIFY(foo == 43);
+	}
+
+	{ // test that a lambda without captures still binds to the RunnableFunction version
+		Thread   thread;
+		intptr_t nThreadReturnValue = 0;
+		int      nContext           = 11;
+
+		thread.Begin([](void* pContext) -> intptr_t { return *static_cast<int*>(pContext) + 1; }, &nContext);
+		thread.WaitForEnd(kTimeoutNone, &nThreadReturnValue);
+		EATEST_VERIFY(nThreadReturnValue == 12);
+	}
+
+	return nErrorCount;
+}
+
+struct BeginGroupThreadData
+{
+	int      mnIndex;
+	ThreadId mThreadId;
+	char     mName[EATHREAD_NAME_SIZE];
+};
+
+static AtomicInt32 sBeginGroupStartedCount = 0;
+static AtomicInt32 sBeginGroupShouldEnd    = 0;
+
+static intptr_t BeginGroupFunction(void* pContext)
+{
+	BeginGroupThreadData* const pData = static_cast<BeginGroupThreadData*>(pContext);
+
+	if(pData)
+	{
+		pData->mThreadId = GetThreadId();
+		strncpy(pData->mName, GetThreadName(), EATHREAD_NAME_SIZE);
+		pData->mName[EATHREAD_NAME_SIZE - 1] = 0;
+	}
+
+	sBeginGroupStartedCount.Increment();
+	while(!sBeginGroupShouldEnd.GetValue())
+		ThreadSleep(1);
+
+	return pData ? pData->mnIndex : -1;
+}
+
+// Returns the time in microseconds that it took for all the threads to start.
+static double StartThreadPool(Thread* pThreadArray, int nThreadCount, bool bBeginGroup, int& nErrorCount)
+{
+	ThreadParameters    parameters;
+	EA::StdC::Stopwatch stopwatch(EA::StdC::Stopwatch::kUnitsMicroseconds, true);
+
+	parameters.mpName         = "Pool";
+	parameters.mnProcessor    = kProcessorAny;
+	parameters.mnAffinityMask = kThreadAffinityMaskAny;
+
+	sBeginGroupStartedCount.SetValue(0);
+	sBeginGroupShouldEnd.SetValue(0);
+
+	if(bBeginGroup)
+		Thread::BeginGroup(pThreadArray, (size_t)nThreadCount, BeginGroupFunction, NULL, &parameters);
+	else
+	{
+		for(int i = 0; i < nThreadCount; i++)
+			pThreadArray[i].Begin(BeginGroupFunction, NULL, &parameters);
+	}
+
+	while(sBeginGroupStartedCount.GetValue() < nThreadCount)
+		ThreadSleep(0);
+	stopwatch.Stop();
+
+	sBeginGroupShouldEnd.SetValue(1);
+	for(int i = 0; i < nThreadCount; i++)
+		EATEST_VERIFY(pThreadArray[i].WaitForEnd(GetThreadTime() + 30000) == Thread::kStatusEnded);
+
+	return (double)stopwatch.GetElapsedTime();
+}
+
+int TestThreadBeginGroup()
+{
+	int nErrorCount = 0;
+
+	#if EA_THREADS_AVAILABLE
+	{
+		const int            kThreadCount = 16;
+		Thread               threadArray[kThreadCount];
+		BeginGroupThreadData dataArray[kThreadCount];
+		void*                contextArray[kThreadCount];
+		ThreadParameters     parameters;
+
+		for(int i = 0; i < kThreadCount; i++)
+		{
+			dataArray[i].mnIndex   = i;
+			dataArray[i].mThreadId = kThreadIdInvalid;
+			dataArray[i].mName[0]  = 0;
+			contextArray[i] = &dataArray[i];
+		}
+
+		parameters.mpName         = "Group";
+		parameters.mnProcessor    = kProcessorAny;
+		parameters.mnAffinityMask = kThreadAffinityMaskAny;
+
+		sBeginGroupStartedCount.SetValue(0);
+		sBeginGroupShouldEnd.SetValue(0);
+
+		const size_t nStartedCount = Thread::BeginGroup(threadArray, kThreadCount, BeginGroupFunction, contextArray, &parameters);
+		EATEST_VERIFY(nStartedCount == kThreadCount);
+
+		#if defined(EA_PLATFORM_UNIX) && !EA_USE_CPP11_CONCURRENCY
+			// The threads are running, with their names set, by the time BeginGroup returns.
+			for(int i = 0; i < kThreadCount; i++)
+			{
+				char name[EATHREAD_NAME_SIZE];
+				EA::StdC::Snprintf(name, sizeof(name), "Group %d", i);
+
+				EATEST_VERIFY(threadArray[i].GetStatus() == Thread::kStatusRunning);
+				EATEST_VERIFY(strcmp(threadArray[i].GetName(), name) == 0);
+			}
+		#endif
+
+		while(sBeginGroupStartedCount.GetValue() < kThreadCount)
+			ThreadSleep(1);
+
+		for(int i = 0; i < kThreadCount; i++)
+		{
+			char name[EATHREAD_NAME_SIZE];
+			EA::StdC::Snprintf(name, sizeof(name), "Group %d", i);
+
+			EATEST_VERIFY(threadArray[i].GetId() != kThreadIdInvalid);
+			EATEST_VERIFY(dataArray[i].mThreadId == threadArray[i].GetId());
+			EATEST_VERIFY_F(strcmp(dataArray[i].mName, name) == 0, "BeginGroup: thread %d is named \"%s\".\n", i, dataArray[i].mName);
+		}
+
+		sBeginGroupShouldEnd.SetValue(1);
+
+		for(int i = 0; i < kThreadCount; i++)
+		{
+			intptr_t nReturnValue = -2;
+
+			EATEST_VERIFY(threadArray[i].WaitForEnd(GetThreadTime() + 30000, &nReturnValue) == Thread::kStatusEnded);
+			EATEST_VERIFY(nReturnValue == i);
+		}
+
+		// The Thread objects can be reused, and the contexts and parameters are optional.
+		sBeginGroupStartedCount.SetValue(0);
+		sBeginGroupShouldEnd.SetValue(1);
+
+		EATEST_VERIFY(Thread::BeginGroup(threadArray, kThreadCount, BeginGroupFunction) == kThreadCount);
+
+		for(int i = 0; i < kThreadCount; i++)
+		{
+			intptr_t nReturnValue = 0;
+
+			EATEST_VERIFY(threadArray[i].WaitForEnd(GetThreadTime() + 30000, &nReturnValue) == Thread::kStatusEnded);
+			EATEST_VERIFY(nReturnValue == -1);
+		}
+	}
+
+	{
+		// Pool startup time, with Begin for each thread versus BeginGroup.
+		const int kThreadCount = 64;
+		const int kRunCount    = 5;
+		Thread    threadArray[kThreadCount];
+		double    beginTime = 0, beginGroupTime = 0;
+
+		for(int i = 0; i < kRunCount; i++)
+		{
+			beginTime      += StartThreadPool(threadArray, kThreadCount, false, nErrorCount);
+			beginGroupTime += StartThreadPool(threadArray, kThreadCount, true,  nErrorCount);
+		}
+
+		EA::UnitTest::ReportVerbosity(1, "Starting %d threads: %.0f us with Begin, %.0f us with BeginGroup.\n", kThreadCount, beginTime / kRunCount, beginGroupTime / kRunCount);
+	}
+	#endif
+
+	return nErrorCount;
+}
+
+#if EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+
+struct SchedulingThreadData
+{
+	ThreadScheduling mStartScheduling; // The thread's scheduling, as it found it on starting.
+	AtomicInt32      mnStarted;
+	AtomicInt32      mShouldEnd;
+
+	SchedulingThreadData() : mnStarted(0), mShouldEnd(0) {}
+};
+
+static intptr_t SchedulingFunction(void* pContext)
+{
+	SchedulingThreadData* const pData = static_cast<SchedulingThreadData*>(pContext);
+
+	GetThreadScheduling(pData->mStartScheduling);
+	pData->mnStarted.SetValue(1);
+
+	while(!pData->mShouldEnd.GetValue())
+		ThreadSleep(1);
+
+	return 0;
+}
+
+static bool IsThreadSchedulingPolicy(const Thread& thread, ThreadSchedulingPolicy policy)
+{
+	ThreadScheduling scheduling(kThreadSchedulingPolicyFifo, 99);
+	return GetThreadScheduling(thread.GetId(), scheduling) && (scheduling.mPolicy == policy);
+}
+
+#endif
+
+int TestThreadScheduling()
+{
+	int nErrorCount = 0;
+
+	// The policies are changed only for threads we start here, as a process without privileges
+	// can't undo some of them, such as kThreadSchedulingPolicyIdle.
+	#if EATHREAD_SCHEDULING_POLICIES_AVAILABLE
+	{
+		ThreadScheduling scheduling;
+
+		EATEST_VERIFY(GetThreadScheduling(scheduling));
+		EATEST_VERIFY(SetThreadScheduling(kThreadIdInvalid, ThreadScheduling(kThreadSchedulingPolicyBatch)) == kThreadSchedulingResultInvalid);
+		EATEST_VERIFY(!GetThreadScheduling(kThreadIdInvalid, scheduling));
+
+		Thread thread;
+		EATEST_VERIFY(thread.SetScheduling(ThreadScheduling(kThreadSchedulingPolicyBatch)) == kThreadSchedulingResultInvalid);
+		EATEST_VERIFY(thread.GetSchedulingResult() == kThreadSchedulingResultPending);
+	}
+
+	{
+		// A thread started with a policy applies it to itself before it runs its function.
+		SchedulingThreadData data;
+		ThreadParameters     parameters;
+		Thread               thread;
+
+		parameters.mScheduling = ThreadScheduling(kThreadSchedulingPolicyIdle);
+		thread.Begin(SchedulingFunction, &data, &parameters);
+
+		while(!data.mnStarted.GetValue())
+			ThreadSleep(1);
+
+		EATEST_VERIFY(thread.GetSchedulingResult() == kThreadSchedulingResultSuccess);
+		EATEST_VERIFY(data.mStartScheduling.mPolicy == kThreadSchedulingPolicyIdle);
+		EATEST_VERIFY(IsThreadSchedulingPolicy(thread, kThreadSchedulingPolicyIdle));
+
+		data.mShouldEnd.SetValue(1);
+		EATEST_VERIFY(thread.WaitForEnd(GetThreadTime() + 30000) == Thread::kStatusEnded);
+	}
+
+	{
+		// Changing the policy of a running thread.
+		SchedulingThreadData data;
+		Thread               thread;
+
+		thread.Begin(SchedulingFunction, &data);
+
+		while(!data.mnStarted.GetValue())
+			ThreadSleep(1);
+
+		EATEST_VERIFY(thread.GetSchedulingResult() == kThreadSchedulingResultSuccess);
+		EATEST_VERIFY(data.mStartScheduling.mPolicy == kThreadSchedulingPolicyDefault);
+
+		EATEST_VERIFY(thread.SetScheduling(ThreadScheduling(kThreadSchedulingPolicyBatch)) == kThreadSchedulingResultSuccess);
+		EATEST_VERIFY(IsThreadSchedulingPolicy(thread, kThreadSchedulingPolicyBatch));
+		EATEST_VERIFY(thread.SetScheduling(ThreadScheduling(kThreadSchedulingPolicyDefault)) == kThreadSchedulingResultSuccess);
+		EATEST_VERIFY(IsThreadSchedulingPolicy(thread, kThreadSchedulingPolicyDefault));
+
+		// Invalid parameters are refused whatever the process's privileges.
+		EATEST_VERIFY(thread.SetScheduling(ThreadScheduling(kThreadSchedulingPolicyFifo, 1000)) == kThreadSchedulingResultInvalid);
+		EATEST_VERIFY(thread.SetScheduling(ThreadScheduling((ThreadSchedulingPolicy)99)) == kThreadSchedulingResultInvalid);
+
+		// The real-time and deadline policies need privileges we may not have.
+		ThreadSchedulingResult result = thread.SetScheduling(ThreadScheduling(kThreadSchedulingPolicyFifo, 1));
+		EATEST_VERIFY((result == kThreadSchedulingResultSuccess) || (result == kThreadSchedulingResultPriorityReduced) || (result == kThreadSchedulingResultNotPermitted));
+
+		if(result == kThreadSchedulingResultSuccess)
+		{
+			ThreadScheduling scheduling;
+			EATEST_VERIFY(GetThreadScheduling(thread.GetId(), scheduling) && (scheduling.mPolicy == kThreadSchedulingPolicyFifo) && (scheduling.mnPriority == 1));
+			EATEST_VERIFY(thread.SetScheduling(ThreadScheduling(kThreadSchedulingPolicyDefault)) == kThreadSchedulingResultSuccess);
+		}
+
+		ThreadScheduling deadline(kThreadSchedulingPolicyDeadline);
+		deadline.mnRuntimeNs = 1000000;
+		deadline.mnPeriodNs  = 10000000;
+
+		result = thread.SetScheduling(deadline);
+		EATEST_VERIFY((result == kThreadSchedulingResultSuccess) || (result == kThreadSchedulingResultNotPermitted) || (result == kThreadSchedulingResultBusy) || (result == kThreadSchedulingResultNotSupported));
+
+		if(result == kThreadSchedulingResultSuccess)
+		{
+			ThreadScheduling scheduling;
+			EATEST_VERIFY(GetThreadScheduling(thread.GetId(), scheduling) && (scheduling.mPolicy == kThreadSchedulingPolicyDeadline));
+			EATEST_VERIFY((scheduling.mnRuntimeNs == deadline.mnRuntimeNs) && (scheduling.mnDeadlineNs == deadline.mnPeriodNs) && (scheduling.mnPeriodNs == deadline.mnPeriodNs));
+			EATEST_VERIFY(thread.SetScheduling(ThreadScheduling(kThreadSchedulingPolicyDefault)) == kThreadSchedulingResultSuccess);
+		}
+
+		EA::UnitTest::ReportVerbosity(1, "Thread scheduling: the deadline policy gave result %d.\n", (int)result);
+
+		// A runtime longer than the deadline.
+		deadline.mnRuntimeNs = 20000000;
+		result = thread.SetScheduling(deadline);
+		EATEST_VERIFY((result == kThreadSchedulingResultInvalid) || (result == kThreadSchedulingResultNotSupported));
+
+		EATEST_VERIFY(thread.SetScheduling(ThreadScheduling(kThreadSchedulingPolicyIdle)) == kThreadSchedulingResultSuccess);
+		EATEST_VERIFY(IsThreadSchedulingPolicy(thread, kThreadSchedulingPolicyIdle));
+
+		data.mShouldEnd.SetValue(1);
+		EATEST_VERIFY(thread.WaitForEnd(GetThreadTime() + 30000) == Thread::kStatusEnded);
+	}
+
+	{
+		// The threads of a group each apply the policy to themselves.
+		const int            kThreadCount = 4;
+		Thread               threadArray[kThreadCount];
+		SchedulingThreadData dataArray[kThreadCount];
+		void*                contextArray[kThreadCount];
+		ThreadParameters     parameters;
+
+		for(int i = 0; i < kThreadCount; i++)
+			contextArray[i] = &dataArray[i];
+
+		parameters.mScheduling = ThreadScheduling(kThreadSchedulingPolicyBatch);
+		EATEST_VERIFY(Thread::BeginGroup(threadArray, kThreadCount, SchedulingFunction, contextArray, &parameters) == kThreadCount);
+
+		for(int i = 0; i < kThreadCount; i++)
+		{
+			while(!dataArray[i].mnStarted.GetValue())
+				ThreadSleep(1);
+
+			EATEST_VERIFY(threadArray[i].GetSchedulingResult() == kThreadSchedulingResultSuccess);
+			EATEST_VERIFY(dataArray[i].mStartScheduling.mPolicy == kThreadSchedulingPolicyBatch);
+			dataArray[i].mShouldEnd.SetValue(1);
+		}
+
+		for(int i = 0; i < kThreadCount; i++)
+			EATEST_VERIFY(threadArray[i].WaitForEnd(GetThreadTime() + 30000) == Thread::kStatusEnded);
+	}
+	#endif
+
 	return nErrorCount;
 }
 
@@ -1233,6 +1594,8 @@ int TestThreadThread()
 	nErrorCount += TestSetThreadProcessConstants();
 	nErrorCount += TestNullThreadNames();
 	nErrorCount += TestLambdaThreads();
+	nErrorCount += TestThreadBeginGroup();
+	nErrorCount += TestThreadScheduling();
 
 	{
 		// Test SetDefaultProcessor
@@ -5,7 +5,10 @@
 #include "TestThread.h"
 #include <EATest/EATest.h>
 #include <eathread/eathread_pool.h>
+#include <eathread/eathread_list.h>
 #include <eathread/eathread_atomic.h>
+#include <eathread/eathread_sync.h>
+#include <EAStdC/EAStopwatch.h>
 #include <stdlib.h>
 
 
@@ -44,6 +47,333 @@ static intptr_t WorkerFunction(void* pvWorkData)
 }
 
 
+const int kDispatchJobCount = 20000;
+
+
+static intptr_t DispatchFunction(void* pvCompletedCount)
+{
+	static_cast<AtomicInt32*>(pvCompletedCount)->Increment();
+	return 0;
+}
+
+
+// Returns the average time in nanoseconds from Begin to the completion of an
+// empty job, with each job queued as soon as the previous one has completed.
+static double RunDispatchLatency(int nIdleSpinMicroseconds, int& nErrorCount)
+{
+	ThreadPoolParameters tpp;
+	tpp.mnMinCount             = 2;
+	tpp.mnMaxCount             = 2;
+	tpp.mnInitialCount         = 2;
+	tpp.mnIdleSpinMicroseconds = nIdleSpinMicroseconds;
+
+	ThreadPool          threadPool(&tpp);
+	AtomicInt32         nCompletedCount(0);
+	EA::StdC::Stopwatch stopwatch(EA::StdC::Stopwatch::kUnitsNanoseconds, true);
+
+	for(int i = 0; i < kDispatchJobCount; i++)
+	{
+		threadPool.Begin(DispatchFunction, &nCompletedCount);
+
+		while(nCompletedCount.GetValue() <= i)
+			EAProcessorPause();
+	}
+
+	stopwatch.Stop();
+
+	const bool bShutdownResult = threadPool.Shutdown(ThreadPool::kJobWaitAll, GetThreadTime() + 60000);
+	EATEST_VERIFY_MSG(bShutdownResult, "Thread pool failure in Shutdown (waiting for jobs to complete).");
+	EATEST_VERIFY_MSG(threadPool.GetCompletedJobCount() == kDispatchJobCount, "Thread pool failure: GetCompletedJobCount.");
+
+	return (double)stopwatch.GetElapsedTime() / kDispatchJobCount;
+}
+
+
+static intptr_t GatedFunction(void* pvGate)
+{
+	while(static_cast<AtomicInt32*>(pvGate)->GetValue() == 0)
+		ThreadSleep(1);
+	return 0;
+}
+
+
+static void TestJobCompletion(int& nErrorCount)
+{
+	ThreadPoolParameters tpp;
+	tpp.mnMinCount     = 2;
+	tpp.mnMaxCount     = 2;
+	tpp.mnInitialCount = 2;
+
+	ThreadPool  threadPool(&tpp);
+	AtomicInt32 nCompletedCount(0);
+	AtomicInt32 nGate(0);
+
+	{   // JobGroup
+		const int kGroupJobCount = 1000;
+		JobGroup  jobGroup;
+
+		for(int i = 0; i < kGroupJobCount; i++)
+			threadPool.Begin(DispatchFunction, &nCompletedCount, NULL, false, &jobGroup);
+
+		EATEST_VERIFY_MSG(jobGroup.Wait(GetThreadTime() + 60000), "JobGroup failure: Wait timed out.");
+		EATEST_VERIFY_MSG(jobGroup.GetPendingCount() == 0, "JobGroup failure: GetPendingCount.");
+		EATEST_VERIFY_MSG(nCompletedCount.GetValue() == kGroupJobCount, "JobGroup failure: Wait returned before all jobs completed.");
+
+		// Counts maintained by the user.
+		jobGroup.Add(2);
+		EATEST_VERIFY_MSG(!jobGroup.Wait(GetThreadTime() + 20), "JobGroup failure: Wait didn't time out.");
+		jobGroup.Done();
+		jobGroup.Done();
+		EATEST_VERIFY_MSG(jobGroup.Wait(kTimeoutImmediate), "JobGroup failure: Wait timed out.");
+	}
+
+	{   // Individual jobs, with hundreds outstanding.
+		const int kSlotJobCount = 600;
+		int       jobIdArray[kSlotJobCount];
+
+		nCompletedCount.SetValue(0);
+
+		const int nGatedJob0 = threadPool.Begin(GatedFunction, &nGate);
+		const int nGatedJob1 = threadPool.Begin(GatedFunction, &nGate);
+
+		for(int i = 0; i < kSlotJobCount; i++)
+			jobIdArray[i] = threadPool.Begin(DispatchFunction, &nCompletedCount);
+
+		EATEST_VERIFY_MSG(threadPool.WaitForJobCompletion(nGatedJob0, ThreadPool::kJobWaitAll, GetThreadTime() + 20) == ThreadPool::kResultTimeout, "Thread pool failure: WaitForJobCompletion didn't time out.");
+		EATEST_VERIFY_MSG(threadPool.WaitForJobCompletion(jobIdArray[kSlotJobCount - 1], ThreadPool::kJobWaitAll, GetThreadTime() + 20) == ThreadPool::kResultTimeout, "Thread pool failure: WaitForJobCompletion didn't time out.");
+
+		nGate.SetValue(1);
+
+		EATEST_VERIFY_MSG(threadPool.WaitForJobCompletion(nGatedJob0, ThreadPool::kJobWaitAll, GetThreadTime() + 60000) == ThreadPool::kResultOK, "Thread pool failure: WaitForJobCompletion.");
+		EATEST_VERIFY_MSG(threadPool.WaitForJobCompletion(nGatedJob1, ThreadPool::kJobWaitAll, GetThreadTime() + 60000) == ThreadPool::kResultOK, "Thread pool failure: WaitForJobCompletion.");
+
+		for(int i = kSlotJobCount - 1; i >= 0; i--)
+		{
+			const int nResult = threadPool.WaitForJobCompletion(jobIdArray[i], ThreadPool::kJobWaitAll, GetThreadTime() + 60000);
+
+			EATEST_VERIFY_MSG(nResult == ThreadPool::kResultOK, "Thread pool failure: WaitForJobCompletion.");
+
+			// Jobs start in order, so once the last job has completed at most one other can still be running.
+			if(i == kSlotJobCount - 1)
+				EATEST_VERIFY_MSG(nCompletedCount.GetValue() >= kSlotJobCount - 1, "Thread pool failure: WaitForJobCompletion returned early.");
+		}
+
+		EATEST_VERIFY_MSG(threadPool.WaitForJobCompletion(-1, ThreadPool::kJobWaitAll, GetThreadTime() + 60000) == ThreadPool::kResultOK, "Thread pool failure: WaitForJobCompletion.");
+		EATEST_VERIFY_MSG(nCompletedCount.GetValue() == kSlotJobCount, "Thread pool failure: jobs lost.");
+	}
+
+	{   // Jobs discarded by Shutdown count as completed.
+		JobGroup jobGroup;
+
+		nGate.SetValue(0);
+
+		for(int i = 0; i < 10; i++)
+			threadPool.Begin(GatedFunction, &nGate, NULL, false, &jobGroup);
+
+		ThreadSleep(20);
+		nGate.SetValue(1);
+		threadPool.Shutdown(ThreadPool::kJobWaitNone, GetThreadTime() + 60000);
+
+		EATEST_VERIFY_MSG(jobGroup.Wait(GetThreadTime() + 60000), "JobGroup failure: Wait for discarded jobs timed out.");
+	}
+}
+
+
+class JobCountingAllocator : public EA::Thread::Allocator
+{
+public:
+	int  mnAllocCount;
+	int  mnFreeCount;
+	bool mbFail; // If true then Alloc returns NULL.
+
+	JobCountingAllocator() : mnAllocCount(0), mnFreeCount(0), mbFail(false) {}
+
+	void* Alloc(size_t size, const char* /*name*/, unsigned int /*flags*/)
+		{ if(mbFail) return NULL; mnAllocCount++; return new char[size]; }
+
+	void* Alloc(size_t size, const char* /*name*/, unsigned int /*flags*/, unsigned int /*align*/, unsigned int /*alignOffset*/)
+		{ if(mbFail) return NULL; mnAllocCount++; return new char[size]; }
+
+	void Free(void* block, size_t /*size*/)
+		{ mnFreeCount++; delete[] static_cast<char*>(block); }
+};
+
+
+// Counts live instances, including moved-from ones, so that tests can check that jobs destroy their callables.
+struct JobCaptureTracker
+{
+	static AtomicInt32 sLiveCount;
+
+	AtomicInt32* mpSum;
+
+	explicit JobCaptureTracker(AtomicInt32* pSum) : mpSum(pSum) { ++sLiveCount; }
+	JobCaptureTracker(const JobCaptureTracker& x) : mpSum(x.mpSum) { ++sLiveCount; }
+	JobCaptureTracker(JobCaptureTracker&& x) noexcept : mpSum(x.mpSum) { ++sLiveCount; }
+   ~JobCaptureTracker() { --sLiveCount; }
+};
+
+AtomicInt32 JobCaptureTracker::sLiveCount(0);
+
+
+// A capture which can only be moved.
+struct JobMoveOnlyValue
+{
+	int mnValue;
+
+	explicit JobMoveOnlyValue(int nValue) : mnValue(nValue) {}
+	JobMoveOnlyValue(JobMoveOnlyValue&& x) noexcept : mnValue(x.mnValue) { x.mnValue = 0; }
+	JobMoveOnlyValue(const JobMoveOnlyValue&) = delete;
+};
+
+
+// Counts constructions and destructions, so that tests can check that the job list's node cache doesn't make extra ones.
+struct JobListValue
+{
+	static int snConstructCount;
+	static int snDestructCount;
+
+	JobListValue() { ++snConstructCount; }
+	JobListValue(const JobListValue&) { ++snConstructCount; }
+   ~JobListValue() { ++snDestructCount; }
+};
+
+int JobListValue::snConstructCount = 0;
+int JobListValue::snDestructCount  = 0;
+
+
+static void TestJobListCache(int& nErrorCount)
+{
+	JobCountingAllocator allocator;
+	Allocator* const     pSavedAllocator = GetAllocator();
+
+	SetAllocator(&allocator);
+
+	{   // The list's two end nodes and three value nodes are cached as they are destroyed, and then freed.
+		simple_list<JobListValue, details::ListCachingAllocatorImpl<JobListValue> > valueList;
+
+		for(int i = 0; i < 3; i++)
+			valueList.push_back(JobListValue());
+		for(int i = 0; i < 3; i++)
+			valueList.pop_front();
+		for(int i = 0; i < 3; i++)
+			valueList.push_back(JobListValue());
+	}
+
+	SetAllocator(pSavedAllocator);
+
+	EATEST_VERIFY_MSG((allocator.mnAllocCount == 5) && (allocator.mnFreeCount == 5), "Job list failure: cached nodes weren't reused and freed.");
+	EATEST_VERIFY_MSG(JobListValue::snConstructCount == JobListValue::snDestructCount, "Job list failure: cached nodes were constructed or destructed when freed.");
+	EATEST_VERIFY_MSG(JobListValue::snConstructCount == 5 + 6 + 3, "Job list failure: cached nodes were constructed when freed.");
+}
+
+
+static void TestCallableJobs(int& nErrorCount)
+{
+	const int kCallableJobCount = 100;
+
+	ThreadPoolParameters tpp;
+	tpp.mnMinCount     = 2;
+	tpp.mnMaxCount     = 2;
+	tpp.mnInitialCount = 2;
+
+	ThreadPool  threadPool(&tpp);
+	AtomicInt32 nSum(0);
+	AtomicInt32 nGate(0);
+	JobGroup    jobGroup;
+
+	// Queues kCallableJobCount callables behind a job for each thread which holds the thread
+	// until the callables are queued. Returns the sum of 0 to kCallableJobCount - 1 when all is well.
+	auto RunCallableJobs = [&](int nJobCount) -> int
+	{
+		nSum.SetValue(0);
+		nGate.SetValue(0);
+
+		for(int i = 0; i < 2; i++)
+			threadPool.Begin(GatedFunction, &nGate, NULL, false, &jobGroup);
+
+		for(int i = 0; i < nJobCount; i++)
+		{
+			JobCaptureTracker tracker(&nSum);
+			threadPool.Begin([tracker, i]{ tracker.mpSum->Add(i); }, &jobGroup);
+		}
+
+		nGate.SetValue(1);
+		EATEST_VERIFY_MSG(jobGroup.Wait(GetThreadTime() + 60000), "Thread pool failure: callable jobs timed out.");
+		return nSum.GetValue();
+	};
+
+	// The first run leaves enough job list nodes cached for the second run.
+	EATEST_VERIFY_MSG(RunCallableJobs(kCallableJobCount * 2) == (kCallableJobCount * 2) * (kCallableJobCount * 2 - 1) / 2, "Thread pool failure: callable jobs.");
+
+	{   // Small callables are stored in the job, and queueing them doesn't allocate memory.
+		JobCountingAllocator allocator;
+		Allocator* const     pSavedAllocator = GetAllocator();
+
+		SetAllocator(&allocator);
+		EATEST_VERIFY_MSG(RunCallableJobs(kCallableJobCount) == kCallableJobCount * (kCallableJobCount - 1) / 2, "Thread pool failure: callable jobs.");
+		EATEST_VERIFY_MSG(allocator.mnAllocCount == 0, "Thread pool failure: queueing a small callable allocated memory.");
+
+		// Large callables are allocated, and freed once they have been called.
+		char largeCaptureArray[128] = { 5 };
+		const int nJob = threadPool.Begin([&nSum, largeCaptureArray]{ nSum.SetValue(largeCaptureArray[0]); });
+
+		EATEST_VERIFY_MSG(threadPool.WaitForJobCompletion(nJob, ThreadPool::kJobWaitAll, GetThreadTime() + 60000) == ThreadPool::kResultOK, "Thread pool failure: WaitForJobCompletion.");
+		EATEST_VERIFY_MSG(nSum.GetValue() == 5, "Thread pool failure: large callable.");
+		EATEST_VERIFY_MSG((allocator.mnAllocCount == 1) && (allocator.mnFreeCount == 1), "Thread pool failure: large callable allocation.");
+
+		// Callables are aligned for their captures, although the allocator doesn't align its allocations.
+		struct alignas(64) AlignedCapture { char mData[64]; } alignedCapture = { { 7 } };
+		const int nAlignedJob = threadPool.Begin([&nSum, alignedCapture]{ nSum.SetValue(((uintptr_t)&alignedCapture % 64) ? -1 : alignedCapture.mData[0]); });
+
+		EATEST_VERIFY_MSG(threadPool.WaitForJobCompletion(nAlignedJob, ThreadPool::kJobWaitAll, GetThreadTime() + 60000) == ThreadPool::kResultOK, "Thread pool failure: WaitForJobCompletion.");
+		EATEST_VERIFY_MSG(nSum.GetValue() == 7, "Thread pool failure: callable allocated without its alignment.");
+
+		// A callable is freed by the allocator which allocated it, even if the allocator has changed since.
+		nGate.SetValue(0);
+		const int nGatedJob = threadPool.Begin([&nGate, largeCaptureArray]{ while(nGate.GetValue() == 0) ThreadSleep(1); });
+		SetAllocator(pSavedAllocator);
+		nGate.SetValue(1);
+
+		EATEST_VERIFY_MSG(threadPool.WaitForJobCompletion(nGatedJob, ThreadPool::kJobWaitAll, GetThreadTime() + 60000) == ThreadPool::kResultOK, "Thread pool failure: WaitForJobCompletion.");
+		EATEST_VERIFY_MSG(allocator.mnAllocCount == allocator.mnFreeCount, "Thread pool failure: callable freed by the wrong allocator.");
+
+		// Failure to allocate a callable fails Begin, rather than queueing an empty job.
+		SetAllocator(&allocator);
+		allocator.mbFail = true;
+		nSum.SetValue(0);
+
+		EATEST_VERIFY_MSG(threadPool.Begin([&nSum, largeCaptureArray]{ nSum.SetValue(largeCaptureArray[0]); }) == ThreadPool::kResultError, "Thread pool failure: Begin succeeded without memory for the callable.");
+
+		Thread thread;
+		EATEST_VERIFY_MSG(thread.Begin([&nSum, largeCaptureArray]{ nSum.SetValue(largeCaptureArray[0]); }) == kThreadIdInvalid, "Thread failure: Begin succeeded without memory for the callable.");
+
+		allocator.mbFail = false;
+		SetAllocator(pSavedAllocator);
+
+		EATEST_VERIFY_MSG(threadPool.WaitForJobCompletion(-1, ThreadPool::kJobWaitAll, GetThreadTime() + 60000) == ThreadPool::kResultOK, "Thread pool failure: WaitForJobCompletion.");
+		EATEST_VERIFY_MSG((nSum.GetValue() == 0) && (threadPool.GetThreadCount() == 2), "Thread pool failure: a failed Begin queued a job.");
+	}
+
+	EATEST_VERIFY_MSG(JobCaptureTracker::sLiveCount.GetValue() == 0, "Thread pool failure: callables not destroyed after they were called.");
+
+	{   // Callables which can only be moved.
+		JobMoveOnlyValue value(23);
+		const int nJob = threadPool.Begin([&nSum, value = std::move(value)]{ nSum.SetValue(value.mnValue); });
+
+		EATEST_VERIFY_MSG(threadPool.WaitForJobCompletion(nJob, ThreadPool::kJobWaitAll, GetThreadTime() + 60000) == ThreadPool::kResultOK, "Thread pool failure: WaitForJobCompletion.");
+		EATEST_VERIFY_MSG(nSum.GetValue() == 23, "Thread pool failure: move-only callable.");
+	}
+
+	{   // The return value of a callable is ignored, whatever its type.
+		struct JobResult { int mnValue; };
+		const int nJob = threadPool.Begin([&nSum]{ nSum.SetValue(29); return JobResult{ 31 }; });
+
+		EATEST_VERIFY_MSG(threadPool.WaitForJobCompletion(nJob, ThreadPool::kJobWaitAll, GetThreadTime() + 60000) == ThreadPool::kResultOK, "Thread pool failure: WaitForJobCompletion.");
+		EATEST_VERIFY_MSG(nSum.GetValue() == 29, "Thread pool failure: callable returning a struct.");
+	}
+}
+
+
 int TestThreadThreadPool()
 {
 	int nErrorCount(0);
@@ -83,6 +413,28 @@ int TestThreadThreadPool()
 		}
 
 		EATEST_VERIFY_MSG(gWorkItemsCreated == gWorkItemsProcessed, "Thread pool failure: gWorkItemsCreated != gWorkItemsProcessed.");
+
+		TestJobCompletion(nErrorCount);
+		TestJobListCache(nErrorCount);
+		TestCallableJobs(nErrorCount);
+
+		{
+			// Job dispatch latency without idle polling and with 50us of it. The submitting thread
+			// busy-waits for each job, so this needs at least two processors.
+			const int nProcessorCount = GetProcessorCount();
+
+			EA::UnitTest::ReportVerbosity(1, "\nThread pool dispatch latency (%d jobs, time in ns from Begin to job completion)...\n", kDispatchJobCount);
+
+			if(nProcessorCount < 2)
+				EA::UnitTest::ReportVerbosity(1, "    skipped, only %d processors.\n", nProcessorCount);
+			else
+			{
+				const double tWait = RunDispatchLatency(0, nErrorCount);
+				const double tPoll = RunDispatchLatency(50, nErrorCount);
+
+				EA::UnitTest::ReportVerbosity(1, "    condition wait only %8.1f, idle polling %8.1f\n", tWait, tPoll);
+			}
+		}
 	#endif
 
 	return nErrorCount;